@@ -11,12 +11,90 @@
 #include <fstream> // file input, file output, file open, file close
 #include <cmath> // sine function (sin(x)), cosine function (cos(x)), square root function (sqrt(x))
 #include <functional> // define custom Function type
+#include <cstdint> // uint64_t (the data type of the number of partitions, n)
+#include <chrono> // std::chrono::steady_clock (used to report the progress and throughput of very large partition counts)
+#include <string> // std::string (used to read command line arguments)
+#include <vector> // std::vector (used to store batches of sample points)
+#include <random> // std::mt19937_64 (used to generate the sample points of the SIMD accuracy report)
+#include <cstring> // std::memcpy (used to load and store vectors of sample points)
+#include <immintrin.h> // _mm256_sqrt_pd(), _mm512_sqrt_pd() (hardware vector square root)
+#include <thread> // std::thread (the workers of the thread pool)
+#include <mutex> // std::mutex, std::unique_lock (used to hand jobs to the thread pool)
+#include <condition_variable> // std::condition_variable (used to wake the thread pool workers and to wait for them)
+#include <atomic> // std::atomic (the index of the next block which a thread pool worker claims)
+#include <map> // std::map (used to store command line options)
+#include <queue> // std::priority_queue (the subintervals of adaptive quadrature, largest error first)
+#include <cfloat> // DBL_EPSILON, DBL_MIN (used by the Gauss-Kronrod error estimate)
+#include <cctype> // std::isalpha(), std::isdigit() (used to parse the user-defined function f(x))
+#include <list> // std::list (the least recently used order of the result cache)
+#include <unordered_map> // std::unordered_map (the index of the result cache)
+#include <fcntl.h> // open() (used to open the file of the result cache)
+#include <unistd.h> // ftruncate(), close() (used to size and close the file of the result cache)
+#include <sys/mman.h> // mmap(), munmap() (used to map the file of the result cache into memory)
+#include <sys/stat.h> // fstat() (used to read the size of the file of the result cache)
+#include <algorithm> // std::stable_sort() (used to group the jobs of a batch by integrand and rule)
+#include <sstream> // std::istringstream (used to read the lines of a job file)
+#include <complex> // std::complex (used to compute the exact integral of sin(x1 + ... + xd) over a box)
+#include <charconv> // std::from_chars(), std::to_chars() (used to read and write the numbers of sample files without copying them)
+#include <ctime> // clock_gettime() (used to measure the CPU time of each phase of the Riemann pipeline)
 #define MINIMUM_a -999 // constant which represents the minimum a value
 #define MAXIMUM_a 999 // constant which represents the maximum a value
 // #define MINIMUM_b -999 // constant which represents the minimum b value
 // #define MAXIMUM_b 999 // constant which represents the maximum b value
-// #define MINIMUM_n 1 // constant which represents the minimum n value
-// #define MAXIMUM_n 999 // constant which represents the maximum n value
+#define MINIMUM_n 1 // constant which represents the minimum n value
+#define MAXIMUM_n 1000000000000ULL // constant which represents the maximum n value (one trillion partitions)
+#define PROGRESS_BLOCK_SIZE 16777216 // constant which represents the number of rectangles which are summed between two checks of the progress clock
+#define PROGRESS_REPORT_SECONDS 1.0 // constant which represents the minimum number of seconds between two progress reports
+#define NUMBER_OF_FUNCTIONS 6 // constant which represents the number of built-in functions in the list displayed by selectFunctionFromListOfFunctions
+#define USER_DEFINED_FUNCTION_OPTION 6 // constant which represents the option number of the user-defined function f(x) (which follows the built-in functions in that list)
+#define EXPRESSION_BATCH_SIZE 256 // constant which represents the number of x values for which each instruction of a compiled expression is executed at once
+#define EXPRESSION_MAXIMUM_REGISTERS 256 // constant which represents the largest number of registers (x, the constants, and the intermediate values) of a compiled expression
+#define MAXIMUM_POLYNOMIAL_DEGREE 16 // constant which represents the largest degree of a polynomial f(x) whose Riemann sums are computed in closed form
+#define CLOSED_FORM_TOLERANCE 1e-9 // constant which represents the largest relative difference between a numeric sum and its closed form which the closed-form report accepts
+#define CLOSED_FORM_MAXIMUM_COMPARED_n 100000000ULL // constant which represents the largest n value for which the closed-form report computes the numeric sums by default
+#define RESULT_CACHE_CAPACITY 4096 // constant which represents the number of results which the result cache keeps in memory before it evicts the least recently used one
+#define RESULT_CACHE_FILE_SLOTS 16384 // constant which represents the number of results which the file of the result cache stores
+#define RESULT_CACHE_FILE_WAYS 4 // constant which represents the number of slots of the file of the result cache which a key may be stored in
+#define RESULT_CACHE_MAXIMUM_PIECES 8 // constant which represents the largest number of cached adjacent intervals which the result cache adds to answer one interval
+#define RESULT_CACHE_FILE_NAME "reimann_sum_cache.bin" // constant which represents the name of the file in which the interactive program caches its results
+#define BATCH_BUFFER_SIZE 1024 // constant which represents the number of points (of one or more jobs) which the batch engine evaluates with one call of a batch evaluator
+#define BATCH_TASK_POINTS 65536 // constant which represents the number of points of small jobs which the batch engine packs into one task for one thread
+#define BATCH_LARGE_JOB_POINTS 1048576 // constant which represents the number of points above which a job of the batch engine is computed on its own (on every thread)
+#define BATCH_RANDOM_JOBS 10000 // constant which represents the number of random jobs which the batch mode generates if no job file is given
+#define MAXIMUM_BOX_DIMENSION 8 // constant which represents the largest number of dimensions of a box
+#define NUMBER_OF_BOX_FUNCTIONS 3 // constant which represents the number of functions which can be integrated over a box
+#define BOX_TILE_POINTS 4096 // constant which represents the number of grid points in each tile of a box (so that the coordinates and values of a tile fit in the level 2 cache)
+#define BOX_MAXIMUM_AXIS_POINTS 16777216 // constant which represents the largest number of points of the rule along one axis of a box
+#define MONTE_CARLO_BLOCK_SIZE 4096 // constant which represents the number of samples in each block which one thread evaluates (independent of the number of threads)
+#define MONTE_CARLO_ROUND_BLOCKS 64 // constant which represents the number of blocks which are handed to the thread pool at once (between two checks of the standard error)
+#define QUASI_MONTE_CARLO_REPLICATES 16 // constant which represents the number of independently scrambled Halton sequences whose spread estimates the error of quasi-Monte Carlo
+#define NUMBER_OF_SAMPLINGS 2 // constant which represents the number of sampling methods (pseudorandom Monte Carlo and scrambled Halton quasi-Monte Carlo)
+#define SAMPLE_CHUNK_BYTES 1048576 // constant which represents the number of bytes of a sample file in each chunk which one thread integrates
+#define SAMPLE_ROUND_CHUNKS 64 // constant which represents the number of chunks of a sample file which are handed to the thread pool at once (the pages of each round are released after it)
+#define NUMBER_OF_SAMPLE_RULES 4 // constant which represents the number of rules for sampled data (left, right, midpoint, and trapezoid)
+#define CUMULATIVE_MAXIMUM_n 4294967296ULL // constant which represents the largest number of partitions of a cumulative integral (whose n + 1 running sums take 32 gigabytes)
+#define CUMULATIVE_CHECKED_QUERIES 100 // constant which represents the number of random queries of a cumulative integral which are checked against a direct computation
+#define DOUBLE_DOUBLE_TAYLOR_TERMS 14 // constant which represents the number of terms of the Taylor series of the double-double sine and cosine (enough for 10^-32 on [-pi/4, pi/4])
+#define FLOAT128_TAYLOR_TERMS 20 // constant which represents the number of terms of the Taylor series of the __float128 sine and cosine
+#define DOUBLE_DOUBLE_DIGITS 32 // constant which represents the number of significant digits which are printed for a double-double value
+#define NUMBER_OF_PHASES 4 // constant which represents the number of phases of the Riemann pipeline (input, evaluation, accumulation, and output)
+#define SAMPLE_CHECK_FILE_NAME "reimann_sum_samples_check.tmp" // constant which represents the name of the file to which the sampled data rule check writes each sample set (and which it then removes)
+#define BENCHMARK_FILE_NAME "reimann_sum_benchmark.csv" // constant which represents the default name of the file to which the benchmark suite appends its results
+#define NUMBER_OF_RULES 6 // constant which represents the number of rules which have compiled kernels (left, right, midpoint, trapezoid, Simpson, and Boole)
+#define MINIMUM_GAUSS_LEGENDRE_ORDER 2 // constant which represents the smallest number of nodes per partition of a Gauss-Legendre rule
+#define MAXIMUM_GAUSS_LEGENDRE_ORDER 64 // constant which represents the largest number of nodes per partition of a Gauss-Legendre rule
+#define RULE_REPORT_MAXIMUM_EVALUATIONS 268435456 // constant which represents the number of function evaluations after which the rule report gives up on a rule
+#define GAUSS_KRONROD_POINTS 15 // constant which represents the number of points at which the 7-point Gauss and 15-point Kronrod rules evaluate f on each subinterval
+#define ADAPTIVE_BATCH_SIZE 16 // constant which represents the largest number of subintervals which adaptive quadrature bisects at once (in parallel)
+#define ADAPTIVE_MAXIMUM_SUBINTERVALS 1000000 // constant which represents the number of subintervals after which adaptive quadrature stops refining
+#define ROMBERG_MAXIMUM_LEVELS 28 // constant which represents the number of times Romberg integration halves the partitions before it stops (2^27 partitions at the last level)
+#define NUMBER_OF_INSTRUCTION_SETS 3 // constant which represents the number of instruction sets which kernels are compiled for (scalar, AVX2, and AVX-512)
+#define ACCURACY_SAMPLE_COUNT 1000000 // constant which represents the number of random points at which the SIMD accuracy report compares each function
+#define PARALLEL_BLOCK_SIZE 65536 // constant which represents the number of rectangles in each block which one thread sums (independent of the number of threads)
+#define PARALLEL_BATCH_BLOCKS 4096 // constant which represents the number of blocks which are handed to the thread pool at once (between two progress checks)
+#define NUMBER_OF_ACCUMULATORS 6 // constant which represents the number of accumulators in the list displayed by selectAccumulator
+#define PAIRWISE_BLOCK_SIZE 128 // constant which represents the number of values which pairwise summation adds in a plain loop (instead of splitting them in half again)
+#define ACCUMULATOR_COST_REPETITIONS 200 // constant which represents the number of times the accumulator report sums the same block of heights to measure the cost per element
 
 // Define the data type for an object which represents a single variable function.
 using Function = std::function<double(double)>;
@@ -28,22 +106,812 @@ using Function = std::function<double(double)>;
  * where the left end of that interval is represented by a double-type variable named a,
  * where the right end of that interval is represented by a double-type variable named b,
  * and where the natural number of times which that interval is divided into equally-sized partitions 
- * is represented by an int-type variable named n.
+ * is represented by a uint64_t-type variable named n.
+ * 
+ * If n is zero, the partitions are chosen adaptively instead (see computeAdaptiveQuadrature) 
+ * until the error bound is at most absoluteTolerance or at most relativeTolerance times the magnitude of the integral.
  */
 struct Parameters { 
     double a; 
     double b; 
-    int n; 
+    uint64_t n; 
+    double absoluteTolerance;
+    double relativeTolerance;
+};
+
+/**
+ * Define a struct-type variable named TraceSettings which stores how much of the Riemann sum computation is printed
+ * where level is a string-type variable which is either "none", "sampled", or "full"
+ * and where interval is an int-type variable which stores k (such that every k-th rectangle is printed) when level is "sampled".
+ * 
+ * "none" prints nothing while the rectangles are being summed (which is the fast path).
+ * 
+ * "sampled" prints one line for every k-th rectangle (and for the last rectangle).
+ * 
+ * "full" prints every step of every rectangle (which is the original step-by-step teaching mode).
+ */
+struct TraceSettings {
+    std::string level;
+    int interval;
+};
+
+/**
+ * Define an enumerated type named Rule whose values are the rectangle construction methods 
+ * (i.e. where inside of each partition of [a,b] the height of that partition's rectangle is measured) 
+ * and the higher-order quadrature rules. 
+ * Unlike the method string, a Rule can be a template argument, so the offset and the weights of each rule are known at compile time.
+ * 
+ * Trapezoid, Simpson, and Boole are the composite Newton-Cotes rules which evaluate f at the n + 1 end-points of the partitions 
+ * (Simpson requires n to be even and Boole requires n to be a multiple of 4). 
+ * GaussLegendre evaluates f at the m Gauss-Legendre nodes of each partition (where m, the order, is 2 through 64).
+ */
+enum class Rule { Left, Right, Midpoint, Trapezoid, Simpson, Boole, GaussLegendre };
+
+/**
+ * Define an enumerated type named InstructionSet whose values are the instruction sets which the kernels are compiled for: 
+ * plain scalar code (which runs on any x86-64 processor), AVX2 with FMA (4 doubles per vector), and AVX-512 (8 doubles per vector). 
+ * detectInstructionSet returns the widest one which the processor running this program supports.
+ */
+enum class InstructionSet { Scalar, Avx2, Avx512 };
+
+/**
+ * Define an enumerated type named Accumulator whose values are the ways in which the heights of the rectangles can be added 
+ * (when nothing is printed while the rectangles are being summed):
+ * 
+ * Naive adds the heights in plain double arithmetic inside of the compiled kernel (the fastest, whose rounding error grows with n).
+ * 
+ * Kahan and Neumaier carry the rounding error of each addition in a second double and add it back (Neumaier also handles values larger than the running sum).
+ * 
+ * Pairwise splits the heights in half recursively (down to PAIRWISE_BLOCK_SIZE values), so its rounding error grows with log(n) instead of n.
+ * 
+ * VectorCompensated carries one error term per vector lane (using the branch-free two-sum), so it keeps most of the speed of SIMD code.
+ * 
+ * LongDouble adds the heights in 80-bit extended precision (for comparison with the compensated accumulators).
+ */
+enum class Accumulator { Naive, Kahan, Neumaier, Pairwise, VectorCompensated, LongDouble };
+
+/**
+ * Define an enumerated type named Phase whose values are the phases of the Riemann pipeline: 
+ * Input (reading the settings and preparing the engine), Evaluation (computing the x-axis points and f of each point), 
+ * Accumulation (adding the heights with the selected accumulator), and Output (printing and writing the result). 
+ * The naive accumulator adds each height inside of the compiled kernel which evaluates it, so its accumulation is measured as part of its evaluation.
+ */
+enum class Phase { Input, Evaluation, Accumulation, Output };
+
+/**
+ * Define the data types for vectors of 4 and 8 double-type values (using the GCC vector extension, 
+ * so that the same templated code compiles to AVX2 instructions inside of functions whose target is AVX2 
+ * and to AVX-512 instructions inside of functions whose target is AVX-512).
+ */
+typedef double Double4 __attribute__((vector_size(32)));
+typedef double Double8 __attribute__((vector_size(64)));
+
+/**
+ * Define one struct-type variable per function in the list displayed by selectFunctionFromListOfFunctions.
+ * Each struct evaluates its function in an inline member function (rather than through std::function) 
+ * so that the compiler can inline (and vectorize) that function inside of the loop of a templated kernel.
+ * (The vectorized version of each function is the evaluateVector overload for that struct, which is defined after main.)
+ */
+struct SquareIntegrand { double operator()(double x) const { return x * x; } }; // f(x) = x^2
+struct CubeIntegrand { double operator()(double x) const { return x * x * x; } }; // f(x) = x^3
+struct SineIntegrand { double operator()(double x) const { return std::sin(x); } }; // f(x) = sin(x)
+struct CosineIntegrand { double operator()(double x) const { return std::cos(x); } }; // f(x) = cos(x)
+struct SquareRootIntegrand { double operator()(double x) const { return std::sqrt(x); } }; // f(x) = sqrt(x)
+struct LinearIntegrand { double operator()(double x) const { return 2 * x + 3; } }; // f(x) = 2x + 3
+
+/**
+ * Define one struct-type variable per function which can be integrated over a box (a d-dimensional rectangle). 
+ * Each function of the point (x1, ..., xd) is finish(combine(...combine(combine(start(), x1), x2)..., xd)), 
+ * so one templated batch evaluator serves every dimension d. 
+ * (The vectorized version of combine and finish for each struct is the combineVector and finishVector overload for that struct, which is defined after main.)
+ */
+struct SumOfSquaresBoxIntegrand { // f(x1, ..., xd) = x1^2 + ... + xd^2
+    double start() const { return 0.0; }
+    double combine(double sum, double x) const { return sum + x * x; }
+    double finish(double sum) const { return sum; }
+};
+struct ProductOfCosinesBoxIntegrand { // f(x1, ..., xd) = cos(x1) * ... * cos(xd)
+    double start() const { return 1.0; }
+    double combine(double product, double x) const { return product * std::cos(x); }
+    double finish(double product) const { return product; }
+};
+struct SineOfSumBoxIntegrand { // f(x1, ..., xd) = sin(x1 + ... + xd)
+    double start() const { return 0.0; }
+    double combine(double sum, double x) const { return sum + x; }
+    double finish(double sum) const { return std::sin(sum); }
+};
+
+/**
+ * Define a struct-type variable named DoubleDouble which stores the unevaluated sum high + low of two doubles with |low| <= ulp(high) / 2 
+ * (about 32 significant digits, as fast as a handful of double operations per operation), and its vector counterpart DoubleDoubleVector 
+ * (whose lanes are independent double-double values, so that the AVX2 and AVX-512 kernels evaluate 4 or 8 of them at once).
+ */
+struct DoubleDouble {
+    double high;
+    double low;
+};
+
+template <typename Vector> struct DoubleDoubleVector {
+    Vector high;
+    Vector low;
+};
+
+// Define the data type for a pointer to a function which returns the double-double total height of the rectangles of partitions first through last - 1 (the height of partition i is measured at a + (i + offset) * dx).
+using DoubleDoubleKernel = DoubleDouble (*)(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last);
+
+/**
+ * Define an enumerated type named ExpressionOperation whose values are the operations of a user-defined function f(x): 
+ * the leaves of a parsed expression (Constant and Variable, which is x), the arithmetic operators, 
+ * Square and Cube (which replace x^2 and x^3 with multiplications), and the functions which an expression may call 
+ * (each of which takes one argument, except Power, which is both the ^ operator and pow(a,b)).
+ */
+enum class ExpressionOperation { Constant, Variable, Add, Subtract, Multiply, Divide, Power, Negate, Square, Cube, SquareRoot, AbsoluteValue, Floor, Ceiling, 
+    Exponential, Logarithm, Logarithm10, Sine, Cosine, Tangent, ArcSine, ArcCosine, ArcTangent, HyperbolicSine, HyperbolicCosine, HyperbolicTangent };
+
+/**
+ * Define a struct-type variable named ExpressionNode which stores one node of a parsed expression: 
+ * its operation, its value (if operation is Constant), and the indices of its operands in the vector of nodes (or -1 for a missing operand).
+ */
+struct ExpressionNode {
+    ExpressionOperation operation;
+    double value;
+    int left;
+    int right;
+};
+
+/**
+ * Define a struct-type variable named ExpressionInstruction which stores one instruction of a compiled expression: 
+ * registers[destination] = operation(registers[left], registers[right]) for each of the (up to EXPRESSION_BATCH_SIZE) x values of a batch 
+ * (where right is ignored by the operations which take one operand).
+ */
+struct ExpressionInstruction {
+    ExpressionOperation operation;
+    int destination;
+    int left;
+    int right;
+};
+
+/**
+ * Define a struct-type variable named ExpressionProgram which stores a compiled user-defined function f(x): 
+ * the text which it was compiled from, its constants, its instructions, the number of registers which it uses, 
+ * the register which holds f(x) after the last instruction (result), and a number which identifies this compilation (identifier, which is 0 if nothing was compiled). 
+ * 
+ * Register 0 holds the batch of x values, registers 1 through constants.size() hold the constants 
+ * (which are stored in every thread's registers once per compilation rather than once per batch), and the remaining registers hold intermediate values.
+ */
+struct ExpressionProgram {
+    std::string text;
+    std::vector<double> constants;
+    std::vector<ExpressionInstruction> instructions;
+    int registerCount;
+    int result;
+    uint64_t identifier;
+};
+
+/**
+ * Define the compiled user-defined function f(x) (option USER_DEFINED_FUNCTION_OPTION in the list displayed by selectFunctionFromListOfFunctions). 
+ * It is a global variable because the kernels and batch evaluators are plain function pointers (so that they can be stored in the same tables as the built-in functions) 
+ * and hence cannot carry a program with them. It is only written before a computation starts and is only read by the threads of that computation.
+ */
+ExpressionProgram userDefinedExpression = { "", {}, {}, 0, 0, 0 };
+
+/**
+ * Define the data type for a pointer to a function which returns the total height of the rectangles 
+ * of partitions first through last - 1 of [a,b] (where each partition has length dx).
+ */
+using RiemannKernel = double (*)(double a, double dx, uint64_t first, uint64_t last);
+
+// Define the data type for a pointer to a function which stores f(x[i]) in y[i] for each i in [0, count).
+using BatchEvaluator = void (*)(const double * x, double * y, uint64_t count);
+
+// Define the data type for a pointer to a function which stores f(coordinates[0][i], ..., coordinates[dimension - 1][i]) in y[i] for each i in [0, count).
+using BoxEvaluator = void (*)(const double * const * coordinates, int dimension, double * y, uint64_t count);
+
+/**
+ * Define a struct-type variable named ThreadPool which stores a fixed set of worker threads 
+ * (started by startThreadPool and stopped by stopThreadPool) and the job which they are currently working on. 
+ * A job is a task (a function of one index) and a number of indices; runOnThreadPool hands out the indices 0, 1, 2, ... 
+ * to whichever thread (including the calling thread) is free next and returns after every index was processed. 
+ * The parallel computations of this program share one pool which lives for the whole run of the program (see acquireThreadPool), 
+ * so its threads are started once (and again only when a different number of threads is requested) instead of once per computation.
+ */
+struct ThreadPool {
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable wake; // notified when a new job is posted (or when the pool is stopping)
+    std::condition_variable finished; // notified when the last worker finishes the current job
+    std::function<void(uint64_t)> task;
+    std::atomic<uint64_t> nextIndex{0};
+    uint64_t taskCount = 0;
+    uint64_t generation = 0; // number of jobs posted so far
+    int activeWorkers = 0; // number of workers which have not yet finished the current job
+    bool stopping = false;
+};
+
+// Define a struct-type variable named SharedThreadPool which stores the thread pool which acquireThreadPool shares (and which stops its threads when the program exits).
+struct SharedThreadPool {
+    ThreadPool pool;
+    ~SharedThreadPool();
+};
+
+/**
+ * Define a struct-type variable named ReductionTree which adds a sequence of partial sums in a fixed pairwise tree 
+ * (the tree of a binary counter: each new value is added to the equal-sized subtree to its left whenever one exists). 
+ * The shape of the tree depends only on how many values are added, so adding the same values in the same order 
+ * always produces the same bits (no matter how many threads computed those values or in which order they finished).
+ * 
+ * If compensated is true, the rounding error of every addition in the tree (and the error term of every value) is added to error, 
+ * which is added to the total once at the end (so a compensated accumulator stays compensated across blocks).
+ */
+struct ReductionTree {
+    std::vector<double> levels; // levels[k] stores the sum of a subtree of 2^k values (if occupied[k] is true)
+    std::vector<bool> occupied;
+    bool compensated = false;
+    double error = 0.0;
+};
+
+/**
+ * Define a struct-type variable named Polynomial which stores f(x) = coefficients[0] + coefficients[1] * x + ... + coefficients[degree] * x^degree 
+ * (where isPolynomial is false, and the other members are meaningless, if f is not a polynomial of degree at most MAXIMUM_POLYNOMIAL_DEGREE). 
+ * A value-initialized Polynomial (i.e. Polynomial()) represents "not a polynomial".
+ */
+struct Polynomial {
+    bool isPolynomial;
+    int degree;
+    double coefficients[MAXIMUM_POLYNOMIAL_DEGREE + 1];
+};
+
+/**
+ * Define a struct-type variable named ResultCacheKey which identifies one result of the quiet path of computeRiemannSum: 
+ * the identity of the integrand (see integrandIdentity), the interval [a,b], the number of partitions n, the rule (and order, if rule is GaussLegendre), 
+ * the accumulator, and the instruction set of the kernel which computed the result (whose results differ in their last bits, so none is served to another). 
+ * Every member is part of the canonical hash, so two keys are equal exactly if their bytes are equal.
+ */
+struct ResultCacheKey {
+    uint64_t integrand;
+    double a;
+    double b;
+    uint64_t n;
+    int32_t rule;
+    int32_t order;
+    int32_t accumulator;
+    int32_t instructionSet;
+};
+
+// Define a struct-type variable named ResultCacheEntry which stores one result (value) of the result cache in memory together with its key.
+struct ResultCacheEntry {
+    ResultCacheKey key;
+    double value;
+};
+
+/**
+ * Define a struct-type variable named ResultCacheSlot which stores one result in the file of the result cache, 
+ * where stamp is the value of the file's stamp counter when the slot was last used (or 0 if the slot is empty).
+ */
+struct ResultCacheSlot {
+    ResultCacheKey key;
+    double value;
+    uint64_t stamp;
+};
+
+// Define a struct-type variable named ResultCacheFileHeader which is stored at the start of the file of the result cache (followed by its slots).
+struct ResultCacheFileHeader {
+    char magic[8];
+    uint64_t slotCount;
+    uint64_t stamp;
+    uint64_t reserved[5];
+};
+
+/**
+ * Define a struct-type variable named ResultCache which stores the results of the quiet path of computeRiemannSum, keyed by ResultCacheKey. 
+ * 
+ * Up to capacity results are kept in memory (entries, most recently used first), and the least recently used one is evicted when another one is stored. 
+ * If a file was opened (see openResultCacheFile), every result is also stored in that memory-mapped file, whose slots form sets of RESULT_CACHE_FILE_WAYS slots: 
+ * a key may only be stored in the set which its hash selects, and the least recently used slot of that set is replaced when the set is full. 
+ * 
+ * starts indexes every key in memory or in the file by the hash of everything but its right end and number of partitions (see hashResultCacheStart), 
+ * so that findComposedResult finds the results of the intervals which start where it needs one without scanning every result. 
+ * 
+ * hits counts the lookups which found their key, composedHits counts the lookups which added the results of adjacent intervals (see findComposedResult), 
+ * misses counts the other lookups, and evictions counts the results which were replaced in memory or in the file.
+ */
+struct ResultCache {
+    std::list<ResultCacheEntry> entries;
+    std::unordered_map<uint64_t, std::list<ResultCacheEntry>::iterator> index; // the entry of each hash (see hashResultCacheKey)
+    std::unordered_multimap<uint64_t, ResultCacheKey> starts; // the key of every result in memory or in the file, by the hash of its start (see hashResultCacheStart)
+    size_t capacity = RESULT_CACHE_CAPACITY;
+    uint64_t hits = 0;
+    uint64_t composedHits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    ResultCacheFileHeader * header = nullptr; // the start of the mapped file (or a null pointer if no file is open)
+    ResultCacheSlot * slots = nullptr;
+    size_t mappedBytes = 0;
+    std::mutex mutex;
+};
+
+/**
+ * Define a struct-type variable named PhaseTimings which stores the wall time and the CPU time spent in each phase of the Riemann pipeline (in nanoseconds, indexed by Phase). 
+ * The evaluation and accumulation of the blocks are timed by whichever thread sums each block (with that thread's own CPU clock), 
+ * so for those phases both times are totals over every thread (thread-seconds), while the input and output phases run on one thread. 
+ * The members are atomic so that every thread of the pool can add its times without a lock.
+ */
+struct PhaseTimings {
+    std::atomic<uint64_t> wallNanoseconds[NUMBER_OF_PHASES] = {};
+    std::atomic<uint64_t> cpuNanoseconds[NUMBER_OF_PHASES] = {};
+    std::atomic<uint64_t> evaluations{0}; // the number of points at which f was evaluated
+};
+
+// Define a struct-type variable named PhaseStamp which stores the wall clock and the CPU clock of the calling thread at the start of a phase (in nanoseconds, see startPhase).
+struct PhaseStamp {
+    uint64_t wall;
+    uint64_t cpu;
+};
+
+/**
+ * Define a struct-type variable named RiemannEngine which stores how the quiet path of computeRiemannSum sums the rectangles: 
+ * the compiled kernel (used by the Naive accumulator), the batch evaluator (used by every other accumulator to store the heights of a block of rectangles), 
+ * the accumulator, the number of threads, the polynomial f(x) (if f is one, see polynomialOfFunction), 
+ * and the result cache in which the quiet path looks up and stores its results (together with the identity of f in that cache).
+ */
+struct RiemannEngine {
+    RiemannKernel kernel;
+    BatchEvaluator evaluator;
+    Accumulator accumulator;
+    int threadCount;
+    Rule rule;
+    int order; // the number of nodes per partition (used only if rule is GaussLegendre)
+    Polynomial polynomial; // the coefficients of f if f is a polynomial (in which case the quiet path computes the sum in closed form instead of evaluating f)
+    ResultCache * cache; // the result cache (or a null pointer if results are not cached)
+    uint64_t integrand; // the identity of f in the result cache (see integrandIdentity)
+    PhaseTimings * timings = nullptr; // the times of the evaluation and accumulation phases (or a null pointer if they are not measured)
+    InstructionSet instructionSet = InstructionSet::Scalar; // the instruction set of kernel and evaluator (which is part of the key of each cached result)
+};
+
+/**
+ * Define a struct-type variable named GaussLegendreTables which stores the nodes (in ascending order) and the weights 
+ * of the Gauss-Legendre rules on [-1,1] of every order from MINIMUM_GAUSS_LEGENDRE_ORDER to MAXIMUM_GAUSS_LEGENDRE_ORDER 
+ * (where nodes[m][k] and weights[m][k] are the kth node and weight of the rule of order m). 
+ * The single instance of this struct, gaussLegendreTables, is computed at compile time (see makeGaussLegendreTables).
+ */
+struct GaussLegendreTables {
+    double nodes[MAXIMUM_GAUSS_LEGENDRE_ORDER + 1][MAXIMUM_GAUSS_LEGENDRE_ORDER];
+    double weights[MAXIMUM_GAUSS_LEGENDRE_ORDER + 1][MAXIMUM_GAUSS_LEGENDRE_ORDER];
+};
+
+/**
+ * Define a struct-type variable named DoubleDoubleTaylorTables which stores the double-double reciprocals 1 / ((2k)(2k + 1)) (sine[k]) and 1 / ((2k - 1)(2k)) (cosine[k]) 
+ * of the Horner form of the Taylor series of sine and cosine, for k from 1 to DOUBLE_DOUBLE_TAYLOR_TERMS 
+ * (so that each term costs a double-double multiplication instead of a double-double division). 
+ * The single instance of this struct, doubleDoubleTaylorTables, is computed at compile time (see makeDoubleDoubleTaylorTables).
+ */
+struct DoubleDoubleTaylorTables {
+    DoubleDouble sine[DOUBLE_DOUBLE_TAYLOR_TERMS + 1];
+    DoubleDouble cosine[DOUBLE_DOUBLE_TAYLOR_TERMS + 1];
+};
+
+/**
+ * Define a struct-type variable named Subinterval which stores one subinterval [a,b] of adaptive quadrature, 
+ * the Kronrod estimate of the integral over that subinterval (estimate), and the estimated error of that estimate (error). 
+ * Subintervals are ordered by error (so the std::priority_queue of subintervals returns the subinterval with the largest error first).
+ */
+struct Subinterval {
+    double a;
+    double b;
+    double estimate;
+    double error;
+    bool operator<(const Subinterval & other) const { return error < other.error; }
+};
+
+/**
+ * Define a struct-type variable named AdaptiveResult which stores the result of adaptive quadrature: 
+ * the estimate of the integral, the error bound of that estimate (the sum of the estimated errors of the subintervals), 
+ * the number of function evaluations, the number of subintervals, 
+ * and whether the error bound met the tolerance (converged is false if the subinterval limit or the floating-point resolution was reached first).
+ */
+struct AdaptiveResult {
+    double estimate;
+    double errorBound;
+    uint64_t evaluations;
+    uint64_t subintervals;
+    bool converged;
+};
+
+/**
+ * Define a struct-type variable named RombergResult which stores the result of Romberg integration: 
+ * the most extrapolated value of the last row of the Romberg tableau (estimate), the difference between that value and the previous row's (difference), 
+ * the number of function evaluations, the number of partitions of the last trapezoid rule (n), 
+ * and whether the difference met the tolerance (converged is false if ROMBERG_MAXIMUM_LEVELS rows were computed first).
+ */
+struct RombergResult {
+    double estimate;
+    double difference;
+    uint64_t evaluations;
+    uint64_t n;
+    bool converged;
+};
+
+/**
+ * Define a struct-type variable named AllRulesEstimates which stores the estimates which the "all" method computes from one pass over the end-points 
+ * and one pass over the middle points of the n partitions of [a,b]: 
+ * the left, right, midpoint, and trapezoid sums, the Simpson rule on the 2n half-partitions (which uses the same points), 
+ * the spread (the largest minus the smallest of the left, right, midpoint, and trapezoid sums), and the number of function evaluations.
+ */
+struct AllRulesEstimates {
+    double left;
+    double right;
+    double midpoint;
+    double trapezoid;
+    double simpson;
+    double spread;
+    uint64_t evaluations;
+};
+
+/**
+ * Define a struct-type variable named IntegrationBatch which stores many integration jobs in structure-of-arrays form: 
+ * job k integrates the function whose option number is function[k] over [a[k],b[k]] with n[k] partitions and rule[k] (and order[k], if rule[k] is GaussLegendre), 
+ * and computeBatch stores its result in result[k] (or NAN if the job is invalid). Every array has one element per job.
+ */
+struct IntegrationBatch {
+    std::vector<double> a;
+    std::vector<double> b;
+    std::vector<uint64_t> n;
+    std::vector<int> function;
+    std::vector<Rule> rule;
+    std::vector<int> order;
+    std::vector<double> result;
+};
+
+/**
+ * Define a struct-type variable named BatchTask which stores the jobs which one thread computes together: 
+ * jobs[first] through jobs[last - 1] of the grouped job order (which all have the same function, rule, and order).
+ */
+struct BatchTask {
+    size_t first;
+    size_t last;
+};
+
+/**
+ * Define a struct-type variable named BatchSegment which stores a run of consecutive points of one job in the evaluation buffer of sumBatchJobs: 
+ * points first through first + count - 1 of jobs[job] (in the order of pointOfRule) are stored in the buffer starting at start.
+ */
+struct BatchSegment {
+    size_t job;
+    int start;
+    int count;
+    uint64_t first;
+};
+
+/**
+ * Define an enumerated type named Sampling whose values are the ways in which Monte Carlo integration chooses its sample points: 
+ * Pseudorandom (independent uniform points from the counter-based Philox4x32-10 generator) 
+ * and Halton (the points of the Halton sequence with a random digit scrambling, i.e. quasi-Monte Carlo).
+ */
+enum class Sampling { Pseudorandom, Halton };
+
+/**
+ * Define a struct-type variable named RunningVariance which stores the number, the mean, and the sum of squared deviations from the mean (m2) 
+ * of a sequence of values, updated one value at a time (Welford) or by merging the statistics of another sequence (Chan et al.).
+ */
+struct RunningVariance {
+    uint64_t count;
+    double mean;
+    double m2;
+};
+
+/**
+ * Define a struct-type variable named MonteCarloResult which stores the estimate of a Monte Carlo integral, its standard error, 
+ * the number of evaluations of f, and whether the standard error reached the target before the maximum number of samples was used.
+ */
+struct MonteCarloResult {
+    double estimate;
+    double standardError;
+    uint64_t samples;
+    bool converged;
+};
+
+/**
+ * Define the enumerated types which describe a sample file: Binary files store 8-byte doubles (in the byte order of this processor) and CSV files store one sample per line, 
+ * and each sample is either a Pair (x and then y) or a Value (y only, at x = x0 + i * dx for the ith sample).
+ */
+enum class SampleFormat { Binary, Csv };
+enum class SampleLayout { Pairs, Values };
+
+/**
+ * Define a struct-type variable named SampleFile which stores a sample file which is mapped into memory (read only) 
+ * together with its format and layout (and x0 and dx, which are used only if layout is Values).
+ */
+struct SampleFile {
+    const char * data;
+    size_t size;
+    SampleFormat format;
+    SampleLayout layout;
+    double x0;
+    double dx;
+};
+
+/**
+ * Define a struct-type variable named SampleSummary which stores what the rules for sampled data need to know about a run of consecutive samples (x_i, y_i): 
+ * the number of samples, the first and last samples, 
+ * the left, right, and trapezoid sums over the intervals between the samples (each with the error term of its Neumaier summation), 
+ * the y of the second and second-to-last samples and the first and last intervals (which the midpoint panels which cross from one run to the next need), 
+ * the midpoint sums over the panels of two intervals [x_i, x_i+2] which lie inside the run (midpoint[p] if the index of the first sample of the run in the file has parity p, 
+ * since a run of a chunk does not know how many samples precede it), 
+ * whether x increased from every sample to the next, and the number of lines of a CSV file which were skipped because they were not samples (e.g. a header).
+ */
+struct SampleSummary {
+    uint64_t count;
+    uint64_t skippedLines;
+    double firstX;
+    double firstY;
+    double lastX;
+    double lastY;
+    double left;
+    double leftError;
+    double right;
+    double rightError;
+    double trapezoid;
+    double trapezoidError;
+    double secondY;
+    double firstInterval;
+    double penultimateY;
+    double lastInterval;
+    double midpoint[2];
+    double midpointError[2];
+    bool increasing;
+};
+
+/**
+ * Define a struct-type variable named CumulativeIntegral which stores the running integral F(x_i) of f from a to x_i = a + i * dx for i = 0 through n 
+ * in values (an array of n + 1 doubles which is either storage or, if mappedBytes is not 0, a file which is mapped into memory), 
+ * so that the integral over [x_i, x_j] is values[j] - values[i] (see cumulativeIntegralBetween).
+ */
+struct CumulativeIntegral {
+    double * values;
+    uint64_t n;
+    double a;
+    double dx;
+    size_t mappedBytes;
+    std::vector<double> storage;
+};
+
+/**
+ * Define a struct-type variable named Box which stores the region [a[0],b[0]] x ... x [a[dimension - 1],b[dimension - 1]] 
+ * and the number of partitions n[k] of each axis k (only the first dimension elements of each array are used).
+ */
+struct Box {
+    int dimension;
+    double a[MAXIMUM_BOX_DIMENSION];
+    double b[MAXIMUM_BOX_DIMENSION];
+    uint64_t n[MAXIMUM_BOX_DIMENSION];
+};
+
+/**
+ * Define a struct-type variable named BoxRow which stores a run of consecutive grid points of one tile of a box (which differ only along axis 0): 
+ * points first through first + count - 1 of axis 0 (with the other coordinates fixed) are stored in the tile buffer starting at start, 
+ * and weight is the product of the weights of the fixed coordinates.
+ */
+struct BoxRow {
+    int start;
+    int count;
+    uint64_t first;
+    double weight;
 };
 
 /** function prototypes */
-double computeRiemannSum(Function func, double a, double b, int n, const std::string& method, std::ofstream & file);
-Function selectFunctionFromListOfFunctions(std::ofstream & file);
+double computeRiemannSum(Function func, double a, double b, uint64_t n, const std::string& method, const TraceSettings & trace, const RiemannEngine & engine, std::ofstream & file);
+AllRulesEstimates computeAllRules(const RiemannEngine & endpointEngine, const RiemannEngine & midpointEngine, double a, double b, uint64_t n);
+double printAllRules(int functionOption, double a, double b, uint64_t n, const RiemannEngine & engine, InstructionSet instructionSet, std::ofstream & file);
+void reportProgress(uint64_t completed, uint64_t n, double seconds, std::ofstream & file);
+PhaseStamp startPhase();
+void stopPhase(PhaseTimings * timings, Phase phase, const PhaseStamp & start);
+double processCpuSeconds();
+std::string nameOfPhase(Phase phase);
+void printPhaseTimings(const PhaseTimings & timings, const RiemannEngine & engine, double computeSeconds, double computeCpuSeconds, uint64_t n, std::ofstream & file);
+template <typename Integrand, Rule rule> double sumRectangleHeights(double a, double dx, uint64_t first, uint64_t last);
+Rule ruleFromMethod(const std::string & method);
+int gaussLegendreOrderFromMethod(const std::string & method);
+bool methodIsRecognized(const std::string & method);
+double offsetOfRule(Rule rule);
+double interiorWeightOfRule(Rule rule, uint64_t i);
+double scaleOfRule(Rule rule);
+double endpointCorrectionOfRule(Rule rule);
+uint64_t numberOfPointsOfRule(Rule rule, int order, uint64_t n);
+void pointOfRule(Rule rule, int order, double a, double dx, uint64_t n, uint64_t j, double & x, double & weight);
+double sumWeightedPoints(Function func, double a, double dx, uint64_t n, Rule rule, int order, const TraceSettings & trace, std::ofstream & file);
+double computeQuadrature(const RiemannEngine & engine, double a, double b, uint64_t n, bool showProgress, std::ofstream & file);
+double sumGaussLegendrePanels(const RiemannEngine & engine, double a, double dx, uint64_t first, uint64_t last, double & error);
+double exactIntegral(int functionOption, double a, double b);
+Polynomial polynomialOfFunction(int functionOption);
+Polynomial polynomialOfExpression(const ExpressionProgram & program);
+Polynomial multiplyPolynomials(const Polynomial & left, const Polynomial & right);
+double evaluatePolynomialDerivative(const Polynomial & polynomial, int order, double x);
+double closedFormRiemannSum(const Polynomial & polynomial, double a, double b, uint64_t n, double offset);
+double closedFormQuadrature(const Polynomial & polynomial, double a, double b, uint64_t n, Rule rule, int order);
+AllRulesEstimates closedFormAllRules(const Polynomial & polynomial, double a, double b, uint64_t n);
+uint64_t integrandIdentity(int functionOption);
+ResultCacheKey makeResultCacheKey(uint64_t integrand, double a, double b, uint64_t n, Rule rule, int order, Accumulator accumulator, InstructionSet instructionSet);
+uint64_t hashBytes(const void * bytes, size_t size, uint64_t hash);
+uint64_t hashResultCacheKey(const ResultCacheKey & key);
+uint64_t hashResultCacheStart(const ResultCacheKey & key);
+void addResultCacheStart(ResultCache & cache, const ResultCacheKey & key);
+void removeResultCacheStart(ResultCache & cache, const ResultCacheKey & key);
+bool resultIsInFile(const ResultCache & cache, const ResultCacheKey & key);
+bool openResultCacheFile(ResultCache & cache, const std::string & path);
+void closeResultCacheFile(ResultCache & cache);
+bool lookUpResult(ResultCache & cache, const ResultCacheKey & key, double & value);
+bool findExactResult(ResultCache & cache, const ResultCacheKey & key, double & value);
+bool findComposedResult(ResultCache & cache, const ResultCacheKey & key, double & value, int pieces);
+void storeResult(ResultCache & cache, const ResultCacheKey & key, double value);
+void storeResultInMemory(ResultCache & cache, const ResultCacheKey & key, double value);
+void storeResultInFile(ResultCache & cache, const ResultCacheKey & key, double value);
+void printResultCacheCounters(const ResultCache & cache, std::ofstream & file);
+bool addBatchJob(IntegrationBatch & batch, int function, const std::string & method, double a, double b, uint64_t n);
+bool batchJobIsValid(const IntegrationBatch & batch, size_t job);
+std::string methodOfRule(Rule rule, int order);
+uint64_t computeBatch(IntegrationBatch & batch, int threadCount, InstructionSet instructionSet, size_t & groupCount);
+void sumBatchJobs(IntegrationBatch & batch, const size_t * jobs, size_t count, BatchEvaluator evaluator);
+bool loadBatchJobs(const std::string & path, IntegrationBatch & batch, std::string & error);
+BoxEvaluator selectBoxEvaluator(int functionOption, InstructionSet instructionSet);
+template <typename BoxIntegrand> void evaluateBoxBatch(const double * const * coordinates, int dimension, double * y, uint64_t count);
+template <typename BoxIntegrand> __attribute__((target("avx2,fma"))) void evaluateBoxBatchAvx2(const double * const * coordinates, int dimension, double * y, uint64_t count);
+template <typename BoxIntegrand> __attribute__((target("avx512f,avx2,fma"))) void evaluateBoxBatchAvx512(const double * const * coordinates, int dimension, double * y, uint64_t count);
+std::string nameOfBoxFunction(int functionOption);
+bool boxIsValid(const Box & box, Rule rule, int order);
+uint64_t numberOfPointsOfBox(const Box & box, Rule rule, int order);
+double computeBoxIntegral(BoxEvaluator evaluator, const Box & box, Rule rule, int order, int threadCount);
+double sumBoxTile(BoxEvaluator evaluator, const Box & box, const std::vector<std::vector<double>> & axisPoints, const std::vector<std::vector<double>> & axisWeights, uint64_t first, uint64_t last);
+double exactBoxIntegral(int functionOption, const Box & box);
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4]);
+double uniformFromBits(uint64_t bits);
+void addToRunningVariance(RunningVariance & statistics, double value);
+void mergeRunningVariance(RunningVariance & statistics, const RunningVariance & other);
+void storeRandomPointsOfBox(const Box & box, uint64_t seed, uint64_t first, uint64_t count, double * const * coordinates);
+void storeHaltonPointsOfBox(const Box & box, const std::vector<uint32_t> & shifts, const std::vector<double> & tails, uint64_t first, uint64_t count, double * const * coordinates);
+template <uint64_t base> void storeScrambledRadicalInverses(const uint32_t * shift, const double * tail, uint64_t first, uint64_t count, double a, double width, double * coordinates);
+void makeHaltonScrambling(const Box & box, uint64_t seed, int replicate, std::vector<uint32_t> & shifts, std::vector<double> & tails);
+int haltonDigitCount(int base);
+MonteCarloResult computeMonteCarloIntegral(BoxEvaluator evaluator, const Box & box, Sampling sampling, uint64_t seed, double targetError, uint64_t maximumSamples, int threadCount);
+RunningVariance sampleMonteCarloBlock(BoxEvaluator evaluator, const Box & box, Sampling sampling, uint64_t seed, const std::vector<uint32_t> & shifts, const std::vector<double> & tails, uint64_t first);
+bool openSampleFile(const std::string & path, SampleFile & file, std::string & error);
+void closeSampleFile(SampleFile & file);
+void addSampleToSummary(SampleSummary & summary, double x, double y, double interval);
+void mergeSampleSummaries(SampleSummary & summary, const SampleSummary & next, const SampleFile & file);
+bool parseSampleLine(const char * begin, const char * end, SampleLayout layout, double & x, double & y);
+SampleSummary summarizeSampleChunk(const SampleFile & file, uint64_t chunk);
+SampleSummary integrateSampleFile(const SampleFile & file, int threadCount);
+double sampleRuleEstimate(const SampleSummary & summary, int rule);
+bool writeSampleFile(const std::string & path, SampleFormat format, SampleLayout layout, int functionOption, double a, double b, uint64_t count, uint64_t seed);
+bool allocateCumulativeIntegral(CumulativeIntegral & integral, double a, double b, uint64_t n, const std::string & path);
+void releaseCumulativeIntegral(CumulativeIntegral & integral);
+void computeCumulativeIntegral(CumulativeIntegral & integral, BatchEvaluator evaluator, Rule rule, int order, int threadCount);
+double scanCumulativeBlock(CumulativeIntegral & integral, BatchEvaluator evaluator, Rule rule, int order, uint64_t first, uint64_t last);
+double cumulativeIntegralBetween(const CumulativeIntegral & integral, uint64_t i, uint64_t j);
+DoubleDouble twoSum(double a, double b);
+DoubleDouble quickTwoSum(double a, double b);
+DoubleDouble twoProduct(double a, double b);
+DoubleDouble negateDoubleDouble(DoubleDouble x);
+DoubleDouble addDoubleDouble(DoubleDouble x, DoubleDouble y);
+DoubleDouble multiplyDoubleDouble(DoubleDouble x, DoubleDouble y);
+DoubleDouble multiplyDoubleDoubleByDouble(DoubleDouble x, double d);
+DoubleDouble divideDoubleDoubleByDouble(DoubleDouble x, double d);
+DoubleDouble squareRootDoubleDouble(DoubleDouble x);
+DoubleDouble sineOfQuadrantDoubleDouble(DoubleDouble x, int quadrantShift);
+DoubleDouble evaluateDoubleDouble(SquareIntegrand, DoubleDouble x);
+DoubleDouble evaluateDoubleDouble(CubeIntegrand, DoubleDouble x);
+DoubleDouble evaluateDoubleDouble(SineIntegrand, DoubleDouble x);
+DoubleDouble evaluateDoubleDouble(CosineIntegrand, DoubleDouble x);
+DoubleDouble evaluateDoubleDouble(SquareRootIntegrand, DoubleDouble x);
+DoubleDouble evaluateDoubleDouble(LinearIntegrand, DoubleDouble x);
+template <typename Integrand> DoubleDouble sumDoubleDoubleHeights(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last);
+template <typename Integrand> __attribute__((target("fma"), flatten)) DoubleDouble sumDoubleDoubleHeightsFma(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last);
+template <typename Integrand> __attribute__((target("avx2,fma"))) DoubleDouble sumDoubleDoubleHeightsAvx2(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last);
+template <typename Integrand> __attribute__((target("avx512f,avx2,fma"))) DoubleDouble sumDoubleDoubleHeightsAvx512(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last);
+DoubleDoubleKernel selectDoubleDoubleKernel(int functionOption, InstructionSet instructionSet);
+std::string doubleDoubleToString(DoubleDouble x, int digits);
+__float128 evaluateFloat128(int functionOption, __float128 x);
+__float128 sineOfQuadrantFloat128(__float128 x, int quadrantShift);
+DoubleDouble sumInFloat128(int functionOption, double a, double b, uint64_t n, double offset);
+long double evaluateLongDouble(int functionOption, long double x);
+DoubleDouble sumInLongDouble(int functionOption, double a, double b, uint64_t n, double offset);
+bool compileExpression(const std::string & text, ExpressionProgram & program, std::string & error, size_t & errorPosition);
+int addExpressionNode(std::vector<ExpressionNode> & nodes, ExpressionOperation operation, double value, int left, int right);
+void skipExpressionSpaces(const std::string & text, size_t & position);
+int parseExpressionSum(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error);
+int parseExpressionProduct(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error);
+int parseExpressionUnary(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error);
+int parseExpressionPower(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error);
+int parseExpressionPrimary(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error);
+void collectExpressionConstants(const std::vector<ExpressionNode> & nodes, int index, ExpressionProgram & program);
+int emitExpressionNode(const std::vector<ExpressionNode> & nodes, int index, ExpressionProgram & program, std::vector<int> & freeRegisters, std::string & error);
+double applyExpressionOperation(ExpressionOperation operation, double left, double right);
+void applyExpressionOperationToBatch(ExpressionOperation operation, const double * left, const double * right, double * destination, int count);
+std::string nameOfExpressionOperation(ExpressionOperation operation);
+void printExpressionProgram(const ExpressionProgram & program, std::ofstream & file);
+double * loadExpressionRegisters(const ExpressionProgram & program);
+void evaluateExpressionBatch(const double * x, double * y, uint64_t count);
+__attribute__((target("avx2,fma"))) void evaluateExpressionBatchAvx2(const double * x, double * y, uint64_t count);
+__attribute__((target("avx512f,avx2,fma"))) void evaluateExpressionBatchAvx512(const double * x, double * y, uint64_t count);
+template <BatchEvaluator evaluator, Rule rule> double sumExpressionHeights(double a, double dx, uint64_t first, uint64_t last);
+template <Rule rule> __attribute__((target("avx2,fma"))) double sumExpressionHeightsAvx2(double a, double dx, uint64_t first, uint64_t last);
+template <Rule rule> __attribute__((target("avx512f,avx2,fma"))) double sumExpressionHeightsAvx512(double a, double dx, uint64_t first, uint64_t last);
+RiemannKernel selectExpressionKernel(Rule rule, InstructionSet instructionSet);
+uint64_t evaluationsToTolerance(const RiemannEngine & engine, double a, double b, double exact, double tolerance, double & error, uint64_t & n);
+Subinterval evaluateGaussKronrod(BatchEvaluator evaluator, double a, double b);
+AdaptiveResult computeAdaptiveQuadrature(BatchEvaluator evaluator, double a, double b, double absoluteTolerance, double relativeTolerance, int threadCount);
+double computeAdaptiveIntegral(int functionOption, const Parameters & parameters, std::ofstream & file);
+RombergResult computeRombergIntegral(const RiemannEngine & engine, double a, double b, double absoluteTolerance, double relativeTolerance, bool showTableau, std::ofstream & file);
+template <typename Integrand, Rule rule> __attribute__((target("avx2,fma"))) double sumRectangleHeightsAvx2(double a, double dx, uint64_t first, uint64_t last);
+template <typename Integrand, Rule rule> __attribute__((target("avx512f,avx2,fma"))) double sumRectangleHeightsAvx512(double a, double dx, uint64_t first, uint64_t last);
+template <typename Integrand> void evaluateBatch(const double * x, double * y, uint64_t count);
+template <typename Integrand> __attribute__((target("avx2,fma"))) void evaluateBatchAvx2(const double * x, double * y, uint64_t count);
+template <typename Integrand> __attribute__((target("avx512f,avx2,fma"))) void evaluateBatchAvx512(const double * x, double * y, uint64_t count);
+InstructionSet detectInstructionSet();
+std::string nameOfInstructionSet(InstructionSet instructionSet);
+RiemannKernel selectRiemannKernel(int functionOption, Rule rule, InstructionSet instructionSet);
+template <typename Integrand> RiemannKernel selectRiemannKernelForIntegrand(Rule rule, InstructionSet instructionSet);
+BatchEvaluator selectBatchEvaluator(int functionOption, InstructionSet instructionSet);
+void startThreadPool(ThreadPool & pool, int threadCount);
+void runOnThreadPool(ThreadPool & pool, uint64_t taskCount, const std::function<void(uint64_t)> & task);
+void processThreadPoolTasks(ThreadPool & pool);
+void runThreadPoolWorker(ThreadPool & pool, uint64_t finishedGeneration);
+void stopThreadPool(ThreadPool & pool);
+ThreadPool & acquireThreadPool(int threadCount);
+void addToReductionTree(ReductionTree & tree, double value, double error);
+double finishReductionTree(const ReductionTree & tree);
+double sumRectangleHeightsInParallel(const RiemannEngine & engine, double a, double dx, uint64_t n, bool showProgress, std::ofstream & file);
+double sumRectangleHeightsWithAccumulator(const RiemannEngine & engine, double a, double dx, uint64_t first, uint64_t last, double & error);
+double sumValues(Accumulator accumulator, const double * values, uint64_t count, double & error);
+double sumNaive(const double * values, uint64_t count, double & error);
+double sumKahan(const double * values, uint64_t count, double & error);
+void addNeumaier(double & sum, double & error, double value);
+double sumNeumaier(const double * values, uint64_t count, double & error);
+double sumPairwise(const double * values, uint64_t count, double & error);
+double sumCompensated(const double * values, uint64_t count, double & error);
+__attribute__((target("avx2,fma"))) double sumCompensatedAvx2(const double * values, uint64_t count, double & error);
+__attribute__((target("avx512f,avx2,fma"))) double sumCompensatedAvx512(const double * values, uint64_t count, double & error);
+double sumInLongDouble(const double * values, uint64_t count, double & error);
+std::string nameOfAccumulator(Accumulator accumulator);
+int runCommandLineMode(int argc, char * argv[]);
+std::map<std::string, std::string> parseCommandLineOptions(int argc, char * argv[], int firstIndex);
+int runSimdAccuracyReport();
+int runScalingReport(const std::map<std::string, std::string> & options);
+int runAccumulatorReport(const std::map<std::string, std::string> & options);
+int runRuleReport(const std::map<std::string, std::string> & options);
+int runAdaptiveReport(const std::map<std::string, std::string> & options);
+int runRombergReport(const std::map<std::string, std::string> & options);
+int runExpressionReport(const std::map<std::string, std::string> & options);
+int runClosedFormReport(const std::map<std::string, std::string> & options);
+int runCacheReport(const std::map<std::string, std::string> & options);
+int runBatchMode(const std::map<std::string, std::string> & options);
+int runBoxReport(const std::map<std::string, std::string> & options);
+int runMonteCarloReport(const std::map<std::string, std::string> & options);
+int runSampleMode(const std::map<std::string, std::string> & options);
+int runSampleRuleCheck();
+int runCumulativeReport(const std::map<std::string, std::string> & options);
+int runPrecisionReport(const std::map<std::string, std::string> & options);
+int runBenchmarkSuite(const std::map<std::string, std::string> & options);
+Function selectFunctionFromListOfFunctions(std::ofstream & file, int & option);
 Parameters selectPartitioningValues(std::ofstream & file);
 std::string selectRectangleConstructionMethod(std::ofstream & file);
+TraceSettings selectTraceLevel(std::ofstream & file);
+Accumulator selectAccumulator(std::ofstream & file);
 
 /** program entry point */
-int main() {
+int main(int argc, char * argv[]) {
+
+    /**
+     * If the program was launched with command line arguments (e.g. "./app --simd-accuracy"), 
+     * run the corresponding non-interactive mode instead of the interactive program and exit with that mode's exit status.
+     */
+    if (argc > 1) return runCommandLineMode(argc, argv);
+
+    /**
+     * Start timing the input phase of the Riemann pipeline (the prompts and the preparation of the engine), 
+     * whose time (and the times of the other phases) is printed at the end of the program.
+     */
+    PhaseTimings timings;
+    PhaseStamp phase = startPhase();
 
     // Declare a file output stream object.
     std::ofstream file;
@@ -76,9 +944,11 @@ int main() {
 
     /**
      * Prompt the user to select one of multiple single-variable functions from a list.
-     * Store the selected function in a Function type variable named func.
+     * Store the selected function in a Function type variable named func 
+     * and store the option number of that function in an int type variable named functionOption.
      */
-    Function func = selectFunctionFromListOfFunctions(file);
+    int functionOption = 0;
+    Function func = selectFunctionFromListOfFunctions(file, functionOption);
 
     // Print a horizontal dividing line to the command line terminal.
     std::cout << "\n\n--------------------------------";
@@ -98,13 +968,33 @@ int main() {
     // Print a horizontal dividing line to the file output stream.
     file << "\n\n--------------------------------";
 
+    /**
+     * If the user entered zero for n, compute the integral with adaptive quadrature (which chooses its own partitions, 
+     * so no rectangle construction method, trace level, or accumulator is selected), print the result, and exit the program.
+     */
+    if (parameters.n == 0)
+    {
+        double estimate = computeAdaptiveIntegral(functionOption, parameters, file);
+        std::cout << "\n\nThe integral obtained by this program runtime instance is " << estimate << ".";
+        file << "\n\nThe integral obtained by this program runtime instance is " << estimate << ".";
+        std::cout << "\n\n--------------------------------";
+        std::cout << "\nEnd Of Program";
+        std::cout << "\n--------------------------------\n\n";
+        file << "\n\n--------------------------------";
+        file << "\nEnd Of Program";
+        file << "\n--------------------------------";
+        file.close();
+        return 0;
+    }
+
     /**
      * Prompt the user to select a partitioning method by which to
      * construct n rectangles whose heights are where the x-value in f(x) 
      * is either the left end-points,
      * the right end-points, 
      * or the middle points of the n equally-sized
-     * partitions of x-axis interval, [a,b].
+     * partitions of x-axis interval, [a,b] 
+     * (or a higher-order quadrature rule: trapezoid, Simpson, Boole, or Gauss-Legendre).
      */
     std::string method = selectRectangleConstructionMethod(file);
 
@@ -114,12 +1004,101 @@ int main() {
     // Print a horizontal dividing line to the file output stream.
     file << "\n\n--------------------------------";
 
-    // Compute the Riemann sum.
-    double sum = computeRiemannSum(func, parameters.a, parameters.b, parameters.n, method, file);
+    /**
+     * Prompt the user to select how much of the computation to print:
+     * nothing (fastest), every k-th rectangle, or every step of every rectangle 
+     * (unless the "all" method was selected, which is never traced because it prints only the estimates of the rules which it computes together).
+     */
+    TraceSettings trace = { "none", 1 };
+    if (method != "all")
+    {
+        trace = selectTraceLevel(file);
+
+        // Print a horizontal dividing line to the command line terminal.
+        std::cout << "\n\n--------------------------------";
+
+        // Print a horizontal dividing line to the file output stream.
+        file << "\n\n--------------------------------";
+    }
+
+    /**
+     * If nothing is printed while the rectangles are being summed, prompt the user to select how the heights of the rectangles are added 
+     * (the traced paths always add the areas one at a time, as printed), 
+     * unless f is a polynomial, whose sum is then computed in closed form (without adding any heights).
+     */
+    Polynomial polynomial = polynomialOfFunction(functionOption);
+    Accumulator accumulator = Accumulator::Naive;
+    if ((trace.level == "none") && !polynomial.isPolynomial)
+    {
+        accumulator = selectAccumulator(file);
+        std::cout << "\n\n--------------------------------";
+        file << "\n\n--------------------------------";
+    }
+
+    /**
+     * Look up the compiled kernel which is specialized for the selected function and rectangle construction method 
+     * and for the widest instruction set which this processor supports 
+     * (which computeRiemannSum uses instead of func when nothing is printed inside of its loop).
+     */
+    InstructionSet instructionSet = detectInstructionSet();
+    RiemannEngine engine;
+    engine.kernel = selectRiemannKernel(functionOption, ruleFromMethod(method), instructionSet);
+    engine.evaluator = selectBatchEvaluator(functionOption, instructionSet);
+    engine.accumulator = accumulator;
+    engine.rule = ruleFromMethod(method);
+    engine.order = gaussLegendreOrderFromMethod(method);
+    engine.threadCount = (int) std::thread::hardware_concurrency();
+    if (engine.threadCount < 1) engine.threadCount = 1;
+    engine.polynomial = polynomial;
+    engine.instructionSet = instructionSet;
+    if ((trace.level == "none") && !engine.polynomial.isPolynomial)
+    {
+        std::cout << "\n\nThe rectangles are summed using " << nameOfInstructionSet(instructionSet) << " instructions on " << engine.threadCount << " thread(s) with the " << nameOfAccumulator(accumulator) << " accumulator.";
+        file << "\n\nThe rectangles are summed using " << nameOfInstructionSet(instructionSet) << " instructions on " << engine.threadCount << " thread(s) with the " << nameOfAccumulator(accumulator) << " accumulator.";
+    }
+
+    /**
+     * Open the result cache (whose results are also stored in the file named reimann_sum_cache.bin, so that they are reused by later runtime instances of this program), 
+     * in which the quiet path of computeRiemannSum looks up its result before summing any rectangles.
+     */
+    ResultCache cache;
+    engine.cache = &cache;
+    engine.integrand = integrandIdentity(functionOption);
+    if (!openResultCacheFile(cache, RESULT_CACHE_FILE_NAME))
+    {
+        std::cout << "\n\nThe file named " << RESULT_CACHE_FILE_NAME << " could not be opened, so results are only cached in memory.";
+        file << "\n\nThe file named " << RESULT_CACHE_FILE_NAME << " could not be opened, so results are only cached in memory.";
+    }
+
+    // Stop timing the input phase, and measure the evaluation and accumulation of every block of rectangles.
+    stopPhase(&timings, Phase::Input, phase);
+    engine.timings = &timings;
+    auto computeStart = std::chrono::steady_clock::now();
+    double computeCpuStart = processCpuSeconds();
+
+    // Compute the Riemann sum (or, if the "all" method was selected, every rule which shares the end-points and middle points of the partitions).
+    double sum = (method == "all") ? printAllRules(functionOption, parameters.a, parameters.b, parameters.n, engine, instructionSet, file) : computeRiemannSum(func, parameters.a, parameters.b, parameters.n, method, trace, engine, file);
+
+    /**
+     * Measure the whole computation (which also includes any printing of a traced computation, whose evaluations are counted here 
+     * because the traced path evaluates f outside of the measured blocks).
+     */
+    double computeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - computeStart).count();
+    double computeCpuSeconds = processCpuSeconds() - computeCpuStart;
+    if (trace.level != "none") timings.evaluations += numberOfPointsOfRule(ruleFromMethod(method), gaussLegendreOrderFromMethod(method), parameters.n);
+    phase = startPhase();
 
     // Print the result of the above function execution to the command line terminal and to the output file stream.
     std::cout << "\n\nThe Reimann Sum obtained by this program runtime instance is " << sum << ".";
 
+    // Print the counters of the result cache to the command line terminal and to the output file stream, and close the file of the result cache.
+    if (trace.level == "none") printResultCacheCounters(cache, file);
+    closeResultCacheFile(cache);
+
+    // Print the time of each phase of the pipeline (the output phase ends before this report is printed).
+    stopPhase(&timings, Phase::Output, phase);
+    printPhaseTimings(timings, engine, computeSeconds, computeCpuSeconds, parameters.n, file);
+
     // Print a closing message to the command line terminal.
     std::cout << "\n\n--------------------------------";
     std::cout << "\nEnd Of Program";
@@ -145,11 +1124,35 @@ int main() {
  * the left end point, 
  * right end point, 
  * or middle point of that rectangle's respective x-axis partition.
+ * 
+ * trace determines how much of the computation is printed to the command line terminal and to the output file stream. 
+ * If trace.level is "none", each x-axis point is evaluated exactly once and nothing is printed inside of the loop 
+ * (so that the loop is limited only by how quickly func can be evaluated).
+ * 
+ * n may be as large as MAXIMUM_n. Each x-axis point is computed directly as a + (i + offset) * dx 
+ * (where i is a 64-bit partition index which converts to double exactly for every i up to 2^53), 
+ * so no rounding error accumulates from one partition to the next. 
+ * The rectangles are summed in blocks of PROGRESS_BLOCK_SIZE rectangles (using no memory which grows with n), 
+ * each block's partial sum is added to the total, and the progress and throughput are printed 
+ * at most once per PROGRESS_REPORT_SECONDS seconds.
+ * 
+ * method may also name a higher-order quadrature rule ("trapezoid", "simpson", "boole", or "gauss-legendre-m" where m is 2 through 64), 
+ * in which case the weighted function values of that rule are added instead of rectangle areas (see sumWeightedPoints and computeQuadrature).
+ * 
+ * If engine.kernel is not a null pointer, the quiet path sums blocks of PARALLEL_BLOCK_SIZE rectangles on engine.threadCount threads 
+ * (with engine.kernel, a compiled loop specialized for func and method, or with engine.evaluator and engine.accumulator), 
+ * adds the block sums in a fixed pairwise order (so the result is identical for every threadCount), 
+ * and prints the measured cost per rectangle of the selected accumulator. 
+ * 
+ * If engine.polynomial is a polynomial (e.g. f(x) = x^2, x^3, 2x + 3, or a user-defined polynomial), the quiet path instead computes the sum 
+ * in closed form (see closedFormQuadrature), which takes the same time for every n and evaluates f at no point. 
+ * 
+ * If engine.cache is not a null pointer, the quiet path first looks up its result in that cache (see lookUpResult) and stores every result which it computes there.
  */
-double computeRiemannSum(Function func, double a, double b, int n, const std::string& method, std::ofstream & file) {
+double computeRiemannSum(Function func, double a, double b, uint64_t n, const std::string& method, const TraceSettings & trace, const RiemannEngine & engine, std::ofstream & file) {
 
-    // Initialize sum, dx, and x to each store the value zero.
-    double sum = 0.0, dx = 0.0, x = 0.0;
+    // Initialize sum, dx, x, y, and offset to each store the value zero.
+    double sum = 0.0, dx = 0.0, x = 0.0, y = 0.0, offset = 0.0;
 
     /**
      * Print an error message to the console window (and output file) if
@@ -178,13 +1181,45 @@ double computeRiemannSum(Function func, double a, double b, int n, const std::st
 
     /**
      * Print an error message to the console window (and output file) if
-     * n is smaller than one (or larger than MAXIMUM_a)
+     * n is smaller than MINIMUM_n (or larger than MAXIMUM_n)
      * and exit the function by returning zero.
      */
-    if ((n < 1) || (n > MAXIMUM_a))
+    if ((n < MINIMUM_n) || (n > MAXIMUM_n))
+    {
+        std::cout << "\n\nInvalid partition number. n is required to represent a natural number no larger than " << MAXIMUM_n << ".";
+        file << "\n\nInvalid partition number. n is required to represent a natural number no larger than " << MAXIMUM_n << ".";
+        return 0.0;
+    }
+
+    /**
+     * Print an error message to the console window (and output file) if 
+     * method is not either 'left', 'right', 'midpoint', 'trapezoid', 'simpson', 'boole', or 'gauss-legendre-m' (where m is 2 through 64)
+     * and exit the function by returning the value 0.0.
+     */
+    if (!methodIsRecognized(method))
+    {
+        std::cout << "\n\nInvalid method. Use 'left', 'right', 'midpoint', 'trapezoid', 'simpson', 'boole', or 'gauss-legendre-m' (where m is " << MINIMUM_GAUSS_LEGENDRE_ORDER << " through " << MAXIMUM_GAUSS_LEGENDRE_ORDER << ").";
+        file << "\n\nInvalid method. Use 'left', 'right', 'midpoint', 'trapezoid', 'simpson', 'boole', or 'gauss-legendre-m' (where m is " << MINIMUM_GAUSS_LEGENDRE_ORDER << " through " << MAXIMUM_GAUSS_LEGENDRE_ORDER << ").";
+        return 0.0;
+    }
+
+    /**
+     * Set offset to represent where inside of each partition the height of each rectangle is measured
+     * (0 for the left end-point, 1 for the right end-point, and 0.5 for the middle point) 
+     * so that x = a + (i + offset) * dx for the ith partition of [a,b].
+     */
+    Rule rule = ruleFromMethod(method);
+    offset = offsetOfRule(rule);
+
+    /**
+     * Print an error message to the console window (and output file) if 
+     * the Simpson rule was selected and n is odd (or if the Boole rule was selected and n is not a multiple of 4)
+     * and exit the function by returning the value 0.0.
+     */
+    if (((rule == Rule::Simpson) && (n % 2 != 0)) || ((rule == Rule::Boole) && (n % 4 != 0)))
     {
-        std::cout << "Invalid partition number. n is required to represent a natural number no larger than.";
-        file << "Invalid partition number. n is required to represent a natural number no larger than.";
+        std::cout << "\n\nInvalid partition number. n is required to be a multiple of " << ((rule == Rule::Simpson) ? 2 : 4) << " for the " << method << " rule.";
+        file << "\n\nInvalid partition number. n is required to be a multiple of " << ((rule == Rule::Simpson) ? 2 : 4) << " for the " << method << " rule.";
         return 0.0;
     }
 
@@ -195,69 +1230,136 @@ double computeRiemannSum(Function func, double a, double b, int n, const std::st
     std::cout << "\n\ndx = (b - a) / n = (" << b << " - " << a << ") / " << n << " = " << dx << ". // the length of each of the n equally-sized partitions of x-axis interval, [a,b]";
     file << "\n\ndx = (b - a) / n = (" << b << " - " << a << ") / " << n << " = " << dx << ". // the length of each of the n equally-sized partitions of x-axis interval, [a,b]";
    
-    // Print a horizontal divider line to the command line terminal and to the file output stream.
-    std::cout << "\n\n~~~~~~~~~~~~~~";
-    file << "\n\n~~~~~~~~~~~~~~";
+    /**
+     * If nothing is to be printed and f is a polynomial, compute the sum of the n rectangles in closed form 
+     * (see closedFormQuadrature), which takes the same time for every n and evaluates f at no point.
+     */
+    if ((trace.level == "none") && engine.polynomial.isPolynomial)
+    {
+        auto start = std::chrono::steady_clock::now();
+        sum = closedFormQuadrature(engine.polynomial, a, b, n, rule, gaussLegendreOrderFromMethod(method));
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::streamsize coutPrecision = std::cout.precision(6), filePrecision = file.precision(6);
+        std::cout << "\n\nf(x) is a polynomial of degree " << engine.polynomial.degree << ", so the sum of the " << n << " rectangles was computed in closed form in " << seconds << " seconds (without evaluating f).";
+        file << "\n\nf(x) is a polynomial of degree " << engine.polynomial.degree << ", so the sum of the " << n << " rectangles was computed in closed form in " << seconds << " seconds (without evaluating f).";
+        std::cout.precision(coutPrecision);
+        file.precision(filePrecision);
+        return sum;
+    }
 
     /**
-     * For each one of the n equally-sized partitions of the x-axis,
-     * compute the approximate area of the region bounded by y = f(x) = func,
-     * the x-axis, and the vertical lines which intersect with the endpoints (or mid points)
-     * of the respective x-axis partition.
-     *
-     * Then add that area (which is the area of some rectangle) to sum.
+     * Otherwise, if nothing is to be printed, add the heights of the n rectangles without any output 
+     * (evaluating func exactly once per rectangle) and multiply their total by dx 
+     * (which is the same as adding the n rectangle areas because each rectangle has width dx).
      */
-    for (int i = 0; i < n; ++i) 
+    if ((trace.level == "none") && ((engine.kernel != nullptr) || ((rule == Rule::GaussLegendre) && (engine.evaluator != nullptr))))
     {
+        ResultCacheKey key = makeResultCacheKey(engine.integrand, a, b, n, rule, engine.order, engine.accumulator, engine.instructionSet);
+        if ((engine.cache != nullptr) && lookUpResult(*engine.cache, key, sum))
+        {
+            std::cout << "\n\nThe result was found in the result cache (so no rectangles were summed).";
+            file << "\n\nThe result was found in the result cache (so no rectangles were summed).";
+            return sum;
+        }
+        auto start = std::chrono::steady_clock::now();
+        sum = computeQuadrature(engine, a, b, n, true, file);
+        if (engine.cache != nullptr) storeResult(*engine.cache, key, sum);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::streamsize coutPrecision = std::cout.precision(6), filePrecision = file.precision(6);
+        std::cout << "\n\nThe " << nameOfAccumulator(engine.accumulator) << " accumulator summed " << n << " rectangles in " << seconds << " seconds (" << (1e9 * seconds / (double) n) << " nanoseconds per rectangle, including the function evaluations).";
+        file << "\n\nThe " << nameOfAccumulator(engine.accumulator) << " accumulator summed " << n << " rectangles in " << seconds << " seconds (" << (1e9 * seconds / (double) n) << " nanoseconds per rectangle, including the function evaluations).";
+        std::cout.precision(coutPrecision);
+        file.precision(filePrecision);
+        return sum;
+    }
+
+    // The higher-order rules (which evaluate f at points other than one per partition) are summed (and traced) by sumWeightedPoints.
+    if ((rule != Rule::Left) && (rule != Rule::Right) && (rule != Rule::Midpoint)) return sumWeightedPoints(func, a, dx, n, rule, gaussLegendreOrderFromMethod(method), trace, file);
+    if (trace.level == "none")
+    {
+        auto start = std::chrono::steady_clock::now(), lastReport = start;
+        for (uint64_t first = 0; first < n; first += PROGRESS_BLOCK_SIZE)
+        {
+            uint64_t last = ((n - first) < PROGRESS_BLOCK_SIZE) ? n : (first + PROGRESS_BLOCK_SIZE);
+            double blockSum = 0.0;
+            for (uint64_t i = first; i < last; ++i) blockSum += func(a + ((double) i + offset) * dx);
+            sum += blockSum;
+
+            // Print the progress if at least PROGRESS_REPORT_SECONDS seconds passed since the previous report.
+            auto now = std::chrono::steady_clock::now();
+            if (std::chrono::duration<double>(now - lastReport).count() >= PROGRESS_REPORT_SECONDS)
+            {
+                reportProgress(last, n, std::chrono::duration<double>(now - start).count(), file);
+                lastReport = now;
+            }
+        }
+
+        // Print the final throughput if any progress was reported (i.e. if the computation took long enough to be worth measuring).
+        if (lastReport != start) reportProgress(n, n, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), file);
+        return sum * dx;
+    }
+
+    // Print a horizontal divider line to the command line terminal and to the file output stream.
+    std::cout << "\n\n~~~~~~~~~~~~~~";
+    file << "\n\n~~~~~~~~~~~~~~";
+
+    /**
+     * For each one of the n equally-sized partitions of the x-axis,
+     * compute the approximate area of the region bounded by y = f(x) = func,
+     * the x-axis, and the vertical lines which intersect with the endpoints (or mid points)
+     * of the respective x-axis partition.
+     *
+     * Then add that area (which is the area of some rectangle) to sum.
+     */
+    for (uint64_t i = 0; i < n; ++i) 
+    {
+        // Determine the x-axis point of the ith partition of [a,b] which sets the height of the ith rectangle and evaluate func at that point (once).
+        x = a + ((double) i + offset) * dx;
+        y = func(x);
+
+        // Add the area of the current rectangle to the running total sum.
+        sum += y * dx; 
+
+        /**
+         * If trace.level is "sampled", print one line for every trace.interval-th rectangle (and for the last rectangle) 
+         * to the command line terminal and to the output file stream.
+         */
+        if (trace.level == "sampled")
+        {
+            if ((i % (uint64_t) trace.interval == 0) || (i == n - 1))
+            {
+                std::cout << "\n\ni = " << i << ", x = " << x << ", f(x) = " << y << ", sum = " << sum << ".";
+                file << "\n\ni = " << i << ", x = " << x << ", f(x) = " << y << ", sum = " << sum << ".";
+            }
+            continue;
+        }
+
         // Print the value of i to the command line terminal and to the output file stream.
         std::cout << "\n\ni = " << i << ". // current iteration of the for loop (of " << n << " iterations)";
         file << "\n\ni = " << i << ". // current iteration of the for loop (of " << n << " iterations)";
 
         if (method == "left") 
         {
-            // Determine the left end-point of the ith partition of [a,b].
-            x = a + i * dx;
-
-            // Print the value of x and the above equation to the command line terminal and to the output file stream.
+            // Print the value of x and the equation which determined the left end-point of the ith partition of [a,b] to the command line terminal and to the output file stream.
             std::cout << "\n\nx = a + i * dx = " << a << " + " << i << " * " << dx << " = " << x << ". // the left end-point of the ith partition of [a,b].";
             file << "\n\nx = a + i * dx = " << a << " + " << i << " * " << dx << " = " << x << ". // the left end-point of the ith partition of [a,b].";
         } 
         else if (method == "right") 
         {
-            // Determine the right end-point of the ith partition of [a,b].
-            x = a + (i + 1) * dx;
-
-            // Print the value of x and the above equation to the command line terminal and to the output file stream.
+            // Print the value of x and the equation which determined the right end-point of the ith partition of [a,b] to the command line terminal and to the output file stream.
             std::cout << "\n\nx = a + (i + 1) * dx = " << a << " + (" << i << " + 1) * " << dx << " = " << x << ". // the right end-point of the ith partition of [a,b].";
             file << "\n\nx = a + (i + 1) * dx = " << a << " + (" << i << " + 1) * " << dx << " = " << x << ". // the right end-point of the ith partition of [a,b].";
         } 
-        else if (method == "midpoint") 
+        else 
         {
-            // Determine the middle point of the ith partition of [a,b].
-        	x = a + (i + 0.5) * dx;
-
-            // Print the value of x and the above equation to the command line terminal and to the output file stream.
+            // Print the value of x and the equation which determined the middle point of the ith partition of [a,b] to the command line terminal and to the output file stream.
             std::cout << "\n\nx = a + (i + 0.5) * dx = " << a << " + (" << i << " + 0.5) * " << dx << " = " << x << ". // the middle point of the ith partition of [a,b].";
             file << "\n\nx = a + (i + 0.5) * dx = " << a << " + (" << i << " + 0.5) * " << dx << " = " << x << ". // the middle point of the ith partition of [a,b].";
         }
 
-        /**
-         * Print an error message to the console window if 
-         * method is not either 'left', 'right', or 'midpoint'
-         * and exit the function by returning the value 0.0.
-         */
-        else 
-        {
-            std::cout << "\n\nInvalid method. Use 'left', 'right', or 'midpoint'.";
-            return 0.0;
-        }
-
-        // Add the area of the current rectangle to the running total sum.
-        sum += func(x) * dx; 
-
-        // Print the right-hand value of the above equation to the command line terminal and to the output file stream.
-        std::cout << "\n\nrectangle_area_x = func(x) * dx = " << func(x) << " * " << dx << " = " << (func(x) * dx) << ". // area of the ith rectangle";
-        file << "\n\nrectangle_area_x = func(x) * dx = " << func(x) << " * " << dx << " = " << (func(x) * dx) << ". // area of the ith rectangle";
+        // Print the area of the current rectangle (using the stored value of func(x) rather than evaluating func again) to the command line terminal and to the output file stream.
+        std::cout << "\n\nrectangle_area_x = func(x) * dx = " << y << " * " << dx << " = " << (y * dx) << ". // area of the ith rectangle";
+        file << "\n\nrectangle_area_x = func(x) * dx = " << y << " * " << dx << " = " << (y * dx) << ". // area of the ith rectangle";
 
         // Print the running total obtained by adding the area of the ith rectangle to the value stored in the variable named sum to the command line terminal and to the output file stream.
         std::cout << "\n\nsum += rectangle_x; // Add rectangle_x to sum and store the result in sum (in the C++ program).";
@@ -274,6 +1376,82 @@ double computeRiemannSum(Function func, double a, double b, int n, const std::st
     return sum;
 }
 
+/**
+ * This function returns the left, right, midpoint, and trapezoid sums of f over the n partitions of [a,b] 
+ * (and the Simpson rule on the 2n half-partitions of [a,b]) from 2n + 1 evaluations of f, where f is the function which both engines evaluate.
+ * 
+ * The left and right sums share the n - 1 interior end-points a + i * dx (i = 1 through n - 1), 
+ * which are evaluated once with endpointEngine (whose rule must be Right, so that the right end-points of the first n - 1 partitions are exactly those points). 
+ * f(a) and f(b) are evaluated once with endpointEngine.evaluator, and the n middle points are evaluated once with midpointEngine (whose rule must be Midpoint). 
+ * The trapezoid sum is the mean of the left and right sums, and the Simpson rule on the 2n half-partitions is (trapezoid + 2 * midpoint) / 3.
+ */
+AllRulesEstimates computeAllRules(const RiemannEngine & endpointEngine, const RiemannEngine & midpointEngine, double a, double b, uint64_t n)
+{
+    std::ofstream noFile;
+    double dx = (b - a) / n;
+    double ends[2] = { a, a + (double) n * dx };
+    double interior = sumRectangleHeightsInParallel(endpointEngine, a, dx, n - 1, false, noFile);
+    double middle = sumRectangleHeightsInParallel(midpointEngine, a, dx, n, false, noFile);
+    endpointEngine.evaluator(ends, ends, 2);
+    AllRulesEstimates estimates;
+    estimates.left = dx * (ends[0] + interior);
+    estimates.right = dx * (interior + ends[1]);
+    estimates.midpoint = dx * middle;
+    estimates.trapezoid = 0.5 * (estimates.left + estimates.right);
+    estimates.simpson = (estimates.trapezoid + 2.0 * estimates.midpoint) / 3.0;
+    estimates.spread = std::fmax(std::fmax(estimates.left, estimates.right), std::fmax(estimates.midpoint, estimates.trapezoid)) 
+                     - std::fmin(std::fmin(estimates.left, estimates.right), std::fmin(estimates.midpoint, estimates.trapezoid));
+    estimates.evaluations = 2 * n + 1;
+    return estimates;
+}
+
+/**
+ * This function computes every estimate of computeAllRules for the function whose option number is functionOption over the n partitions of [a,b] 
+ * (using the compiled right end-point and midpoint kernels for instructionSet and the accumulator and threads of engine), 
+ * prints those estimates, their spread, the bracket [min(midpoint, trapezoid), max(midpoint, trapezoid)] 
+ * (which contains the integral whenever the second derivative of f does not change sign on [a,b]), and the number of function evaluations 
+ * to the command line terminal and to the output file stream, and returns the Simpson estimate (which is the most accurate of them for a smooth f). 
+ * If engine.polynomial is a polynomial, the same estimates are computed in closed form instead (see closedFormAllRules).
+ */
+double printAllRules(int functionOption, double a, double b, uint64_t n, const RiemannEngine & engine, InstructionSet instructionSet, std::ofstream & file)
+{
+    RiemannEngine endpointEngine = engine, midpointEngine = engine;
+    endpointEngine.rule = Rule::Right;
+    endpointEngine.kernel = selectRiemannKernel(functionOption, Rule::Right, instructionSet);
+    midpointEngine.rule = Rule::Midpoint;
+    midpointEngine.kernel = selectRiemannKernel(functionOption, Rule::Midpoint, instructionSet);
+    if (!engine.polynomial.isPolynomial && ((endpointEngine.kernel == nullptr) || (midpointEngine.kernel == nullptr) || (engine.evaluator == nullptr)))
+    {
+        std::cout << "\n\nThe \"all\" method requires a compiled kernel for the selected function.";
+        file << "\n\nThe \"all\" method requires a compiled kernel for the selected function.";
+        return 0.0;
+    }
+    auto start = std::chrono::steady_clock::now();
+    AllRulesEstimates estimates = engine.polynomial.isPolynomial ? closedFormAllRules(engine.polynomial, a, b, n) : computeAllRules(endpointEngine, midpointEngine, a, b, n);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double lower = std::fmin(estimates.midpoint, estimates.trapezoid), upper = std::fmax(estimates.midpoint, estimates.trapezoid);
+    std::cout << "\n\nleft = " << estimates.left << ".";
+    std::cout << "\n\nright = " << estimates.right << ".";
+    std::cout << "\n\nmidpoint = " << estimates.midpoint << ".";
+    std::cout << "\n\ntrapezoid = (left + right) / 2 = " << estimates.trapezoid << ".";
+    std::cout << "\n\nsimpson = (trapezoid + 2 * midpoint) / 3 = " << estimates.simpson << ". // the Simpson rule on the 2n half-partitions of [a,b]";
+    std::cout << "\n\nspread = " << estimates.spread << ". // the largest minus the smallest of the left, right, midpoint, and trapezoid sums";
+    std::cout << "\n\nThe integral is within [" << lower << ", " << upper << "] if the second derivative of f does not change sign on [a,b].";
+    file << "\n\nleft = " << estimates.left << ".";
+    file << "\n\nright = " << estimates.right << ".";
+    file << "\n\nmidpoint = " << estimates.midpoint << ".";
+    file << "\n\ntrapezoid = (left + right) / 2 = " << estimates.trapezoid << ".";
+    file << "\n\nsimpson = (trapezoid + 2 * midpoint) / 3 = " << estimates.simpson << ". // the Simpson rule on the 2n half-partitions of [a,b]";
+    file << "\n\nspread = " << estimates.spread << ". // the largest minus the smallest of the left, right, midpoint, and trapezoid sums";
+    file << "\n\nThe integral is within [" << lower << ", " << upper << "] if the second derivative of f does not change sign on [a,b].";
+    std::streamsize coutPrecision = std::cout.precision(6), filePrecision = file.precision(6);
+    std::cout << "\n\nThe estimates were computed from " << estimates.evaluations << " function evaluations (instead of " << (3 * n) << " for three separate left, right, and midpoint sums) in " << seconds << " seconds.";
+    file << "\n\nThe estimates were computed from " << estimates.evaluations << " function evaluations (instead of " << (3 * n) << " for three separate left, right, and midpoint sums) in " << seconds << " seconds.";
+    std::cout.precision(coutPrecision);
+    file.precision(filePrecision);
+    return estimates.simpson;
+}
+
 /**
  * This function displays a list of single-variable algebraic functions
  * on the command line terminal and in the output file stream and
@@ -281,9 +1459,9 @@ double computeRiemannSum(Function func, double a, double b, int n, const std::st
  * with exactly one of the aforementioned functions. 
  * 
  * After the user enters some value, the corresponding Function type
- * object is returned.
+ * object is returned (and the option number of that function is stored in option).
  */
-Function selectFunctionFromListOfFunctions(std::ofstream & file)
+Function selectFunctionFromListOfFunctions(std::ofstream & file, int & option)
 {
     // example function: f(x) = x^2
     Function func_0 = [](double x) { return x * x; };
@@ -303,8 +1481,11 @@ Function selectFunctionFromListOfFunctions(std::ofstream & file)
     // example function: f(x) = 2x + 3
     Function func_5 = [](double x) { return 2 * x + 3; };
 
+    // user-defined function: f(x) = the expression which the user enters (evaluated by the compiled program of that expression)
+    Function func_6 = [](double x) { double y = 0.0; evaluateExpressionBatch(&x, &y, 1); return y; };
+
     // Initialize option to represent 0 (which is the associated with the first function in the above list).
-    int option = 0;
+    option = 0;
 
     // Print menu options and the instruction to input an option number to the command line terminal.
     std::cout << "\n\nEnter the number which corresponds with one of the following functions:";
@@ -314,6 +1495,7 @@ Function selectFunctionFromListOfFunctions(std::ofstream & file)
     std::cout << "\n\n3 --> f(x) = cos(x)";
     std::cout << "\n\n4 --> f(x) = sqrt(x)";
     std::cout << "\n\n5 --> f(x) = 2x + 3";
+    std::cout << "\n\n6 --> f(x) = an expression which you enter (e.g. x^2 * sin(x) + exp(-x / 2))";
     std::cout << "\n\nEnter Option Here: ";
 
     // Print menu options and the instruction to input an option number to the file output stream.
@@ -324,6 +1506,7 @@ Function selectFunctionFromListOfFunctions(std::ofstream & file)
     file << "\n\n3 --> f(x) = cos(x)";
     file << "\n\n4 --> f(x) = sqrt(x)";
     file << "\n\n5 --> f(x) = 2x + 3";
+    file << "\n\n6 --> f(x) = an expression which you enter (e.g. x^2 * sin(x) + exp(-x / 2))";
     file << "\n\nEnter Option Here: ";
 
     /**
@@ -339,10 +1522,10 @@ Function selectFunctionFromListOfFunctions(std::ofstream & file)
     file << "\n\nThe value which was entered for option is " << option << ".";
 
     /**
-     * If option is smaller than 0 or if option is larger than 5, set option to 0
+     * If option is smaller than 0 or if option is larger than 6, set option to 0
      * and print a message stating that fact to the command line terminal and to the output file stream.
      */
-    if ((option < 0) || (option > 5))
+    if ((option < 0) || (option > USER_DEFINED_FUNCTION_OPTION))
     {
         option = 0;
         std::cout << "\n\noption was set to 0 by default due to the fact that the value input by the user was not recognized.";
@@ -389,7 +1572,32 @@ Function selectFunctionFromListOfFunctions(std::ofstream & file)
         file << "\n\nThe single-variable function which was selected from the list of such functions is f(x) = 2x + 3.";
         return func_5;
     }
-    return func_0;
+
+    /**
+     * Prompt the user to input f(x) as an expression, compile that expression (see compileExpression), 
+     * and print the compiled program to the command line terminal and to the output file stream 
+     * (or, if the expression could not be compiled, print the reason and use f(x) = x^2 instead).
+     */
+    std::string text, error;
+    size_t errorPosition = 0;
+    ExpressionProgram program;
+    std::cout << "\n\nEnter f(x) using x, numbers, pi, e, +, -, *, /, ^ (or implicit multiplication, e.g. 2x), parentheses, pow(a,b), and sqrt, abs, floor, ceil, exp, log, log10, sin, cos, tan, asin, acos, atan, sinh, cosh, or tanh: ";
+    file << "\n\nEnter f(x) using x, numbers, pi, e, +, -, *, /, ^ (or implicit multiplication, e.g. 2x), parentheses, pow(a,b), and sqrt, abs, floor, ceil, exp, log, log10, sin, cos, tan, asin, acos, atan, sinh, cosh, or tanh: ";
+    std::getline(std::cin >> std::ws, text);
+    std::cout << "\nThe value which was entered for f(x) is " << text << ".";
+    file << "\n\nThe value which was entered for f(x) is " << text << ".";
+    if (!compileExpression(text, program, error, errorPosition))
+    {
+        option = 0;
+        std::cout << "\n\nThe expression could not be compiled (" << error << " at character " << (errorPosition + 1) << "). Hence f(x) = x^2 is being used by default.";
+        file << "\n\nThe expression could not be compiled (" << error << " at character " << (errorPosition + 1) << "). Hence f(x) = x^2 is being used by default.";
+        return func_0;
+    }
+    userDefinedExpression = program;
+    std::cout << "\n\nThe single-variable function which was selected from the list of such functions is f(x) = " << text << ".";
+    file << "\n\nThe single-variable function which was selected from the list of such functions is f(x) = " << text << ".";
+    printExpressionProgram(userDefinedExpression, file);
+    return func_6;
 }
 
 /**
@@ -401,7 +1609,8 @@ Function selectFunctionFromListOfFunctions(std::ofstream & file)
  * 
  * b represents the right-most point of the aforementioned x-axis partition.
  * 
- * n represents the number of equally-sized partitions to divide the x-axis partition, [a,b], into.
+ * n represents the number of equally-sized partitions to divide the x-axis partition, [a,b], into 
+ * (or zero, in which case the absolute and relative tolerances of adaptive quadrature are input instead).
  * 
  * If an invalid input to this function is detected, then this function will return a Parameters instance with default values as follows:
  * 
@@ -412,11 +1621,14 @@ Parameters selectPartitioningValues(std::ofstream & file)
     // Define two double-type variables for storing values which represent the end points of an x-axis interval.
     double a = 0.0, b = 0.0;
 
-    // Define one int-type variable for storing the number of equally sized partitions to divide the aforementioned x-axis interval into.
-    int n = 1;
+    /**
+     * Define one long long-type variable for storing the number of equally sized partitions to divide the aforementioned x-axis interval into 
+     * (which is signed so that a negative input value is detected rather than wrapping around to a large unsigned value).
+     */
+    long long n = 1;
 
     // Define a read-only default Parameters value to use as a reference to replace invalid user-input values with correct values.
-    const Parameters default_params = { 0.0, 1.0, 10 };
+    const Parameters default_params = { 0.0, 1.0, 10, 0.0, 0.0 };
 
     /*****************************/
     /* Get User Input: a         */
@@ -497,10 +1709,10 @@ Parameters selectPartitioningValues(std::ofstream & file)
     /*****************************/
 
     // Print a message to the command line terminal which prompts the user to input a value to store in the variable named n.
-    std::cout << "\n\nEnter a value to store in int-type variable n (which represents the number of equally-sized partitions to divide x-axis interval [a,b] into): ";
+    std::cout << "\n\nEnter a value to store in uint64_t-type variable n (which represents the number of equally-sized partitions to divide x-axis interval [a,b] into, up to " << MAXIMUM_n << ", or 0 to choose the partitions adaptively for a given tolerance): ";
 
     // Print a message to the output file stream which prompts the user to input a value to store in the variable named n.
-    file << "\n\nEnter a value to store in int-type variable n (which represents the number of equally-sized partitions to divide x-axis interval [a,b] into): ";
+    file << "\n\nEnter a value to store in uint64_t-type variable n (which represents the number of equally-sized partitions to divide x-axis interval [a,b] into, up to " << MAXIMUM_n << ", or 0 to choose the partitions adaptively for a given tolerance): ";
 
     /**
      * Scan the command line terminal for the most recent keyboard input value. 
@@ -516,15 +1728,66 @@ Parameters selectPartitioningValues(std::ofstream & file)
 
     /**
      * Print an error message to the command line terminal and to the output file stream if
-     * n is smaller than one or if
-     * n is larger than MAXIMUM_a
+     * the input was not a number (in which case std::cin stores 0 in n, which must not be mistaken for the adaptive quadrature option)
+     * and return a default Parameters instance.
+     */
+    if (std::cin.fail())
+    {
+        std::cout << "\n\nInvalid partition number. n is required to be a natural number within range [" << MINIMUM_n << "," << MAXIMUM_n << "] (or 0).";
+        std::cout << "\n\nHence, default program values are being used to replace user inputs for the Reimann Sum partitioning parameters.";
+        file << "\n\nInvalid partition number. n is required to be a natural number within range [" << MINIMUM_n << "," << MAXIMUM_n << "] (or 0).";
+        file << "\n\nHence, default program values are being used to replace user inputs for the Reimann Sum partitioning parameters.";
+        return default_params;
+    }
+
+    /**
+     * If n is zero, prompt the user to input the absolute and the relative tolerance of adaptive quadrature (instead of a number of partitions) 
+     * and return a Parameters instance whose n is zero. 
+     * A tolerance which is not positive is never met (so at least one of the two tolerances is required to be positive), 
+     * and a tolerance which is not a number replaces the user inputs with the default Parameters instance.
+     */
+    if (n == 0)
+    {
+        double absoluteTolerance = 0.0, relativeTolerance = 0.0;
+        std::cout << "\n\nEnter a value to store in double-type variable absoluteTolerance (the largest acceptable error bound, or 0 for none): ";
+        file << "\n\nEnter a value to store in double-type variable absoluteTolerance (the largest acceptable error bound, or 0 for none): ";
+        std::cin >> absoluteTolerance;
+        std::cout << "\nThe value which was entered for absoluteTolerance is " << absoluteTolerance << ".";
+        file << "\n\nThe value which was entered for absoluteTolerance is " << absoluteTolerance << ".";
+        std::cout << "\n\nEnter a value to store in double-type variable relativeTolerance (the largest acceptable error bound divided by the magnitude of the integral, or 0 for none): ";
+        file << "\n\nEnter a value to store in double-type variable relativeTolerance (the largest acceptable error bound divided by the magnitude of the integral, or 0 for none): ";
+        std::cin >> relativeTolerance;
+        std::cout << "\nThe value which was entered for relativeTolerance is " << relativeTolerance << ".";
+        file << "\n\nThe value which was entered for relativeTolerance is " << relativeTolerance << ".";
+        if (std::cin.fail())
+        {
+            std::cout << "\n\nInvalid tolerance. Each tolerance is required to be a number.";
+            std::cout << "\n\nHence, default program values are being used to replace user inputs for the Reimann Sum partitioning parameters.";
+            file << "\n\nInvalid tolerance. Each tolerance is required to be a number.";
+            file << "\n\nHence, default program values are being used to replace user inputs for the Reimann Sum partitioning parameters.";
+            return default_params;
+        }
+        if (!(absoluteTolerance > 0.0) && !(relativeTolerance > 0.0))
+        {
+            absoluteTolerance = 1e-10;
+            relativeTolerance = 0.0;
+            std::cout << "\n\nabsoluteTolerance was set to 1e-10 by default due to the fact that neither tolerance which was input by the user was positive.";
+            file << "\n\nabsoluteTolerance was set to 1e-10 by default due to the fact that neither tolerance which was input by the user was positive.";
+        }
+        return {a,b,0,absoluteTolerance,relativeTolerance};
+    }
+
+    /**
+     * Print an error message to the command line terminal and to the output file stream if
+     * n is smaller than MINIMUM_n or if
+     * n is larger than MAXIMUM_n
      * and return a default Parameters instance.
      */
-    if ((n < 1) || (n > MAXIMUM_a))
+    if ((n < (long long) MINIMUM_n) || (n > (long long) MAXIMUM_n))
     {
-        std::cout << "\n\nInvalid partition number. n is required to be a natural number within range [1," << MAXIMUM_a << "].";
+        std::cout << "\n\nInvalid partition number. n is required to be a natural number within range [" << MINIMUM_n << "," << MAXIMUM_n << "].";
         std::cout << "\n\nHence, default program values are being used to replace user inputs for the Reimann Sum partitioning parameters.";
-        file << "\n\nInvalid partition number. n is required to be a natural number within range [1," << MAXIMUM_a << "].";
+        file << "\n\nInvalid partition number. n is required to be a natural number within range [" << MINIMUM_n << "," << MAXIMUM_n << "].";
         file << "\n\nHence, default program values are being used to replace user inputs for the Reimann Sum partitioning parameters.";
         return default_params;
     }
@@ -539,7 +1802,7 @@ Parameters selectPartitioningValues(std::ofstream & file)
     file << "\n\nThe selected number of equally-sized partitions to divide that interval into is " << n << ".";
 
     // Return a struct whose data type is Parameters and whose data attributes are the values which the user entered during a runtime instance of this function.
-    return {a,b,n};
+    return {a,b,(uint64_t) n,0.0,0.0};
 }
 
 /**
@@ -563,10 +1826,25 @@ std::string selectRectangleConstructionMethod(std::ofstream & file)
      * "right" refers to the method of using the right end-point of each of the n partitions of [a,b] to set the height of each of the n rectangles.
      * 
      * "midpoint" refers to the method of using the middle point of each of the n partitions of [a,b] to set the height of each of the n rectangles.
+     * 
+     * The next three methods are not rectangles but the composite Newton-Cotes rules which weight f at the n + 1 end-points of the partitions: 
+     * "trapezoid" (a straight line through the two end-points of each partition), 
+     * "simpson" (a parabola through the three end-points of each pair of partitions; n must be even), 
+     * and "boole" (a quartic through the five end-points of each group of four partitions; n must be a multiple of 4).
+     * 
+     * The next method, "gauss-legendre-m", weights f at the m Gauss-Legendre nodes of each partition (and is exact for polynomials of degree up to 2m - 1).
+     * 
+     * The last method, "all", evaluates f once at each of the n + 1 end-points and once at each of the n middle points of the partitions 
+     * and prints every estimate which those 2n + 1 values determine (left, right, midpoint, trapezoid, and Simpson) together with the spread between them.
      */
     const std::string method_0 = "left";
     const std::string method_1 = "right";
     const std::string method_2 = "midpoint";
+    const std::string method_3 = "trapezoid";
+    const std::string method_4 = "simpson";
+    const std::string method_5 = "boole";
+    const std::string method_6 = "gauss-legendre-";
+    const std::string method_7 = "all";
 
     // Initialize option to represent 0 (which is the associated with the first method in the above list).
     int option = 0;
@@ -576,6 +1854,11 @@ std::string selectRectangleConstructionMethod(std::ofstream & file)
     std::cout << "\n\n0 --> \"left\"";
     std::cout << "\n\n1 --> \"right\"";    
     std::cout << "\n\n2 --> \"midpoint\"";
+    std::cout << "\n\n3 --> \"trapezoid\"";
+    std::cout << "\n\n4 --> \"simpson\" (n must be even)";
+    std::cout << "\n\n5 --> \"boole\" (n must be a multiple of 4)";
+    std::cout << "\n\n6 --> \"gauss-legendre-m\" (m nodes per partition)";
+    std::cout << "\n\n7 --> \"all\" (left, right, midpoint, trapezoid, and Simpson from 2n + 1 evaluations)";
     std::cout << "\n\nEnter Option Here: ";
 
     // Print menu options and the instruction to input an option number to the file output stream.
@@ -583,6 +1866,11 @@ std::string selectRectangleConstructionMethod(std::ofstream & file)
     file << "\n\n0 --> \"left\"";
     file << "\n\n1 --> \"right\"";    
     file << "\n\n2 --> \"midpoint\"";
+    file << "\n\n3 --> \"trapezoid\"";
+    file << "\n\n4 --> \"simpson\" (n must be even)";
+    file << "\n\n5 --> \"boole\" (n must be a multiple of 4)";
+    file << "\n\n6 --> \"gauss-legendre-m\" (m nodes per partition)";
+    file << "\n\n7 --> \"all\" (left, right, midpoint, trapezoid, and Simpson from 2n + 1 evaluations)";
     file << "\n\nEnter Option Here: ";
 
     /**
@@ -598,10 +1886,10 @@ std::string selectRectangleConstructionMethod(std::ofstream & file)
     file << "\n\nThe value which was entered for option is " << option << ".";
 
     /**
-     * If option is smaller than 0 or if option is larger than 2, set option to 0
+     * If option is smaller than 0 or if option is larger than 7, set option to 0
      * and print a message stating that fact to the command line terminal and to the output file stream.
      */
-    if ((option < 0) || (option > 2))
+    if ((option < 0) || (option > 7))
     {
         option = 0;
         std::cout << "\n\noption was set to 0 by default due to the fact that the value input by the user was not recognized.";
@@ -630,5 +1918,5603 @@ std::string selectRectangleConstructionMethod(std::ofstream & file)
         file << "\n\nThe rectangle construction method which was selected from the list of such methods is \"midpoint\" (i.e. using the middle point of each of the n partitions of [a,b] to set the height of each of the n rectangles).";
         return method_2;
     }
-    return method_0;
+    if (option == 3) 
+    {
+        std::cout << "\n\nThe rectangle construction method which was selected from the list of such methods is \"trapezoid\" (i.e. weighting f at the n + 1 end-points of the partitions of [a,b] by 1/2, 1, 1, ..., 1, 1/2).";
+        file << "\n\nThe rectangle construction method which was selected from the list of such methods is \"trapezoid\" (i.e. weighting f at the n + 1 end-points of the partitions of [a,b] by 1/2, 1, 1, ..., 1, 1/2).";
+        return method_3;
+    }
+    if (option == 4) 
+    {
+        std::cout << "\n\nThe rectangle construction method which was selected from the list of such methods is \"simpson\" (i.e. weighting f at the n + 1 end-points of the partitions of [a,b] by 1/3, 4/3, 2/3, 4/3, ..., 4/3, 1/3).";
+        file << "\n\nThe rectangle construction method which was selected from the list of such methods is \"simpson\" (i.e. weighting f at the n + 1 end-points of the partitions of [a,b] by 1/3, 4/3, 2/3, 4/3, ..., 4/3, 1/3).";
+        return method_4;
+    }
+    if (option == 5) 
+    {
+        std::cout << "\n\nThe rectangle construction method which was selected from the list of such methods is \"boole\" (i.e. weighting f at the n + 1 end-points of the partitions of [a,b] by 2/45 times 7, 32, 12, 32, 14, 32, 12, 32, ..., 32, 7).";
+        file << "\n\nThe rectangle construction method which was selected from the list of such methods is \"boole\" (i.e. weighting f at the n + 1 end-points of the partitions of [a,b] by 2/45 times 7, 32, 12, 32, 14, 32, 12, 32, ..., 32, 7).";
+        return method_5;
+    }
+    if (option == 7) 
+    {
+        std::cout << "\n\nThe rectangle construction method which was selected from the list of such methods is \"all\" (i.e. evaluating f once at each end-point and once at each middle point of the n partitions of [a,b] and computing every rule which those points determine).";
+        file << "\n\nThe rectangle construction method which was selected from the list of such methods is \"all\" (i.e. evaluating f once at each end-point and once at each middle point of the n partitions of [a,b] and computing every rule which those points determine).";
+        return method_7;
+    }
+
+    // Prompt the user to input m (and replace any value outside of [MINIMUM_GAUSS_LEGENDRE_ORDER, MAXIMUM_GAUSS_LEGENDRE_ORDER] with the nearest value inside of it).
+    int order = MINIMUM_GAUSS_LEGENDRE_ORDER;
+    std::cout << "\n\nEnter a value to store in int-type variable m (which represents the number of Gauss-Legendre nodes per partition, " << MINIMUM_GAUSS_LEGENDRE_ORDER << " through " << MAXIMUM_GAUSS_LEGENDRE_ORDER << "): ";
+    file << "\n\nEnter a value to store in int-type variable m (which represents the number of Gauss-Legendre nodes per partition, " << MINIMUM_GAUSS_LEGENDRE_ORDER << " through " << MAXIMUM_GAUSS_LEGENDRE_ORDER << "): ";
+    std::cin >> order;
+    std::cout << "\nThe value which was entered for m is " << order << ".";
+    file << "\n\nThe value which was entered for m is " << order << ".";
+    if ((order < MINIMUM_GAUSS_LEGENDRE_ORDER) || (order > MAXIMUM_GAUSS_LEGENDRE_ORDER))
+    {
+        order = (order < MINIMUM_GAUSS_LEGENDRE_ORDER) ? MINIMUM_GAUSS_LEGENDRE_ORDER : MAXIMUM_GAUSS_LEGENDRE_ORDER;
+        std::cout << "\n\nm was set to " << order << " by default due to the fact that the value input by the user was out of range.";
+        file << "\n\nm was set to " << order << " by default due to the fact that the value input by the user was out of range.";
+    }
+    std::cout << "\n\nThe rectangle construction method which was selected from the list of such methods is \"" << method_6 << order << "\" (i.e. weighting f at the " << order << " Gauss-Legendre nodes of each of the n partitions of [a,b]).";
+    file << "\n\nThe rectangle construction method which was selected from the list of such methods is \"" << method_6 << order << "\" (i.e. weighting f at the " << order << " Gauss-Legendre nodes of each of the n partitions of [a,b]).";
+    return method_6 + std::to_string(order);
+}
+
+/**
+ * This function displays a list of trace levels (i.e. how much of the Riemann sum computation is printed)
+ * on the command line terminal and in the output file stream and
+ * prompts the program user to input an option number which corresponds
+ * with exactly one of the aforementioned trace levels. 
+ * 
+ * If the "sampled" trace level is selected, this function also prompts the user to input k 
+ * (such that every k-th rectangle is printed).
+ * 
+ * After the user enters some value, the corresponding TraceSettings type
+ * object is returned.
+ */
+TraceSettings selectTraceLevel(std::ofstream & file)
+{
+    // Initialize option to represent 2 (which is the associated with the step-by-step trace level which this program originally always used).
+    int option = 2, interval = 1;
+
+    // Print menu options and the instruction to input an option number to the command line terminal.
+    std::cout << "\n\nEnter the number which corresponds with one of the following trace levels:";
+    std::cout << "\n\n0 --> \"none\" (print only the result; fastest)";
+    std::cout << "\n\n1 --> \"sampled\" (print every k-th rectangle)";
+    std::cout << "\n\n2 --> \"full\" (print every step of every rectangle)";
+    std::cout << "\n\nEnter Option Here: ";
+
+    // Print menu options and the instruction to input an option number to the file output stream.
+    file << "\n\nEnter the number which corresponds with one of the following trace levels:";
+    file << "\n\n0 --> \"none\" (print only the result; fastest)";
+    file << "\n\n1 --> \"sampled\" (print every k-th rectangle)";
+    file << "\n\n2 --> \"full\" (print every step of every rectangle)";
+    file << "\n\nEnter Option Here: ";
+
+    /**
+     * Scan the command line terminal for the most recent keyboard input value. 
+     * Store that value (which is coerced to be of type int upon storage) in the variable named option.
+     */
+    std::cin >> option;
+
+    // Print "The value which was entered for option is {option}." to the command line terminal and to the file output stream.
+    std::cout << "\nThe value which was entered for option is " << option << ".";
+    file << "\n\nThe value which was entered for option is " << option << ".";
+
+    /**
+     * If option is smaller than 0 or if option is larger than 2, set option to 2
+     * and print a message stating that fact to the command line terminal and to the output file stream.
+     */
+    if ((option < 0) || (option > 2))
+    {
+        option = 2;
+        std::cout << "\n\noption was set to 2 by default due to the fact that the value input by the user was not recognized.";
+        file << "\n\noption was set to 2 by default due to the fact that the value input by the user was not recognized.";
+    }
+
+    if (option == 0) 
+    {
+        std::cout << "\n\nThe trace level which was selected is \"none\" (i.e. nothing is printed while the rectangles are being summed).";
+        file << "\n\nThe trace level which was selected is \"none\" (i.e. nothing is printed while the rectangles are being summed).";
+        return { "none", 1 };
+    }
+    if (option == 2) 
+    {
+        std::cout << "\n\nThe trace level which was selected is \"full\" (i.e. every step of every rectangle is printed).";
+        file << "\n\nThe trace level which was selected is \"full\" (i.e. every step of every rectangle is printed).";
+        return { "full", 1 };
+    }
+
+    // Prompt the user to input k (and replace any value smaller than one with one).
+    std::cout << "\n\nEnter a value to store in int-type variable k (which represents the number of rectangles per printed line): ";
+    file << "\n\nEnter a value to store in int-type variable k (which represents the number of rectangles per printed line): ";
+    std::cin >> interval;
+    std::cout << "\nThe value which was entered for k is " << interval << ".";
+    file << "\n\nThe value which was entered for k is " << interval << ".";
+    if (interval < 1)
+    {
+        interval = 1;
+        std::cout << "\n\nk was set to 1 by default due to the fact that the value input by the user was not a natural number.";
+        file << "\n\nk was set to 1 by default due to the fact that the value input by the user was not a natural number.";
+    }
+    std::cout << "\n\nThe trace level which was selected is \"sampled\" (i.e. every " << interval << "-th rectangle is printed).";
+    file << "\n\nThe trace level which was selected is \"sampled\" (i.e. every " << interval << "-th rectangle is printed).";
+    return { "sampled", interval };
+}
+
+/**
+ * This function displays a list of accumulators (i.e. ways in which the heights of the rectangles are added)
+ * on the command line terminal and in the output file stream and
+ * prompts the program user to input an option number which corresponds
+ * with exactly one of the aforementioned accumulators. 
+ * 
+ * After the user enters some value, the corresponding Accumulator type
+ * object is returned.
+ */
+Accumulator selectAccumulator(std::ofstream & file)
+{
+    // Initialize option to represent 0 (which is the associated with the naive accumulator which this program originally always used).
+    int option = 0;
+
+    // Print menu options and the instruction to input an option number to the command line terminal and to the file output stream.
+    std::cout << "\n\nEnter the number which corresponds with one of the following accumulators:";
+    file << "\n\nEnter the number which corresponds with one of the following accumulators:";
+    for (int k = 0; k < NUMBER_OF_ACCUMULATORS; k++)
+    {
+        std::cout << "\n\n" << k << " --> \"" << nameOfAccumulator((Accumulator) k) << "\"";
+        file << "\n\n" << k << " --> \"" << nameOfAccumulator((Accumulator) k) << "\"";
+    }
+    std::cout << "\n\n(Run ./app --accumulators to measure the cost per element and the rounding error of each accumulator.)";
+    std::cout << "\n\nEnter Option Here: ";
+    file << "\n\n(Run ./app --accumulators to measure the cost per element and the rounding error of each accumulator.)";
+    file << "\n\nEnter Option Here: ";
+
+    /**
+     * Scan the command line terminal for the most recent keyboard input value. 
+     * Store that value (which is coerced to be of type int upon storage) in the variable named option.
+     */
+    std::cin >> option;
+
+    // Print "The value which was entered for option is {option}." to the command line terminal and to the file output stream.
+    std::cout << "\nThe value which was entered for option is " << option << ".";
+    file << "\n\nThe value which was entered for option is " << option << ".";
+
+    /**
+     * If option is smaller than 0 or if option is larger than NUMBER_OF_ACCUMULATORS - 1, set option to 0
+     * and print a message stating that fact to the command line terminal and to the output file stream.
+     */
+    if ((option < 0) || (option >= NUMBER_OF_ACCUMULATORS))
+    {
+        option = 0;
+        std::cout << "\n\noption was set to 0 by default due to the fact that the value input by the user was not recognized.";
+        file << "\n\noption was set to 0 by default due to the fact that the value input by the user was not recognized.";
+    }
+    std::cout << "\n\nThe accumulator which was selected is \"" << nameOfAccumulator((Accumulator) option) << "\".";
+    file << "\n\nThe accumulator which was selected is \"" << nameOfAccumulator((Accumulator) option) << "\".";
+    return (Accumulator) option;
+}
+
+/**
+ * This function prints how many of the n rectangles were summed so far (completed), 
+ * what percentage of n that is, how many seconds have elapsed, 
+ * and how many function evaluations were performed per second 
+ * to the command line terminal and to the output file stream.
+ */
+void reportProgress(uint64_t completed, uint64_t n, double seconds, std::ofstream & file)
+{
+    double percent = 100.0 * (double) completed / (double) n;
+    double throughput = (seconds > 0.0) ? (double) completed / seconds : 0.0;
+    std::streamsize coutPrecision = std::cout.precision(6), filePrecision = file.precision(6);
+    std::cout << "\n\nprogress: " << completed << " of " << n << " rectangles (" << percent << "%) in " << seconds << " seconds (" << throughput << " evaluations per second).";
+    file << "\n\nprogress: " << completed << " of " << n << " rectangles (" << percent << "%) in " << seconds << " seconds (" << throughput << " evaluations per second).";
+    std::cout.flush();
+    std::cout.precision(coutPrecision);
+    file.precision(filePrecision);
+}
+
+/**
+ * This function returns the current wall clock (std::chrono::steady_clock) and the CPU clock of the calling thread (CLOCK_THREAD_CPUTIME_ID), 
+ * which stopPhase subtracts from the clocks at the end of the phase. Reading both clocks costs well under a microsecond, 
+ * so the blocks of PARALLEL_BLOCK_SIZE rectangles can be timed one by one without slowing them down measurably.
+ */
+PhaseStamp startPhase()
+{
+    timespec cpu = {};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &cpu);
+    uint64_t wall = (uint64_t) std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    return { wall, (uint64_t) cpu.tv_sec * 1000000000ULL + (uint64_t) cpu.tv_nsec };
+}
+
+// This function adds the wall time and the CPU time which passed on the calling thread since start to the times of phase in timings (unless timings is a null pointer).
+void stopPhase(PhaseTimings * timings, Phase phase, const PhaseStamp & start)
+{
+    if (timings == nullptr) return;
+    PhaseStamp stop = startPhase();
+    timings->wallNanoseconds[(int) phase] += stop.wall - start.wall;
+    timings->cpuNanoseconds[(int) phase] += stop.cpu - start.cpu;
+}
+
+// This function returns the CPU time used so far by every thread of this program (CLOCK_PROCESS_CPUTIME_ID) in seconds.
+double processCpuSeconds()
+{
+    timespec cpu = {};
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &cpu);
+    return (double) cpu.tv_sec + 1e-9 * (double) cpu.tv_nsec;
+}
+
+// This function returns the name of phase (as printed by printPhaseTimings and written by the benchmark suite).
+std::string nameOfPhase(Phase phase)
+{
+    static const char * names[NUMBER_OF_PHASES] = { "input", "evaluation", "accumulation", "output" };
+    return names[(int) phase];
+}
+
+/**
+ * This function prints (to the command line terminal and to file) the wall time and the CPU time of each phase in timings, 
+ * the elapsed wall time and the CPU time (of every thread) of the computation (computeSeconds and computeCpuSeconds), 
+ * the number of function evaluations (timings.evaluations) per second of the computation, and the number of nanoseconds per rectangle (of the n rectangles).
+ */
+void printPhaseTimings(const PhaseTimings & timings, const RiemannEngine & engine, double computeSeconds, double computeCpuSeconds, uint64_t n, std::ofstream & file)
+{
+    uint64_t evaluations = timings.evaluations;
+    std::streamsize coutPrecision = std::cout.precision(6), filePrecision = file.precision(6);
+    std::ostringstream report;
+    report.precision(6);
+    report << "\n\nPhase timings (wall seconds, CPU seconds):";
+    for (int k = 0; k < NUMBER_OF_PHASES; k++)
+    {
+        report << "\n\n" << nameOfPhase((Phase) k) << ": " << (1e-9 * (double) timings.wallNanoseconds[k]) << " s wall, " << (1e-9 * (double) timings.cpuNanoseconds[k]) << " s CPU";
+        if (((Phase) k == Phase::Evaluation) || ((Phase) k == Phase::Accumulation)) report << " (summed over the " << engine.threadCount << " thread(s))";
+        if (((Phase) k == Phase::Evaluation) && (engine.accumulator == Accumulator::Naive) && (engine.rule != Rule::GaussLegendre)) report << " (including the accumulation, which the compiled kernel does as it evaluates)";
+    }
+    report << "\n\ncomputation: " << computeSeconds << " s wall, " << computeCpuSeconds << " s CPU (every thread)";
+    report << "\n\n" << evaluations << " function evaluations (" << ((computeSeconds > 0.0) ? ((double) evaluations / computeSeconds) : 0.0) << " per second), " << ((n > 0) ? (1e9 * computeSeconds / (double) n) : 0.0) << " nanoseconds per rectangle.";
+    std::cout << report.str();
+    file << report.str();
+    std::cout.precision(coutPrecision);
+    file.precision(filePrecision);
+}
+
+/**
+ * This function returns the total height of the rectangles of partitions first through last - 1 of [a,b] 
+ * (where each partition has length dx) for the function evaluated by Integrand and the rectangle construction method named by rule.
+ * 
+ * Because Integrand and rule are template arguments, each of the NUMBER_OF_FUNCTIONS * NUMBER_OF_RULES instantiations of this function 
+ * is a separate loop in which the function is inlined and the offset of the rule is a constant. 
+ * The loop keeps four independent partial sums (one per lane of four consecutive partitions) so that the additions do not form 
+ * a single serial dependency chain (and so that the compiler can vectorize the loop). 
+ * The partition index is carried as a double which is incremented by exactly 1.0 per partition, 
+ * so each x-axis point is still exactly a + (i + offset) * dx.
+ * 
+ * For the Newton-Cotes rules (trapezoid, Simpson, and Boole), the height of partition i is multiplied by interiorWeightOfRule(rule, i). 
+ * Those weights repeat every 1, 2, or 4 partitions, so each of the four partial sums only ever holds partitions with the same weight, 
+ * and each partial sum is multiplied by its weight once, at the end (so the weights cost nothing inside of the loop).
+ */
+template <typename Integrand, Rule rule> double sumRectangleHeights(double a, double dx, uint64_t first, uint64_t last)
+{
+    constexpr double offset = (rule == Rule::Right) ? 1.0 : ((rule == Rule::Midpoint) ? 0.5 : 0.0);
+    const Integrand func = Integrand();
+    double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+    double t = (double) first + offset;
+    uint64_t i = first;
+
+    // Add the heights of four consecutive rectangles per iteration.
+    for (; i + 4 <= last; i += 4, t += 4.0)
+    {
+        sum0 += func(a + t * dx);
+        sum1 += func(a + (t + 1.0) * dx);
+        sum2 += func(a + (t + 2.0) * dx);
+        sum3 += func(a + (t + 3.0) * dx);
+    }
+
+    // Weight the four partial sums and add the weighted heights of the (at most three) remaining rectangles.
+    double total = (interiorWeightOfRule(rule, first) * sum0 + interiorWeightOfRule(rule, first + 1) * sum1) + (interiorWeightOfRule(rule, first + 2) * sum2 + interiorWeightOfRule(rule, first + 3) * sum3);
+    for (; i < last; ++i, t += 1.0) total += interiorWeightOfRule(rule, i) * func(a + t * dx);
+    return total;
+}
+
+/**
+ * This function returns the cosine of x (for x within [0, pi]) using the first 40 terms of its Taylor series. 
+ * It is constexpr (unlike std::cos) so that makeGaussLegendreTables can be evaluated at compile time, 
+ * and it is only used for the initial guesses of the Newton iterations (so its last few bits do not matter).
+ */
+constexpr double compileTimeCosine(double x)
+{
+    double term = 1.0, sum = 1.0;
+    for (int k = 1; k < 40; k++)
+    {
+        term *= -x * x / ((2.0 * k - 1.0) * (2.0 * k));
+        sum += term;
+    }
+    return sum;
+}
+
+// This function stores P_order(x) in value and P_order'(x) in derivative (for x within (-1,1)) using the three-term recurrence of the Legendre polynomials.
+constexpr void evaluateLegendrePolynomial(int order, double x, double & value, double & derivative)
+{
+    double previous = 1.0, current = x;
+    for (int j = 1; j < order; j++)
+    {
+        double next = ((2.0 * j + 1.0) * x * current - j * previous) / (j + 1.0);
+        previous = current;
+        current = next;
+    }
+    value = current;
+    derivative = order * (x * current - previous) / (x * x - 1.0);
+}
+
+/**
+ * This function returns the nodes and weights of the Gauss-Legendre rules of every order m from MINIMUM_GAUSS_LEGENDRE_ORDER to MAXIMUM_GAUSS_LEGENDRE_ORDER. 
+ * The nodes of the rule of order m are the roots of the Legendre polynomial P_m, which are symmetric about zero, 
+ * so only the positive half is computed: each root is found by Newton's method starting from cos(pi * (k + 0.75) / (m + 0.5)), 
+ * where P_m and its derivative are evaluated by evaluateLegendrePolynomial. 
+ * The weight of the root x is 2 / ((1 - x^2) P_m'(x)^2) (with the derivative evaluated at the converged root).
+ */
+constexpr GaussLegendreTables makeGaussLegendreTables()
+{
+    GaussLegendreTables tables = {};
+    for (int order = MINIMUM_GAUSS_LEGENDRE_ORDER; order <= MAXIMUM_GAUSS_LEGENDRE_ORDER; order++)
+    {
+        for (int k = 0; k < (order + 1) / 2; k++)
+        {
+            double x = compileTimeCosine(3.14159265358979323846 * (k + 0.75) / (order + 0.5)), value = 0.0, derivative = 1.0;
+            for (int iteration = 0; iteration < 100; iteration++)
+            {
+                evaluateLegendrePolynomial(order, x, value, derivative);
+                double step = value / derivative;
+                x -= step;
+                if ((step < 0.0 ? -step : step) <= 1e-16) break;
+            }
+            evaluateLegendrePolynomial(order, x, value, derivative);
+            tables.nodes[order][k] = -x;
+            tables.nodes[order][order - 1 - k] = x;
+            tables.weights[order][k] = 2.0 / ((1.0 - x * x) * derivative * derivative);
+            tables.weights[order][order - 1 - k] = tables.weights[order][k];
+        }
+    }
+    return tables;
+}
+
+// Store the Gauss-Legendre nodes and weights (which are computed by the compiler, so none of them are computed when the program runs).
+constexpr GaussLegendreTables gaussLegendreTables = makeGaussLegendreTables();
+
+/**
+ * This function returns 1 / m (for a positive integer m below 2^26) as a double-double. The high part is the rounded quotient h, 
+ * and the low part is the remainder 1 - h * m divided by m, where h is split into two 26-bit halves (Veltkamp splitting) so that 
+ * both products with m are exact without a fused multiply-add (which a constant expression cannot use).
+ */
+constexpr DoubleDouble compileTimeReciprocal(double m)
+{
+    double high = 1.0 / m, split = 134217729.0 * high; // 2^27 + 1
+    double highPart = split - (split - high), lowPart = high - highPart;
+    return { high, ((1.0 - highPart * m) - lowPart * m) / m };
+}
+
+// This function returns the reciprocals of the Taylor series of the double-double sine and cosine (see DoubleDoubleTaylorTables).
+constexpr DoubleDoubleTaylorTables makeDoubleDoubleTaylorTables()
+{
+    DoubleDoubleTaylorTables tables = {};
+    for (int k = 1; k <= DOUBLE_DOUBLE_TAYLOR_TERMS; k++)
+    {
+        tables.sine[k] = compileTimeReciprocal((double) (2 * k) * (2 * k + 1));
+        tables.cosine[k] = compileTimeReciprocal((double) (2 * k - 1) * (2 * k));
+    }
+    return tables;
 }
+
+// Store the reciprocals of the Taylor series of the double-double sine and cosine (which are computed by the compiler).
+constexpr DoubleDoubleTaylorTables doubleDoubleTaylorTables = makeDoubleDoubleTaylorTables();
+
+/**
+ * Define a struct-type variable named BernoulliNumbers which stores the Bernoulli numbers B_0 through B_(MAXIMUM_POLYNOMIAL_DEGREE + 1) 
+ * (with B_1 = -1/2), which the Euler-Maclaurin formula of closedFormRiemannSum needs for polynomials of degree up to MAXIMUM_POLYNOMIAL_DEGREE.
+ */
+struct BernoulliNumbers {
+    double values[MAXIMUM_POLYNOMIAL_DEGREE + 2];
+};
+
+/**
+ * This function returns the Bernoulli numbers B_0 through B_(MAXIMUM_POLYNOMIAL_DEGREE + 1) 
+ * using the recurrence B_0 = 1 and B_m = -(C(m+1,0) B_0 + ... + C(m+1,m-1) B_(m-1)) / (m + 1).
+ */
+constexpr BernoulliNumbers makeBernoulliNumbers()
+{
+    BernoulliNumbers numbers = {};
+    numbers.values[0] = 1.0;
+    for (int m = 1; m <= MAXIMUM_POLYNOMIAL_DEGREE + 1; m++)
+    {
+        double binomial = 1.0, sum = 0.0; // binomial is C(m+1,j)
+        for (int j = 0; j < m; j++)
+        {
+            sum += binomial * numbers.values[j];
+            binomial = binomial * (m + 1 - j) / (j + 1);
+        }
+        numbers.values[m] = -sum / (m + 1);
+    }
+    return numbers;
+}
+
+// Store the Bernoulli numbers (which, like the Gauss-Legendre tables, are computed by the compiler).
+constexpr BernoulliNumbers bernoulliNumbers = makeBernoulliNumbers();
+
+/**
+ * This function returns the Rule which corresponds with the rectangle construction method string 
+ * returned by selectRectangleConstructionMethod ("left", "right", "midpoint", "trapezoid", "simpson", "boole", or "gauss-legendre-m"). 
+ * Any other string is treated as "left".
+ */
+Rule ruleFromMethod(const std::string & method)
+{
+    if (method == "right") return Rule::Right;
+    if (method == "midpoint") return Rule::Midpoint;
+    if (method == "trapezoid") return Rule::Trapezoid;
+    if (method == "simpson") return Rule::Simpson;
+    if (method == "boole") return Rule::Boole;
+    if (method.compare(0, 15, "gauss-legendre-") == 0) return Rule::GaussLegendre;
+    return Rule::Left;
+}
+
+// This function returns m if method is "gauss-legendre-m" (or 0 if method does not name a Gauss-Legendre rule).
+int gaussLegendreOrderFromMethod(const std::string & method)
+{
+    if (method.compare(0, 15, "gauss-legendre-") != 0) return 0;
+    return atoi(method.c_str() + 15);
+}
+
+/**
+ * This function returns true if method is "left", "right", "midpoint", "trapezoid", "simpson", "boole", 
+ * or "gauss-legendre-m" where m is MINIMUM_GAUSS_LEGENDRE_ORDER through MAXIMUM_GAUSS_LEGENDRE_ORDER (and false otherwise).
+ */
+bool methodIsRecognized(const std::string & method)
+{
+    if ((method == "left") || (method == "right") || (method == "midpoint") || (method == "trapezoid") || (method == "simpson") || (method == "boole")) return true;
+    int order = gaussLegendreOrderFromMethod(method);
+    return (order >= MINIMUM_GAUSS_LEGENDRE_ORDER) && (order <= MAXIMUM_GAUSS_LEGENDRE_ORDER) && (method == "gauss-legendre-" + std::to_string(order));
+}
+
+// This function returns where inside of each partition the height of the rectangle is measured for rule (0 for left, 1 for right, 0.5 for midpoint, and 0 for the Newton-Cotes rules).
+double offsetOfRule(Rule rule)
+{
+    if (rule == Rule::Right) return 1.0;
+    if (rule == Rule::Midpoint) return 0.5;
+    return 0.0;
+}
+
+/**
+ * This function returns the weight (before scaleOfRule is applied) of the value of f at the left end-point of partition i for rule: 
+ * 1 for the rectangle rules and the trapezoid rule, 2 and 4 (alternating) for the Simpson rule, and 14, 32, 12, 32 (repeating) for the Boole rule. 
+ * The first end-point of [a,b] (which is also given the interior weight) and the last end-point (which is not the left end-point of any partition) 
+ * are corrected by endpointCorrectionOfRule.
+ */
+double interiorWeightOfRule(Rule rule, uint64_t i)
+{
+    if (rule == Rule::Simpson) return (i % 2 == 0) ? 2.0 : 4.0;
+    if (rule == Rule::Boole) return (i % 2 == 1) ? 32.0 : ((i % 4 == 0) ? 14.0 : 12.0);
+    return 1.0;
+}
+
+// This function returns the number which every weight of rule is multiplied by (1/3 for the Simpson rule, 2/45 for the Boole rule, and 1 otherwise).
+double scaleOfRule(Rule rule)
+{
+    if (rule == Rule::Simpson) return 1.0 / 3.0;
+    if (rule == Rule::Boole) return 2.0 / 45.0;
+    return 1.0;
+}
+
+/**
+ * This function returns c such that, if S is the sum of interiorWeightOfRule(rule, i) * f(a + i * dx) for i = 0 through n - 1, 
+ * the composite Newton-Cotes rule is dx * scaleOfRule(rule) * (S + c * (f(b) - f(a))) 
+ * (1/2 for the trapezoid rule, 1 for the Simpson rule, 7 for the Boole rule, and 0 for the other rules).
+ */
+double endpointCorrectionOfRule(Rule rule)
+{
+    if (rule == Rule::Trapezoid) return 0.5;
+    if (rule == Rule::Simpson) return 1.0;
+    if (rule == Rule::Boole) return 7.0;
+    return 0.0;
+}
+
+// This function returns the number of points at which rule evaluates f on n partitions (n for the rectangle rules, n + 1 for the Newton-Cotes rules, and n * order for Gauss-Legendre).
+uint64_t numberOfPointsOfRule(Rule rule, int order, uint64_t n)
+{
+    if (rule == Rule::GaussLegendre) return n * (uint64_t) order;
+    if ((rule == Rule::Trapezoid) || (rule == Rule::Simpson) || (rule == Rule::Boole)) return n + 1;
+    return n;
+}
+
+/**
+ * This function stores the jth point (of the numberOfPointsOfRule(rule, order, n) points at which rule evaluates f on the n partitions of [a,b]) in x 
+ * and the weight of f(x) in weight (such that the rule is dx times the sum of weight * f(x) over every point).
+ */
+void pointOfRule(Rule rule, int order, double a, double dx, uint64_t n, uint64_t j, double & x, double & weight)
+{
+    if (rule == Rule::GaussLegendre)
+    {
+        uint64_t i = j / (uint64_t) order;
+        int k = (int) (j % (uint64_t) order);
+        x = a + ((double) i + 0.5 * (1.0 + gaussLegendreTables.nodes[order][k])) * dx;
+        weight = 0.5 * gaussLegendreTables.weights[order][k];
+        return;
+    }
+    x = a + ((double) j + offsetOfRule(rule)) * dx;
+    weight = scaleOfRule(rule) * interiorWeightOfRule(rule, j);
+    if ((j == 0) || (j == n)) weight = scaleOfRule(rule) * (interiorWeightOfRule(rule, 0) - endpointCorrectionOfRule(rule));
+}
+
+/**
+ * The following section (up to the matching "#pragma GCC pop_options") contains the vectorized math kernels. 
+ * Every function in this section is compiled for AVX2 with FMA, and each one is always inlined into one of the 
+ * AVX2 or AVX-512 entry points below (whose instruction sets include AVX2 and FMA), so none of them is ever called on a processor without AVX2. 
+ * These functions are not listed with the other function prototypes because a prototype outside of this section would not have the same target. 
+ * Because these functions are never called through the ABI, the warning about returning 64-byte vectors without AVX-512 enabled does not apply to them 
+ * (and vectors are passed to them by reference for the same reason). The warning is ignored between "#pragma GCC diagnostic push" and "#pragma GCC diagnostic pop" 
+ * (because "#pragma GCC pop_options" does not restore the state of the diagnostics) and once more at the end of this file (see the last lines).
+ */
+#pragma GCC push_options
+#pragma GCC target("avx2,fma")
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wpsabi"
+
+/**
+ * This function returns x rounded to the nearest integer (with ties rounded to even) for every element x whose magnitude is smaller than 2^51. 
+ * Adding and then subtracting 1.5 * 2^52 pushes the fractional bits of x out of the 52-bit significand, 
+ * so this needs no rounding instruction and compiles to the same two instructions on every vector width.
+ */
+template <typename Vector> inline __attribute__((always_inline)) Vector vectorRound(const Vector & x)
+{
+    const double shifter = 6755399441055744.0; // 1.5 * 2^52
+    return (x + shifter) - shifter;
+}
+
+/**
+ * This function returns the sine of every element of x.
+ * 
+ * Range reduction: q = round(x * 2 / pi) and r = x - q * (pi / 2), where pi / 2 is split into four parts (the fdlibm Cody-Waite constants, 
+ * the first three of which have 33 significant bits, so that q times each of them is exact for |q| < 2^20) 
+ * and r is accurate for every |x| up to about 10^6 (and the menu limits |x| to 999). 
+ * r is within [-pi/4, pi/4], where sin(r) and cos(r) are approximated by the fdlibm minimax polynomials (evaluated in Horner form, 
+ * which the compiler contracts into fused multiply-add instructions). 
+ * The quadrant k = q mod 4 selects sin(r), cos(r), -sin(r), or -cos(r).
+ * 
+ * Measured against the scalar libm sin and cos at 10^6 random points of [-999, 999] (see "./app --simd-accuracy") the error is at most 2 ulp.
+ */
+template <typename Vector> inline __attribute__((always_inline)) Vector vectorSineOfQuadrant(const Vector & x, double quadrantShift)
+{
+    const double twoOverPi = 6.36619772367581382433e-01;
+    const double pio2Part1 = 1.57079632673412561417e+00, pio2Part2 = 6.07710050630396597660e-11, pio2Part3 = 2.02226624871116645580e-21, pio2Part4 = 8.47842766036889956997e-32;
+    Vector q = vectorRound(x * twoOverPi);
+    Vector r = (((x - q * pio2Part1) - q * pio2Part2) - q * pio2Part3) - q * pio2Part4;
+    Vector z = r * r;
+
+    // Approximate sin(r) and cos(r) on [-pi/4, pi/4].
+    Vector sinePolynomial = -1.66666666666666324348e-01 + z * (8.33333333332248946124e-03 + z * (-1.98412698298579493134e-04 
+        + z * (2.75573137070700676789e-06 + z * (-2.50507602534068634195e-08 + z * 1.58969099521155010221e-10))));
+    Vector cosinePolynomial = 4.16666666666666019037e-02 + z * (-1.38888888888741095749e-03 + z * (2.48015872894767294178e-05 
+        + z * (-2.75573143513906633035e-07 + z * (2.08757232129817482790e-09 + z * -1.13596475577881948265e-11))));
+    Vector sine = r + r * z * sinePolynomial;
+    Vector cosine = (1.0 - 0.5 * z) + z * z * cosinePolynomial;
+
+    // Set k to q + quadrantShift modulo 4 (using floor((q + quadrantShift) / 4) = round((q + quadrantShift) / 4 - 0.375) for integer q).
+    Vector shifted = q + quadrantShift;
+    Vector k = shifted - 4.0 * vectorRound(shifted * 0.25 - 0.375);
+
+    /**
+     * Select the result with arithmetic rather than with comparison masks (which the compiler does not turn into AVX-512 mask registers): 
+     * high is 1 for k = 2 or 3 (negate) and low is 1 for k = 1 or 3 (use the cosine). 
+     * Every product below is by exactly 0, 1, or -1, so the selection itself introduces no rounding error.
+     */
+    Vector high = vectorRound(k * 0.5 - 0.25);
+    Vector low = k - 2.0 * high;
+    Vector result = sine * (1.0 - low) + cosine * low;
+    return result * (1.0 - 2.0 * high);
+}
+
+template <typename Vector> inline __attribute__((always_inline)) Vector vectorSine(const Vector & x)
+{
+    return vectorSineOfQuadrant(x, 0.0);
+}
+
+// This function returns the cosine of every element of x (using cos(x) = sin(x + pi / 2), i.e. the quadrant of x shifted by one).
+template <typename Vector> inline __attribute__((always_inline)) Vector vectorCosine(const Vector & x)
+{
+    return vectorSineOfQuadrant(x, 1.0);
+}
+
+/**
+ * These functions return the square root of every element of x using the hardware vector square root instruction 
+ * (which is correctly rounded, so its results are identical to the scalar libm sqrt). 
+ * The 8-wide version takes the square roots of its two 4-wide halves, because AVX-512 instructions cannot be used in this section.
+ */
+inline __attribute__((always_inline)) Double4 vectorSquareRoot(const Double4 & x)
+{
+    return _mm256_sqrt_pd(x);
+}
+
+inline __attribute__((always_inline)) Double8 vectorSquareRoot(const Double8 & x)
+{
+    Double4 low = { x[0], x[1], x[2], x[3] }, high = { x[4], x[5], x[6], x[7] };
+    low = vectorSquareRoot(low);
+    high = vectorSquareRoot(high);
+    return (Double8) { low[0], low[1], low[2], low[3], high[0], high[1], high[2], high[3] };
+}
+
+/**
+ * These functions are the vectorized versions of the integrand structs (i.e. each one returns f(x) for every element of x).
+ * Polynomials are written in a form which the compiler contracts into fused multiply-add instructions.
+ */
+template <typename Vector> inline __attribute__((always_inline)) Vector evaluateVector(SquareIntegrand, const Vector & x) { return x * x; }
+template <typename Vector> inline __attribute__((always_inline)) Vector evaluateVector(CubeIntegrand, const Vector & x) { return x * x * x; }
+template <typename Vector> inline __attribute__((always_inline)) Vector evaluateVector(SineIntegrand, const Vector & x) { return vectorSine(x); }
+template <typename Vector> inline __attribute__((always_inline)) Vector evaluateVector(CosineIntegrand, const Vector & x) { return vectorCosine(x); }
+template <typename Vector> inline __attribute__((always_inline)) Vector evaluateVector(SquareRootIntegrand, const Vector & x) { return vectorSquareRoot(x); }
+template <typename Vector> inline __attribute__((always_inline)) Vector evaluateVector(LinearIntegrand, const Vector & x) { return 2 * x + 3; }
+
+// These functions are the vectorized versions of the combine and finish member functions of the box integrand structs.
+template <typename Vector> inline __attribute__((always_inline)) Vector combineVector(SumOfSquaresBoxIntegrand, const Vector & sum, const Vector & x) { return sum + x * x; }
+template <typename Vector> inline __attribute__((always_inline)) Vector combineVector(ProductOfCosinesBoxIntegrand, const Vector & product, const Vector & x) { return product * vectorCosine(x); }
+template <typename Vector> inline __attribute__((always_inline)) Vector combineVector(SineOfSumBoxIntegrand, const Vector & sum, const Vector & x) { return sum + x; }
+template <typename Vector> inline __attribute__((always_inline)) Vector finishVector(SumOfSquaresBoxIntegrand, const Vector & sum) { return sum; }
+template <typename Vector> inline __attribute__((always_inline)) Vector finishVector(ProductOfCosinesBoxIntegrand, const Vector & product) { return product; }
+template <typename Vector> inline __attribute__((always_inline)) Vector finishVector(SineOfSumBoxIntegrand, const Vector & sum) { return vectorSine(sum); }
+
+/**
+ * This function stores the box integrand of the points i through i + (the width of Vector) - 1 of coordinates (see BoxEvaluator) in y[i] onward, 
+ * loading one vector of each axis and combining the axes in order.
+ */
+template <typename Vector, typename BoxIntegrand> inline __attribute__((always_inline)) void evaluateBoxVector(const BoxIntegrand & func, const double * const * coordinates, int dimension, double * y, uint64_t i)
+{
+    Vector value = Vector{} + func.start(), x;
+    for (int k = 0; k < dimension; k++)
+    {
+        std::memcpy(&x, coordinates[k] + i, sizeof(x));
+        value = combineVector(func, value, x);
+    }
+    value = finishVector(func, value);
+    std::memcpy(y + i, &value, sizeof(value));
+}
+
+/**
+ * This function is the vectorized version of sumRectangleHeights: it returns the total height of the rectangles 
+ * of partitions first through last - 1 of [a,b] using vectors of Vector (4 or 8 doubles), 
+ * evaluating four vectors of consecutive partitions per iteration into four independent vector accumulators. 
+ * The (fewer than 4 * lanes) remaining partitions are evaluated with the scalar function. 
+ * As in sumRectangleHeights, the weight of each partition depends only on its lane (because lanes is a multiple of 4), 
+ * so each lane of the accumulated vector is multiplied by its weight once, at the end.
+ * 
+ * This function is always inlined into sumRectangleHeightsAvx2 or sumRectangleHeightsAvx512, 
+ * so the 8-wide version is compiled to AVX-512 instructions inside of sumRectangleHeightsAvx512.
+ */
+template <typename Vector, typename Integrand, Rule rule> inline __attribute__((always_inline)) double sumRectangleHeightsVector(double a, double dx, uint64_t first, uint64_t last)
+{
+    constexpr int lanes = sizeof(Vector) / sizeof(double);
+    constexpr double offset = (rule == Rule::Right) ? 1.0 : ((rule == Rule::Midpoint) ? 0.5 : 0.0);
+    const Integrand func = Integrand();
+    Vector lane = {}, sum0 = {}, sum1 = {}, sum2 = {}, sum3 = {};
+    for (int k = 0; k < lanes; k++) lane[k] = k;
+    double t = (double) first + offset, total = 0.0;
+    uint64_t i = first;
+
+    // Add the heights of 4 * lanes consecutive rectangles per iteration.
+    for (; i + 4 * lanes <= last; i += 4 * lanes, t += 4 * lanes)
+    {
+        Vector base = t + lane;
+        sum0 += evaluateVector(func, a + base * dx);
+        sum1 += evaluateVector(func, a + (base + lanes) * dx);
+        sum2 += evaluateVector(func, a + (base + 2 * lanes) * dx);
+        sum3 += evaluateVector(func, a + (base + 3 * lanes) * dx);
+    }
+
+    // Add the weighted lanes of the four accumulators and the weighted heights of the remaining rectangles.
+    Vector sum = (sum0 + sum1) + (sum2 + sum3);
+    for (int k = 0; k < lanes; k++) total += interiorWeightOfRule(rule, first + k) * sum[k];
+    for (; i < last; ++i, t += 1.0) total += interiorWeightOfRule(rule, i) * func(a + t * dx);
+    return total;
+}
+
+/**
+ * This function returns the sum of values[0] through values[count - 1] using vectors of Vector (4 or 8 doubles). 
+ * Two vector accumulators each carry one error term per lane: the branch-free two-sum (t = s + v, b = t - s, e = (s - (t - b)) + (v - b)) 
+ * computes the exact rounding error e of each lane's addition without any comparison, and e is added to that lane's error term. 
+ * The lane sums and the (fewer than 2 * lanes) remaining values are then added with addNeumaier, and the lane errors are added to the error term (which is stored in error).
+ */
+template <typename Vector> inline __attribute__((always_inline)) double sumCompensatedVector(const double * values, uint64_t count, double & error)
+{
+    constexpr int lanes = sizeof(Vector) / sizeof(double);
+    Vector sum0 = {}, sum1 = {}, error0 = {}, error1 = {};
+    uint64_t i = 0;
+
+    // Add 2 * lanes values per iteration (one vector to each accumulator).
+    for (; i + 2 * lanes <= count; i += 2 * lanes)
+    {
+        Vector value0, value1;
+        std::memcpy(&value0, values + i, sizeof(value0));
+        std::memcpy(&value1, values + i + lanes, sizeof(value1));
+        Vector total0 = sum0 + value0, total1 = sum1 + value1;
+        Vector part0 = total0 - sum0, part1 = total1 - sum1;
+        error0 += (sum0 - (total0 - part0)) + (value0 - part0);
+        error1 += (sum1 - (total1 - part1)) + (value1 - part1);
+        sum0 = total0;
+        sum1 = total1;
+    }
+
+    // Add the lanes of both accumulators and the remaining values (and carry every error term into the final error).
+    double sum = 0.0;
+    error = 0.0;
+    for (int k = 0; k < lanes; k++)
+    {
+        addNeumaier(sum, error, sum0[k]);
+        addNeumaier(sum, error, sum1[k]);
+        error += error0[k] + error1[k];
+    }
+    for (; i < count; i++) addNeumaier(sum, error, values[i]);
+    return sum;
+}
+
+/**
+ * These functions load lanes consecutive doubles from values into a Vector and store a Vector into lanes consecutive doubles of values 
+ * (through std::memcpy, which compiles to one unaligned vector load or store).
+ */
+template <typename Vector> inline __attribute__((always_inline)) Vector loadVector(const double * values)
+{
+    Vector vector;
+    std::memcpy(&vector, values, sizeof(vector));
+    return vector;
+}
+
+template <typename Vector> inline __attribute__((always_inline)) void storeVector(double * values, const Vector & vector)
+{
+    std::memcpy(values, &vector, sizeof(vector));
+}
+
+/**
+ * This function executes each instruction of program for the first padded (a whole number of vectors) x values of register 0 of registers, 
+ * one Vector (4 or 8 doubles) at a time. 
+ * The arithmetic operations and the square root are vector instructions, sine and cosine use vectorSine and vectorCosine 
+ * (for every vector whose elements are all within [-10^5, 10^5], where their range reduction is accurate, and the scalar libm functions otherwise), 
+ * and the other functions are evaluated one element at a time by applyExpressionOperationToBatch.
+ */
+template <typename Vector> inline __attribute__((always_inline)) void executeExpressionProgramVector(const ExpressionProgram & program, double * registers, int padded)
+{
+    constexpr int lanes = sizeof(Vector) / sizeof(double);
+    for (const ExpressionInstruction & instruction : program.instructions)
+    {
+        const double * left = registers + instruction.left * EXPRESSION_BATCH_SIZE, * right = registers + instruction.right * EXPRESSION_BATCH_SIZE;
+        double * destination = registers + instruction.destination * EXPRESSION_BATCH_SIZE;
+        switch (instruction.operation)
+        {
+            case ExpressionOperation::Add: for (int i = 0; i < padded; i += lanes) storeVector(destination + i, loadVector<Vector>(left + i) + loadVector<Vector>(right + i)); break;
+            case ExpressionOperation::Subtract: for (int i = 0; i < padded; i += lanes) storeVector(destination + i, loadVector<Vector>(left + i) - loadVector<Vector>(right + i)); break;
+            case ExpressionOperation::Multiply: for (int i = 0; i < padded; i += lanes) storeVector(destination + i, loadVector<Vector>(left + i) * loadVector<Vector>(right + i)); break;
+            case ExpressionOperation::Divide: for (int i = 0; i < padded; i += lanes) storeVector(destination + i, loadVector<Vector>(left + i) / loadVector<Vector>(right + i)); break;
+            case ExpressionOperation::Negate: for (int i = 0; i < padded; i += lanes) storeVector(destination + i, -loadVector<Vector>(left + i)); break;
+            case ExpressionOperation::Square: for (int i = 0; i < padded; i += lanes) { Vector value = loadVector<Vector>(left + i); storeVector(destination + i, value * value); } break;
+            case ExpressionOperation::Cube: for (int i = 0; i < padded; i += lanes) { Vector value = loadVector<Vector>(left + i); storeVector(destination + i, value * value * value); } break;
+            case ExpressionOperation::SquareRoot: for (int i = 0; i < padded; i += lanes) storeVector(destination + i, vectorSquareRoot(loadVector<Vector>(left + i))); break;
+            case ExpressionOperation::Sine:
+            case ExpressionOperation::Cosine:
+                for (int i = 0; i < padded; i += lanes)
+                {
+                    Vector value = loadVector<Vector>(left + i);
+                    bool reducible = true;
+                    for (int k = 0; k < lanes; k++) reducible = reducible && (std::fabs(value[k]) <= 1e5);
+                    if (!reducible) applyExpressionOperationToBatch(instruction.operation, left + i, right + i, destination + i, lanes);
+                    else storeVector(destination + i, (instruction.operation == ExpressionOperation::Sine) ? vectorSine(value) : vectorCosine(value));
+                }
+                break;
+            default: applyExpressionOperationToBatch(instruction.operation, left, right, destination, padded); break;
+        }
+    }
+}
+
+/**
+ * This function is the vectorized version of evaluateExpressionBatch: it stores f(x[i]) in y[i] for each i in [0, count) 
+ * (where f is the compiled userDefinedExpression) by executing the program for a batch of up to EXPRESSION_BATCH_SIZE x values at a time (see executeExpressionProgramVector). 
+ * The batch is padded with its last x value to a whole number of vectors (and the padding lanes are never stored in y).
+ */
+template <typename Vector> inline __attribute__((always_inline)) void evaluateExpressionBatchVector(const double * x, double * y, uint64_t count)
+{
+    constexpr int lanes = sizeof(Vector) / sizeof(double);
+    const ExpressionProgram & program = userDefinedExpression;
+    double * registers = loadExpressionRegisters(program);
+    for (uint64_t first = 0; first < count; first += EXPRESSION_BATCH_SIZE)
+    {
+        int size = ((count - first) < EXPRESSION_BATCH_SIZE) ? (int) (count - first) : EXPRESSION_BATCH_SIZE;
+        int padded = (size + lanes - 1) / lanes * lanes;
+        std::memcpy(registers, x + first, size * sizeof(double));
+        for (int i = size; i < padded; i++) registers[i] = registers[size - 1];
+        executeExpressionProgramVector<Vector>(program, registers, padded);
+        std::memcpy(y + first, registers + program.result * EXPRESSION_BATCH_SIZE, size * sizeof(double));
+    }
+}
+
+/**
+ * This function is the vectorized version of sumExpressionHeights: for each batch of up to EXPRESSION_BATCH_SIZE partitions, 
+ * it computes their x-axis points directly into register 0 with vector instructions (padded with the last x-axis point to a whole number of vectors), 
+ * executes the program (see executeExpressionProgramVector), and adds the whole vectors of the result register into four independent vector accumulators. 
+ * Because EXPRESSION_BATCH_SIZE and lanes are multiples of 4, the weight of each partition depends only on its lane (as in sumRectangleHeightsVector), 
+ * so each lane of the accumulated vector is multiplied by its weight once, at the end; 
+ * the (fewer than lanes) remaining heights of the last batch are multiplied by their own weights.
+ */
+template <typename Vector, Rule rule> inline __attribute__((always_inline)) double sumExpressionHeightsVector(double a, double dx, uint64_t first, uint64_t last)
+{
+    constexpr int lanes = sizeof(Vector) / sizeof(double);
+    const ExpressionProgram & program = userDefinedExpression;
+    double * registers = loadExpressionRegisters(program);
+    const double * heights = registers + program.result * EXPRESSION_BATCH_SIZE;
+    Vector lane = {}, sum0 = {}, sum1 = {}, sum2 = {}, sum3 = {};
+    for (int k = 0; k < lanes; k++) lane[k] = k;
+    double t = (double) first + offsetOfRule(rule), total = 0.0;
+    for (uint64_t i = first; i < last; i += EXPRESSION_BATCH_SIZE, t += EXPRESSION_BATCH_SIZE)
+    {
+        int count = ((last - i) < EXPRESSION_BATCH_SIZE) ? (int) (last - i) : EXPRESSION_BATCH_SIZE, k = 0;
+        int whole = count / lanes * lanes, padded = (count + lanes - 1) / lanes * lanes;
+        for (k = 0; k < padded; k += lanes) storeVector(registers + k, a + ((t + k) + lane) * dx);
+        for (k = count; k < padded; k++) registers[k] = registers[count - 1];
+        executeExpressionProgramVector<Vector>(program, registers, padded);
+
+        // Add the whole vectors of heights into four accumulators and the remaining heights (with their weights) into total.
+        for (k = 0; k + 4 * lanes <= whole; k += 4 * lanes)
+        {
+            sum0 += loadVector<Vector>(heights + k);
+            sum1 += loadVector<Vector>(heights + k + lanes);
+            sum2 += loadVector<Vector>(heights + k + 2 * lanes);
+            sum3 += loadVector<Vector>(heights + k + 3 * lanes);
+        }
+        for (; k < whole; k += lanes) sum0 += loadVector<Vector>(heights + k);
+        for (; k < count; k++) total += interiorWeightOfRule(rule, i + k) * heights[k];
+    }
+    Vector sum = (sum0 + sum1) + (sum2 + sum3);
+    for (int k = 0; k < lanes; k++) total += interiorWeightOfRule(rule, first + k) * sum[k];
+    return total;
+}
+
+/**
+ * These functions return a * b - c for every element with a single rounding (the fused multiply-subtract instruction), 
+ * which is what makes the product of two doubles exactly representable as a double-double (see vectorTwoProduct). 
+ * The 8-wide version uses its two 4-wide halves, because AVX-512 instructions cannot be used in this section.
+ */
+inline __attribute__((always_inline)) Double4 vectorFusedMultiplySubtract(const Double4 & a, const Double4 & b, const Double4 & c)
+{
+    return _mm256_fmsub_pd(a, b, c);
+}
+
+inline __attribute__((always_inline)) Double8 vectorFusedMultiplySubtract(const Double8 & a, const Double8 & b, const Double8 & c)
+{
+    Double4 low = _mm256_fmsub_pd((Double4) { a[0], a[1], a[2], a[3] }, (Double4) { b[0], b[1], b[2], b[3] }, (Double4) { c[0], c[1], c[2], c[3] });
+    Double4 high = _mm256_fmsub_pd((Double4) { a[4], a[5], a[6], a[7] }, (Double4) { b[4], b[5], b[6], b[7] }, (Double4) { c[4], c[5], c[6], c[7] });
+    return (Double8) { low[0], low[1], low[2], low[3], high[0], high[1], high[2], high[3] };
+}
+
+/**
+ * These functions are the vectorized versions of the double-double operations (see twoSum and the functions after it): 
+ * each one applies the scalar operation of the same name to every lane.
+ */
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> vectorTwoSum(const Vector & a, const Vector & b)
+{
+    Vector sum = a + b, virtualB = sum - a;
+    return { sum, (a - (sum - virtualB)) + (b - virtualB) };
+}
+
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> vectorQuickTwoSum(const Vector & a, const Vector & b)
+{
+    Vector sum = a + b;
+    return { sum, b - (sum - a) };
+}
+
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> vectorTwoProduct(const Vector & a, const Vector & b)
+{
+    Vector product = a * b;
+    return { product, vectorFusedMultiplySubtract(a, b, product) };
+}
+
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> vectorAddDoubleDouble(const DoubleDoubleVector<Vector> & x, const DoubleDoubleVector<Vector> & y)
+{
+    DoubleDoubleVector<Vector> sum = vectorTwoSum(x.high, y.high), lows = vectorTwoSum(x.low, y.low);
+    sum = vectorQuickTwoSum(sum.high, sum.low + lows.high);
+    return vectorQuickTwoSum(sum.high, sum.low + lows.low);
+}
+
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> vectorMultiplyDoubleDouble(const DoubleDoubleVector<Vector> & x, const DoubleDoubleVector<Vector> & y)
+{
+    DoubleDoubleVector<Vector> product = vectorTwoProduct(x.high, y.high);
+    return vectorQuickTwoSum(product.high, product.low + (x.high * y.low + x.low * y.high));
+}
+
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> vectorMultiplyDoubleDoubleByVector(const DoubleDoubleVector<Vector> & x, const Vector & d)
+{
+    DoubleDoubleVector<Vector> product = vectorTwoProduct(x.high, d);
+    return vectorQuickTwoSum(product.high, product.low + x.low * d);
+}
+
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> vectorSquareRootDoubleDouble(const DoubleDoubleVector<Vector> & x)
+{
+    Vector root = vectorSquareRoot(x.high);
+    DoubleDoubleVector<Vector> square = vectorTwoProduct(root, root);
+    DoubleDoubleVector<Vector> residual = vectorAddDoubleDouble(x, DoubleDoubleVector<Vector>{ -square.high, -square.low });
+    return vectorQuickTwoSum(root, residual.high / (2.0 * root + DBL_MIN));
+}
+
+/**
+ * This function is the vectorized version of sineOfQuadrantDoubleDouble (the reduction, the Taylor series, and the choice of quadrant are the same), 
+ * with the quadrant selected by arithmetic rather than by comparison masks (as in vectorSineOfQuadrant): 
+ * each lane evaluates one series, whose reciprocals (and final factor, r or 1) are those of the sine in even quadrants and of the cosine in odd ones 
+ * (selected exactly, since low is 0 or 1), so that no lane evaluates a series which it then discards.
+ */
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> vectorSineOfQuadrantDoubleDouble(const DoubleDoubleVector<Vector> & x, double quadrantShift)
+{
+    const double twoOverPi = 6.36619772367581382433e-01;
+    const double pio2Part1 = 1.57079632673412561417e+00, pio2Part2 = 6.07710050630396597660e-11, pio2Part3 = 2.02226624871116645580e-21, pio2Part4 = 8.47842766036889956997e-32;
+    Vector q = vectorRound(x.high * twoOverPi);
+    DoubleDoubleVector<Vector> r = vectorQuickTwoSum(x.high - q * pio2Part1, x.low), one = { Vector{} + 1.0, Vector{} };
+    r = vectorAddDoubleDouble(r, vectorTwoProduct(-q, Vector{} + pio2Part2));
+    r = vectorAddDoubleDouble(r, vectorTwoProduct(-q, Vector{} + pio2Part3));
+    r = vectorAddDoubleDouble(r, vectorTwoProduct(-q, Vector{} + pio2Part4));
+    Vector shifted = q + quadrantShift;
+    Vector k = shifted - 4.0 * vectorRound(shifted * 0.25 - 0.375);
+    Vector high = vectorRound(k * 0.5 - 0.25);
+    Vector low = k - 2.0 * high;
+    DoubleDoubleVector<Vector> z = vectorMultiplyDoubleDouble(r, r), series = one;
+    for (int term = DOUBLE_DOUBLE_TAYLOR_TERMS; term >= 1; term--)
+    {
+        const DoubleDouble & sineReciprocal = doubleDoubleTaylorTables.sine[term], & cosineReciprocal = doubleDoubleTaylorTables.cosine[term];
+        DoubleDoubleVector<Vector> reciprocal = { sineReciprocal.high * (1.0 - low) + cosineReciprocal.high * low, sineReciprocal.low * (1.0 - low) + cosineReciprocal.low * low };
+        DoubleDoubleVector<Vector> seriesTerm = vectorMultiplyDoubleDouble(vectorMultiplyDoubleDouble(z, series), reciprocal);
+        series = vectorAddDoubleDouble(one, DoubleDoubleVector<Vector>{ -seriesTerm.high, -seriesTerm.low });
+    }
+    series = vectorMultiplyDoubleDouble(DoubleDoubleVector<Vector>{ r.high * (1.0 - low) + low, r.low * (1.0 - low) }, series);
+    return { series.high * (1.0 - 2.0 * high), series.low * (1.0 - 2.0 * high) };
+}
+
+// These functions are the double-double versions of evaluateVector (i.e. each one returns f(x) for every double-double lane of x).
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> evaluateDoubleDoubleVector(SquareIntegrand, const DoubleDoubleVector<Vector> & x) { return vectorMultiplyDoubleDouble(x, x); }
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> evaluateDoubleDoubleVector(CubeIntegrand, const DoubleDoubleVector<Vector> & x) { return vectorMultiplyDoubleDouble(vectorMultiplyDoubleDouble(x, x), x); }
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> evaluateDoubleDoubleVector(SineIntegrand, const DoubleDoubleVector<Vector> & x) { return vectorSineOfQuadrantDoubleDouble(x, 0.0); }
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> evaluateDoubleDoubleVector(CosineIntegrand, const DoubleDoubleVector<Vector> & x) { return vectorSineOfQuadrantDoubleDouble(x, 1.0); }
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> evaluateDoubleDoubleVector(SquareRootIntegrand, const DoubleDoubleVector<Vector> & x) { return vectorSquareRootDoubleDouble(x); }
+template <typename Vector> inline __attribute__((always_inline)) DoubleDoubleVector<Vector> evaluateDoubleDoubleVector(LinearIntegrand, const DoubleDoubleVector<Vector> & x) { return vectorAddDoubleDouble(DoubleDoubleVector<Vector>{ 2.0 * x.high, 2.0 * x.low }, DoubleDoubleVector<Vector>{ Vector{} + 3.0, Vector{} }); }
+
+/**
+ * This function is the vectorized version of sumDoubleDoubleHeights: each lane computes its x-axis point a + t * dx and f of that point in double-double arithmetic 
+ * and adds it to its own double-double sum, and the lane sums (and the heights of the remaining rectangles) are added at the end.
+ */
+template <typename Vector, typename Integrand> inline __attribute__((always_inline)) DoubleDouble sumDoubleDoubleHeightsVector(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last)
+{
+    constexpr int lanes = sizeof(Vector) / sizeof(double);
+    const Integrand func = Integrand();
+    const DoubleDoubleVector<Vector> start = { Vector{} + a.high, Vector{} + a.low }, width = { Vector{} + dx.high, Vector{} + dx.low };
+    DoubleDoubleVector<Vector> sum = { Vector{}, Vector{} };
+    Vector lane = {};
+    for (int k = 0; k < lanes; k++) lane[k] = k;
+    double t = (double) first + offset;
+    uint64_t i = first;
+    for (; i + lanes <= last; i += lanes, t += lanes)
+    {
+        DoubleDoubleVector<Vector> x = vectorAddDoubleDouble(start, vectorMultiplyDoubleDoubleByVector(width, t + lane));
+        sum = vectorAddDoubleDouble(sum, evaluateDoubleDoubleVector(func, x));
+    }
+    DoubleDouble total = { 0.0, 0.0 };
+    for (int k = 0; k < lanes; k++) total = addDoubleDouble(total, DoubleDouble{ sum.high[k], sum.low[k] });
+    for (; i < last; ++i, t += 1.0) total = addDoubleDouble(total, evaluateDoubleDouble(func, addDoubleDouble(a, multiplyDoubleDoubleByDouble(dx, t))));
+    return total;
+}
+
+#pragma GCC diagnostic pop
+#pragma GCC pop_options
+
+// These functions are the AVX2 (4 doubles per vector) and AVX-512 (8 doubles per vector) instantiations of evaluateExpressionBatchVector.
+__attribute__((target("avx2,fma"))) void evaluateExpressionBatchAvx2(const double * x, double * y, uint64_t count)
+{
+    evaluateExpressionBatchVector<Double4>(x, y, count);
+}
+
+__attribute__((target("avx512f,avx2,fma"))) void evaluateExpressionBatchAvx512(const double * x, double * y, uint64_t count)
+{
+    evaluateExpressionBatchVector<Double8>(x, y, count);
+}
+
+// These functions are the AVX2 (4 doubles per vector) and AVX-512 (8 doubles per vector) instantiations of sumExpressionHeightsVector.
+template <Rule rule> __attribute__((target("avx2,fma"))) double sumExpressionHeightsAvx2(double a, double dx, uint64_t first, uint64_t last)
+{
+    return sumExpressionHeightsVector<Double4, rule>(a, dx, first, last);
+}
+
+template <Rule rule> __attribute__((target("avx512f,avx2,fma"))) double sumExpressionHeightsAvx512(double a, double dx, uint64_t first, uint64_t last)
+{
+    return sumExpressionHeightsVector<Double8, rule>(a, dx, first, last);
+}
+
+// These functions are the AVX2 (4 doubles per vector) and AVX-512 (8 doubles per vector) instantiations of sumCompensatedVector.
+__attribute__((target("avx2,fma"))) double sumCompensatedAvx2(const double * values, uint64_t count, double & error)
+{
+    return sumCompensatedVector<Double4>(values, count, error);
+}
+
+__attribute__((target("avx512f,avx2,fma"))) double sumCompensatedAvx512(const double * values, uint64_t count, double & error)
+{
+    return sumCompensatedVector<Double8>(values, count, error);
+}
+
+// These functions are the AVX2 (4 doubles per vector) and AVX-512 (8 doubles per vector) instantiations of sumRectangleHeightsVector.
+template <typename Integrand, Rule rule> __attribute__((target("avx2,fma"))) double sumRectangleHeightsAvx2(double a, double dx, uint64_t first, uint64_t last)
+{
+    return sumRectangleHeightsVector<Double4, Integrand, rule>(a, dx, first, last);
+}
+
+template <typename Integrand, Rule rule> __attribute__((target("avx512f,avx2,fma"))) double sumRectangleHeightsAvx512(double a, double dx, uint64_t first, uint64_t last)
+{
+    return sumRectangleHeightsVector<Double8, Integrand, rule>(a, dx, first, last);
+}
+
+// These functions are the AVX2 (4 double-doubles per vector) and AVX-512 (8 double-doubles per vector) instantiations of sumDoubleDoubleHeightsVector.
+template <typename Integrand> __attribute__((target("avx2,fma"))) DoubleDouble sumDoubleDoubleHeightsAvx2(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last)
+{
+    return sumDoubleDoubleHeightsVector<Double4, Integrand>(a, dx, offset, first, last);
+}
+
+template <typename Integrand> __attribute__((target("avx512f,avx2,fma"))) DoubleDouble sumDoubleDoubleHeightsAvx512(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last)
+{
+    return sumDoubleDoubleHeightsVector<Double8, Integrand>(a, dx, offset, first, last);
+}
+
+/**
+ * These functions store f(x[i]) in y[i] for each i in [0, count) (where f is the function evaluated by Integrand) 
+ * using scalar code, 4-wide AVX2 vectors, or 8-wide AVX-512 vectors respectively.
+ */
+template <typename Integrand> void evaluateBatch(const double * x, double * y, uint64_t count)
+{
+    const Integrand func = Integrand();
+    for (uint64_t i = 0; i < count; i++) y[i] = func(x[i]);
+}
+
+template <typename Integrand> __attribute__((target("avx2,fma"))) void evaluateBatchAvx2(const double * x, double * y, uint64_t count)
+{
+    const Integrand func = Integrand();
+    uint64_t i = 0;
+    for (; i + 4 <= count; i += 4)
+    {
+        Double4 vector;
+        std::memcpy(&vector, x + i, sizeof(vector));
+        vector = evaluateVector(func, vector);
+        std::memcpy(y + i, &vector, sizeof(vector));
+    }
+    for (; i < count; i++) y[i] = func(x[i]);
+}
+
+template <typename Integrand> __attribute__((target("avx512f,avx2,fma"))) void evaluateBatchAvx512(const double * x, double * y, uint64_t count)
+{
+    const Integrand func = Integrand();
+    uint64_t i = 0;
+    for (; i + 8 <= count; i += 8)
+    {
+        Double8 vector;
+        std::memcpy(&vector, x + i, sizeof(vector));
+        vector = evaluateVector(func, vector);
+        std::memcpy(y + i, &vector, sizeof(vector));
+    }
+    for (; i < count; i++) y[i] = func(x[i]);
+}
+
+/**
+ * These functions store f(coordinates[0][i], ..., coordinates[dimension - 1][i]) in y[i] for each i in [0, count) (where f is the function evaluated by BoxIntegrand) 
+ * using scalar code, 4-wide AVX2 vectors, or 8-wide AVX-512 vectors respectively.
+ */
+template <typename BoxIntegrand> void evaluateBoxBatch(const double * const * coordinates, int dimension, double * y, uint64_t count)
+{
+    const BoxIntegrand func = BoxIntegrand();
+    for (uint64_t i = 0; i < count; i++)
+    {
+        double value = func.start();
+        for (int k = 0; k < dimension; k++) value = func.combine(value, coordinates[k][i]);
+        y[i] = func.finish(value);
+    }
+}
+
+template <typename BoxIntegrand> __attribute__((target("avx2,fma"))) void evaluateBoxBatchAvx2(const double * const * coordinates, int dimension, double * y, uint64_t count)
+{
+    const BoxIntegrand func = BoxIntegrand();
+    uint64_t i = 0;
+    for (; i + 4 <= count; i += 4) evaluateBoxVector<Double4>(func, coordinates, dimension, y, i);
+    for (; i < count; i++)
+    {
+        double value = func.start();
+        for (int k = 0; k < dimension; k++) value = func.combine(value, coordinates[k][i]);
+        y[i] = func.finish(value);
+    }
+}
+
+template <typename BoxIntegrand> __attribute__((target("avx512f,avx2,fma"))) void evaluateBoxBatchAvx512(const double * const * coordinates, int dimension, double * y, uint64_t count)
+{
+    const BoxIntegrand func = BoxIntegrand();
+    uint64_t i = 0;
+    for (; i + 8 <= count; i += 8) evaluateBoxVector<Double8>(func, coordinates, dimension, y, i);
+    for (; i < count; i++)
+    {
+        double value = func.start();
+        for (int k = 0; k < dimension; k++) value = func.combine(value, coordinates[k][i]);
+        y[i] = func.finish(value);
+    }
+}
+
+/**
+ * This function returns the widest instruction set which both this processor and the operating system support 
+ * (AVX-512 if the AVX-512 foundation instructions are available, otherwise AVX2 if both AVX2 and FMA are available, otherwise scalar code).
+ */
+InstructionSet detectInstructionSet()
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f")) return InstructionSet::Avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) return InstructionSet::Avx2;
+    return InstructionSet::Scalar;
+}
+
+// This function returns the name of instructionSet ("scalar", "AVX2", or "AVX-512").
+std::string nameOfInstructionSet(InstructionSet instructionSet)
+{
+    if (instructionSet == InstructionSet::Avx512) return "AVX-512";
+    if (instructionSet == InstructionSet::Avx2) return "AVX2";
+    return "scalar";
+}
+
+/**
+ * This function returns the instantiation of sumRectangleHeights (or of its AVX2 or AVX-512 version) which is specialized 
+ * for the function whose option number (in the list displayed by selectFunctionFromListOfFunctions) is functionOption, 
+ * for the rectangle construction method named by rule, and for instructionSet 
+ * (or a null pointer if functionOption is not the option number of any function in that list, or if rule is GaussLegendre, which has no compiled kernel). 
+ * The kernels of the user-defined function (option USER_DEFINED_FUNCTION_OPTION) evaluate the compiled userDefinedExpression (see sumExpressionHeights).
+ * 
+ * The caller is responsible for passing an instructionSet which the processor supports (e.g. the one returned by detectInstructionSet).
+ */
+RiemannKernel selectRiemannKernel(int functionOption, Rule rule, InstructionSet instructionSet)
+{
+    // Store one function per row of kernels (in menu order).
+    static RiemannKernel (* const selectors[NUMBER_OF_FUNCTIONS])(Rule, InstructionSet) = {
+        selectRiemannKernelForIntegrand<SquareIntegrand>, selectRiemannKernelForIntegrand<CubeIntegrand>, selectRiemannKernelForIntegrand<SineIntegrand>, 
+        selectRiemannKernelForIntegrand<CosineIntegrand>, selectRiemannKernelForIntegrand<SquareRootIntegrand>, selectRiemannKernelForIntegrand<LinearIntegrand>
+    };
+    if ((functionOption == USER_DEFINED_FUNCTION_OPTION) && (userDefinedExpression.identifier != 0) && ((int) rule < NUMBER_OF_RULES)) return selectExpressionKernel(rule, instructionSet);
+    if ((functionOption < 0) || (functionOption >= NUMBER_OF_FUNCTIONS) || ((int) rule >= NUMBER_OF_RULES)) return nullptr;
+    return selectors[functionOption](rule, instructionSet);
+}
+
+/**
+ * This function returns the kernel for the function evaluated by Integrand, the rule named by rule (which must have a compiled kernel), and instructionSet. 
+ * Each instantiation stores one table per instruction set, with one kernel per rule (in the order left, right, midpoint, trapezoid, Simpson, Boole).
+ */
+template <typename Integrand> RiemannKernel selectRiemannKernelForIntegrand(Rule rule, InstructionSet instructionSet)
+{
+    static const RiemannKernel kernels[NUMBER_OF_INSTRUCTION_SETS][NUMBER_OF_RULES] = {
+        { sumRectangleHeights<Integrand, Rule::Left>, sumRectangleHeights<Integrand, Rule::Right>, sumRectangleHeights<Integrand, Rule::Midpoint>, 
+          sumRectangleHeights<Integrand, Rule::Trapezoid>, sumRectangleHeights<Integrand, Rule::Simpson>, sumRectangleHeights<Integrand, Rule::Boole> },
+        { sumRectangleHeightsAvx2<Integrand, Rule::Left>, sumRectangleHeightsAvx2<Integrand, Rule::Right>, sumRectangleHeightsAvx2<Integrand, Rule::Midpoint>, 
+          sumRectangleHeightsAvx2<Integrand, Rule::Trapezoid>, sumRectangleHeightsAvx2<Integrand, Rule::Simpson>, sumRectangleHeightsAvx2<Integrand, Rule::Boole> },
+        { sumRectangleHeightsAvx512<Integrand, Rule::Left>, sumRectangleHeightsAvx512<Integrand, Rule::Right>, sumRectangleHeightsAvx512<Integrand, Rule::Midpoint>, 
+          sumRectangleHeightsAvx512<Integrand, Rule::Trapezoid>, sumRectangleHeightsAvx512<Integrand, Rule::Simpson>, sumRectangleHeightsAvx512<Integrand, Rule::Boole> }
+    };
+    return kernels[(int) instructionSet][(int) rule];
+}
+
+/**
+ * This function returns the batch evaluator for the function whose option number is functionOption and for instructionSet 
+ * (or a null pointer if functionOption is not the option number of any function in the list displayed by selectFunctionFromListOfFunctions, 
+ * including the user-defined function if no expression was compiled).
+ */
+BatchEvaluator selectBatchEvaluator(int functionOption, InstructionSet instructionSet)
+{
+    static const BatchEvaluator evaluators[NUMBER_OF_INSTRUCTION_SETS][NUMBER_OF_FUNCTIONS] = {
+        { evaluateBatch<SquareIntegrand>, evaluateBatch<CubeIntegrand>, evaluateBatch<SineIntegrand>, evaluateBatch<CosineIntegrand>, evaluateBatch<SquareRootIntegrand>, evaluateBatch<LinearIntegrand> },
+        { evaluateBatchAvx2<SquareIntegrand>, evaluateBatchAvx2<CubeIntegrand>, evaluateBatchAvx2<SineIntegrand>, evaluateBatchAvx2<CosineIntegrand>, evaluateBatchAvx2<SquareRootIntegrand>, evaluateBatchAvx2<LinearIntegrand> },
+        { evaluateBatchAvx512<SquareIntegrand>, evaluateBatchAvx512<CubeIntegrand>, evaluateBatchAvx512<SineIntegrand>, evaluateBatchAvx512<CosineIntegrand>, evaluateBatchAvx512<SquareRootIntegrand>, evaluateBatchAvx512<LinearIntegrand> }
+    };
+    static const BatchEvaluator expressionEvaluators[NUMBER_OF_INSTRUCTION_SETS] = { evaluateExpressionBatch, evaluateExpressionBatchAvx2, evaluateExpressionBatchAvx512 };
+    if ((functionOption == USER_DEFINED_FUNCTION_OPTION) && (userDefinedExpression.identifier != 0)) return expressionEvaluators[(int) instructionSet];
+    if ((functionOption < 0) || (functionOption >= NUMBER_OF_FUNCTIONS)) return nullptr;
+    return evaluators[(int) instructionSet][functionOption];
+}
+
+/**
+ * This function returns the box evaluator for the box function whose option number is functionOption (see nameOfBoxFunction) and for instructionSet 
+ * (or a null pointer if functionOption is not 0 through NUMBER_OF_BOX_FUNCTIONS - 1).
+ */
+BoxEvaluator selectBoxEvaluator(int functionOption, InstructionSet instructionSet)
+{
+    static const BoxEvaluator evaluators[NUMBER_OF_INSTRUCTION_SETS][NUMBER_OF_BOX_FUNCTIONS] = {
+        { evaluateBoxBatch<SumOfSquaresBoxIntegrand>, evaluateBoxBatch<ProductOfCosinesBoxIntegrand>, evaluateBoxBatch<SineOfSumBoxIntegrand> },
+        { evaluateBoxBatchAvx2<SumOfSquaresBoxIntegrand>, evaluateBoxBatchAvx2<ProductOfCosinesBoxIntegrand>, evaluateBoxBatchAvx2<SineOfSumBoxIntegrand> },
+        { evaluateBoxBatchAvx512<SumOfSquaresBoxIntegrand>, evaluateBoxBatchAvx512<ProductOfCosinesBoxIntegrand>, evaluateBoxBatchAvx512<SineOfSumBoxIntegrand> }
+    };
+    if ((functionOption < 0) || (functionOption >= NUMBER_OF_BOX_FUNCTIONS)) return nullptr;
+    return evaluators[(int) instructionSet][functionOption];
+}
+
+/**
+ * These functions are the error-free transformations on which double-double arithmetic is built: 
+ * twoSum returns a + b as the double-double (fl(a + b), exact rounding error), quickTwoSum does the same with fewer operations if |a| >= |b|, 
+ * and twoProduct returns a * b as the double-double (fl(a * b), exact rounding error) using one fused multiply-add.
+ */
+DoubleDouble twoSum(double a, double b)
+{
+    double sum = a + b, virtualB = sum - a;
+    return { sum, (a - (sum - virtualB)) + (b - virtualB) };
+}
+
+DoubleDouble quickTwoSum(double a, double b)
+{
+    double sum = a + b;
+    return { sum, b - (sum - a) };
+}
+
+DoubleDouble twoProduct(double a, double b)
+{
+    double product = a * b;
+    return { product, std::fma(a, b, -product) };
+}
+
+/**
+ * These functions return -x, x + y, x * y, x * d, and x / d in double-double arithmetic 
+ * (x + y is the accurate version which adds the high and low parts separately, so it is also accurate when x and y nearly cancel).
+ */
+DoubleDouble negateDoubleDouble(DoubleDouble x)
+{
+    return { -x.high, -x.low };
+}
+
+DoubleDouble addDoubleDouble(DoubleDouble x, DoubleDouble y)
+{
+    DoubleDouble sum = twoSum(x.high, y.high), lows = twoSum(x.low, y.low);
+    sum = quickTwoSum(sum.high, sum.low + lows.high);
+    return quickTwoSum(sum.high, sum.low + lows.low);
+}
+
+DoubleDouble multiplyDoubleDouble(DoubleDouble x, DoubleDouble y)
+{
+    DoubleDouble product = twoProduct(x.high, y.high);
+    return quickTwoSum(product.high, product.low + (x.high * y.low + x.low * y.high));
+}
+
+DoubleDouble multiplyDoubleDoubleByDouble(DoubleDouble x, double d)
+{
+    DoubleDouble product = twoProduct(x.high, d);
+    return quickTwoSum(product.high, product.low + x.low * d);
+}
+
+DoubleDouble divideDoubleDoubleByDouble(DoubleDouble x, double d)
+{
+    double quotient = x.high / d;
+    DoubleDouble product = twoProduct(quotient, d), remainder = twoSum(x.high, -product.high);
+    return quickTwoSum(quotient, (remainder.high + (remainder.low + (x.low - product.low))) / d);
+}
+
+/**
+ * This function returns the square root of x (where x is not negative) in double-double arithmetic: 
+ * one Newton step from the double square root r of the high part, i.e. r + (x - r^2) / (2r), with r^2 computed exactly by twoProduct.
+ */
+DoubleDouble squareRootDoubleDouble(DoubleDouble x)
+{
+    double root = std::sqrt(x.high);
+    DoubleDouble square = twoProduct(root, root), residual = addDoubleDouble(x, negateDoubleDouble(square));
+    return quickTwoSum(root, residual.high / (2.0 * root + DBL_MIN));
+}
+
+/**
+ * This function returns sin(x + quadrantShift * pi / 2) in double-double arithmetic (so quadrantShift = 1 returns cos(x)). 
+ * 
+ * x is reduced to r = x - q * pi / 2 with |r| <= pi / 4 by subtracting q times each of the four parts of pi / 2 (which vectorSineOfQuadrant also uses; 
+ * the first product is exact, and the others are added as exact double-double products). The quadrant (q + quadrantShift) mod 4 chooses between sin(r), cos(r), -sin(r), and -cos(r), 
+ * so only the Taylor series of DOUBLE_DOUBLE_TAYLOR_TERMS terms in Horner form (see doubleDoubleTaylorTables) which that quadrant needs is evaluated 
+ * (both series have the same form, 1 - z * term * reciprocal[k], and differ only in their reciprocals and in the final factor r of the sine).
+ */
+DoubleDouble sineOfQuadrantDoubleDouble(DoubleDouble x, int quadrantShift)
+{
+    const double twoOverPi = 6.36619772367581382433e-01;
+    const double pio2Part1 = 1.57079632673412561417e+00, pio2Part2 = 6.07710050630396597660e-11, pio2Part3 = 2.02226624871116645580e-21, pio2Part4 = 8.47842766036889956997e-32;
+    double q = std::nearbyint(x.high * twoOverPi);
+    DoubleDouble r = quickTwoSum(x.high - q * pio2Part1, x.low), one = { 1.0, 0.0 };
+    r = addDoubleDouble(r, twoProduct(-q, pio2Part2));
+    r = addDoubleDouble(r, twoProduct(-q, pio2Part3));
+    r = addDoubleDouble(r, twoProduct(-q, pio2Part4));
+    int quadrant = (int) (((int64_t) q + quadrantShift) & 3);
+    const DoubleDouble * reciprocals = (quadrant % 2 == 0) ? doubleDoubleTaylorTables.sine : doubleDoubleTaylorTables.cosine;
+    DoubleDouble z = multiplyDoubleDouble(r, r), series = one;
+    for (int k = DOUBLE_DOUBLE_TAYLOR_TERMS; k >= 1; k--) series = addDoubleDouble(one, negateDoubleDouble(multiplyDoubleDouble(multiplyDoubleDouble(z, series), reciprocals[k])));
+    if (quadrant % 2 == 0) series = multiplyDoubleDouble(r, series);
+    return (quadrant >= 2) ? negateDoubleDouble(series) : series;
+}
+
+// These functions are the double-double versions of the integrands of the menu (i.e. each one returns f(x) in double-double arithmetic).
+DoubleDouble evaluateDoubleDouble(SquareIntegrand, DoubleDouble x) { return multiplyDoubleDouble(x, x); }
+DoubleDouble evaluateDoubleDouble(CubeIntegrand, DoubleDouble x) { return multiplyDoubleDouble(multiplyDoubleDouble(x, x), x); }
+DoubleDouble evaluateDoubleDouble(SineIntegrand, DoubleDouble x) { return sineOfQuadrantDoubleDouble(x, 0); }
+DoubleDouble evaluateDoubleDouble(CosineIntegrand, DoubleDouble x) { return sineOfQuadrantDoubleDouble(x, 1); }
+DoubleDouble evaluateDoubleDouble(SquareRootIntegrand, DoubleDouble x) { return squareRootDoubleDouble(x); }
+DoubleDouble evaluateDoubleDouble(LinearIntegrand, DoubleDouble x) { return addDoubleDouble(DoubleDouble{ 2.0 * x.high, 2.0 * x.low }, DoubleDouble{ 3.0, 0.0 }); }
+
+/**
+ * This function returns the double-double sum of f(a + (i + offset) * dx) for each i in [first, last), 
+ * where both the x-axis point and the height are computed in double-double arithmetic (so the sum is not limited by the 53-bit x-axis points of the double kernels).
+ */
+template <typename Integrand> DoubleDouble sumDoubleDoubleHeights(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last)
+{
+    const Integrand func = Integrand();
+    DoubleDouble total = { 0.0, 0.0 };
+    double t = (double) first + offset;
+    for (uint64_t i = first; i < last; ++i, t += 1.0) total = addDoubleDouble(total, evaluateDoubleDouble(func, addDoubleDouble(a, multiplyDoubleDoubleByDouble(dx, t))));
+    return total;
+}
+
+/**
+ * This function is the version of sumDoubleDoubleHeights for processors with FMA instructions (see selectDoubleDoubleKernel): 
+ * flatten inlines the double-double operations into it, so that the std::fma of twoProduct is one instruction 
+ * (rather than a call to the fma function of the C library, as in the default build, which does not assume FMA instructions).
+ */
+template <typename Integrand> __attribute__((target("fma"), flatten)) DoubleDouble sumDoubleDoubleHeightsFma(DoubleDouble a, DoubleDouble dx, double offset, uint64_t first, uint64_t last)
+{
+    return sumDoubleDoubleHeights<Integrand>(a, dx, offset, first, last);
+}
+
+/**
+ * This function returns the double-double kernel for the function whose option number is functionOption and for instructionSet 
+ * (or a null pointer if functionOption is not 0 through 5, since the user-defined function f(x) is only compiled to double arithmetic). 
+ * The scalar kernels are those of sumDoubleDoubleHeightsFma if the processor has FMA instructions.
+ */
+DoubleDoubleKernel selectDoubleDoubleKernel(int functionOption, InstructionSet instructionSet)
+{
+    static const DoubleDoubleKernel fmaKernels[6] = { sumDoubleDoubleHeightsFma<SquareIntegrand>, sumDoubleDoubleHeightsFma<CubeIntegrand>, sumDoubleDoubleHeightsFma<SineIntegrand>, sumDoubleDoubleHeightsFma<CosineIntegrand>, sumDoubleDoubleHeightsFma<SquareRootIntegrand>, sumDoubleDoubleHeightsFma<LinearIntegrand> };
+    static const DoubleDoubleKernel kernels[NUMBER_OF_INSTRUCTION_SETS][6] = {
+        { sumDoubleDoubleHeights<SquareIntegrand>, sumDoubleDoubleHeights<CubeIntegrand>, sumDoubleDoubleHeights<SineIntegrand>, sumDoubleDoubleHeights<CosineIntegrand>, sumDoubleDoubleHeights<SquareRootIntegrand>, sumDoubleDoubleHeights<LinearIntegrand> },
+        { sumDoubleDoubleHeightsAvx2<SquareIntegrand>, sumDoubleDoubleHeightsAvx2<CubeIntegrand>, sumDoubleDoubleHeightsAvx2<SineIntegrand>, sumDoubleDoubleHeightsAvx2<CosineIntegrand>, sumDoubleDoubleHeightsAvx2<SquareRootIntegrand>, sumDoubleDoubleHeightsAvx2<LinearIntegrand> },
+        { sumDoubleDoubleHeightsAvx512<SquareIntegrand>, sumDoubleDoubleHeightsAvx512<CubeIntegrand>, sumDoubleDoubleHeightsAvx512<SineIntegrand>, sumDoubleDoubleHeightsAvx512<CosineIntegrand>, sumDoubleDoubleHeightsAvx512<SquareRootIntegrand>, sumDoubleDoubleHeightsAvx512<LinearIntegrand> }
+    };
+    if ((functionOption < 0) || (functionOption > 5)) return nullptr;
+    if ((instructionSet == InstructionSet::Scalar) && __builtin_cpu_supports("fma")) return fmaKernels[functionOption];
+    return kernels[(int) instructionSet][functionOption];
+}
+
+/**
+ * This function returns x in scientific notation with digits significant digits (truncated, not rounded), 
+ * e.g. "2.0100075033995546986727138342337e+00" (since printing x.high and x.low separately would not show the digits of the sum).
+ */
+std::string doubleDoubleToString(DoubleDouble x, int digits)
+{
+    if (!std::isfinite(x.high)) return std::to_string(x.high);
+    if (x.high == 0.0) return "0";
+    std::string text = (x.high < 0.0) ? "-" : "";
+    if (x.high < 0.0) x = negateDoubleDouble(x);
+    int exponent = (int) std::floor(std::log10(x.high));
+    for (int k = 0; k < exponent; k++) x = divideDoubleDoubleByDouble(x, 10.0);
+    for (int k = 0; k > exponent; k--) x = multiplyDoubleDoubleByDouble(x, 10.0);
+    while (x.high >= 10.0) { x = divideDoubleDoubleByDouble(x, 10.0); exponent++; }
+    while (x.high < 1.0) { x = multiplyDoubleDoubleByDouble(x, 10.0); exponent--; }
+    for (int k = 0; k < digits; k++)
+    {
+        double digit = std::floor(x.high);
+        if ((x.high == digit) && (x.low < 0.0)) digit -= 1.0;
+        digit = std::fmin(std::fmax(digit, 0.0), 9.0);
+        text += (char) ('0' + (int) digit);
+        if (k == 0) text += '.';
+        x = multiplyDoubleDoubleByDouble(addDoubleDouble(x, DoubleDouble{ -digit, 0.0 }), 10.0);
+    }
+    char suffix[16];
+    snprintf(suffix, sizeof(suffix), "e%+03d", exponent);
+    return text + suffix;
+}
+
+/**
+ * This function returns sin(x + quadrantShift * pi / 2) in __float128 arithmetic (113-bit significands), computed in the same way as sineOfQuadrantDoubleDouble 
+ * with FLOAT128_TAYLOR_TERMS terms (GCC provides __float128 addition, multiplication, and division in software, but its sine is in libquadmath, which this program does not link).
+ */
+__float128 sineOfQuadrantFloat128(__float128 x, int quadrantShift)
+{
+    const __float128 pio2 = (__float128) 1.57079632673412561417e+00 + (__float128) 6.07710050630396597660e-11 + (__float128) 2.02226624871116645580e-21 + (__float128) 8.47842766036889956997e-32;
+    double q = std::nearbyint((double) x * 6.36619772367581382433e-01);
+    static const std::vector<__float128> sineReciprocals = [] { std::vector<__float128> values(FLOAT128_TAYLOR_TERMS + 1); for (int k = 1; k <= FLOAT128_TAYLOR_TERMS; k++) values[k] = 1 / ((__float128) (2 * k) * (2 * k + 1)); return values; }();
+    static const std::vector<__float128> cosineReciprocals = [] { std::vector<__float128> values(FLOAT128_TAYLOR_TERMS + 1); for (int k = 1; k <= FLOAT128_TAYLOR_TERMS; k++) values[k] = 1 / ((__float128) (2 * k - 1) * (2 * k)); return values; }();
+    __float128 r = x - (__float128) q * pio2, z = r * r, sine = 1, cosine = 1;
+    for (int k = FLOAT128_TAYLOR_TERMS; k >= 1; k--)
+    {
+        sine = 1 - z * sine * sineReciprocals[k];
+        cosine = 1 - z * cosine * cosineReciprocals[k];
+    }
+    sine = r * sine;
+    int quadrant = (int) (((int64_t) q + quadrantShift) & 3);
+    if (quadrant == 0) return sine;
+    if (quadrant == 1) return cosine;
+    if (quadrant == 2) return -sine;
+    return -cosine;
+}
+
+// This function returns f(x) in __float128 arithmetic for the function whose option number is functionOption (0 through 5).
+__float128 evaluateFloat128(int functionOption, __float128 x)
+{
+    if (functionOption == 0) return x * x;
+    if (functionOption == 1) return x * x * x;
+    if (functionOption == 2) return sineOfQuadrantFloat128(x, 0);
+    if (functionOption == 3) return sineOfQuadrantFloat128(x, 1);
+    if (functionOption == 4)
+    {
+        if (x <= 0) return 0;
+        __float128 root = std::sqrt((double) x);
+        for (int k = 0; k < 2; k++) root = (root + x / root) / 2; // two Newton steps from the double square root (53 to 113 bits)
+        return root;
+    }
+    return 2 * x + 3;
+}
+
+/**
+ * This function returns the Riemann sum of the function whose option number is functionOption over [a,b] with n partitions (and the given offset of the rule) 
+ * computed entirely in __float128 arithmetic, converted to a double-double (which represents every __float128 value to within its own 106 bits).
+ */
+DoubleDouble sumInFloat128(int functionOption, double a, double b, uint64_t n, double offset)
+{
+    __float128 dx = ((__float128) b - (__float128) a) / (__float128) n, sum = 0;
+    for (uint64_t i = 0; i < n; i++) sum += evaluateFloat128(functionOption, (__float128) a + ((__float128) i + offset) * dx);
+    sum *= dx;
+    double high = (double) sum;
+    return { high, (double) (sum - high) };
+}
+
+// This function returns f(x) in long double arithmetic for the function whose option number is functionOption (0 through 5).
+long double evaluateLongDouble(int functionOption, long double x)
+{
+    if (functionOption == 0) return x * x;
+    if (functionOption == 1) return x * x * x;
+    if (functionOption == 2) return std::sin(x);
+    if (functionOption == 3) return std::cos(x);
+    if (functionOption == 4) return std::sqrt(x);
+    return 2.0L * x + 3.0L;
+}
+
+// This function returns the Riemann sum of the function whose option number is functionOption over [a,b] with n partitions computed entirely in long double arithmetic.
+DoubleDouble sumInLongDouble(int functionOption, double a, double b, uint64_t n, double offset)
+{
+    long double dx = ((long double) b - (long double) a) / (long double) n, sum = 0.0L;
+    for (uint64_t i = 0; i < n; i++) sum += evaluateLongDouble(functionOption, (long double) a + ((long double) i + offset) * dx);
+    sum *= dx;
+    double high = (double) sum;
+    return { high, (double) (sum - high) };
+}
+
+/**
+ * This function runs the non-interactive mode named by the first command line argument and returns that mode's exit status.
+ * 
+ * The supported modes are:
+ * 
+ * ./app --simd-accuracy
+ * (compare the AVX2 and AVX-512 versions of each function in the list against the scalar libm version of that function)
+ * 
+ * ./app --scaling [function=0..5] [method=left|right|midpoint] [a=...] [b=...] [n=...]
+ * (time the parallel Riemann sum on 1, 2, 4, ... threads up to the number of cores and print the speedup and scaling efficiency of each)
+ * 
+ * ./app --accumulators [function=0..5] [method=left|right|midpoint] [a=...] [b=...] [n=...]
+ * (print the cost per element and the rounding error of each accumulator)
+ * 
+ * ./app --rules [function=0..5] [a=...] [b=...] [tolerance=...]
+ * (print how many function evaluations each rule needs to come within tolerance of the exact integral)
+ * 
+ * ./app --adaptive [function=0..5] [a=...] [b=...] [tolerance=...] [relative=...]
+ * (print the result, error bound, and evaluations of adaptive quadrature next to the evaluations which the uniform rules need)
+ * 
+ * ./app --romberg [function=0..5] [a=...] [b=...] [tolerance=...] [relative=...]
+ * (print the Romberg tableau diagonal, which reuses every evaluation of the previous trapezoid rule when n doubles)
+ * 
+ * ./app --expression [expression=...] [a=...] [b=...] [n=...]
+ * (print the compiled program of an expression and time it, or compare the compiled text of each built-in function with its compiled kernel)
+ * 
+ * ./app --closed-form [function=0|1|5|6] [a=...] [b=...] [n=...] [compare=0|1]
+ * (compare every rule computed by the numeric engine with its closed form, for each polynomial function or for the given one; 
+ * the numeric sums are skipped for n larger than one hundred million unless compare=1 is given)
+ * 
+ * ./app --cache [function=0..6] [method=...] [a=...] [b=...] [n=...] [capacity=...] [file=...]
+ * (exercise the exact, composed, and evicting paths of the result cache, optionally backed by a file)
+ * 
+ * ./app --batch [jobs=...] [output=...] [count=...] [seed=...] [compare=0|1] [threads=...]
+ * (compute every job of a job file unattended, or time a batch of random jobs against computing them one at a time)
+ * 
+ * ./app --box [function=0..2] [method=...] [dimension=1..8] [a=...] [b=...] [points=...] [threads=...]
+ * (integrate over the box [a,b]^d for d = 1, 2, ... up to dimension and print the throughput of the tensor-product grid for each d)
+ * 
+ * ./app --monte-carlo [function=0..2] [dimension=1..8] [a=...] [b=...] [error=...] [samples=...] [seed=...] [threads=...]
+ * (integrate over the box [a,b]^d with pseudorandom Monte Carlo and scrambled Halton quasi-Monte Carlo until the standard error reaches the target)
+ * 
+ * ./app --samples [file=...] [format=binary|csv] [layout=pairs|values] [x0=...] [dx=...] [threads=...] [generate=count [function=0..5] [a=...] [b=...]]
+ * (integrate the sampled data of a binary or CSV file with the left, right, midpoint (over panels of two intervals), and trapezoid rules in one pass, optionally writing a file of samples of a function first)
+ * 
+ * ./app --cumulative [function=0..6] [method=...] [a=...] [b=...] [n=...] [file=...] [queries=...] [threads=...]
+ * (compute the running integral F(x_i) at every partition end-point into memory or into a file, and time O(1) queries of the integral over [x_i, x_j])
+ * 
+ * ./app --precision [function=0..5] [method=left|right|midpoint] [a=...] [b=...] [n=...]
+ * (compute the same Riemann sum in double, long double, double-double (scalar, AVX2, and AVX-512), and __float128, and print the cost and the accuracy of each precision)
+ * 
+ * ./app --benchmark [minimum-n=...] [maximum-n=...] [steps=...] [accumulator=0..5] [repetitions=...] [threads=...] [format=csv|json] [output=...]
+ * (time every function, every rule, and n on a log scale, phase by phase, and append one record per run to a CSV or JSON Lines file)
+ * 
+ * Every mode also accepts expression=... (e.g. "expression=x*exp(-x)"), which compiles f(x) as the user-defined function, 
+ * so function=6 selects that f(x) (although the modes which compare with the exact integral only support the built-in functions).
+ */
+int runCommandLineMode(int argc, char * argv[])
+{
+    std::string mode = argv[1];
+    std::map<std::string, std::string> options = parseCommandLineOptions(argc, argv, 2);
+    if (options.count("expression") > 0)
+    {
+        std::string error;
+        size_t errorPosition = 0;
+        if (!compileExpression(options["expression"], userDefinedExpression, error, errorPosition))
+        {
+            std::cout << "\n\nThe expression could not be compiled (" << error << " at character " << (errorPosition + 1) << ").\n\n";
+            return 2;
+        }
+    }
+    if ((argc == 2) && (mode == "--simd-accuracy")) return runSimdAccuracyReport();
+    if (mode == "--scaling") return runScalingReport(options);
+    if (mode == "--accumulators") return runAccumulatorReport(options);
+    if (mode == "--rules") return runRuleReport(options);
+    if (mode == "--adaptive") return runAdaptiveReport(options);
+    if (mode == "--romberg") return runRombergReport(options);
+    if (mode == "--expression") return runExpressionReport(options);
+    if (mode == "--closed-form") return runClosedFormReport(options);
+    if (mode == "--cache") return runCacheReport(options);
+    if (mode == "--batch") return runBatchMode(options);
+    if (mode == "--box") return runBoxReport(options);
+    if (mode == "--monte-carlo") return runMonteCarloReport(options);
+    if (mode == "--samples") return runSampleMode(options);
+    if ((argc == 2) && (mode == "--samples-check")) return runSampleRuleCheck();
+    if (mode == "--cumulative") return runCumulativeReport(options);
+    if (mode == "--precision") return runPrecisionReport(options);
+    if (mode == "--benchmark") return runBenchmarkSuite(options);
+    std::cout << "\n\nUsage: ./app";
+    std::cout << "\n       ./app --simd-accuracy";
+    std::cout << "\n       ./app --scaling [function=0..5] [method=left|right|midpoint] [a=...] [b=...] [n=...]";
+    std::cout << "\n       ./app --accumulators [function=0..5] [method=left|right|midpoint] [a=...] [b=...] [n=...]";
+    std::cout << "\n       ./app --rules [function=0..5] [a=...] [b=...] [tolerance=...]";
+    std::cout << "\n       ./app --adaptive [function=0..5] [a=...] [b=...] [tolerance=...] [relative=...]";
+    std::cout << "\n       ./app --romberg [function=0..5] [a=...] [b=...] [tolerance=...] [relative=...]";
+    std::cout << "\n       ./app --expression [expression=...] [a=...] [b=...] [n=...]";
+    std::cout << "\n       ./app --closed-form [function=0|1|5|6] [a=...] [b=...] [n=...] [compare=0|1]";
+    std::cout << "\n       ./app --cache [function=0..6] [method=...] [a=...] [b=...] [n=...] [capacity=...] [file=...]";
+    std::cout << "\n       ./app --batch [jobs=...] [output=...] [count=...] [seed=...] [compare=0|1] [threads=...]";
+    std::cout << "\n       ./app --box [function=0..2] [method=...] [dimension=1..8] [a=...] [b=...] [points=...] [threads=...]";
+    std::cout << "\n       ./app --monte-carlo [function=0..2] [dimension=1..8] [a=...] [b=...] [error=...] [samples=...] [seed=...] [threads=...]";
+    std::cout << "\n       ./app --samples [file=...] [format=binary|csv] [layout=pairs|values] [x0=...] [dx=...] [threads=...] [generate=count [function=0..5] [a=...] [b=...]]";
+    std::cout << "\n       ./app --samples-check";
+    std::cout << "\n       ./app --cumulative [function=0..6] [method=...] [a=...] [b=...] [n=...] [file=...] [queries=...] [threads=...]";
+    std::cout << "\n       ./app --precision [function=0..5] [method=left|right|midpoint] [a=...] [b=...] [n=...]";
+    std::cout << "\n       ./app --benchmark [minimum-n=...] [maximum-n=...] [steps=...] [accumulator=0..5] [repetitions=...] [threads=...] [format=csv|json] [output=...]";
+    std::cout << "\n       (every mode also accepts expression=..., which function=6 then selects)\n\n";
+    return 2;
+}
+
+/**
+ * This function returns the key=value command line arguments argv[firstIndex] through argv[argc - 1] as a map from each key to its value 
+ * (ignoring any argument which does not contain an equals sign).
+ */
+std::map<std::string, std::string> parseCommandLineOptions(int argc, char * argv[], int firstIndex)
+{
+    std::map<std::string, std::string> options;
+    for (int i = firstIndex; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        size_t equals = argument.find('=');
+        if (equals != std::string::npos) options[argument.substr(0, equals)] = argument.substr(equals + 1);
+    }
+    return options;
+}
+
+/**
+ * This function prints (to the command line terminal) how far the vectorized version of each function in the list 
+ * is from the scalar (libm) version of that function for each vector instruction set which this processor supports, 
+ * and returns 0.
+ * 
+ * For each function, ACCURACY_SAMPLE_COUNT random points are drawn from [MINIMUM_a, MAXIMUM_a] (or [0, MAXIMUM_a] for sqrt), 
+ * and the largest and the mean error are printed in units in the last place (ulp) of the scalar result. 
+ * Then the midpoint Riemann sum of each function over [0, 3] with n = 10^7 is computed with each instruction set, 
+ * and the relative difference from the scalar Riemann sum is printed.
+ */
+int runSimdAccuracyReport()
+{
+    const char * names[NUMBER_OF_FUNCTIONS] = { "x^2", "x^3", "sin(x)", "cos(x)", "sqrt(x)", "2x + 3" };
+    InstructionSet widest = detectInstructionSet();
+    std::mt19937_64 generator(1);
+    std::vector<double> x(ACCURACY_SAMPLE_COUNT), expected(ACCURACY_SAMPLE_COUNT), actual(ACCURACY_SAMPLE_COUNT);
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nSIMD Accuracy Report (widest supported instruction set: " << nameOfInstructionSet(widest) << ")";
+    std::cout << "\n--------------------------------";
+    for (int option = 0; option < NUMBER_OF_FUNCTIONS; option++)
+    {
+        std::uniform_real_distribution<double> distribution((option == 4) ? 0.0 : MINIMUM_a, MAXIMUM_a);
+        for (double & point : x) point = distribution(generator);
+        selectBatchEvaluator(option, InstructionSet::Scalar)(x.data(), expected.data(), ACCURACY_SAMPLE_COUNT);
+        double scalarSum = selectRiemannKernel(option, Rule::Midpoint, InstructionSet::Scalar)(0.0, 3.0 / 10000000, 0, 10000000);
+        for (int set = 1; set <= (int) widest; set++)
+        {
+            InstructionSet instructionSet = (InstructionSet) set;
+            double largestError = 0.0, totalError = 0.0;
+            selectBatchEvaluator(option, instructionSet)(x.data(), actual.data(), ACCURACY_SAMPLE_COUNT);
+            for (int i = 0; i < ACCURACY_SAMPLE_COUNT; i++)
+            {
+                double ulp = std::nextafter(std::fabs(expected[i]), INFINITY) - std::fabs(expected[i]);
+                double error = std::fabs(actual[i] - expected[i]) / ulp;
+                if (error > largestError) largestError = error;
+                totalError += error;
+            }
+            double vectorSum = selectRiemannKernel(option, Rule::Midpoint, instructionSet)(0.0, 3.0 / 10000000, 0, 10000000);
+            std::cout << "\n\nf(x) = " << names[option] << " (" << nameOfInstructionSet(instructionSet) << "): largest error " << largestError << " ulp, mean error " << (totalError / ACCURACY_SAMPLE_COUNT) << " ulp";
+            std::cout << "; midpoint Riemann sum over [0,3] with n = 10^7 differs from the scalar sum by a relative " << (std::fabs(vectorSum - scalarSum) / std::fabs(scalarSum)) << ".";
+        }
+    }
+    std::cout << "\n\n--------------------------------\n\n";
+    return 0;
+}
+
+/**
+ * This function starts threadCount - 1 worker threads in pool (the thread which calls runOnThreadPool is the remaining thread). 
+ * Each worker starts out having finished every job which was posted to pool so far (so a restarted pool does not repeat its last job).
+ */
+void startThreadPool(ThreadPool & pool, int threadCount)
+{
+    pool.stopping = false;
+    for (int k = 1; k < threadCount; k++) pool.workers.emplace_back(runThreadPoolWorker, std::ref(pool), pool.generation);
+}
+
+/**
+ * This function calls task(i) exactly once for each i in [0, taskCount) using every thread of pool (and the calling thread) 
+ * and returns after every call returned.
+ */
+void runOnThreadPool(ThreadPool & pool, uint64_t taskCount, const std::function<void(uint64_t)> & task)
+{
+    {
+        std::unique_lock<std::mutex> lock(pool.mutex);
+        pool.task = task;
+        pool.taskCount = taskCount;
+        pool.nextIndex = 0;
+        pool.activeWorkers = (int) pool.workers.size();
+        pool.generation++;
+    }
+    pool.wake.notify_all();
+    processThreadPoolTasks(pool);
+    std::unique_lock<std::mutex> lock(pool.mutex);
+    pool.finished.wait(lock, [&pool]() { return pool.activeWorkers == 0; });
+}
+
+// This function claims and processes indices of the current job of pool until every index was claimed.
+void processThreadPoolTasks(ThreadPool & pool)
+{
+    for (uint64_t i = pool.nextIndex++; i < pool.taskCount; i = pool.nextIndex++) pool.task(i);
+}
+
+/**
+ * This function is the body of each worker thread of pool (which has finished the jobs up to and including job number finishedGeneration): 
+ * it waits for a new job, helps to process that job, reports that it finished, and repeats until the pool is stopped.
+ */
+void runThreadPoolWorker(ThreadPool & pool, uint64_t finishedGeneration)
+{
+    while (true)
+    {
+        std::unique_lock<std::mutex> lock(pool.mutex);
+        pool.wake.wait(lock, [&]() { return pool.stopping || (pool.generation != finishedGeneration); });
+        if (pool.stopping) return;
+        finishedGeneration = pool.generation;
+        lock.unlock();
+        processThreadPoolTasks(pool);
+        lock.lock();
+        if (--pool.activeWorkers == 0) pool.finished.notify_all();
+    }
+}
+
+// This function stops every worker thread of pool and waits for each of them to exit.
+void stopThreadPool(ThreadPool & pool)
+{
+    {
+        std::unique_lock<std::mutex> lock(pool.mutex);
+        pool.stopping = true;
+    }
+    pool.wake.notify_all();
+    for (std::thread & worker : pool.workers) worker.join();
+    pool.workers.clear();
+}
+
+/**
+ * This function returns the thread pool which is shared by every parallel computation of this program, with threadCount threads 
+ * (the calling thread and threadCount - 1 workers). The pool is started by the first call and lives until the program exits; 
+ * it is only restarted if a call asks for a different number of threads than the previous call. 
+ * The pool runs one job at a time, so it must not be acquired from inside one of its own tasks.
+ */
+ThreadPool & acquireThreadPool(int threadCount)
+{
+    static SharedThreadPool shared;
+    if (shared.pool.workers.size() + 1 != (size_t) threadCount)
+    {
+        stopThreadPool(shared.pool);
+        startThreadPool(shared.pool, threadCount);
+    }
+    return shared.pool;
+}
+
+// This function stops the threads of the shared thread pool (when the program exits).
+SharedThreadPool::~SharedThreadPool()
+{
+    stopThreadPool(pool);
+}
+
+/**
+ * This function adds value (the next value of the sequence) to tree: 
+ * while the subtree at the current level is occupied, value is added to the right of that subtree and carried one level up.
+ * If tree.compensated is true, error (the error term of value) and the rounding error of each addition are added to tree.error.
+ */
+void addToReductionTree(ReductionTree & tree, double value, double error)
+{
+    size_t level = 0;
+    if (tree.compensated) tree.error += error;
+    while ((level < tree.occupied.size()) && tree.occupied[level])
+    {
+        if (tree.compensated)
+        {
+            double total = tree.levels[level];
+            addNeumaier(total, tree.error, value);
+            value = total;
+        }
+        else value = tree.levels[level] + value;
+        tree.occupied[level] = false;
+        level++;
+    }
+    if (level == tree.occupied.size())
+    {
+        tree.levels.push_back(0.0);
+        tree.occupied.push_back(false);
+    }
+    tree.levels[level] = value;
+    tree.occupied[level] = true;
+}
+
+/**
+ * This function returns the sum of every value which was added to tree 
+ * (adding the remaining subtrees from the smallest, which holds the latest values, to the largest, which holds the earliest values, 
+ * and then adding tree.error if tree.compensated is true).
+ */
+double finishReductionTree(const ReductionTree & tree)
+{
+    double sum = 0.0, error = tree.error;
+    bool empty = true;
+    for (size_t level = 0; level < tree.levels.size(); level++)
+    {
+        if (!tree.occupied[level]) continue;
+        if (empty) sum = tree.levels[level];
+        else if (tree.compensated)
+        {
+            double total = tree.levels[level];
+            addNeumaier(total, error, sum);
+            sum = total;
+        }
+        else sum = tree.levels[level] + sum;
+        empty = false;
+    }
+    return tree.compensated ? (sum + error) : sum;
+}
+
+/**
+ * This function returns the total (weighted) height of the rectangles of partitions 0 through n - 1 of [a,b] (where each partition has length dx 
+ * and the height of each rectangle is measured as specified by engine.rule) using engine on engine.threadCount threads.
+ * 
+ * The partitions are divided into blocks of PARALLEL_BLOCK_SIZE partitions (so the blocks do not depend on threadCount). 
+ * The thread pool sums PARALLEL_BATCH_BLOCKS blocks at a time (each block is claimed by whichever thread is free next 
+ * and its sum is stored in the slot for that block), and then the block sums are added to a ReductionTree in block order 
+ * (a compensated tree if engine.accumulator carries an error term, so that the error terms of the blocks are not rounded away). 
+ * Hence the result is bit-identical for every threadCount and every scheduling of the threads, 
+ * and the memory used does not grow with n.
+ * 
+ * If showProgress is true, the progress and throughput are printed (to the command line terminal and to file) 
+ * at most once per PROGRESS_REPORT_SECONDS seconds.
+ */
+double sumRectangleHeightsInParallel(const RiemannEngine & engine, double a, double dx, uint64_t n, bool showProgress, std::ofstream & file)
+{
+    ReductionTree tree;
+    std::vector<double> blockSums(PARALLEL_BATCH_BLOCKS), blockErrors(PARALLEL_BATCH_BLOCKS);
+    uint64_t blockCount = (n + PARALLEL_BLOCK_SIZE - 1) / PARALLEL_BLOCK_SIZE;
+    auto start = std::chrono::steady_clock::now(), lastReport = start;
+    tree.compensated = (engine.accumulator != Accumulator::Naive) && (engine.accumulator != Accumulator::Pairwise);
+    ThreadPool & pool = acquireThreadPool((engine.threadCount < 1) ? 1 : engine.threadCount);
+    for (uint64_t firstBlock = 0; firstBlock < blockCount; firstBlock += PARALLEL_BATCH_BLOCKS)
+    {
+        uint64_t batchBlocks = ((blockCount - firstBlock) < PARALLEL_BATCH_BLOCKS) ? (blockCount - firstBlock) : PARALLEL_BATCH_BLOCKS;
+
+        // Sum each block of this batch on whichever thread claims it.
+        runOnThreadPool(pool, batchBlocks, [&](uint64_t k)
+        {
+            uint64_t first = (firstBlock + k) * PARALLEL_BLOCK_SIZE;
+            uint64_t last = ((n - first) < PARALLEL_BLOCK_SIZE) ? n : (first + PARALLEL_BLOCK_SIZE);
+            blockSums[k] = sumRectangleHeightsWithAccumulator(engine, a, dx, first, last, blockErrors[k]);
+        });
+
+        // Add the block sums to the tree in block order.
+        for (uint64_t k = 0; k < batchBlocks; k++) addToReductionTree(tree, blockSums[k], blockErrors[k]);
+
+        // Print the progress if at least PROGRESS_REPORT_SECONDS seconds passed since the previous report.
+        auto now = std::chrono::steady_clock::now();
+        if (showProgress && (std::chrono::duration<double>(now - lastReport).count() >= PROGRESS_REPORT_SECONDS))
+        {
+            uint64_t completed = (firstBlock + batchBlocks) * PARALLEL_BLOCK_SIZE;
+            reportProgress((completed < n) ? completed : n, n, std::chrono::duration<double>(now - start).count(), file);
+            lastReport = now;
+        }
+    }
+
+    // Print the final throughput if any progress was reported (i.e. if the computation took long enough to be worth measuring).
+    if (showProgress && (lastReport != start)) reportProgress(n, n, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), file);
+    return finishReductionTree(tree);
+}
+
+/**
+ * This function returns the total (weighted) height of the rectangles of partitions first through last - 1 of [a,b] 
+ * (where each partition has length dx and the height of each rectangle is measured as specified by engine.rule) 
+ * and stores the error term of that total in error (see sumValues).
+ * 
+ * If engine.rule is GaussLegendre, the partitions are summed by sumGaussLegendrePanels. 
+ * Otherwise, if engine.accumulator is Naive (or if there is no batch evaluator), the compiled kernel adds the heights as it evaluates them. 
+ * Otherwise the x-axis points of the block are stored in a buffer which belongs to the calling thread (and which is reused by every block that thread sums), 
+ * engine.evaluator replaces each point with the height of its rectangle in place, each height is multiplied by its Newton-Cotes weight (if any), 
+ * and the heights are added with engine.accumulator.
+ * 
+ * If engine.timings is not a null pointer, the time of the evaluation and of the accumulation of the block are added to it (see stopPhase).
+ */
+double sumRectangleHeightsWithAccumulator(const RiemannEngine & engine, double a, double dx, uint64_t first, uint64_t last, double & error)
+{
+    error = 0.0;
+    if (engine.rule == Rule::GaussLegendre) return sumGaussLegendrePanels(engine, a, dx, first, last, error);
+    PhaseStamp phase = startPhase();
+    if ((engine.accumulator == Accumulator::Naive) || (engine.evaluator == nullptr))
+    {
+        double sum = engine.kernel(a, dx, first, last);
+        stopPhase(engine.timings, Phase::Evaluation, phase);
+        if (engine.timings != nullptr) engine.timings->evaluations += last - first;
+        return sum;
+    }
+    thread_local std::vector<double> heights;
+    uint64_t count = last - first;
+    double t = (double) first + offsetOfRule(engine.rule);
+    if (heights.size() < count) heights.resize(count);
+    for (int i = 0; i < (int) count; i++) heights[i] = a + (t + (double) i) * dx; // (an int index converts to double with vector instructions)
+    engine.evaluator(heights.data(), heights.data(), count);
+    if ((engine.rule == Rule::Simpson) || (engine.rule == Rule::Boole)) for (uint64_t i = 0; i < count; i++) heights[i] *= interiorWeightOfRule(engine.rule, first + i);
+    stopPhase(engine.timings, Phase::Evaluation, phase);
+    if (engine.timings != nullptr) engine.timings->evaluations += count;
+    phase = startPhase();
+    double sum = sumValues(engine.accumulator, heights.data(), count, error);
+    stopPhase(engine.timings, Phase::Accumulation, phase);
+    return sum;
+}
+
+/**
+ * This function returns the sum of (w_k / 2) * f(a + (i + (1 + x_k) / 2) * dx) over the partitions i = first through last - 1 of [a,b] 
+ * and over the nodes x_k and weights w_k of the Gauss-Legendre rule of order engine.order (the rule on [-1,1] mapped onto each partition, 
+ * so that dx times the returned value is the composite Gauss-Legendre rule), and stores the error term of that sum in error.
+ * 
+ * The partitions are processed in chunks of at most PARALLEL_BLOCK_SIZE points: the points of a chunk are stored in a buffer which belongs to the calling thread, 
+ * engine.evaluator replaces each point with f of that point in place, each value is multiplied by its weight, 
+ * and the weighted values are added with engine.accumulator (and the chunk sums are added with Neumaier summation if engine.accumulator carries an error term).
+ */
+double sumGaussLegendrePanels(const RiemannEngine & engine, double a, double dx, uint64_t first, uint64_t last, double & error)
+{
+    thread_local std::vector<double> values;
+    const int order = engine.order;
+    const double * nodes = gaussLegendreTables.nodes[order];
+    const double * weights = gaussLegendreTables.weights[order];
+    uint64_t panelsPerChunk = PARALLEL_BLOCK_SIZE / order;
+    bool compensated = (engine.accumulator != Accumulator::Naive) && (engine.accumulator != Accumulator::Pairwise);
+    double sum = 0.0, halfNodes[MAXIMUM_GAUSS_LEGENDRE_ORDER], halfWeights[MAXIMUM_GAUSS_LEGENDRE_ORDER];
+    error = 0.0;
+    if (values.size() < PARALLEL_BLOCK_SIZE) values.resize(PARALLEL_BLOCK_SIZE);
+
+    // Map the nodes and weights from [-1,1] onto [0,1] (the position inside of a partition, in units of dx).
+    for (int k = 0; k < order; k++)
+    {
+        halfNodes[k] = 0.5 * (1.0 + nodes[k]);
+        halfWeights[k] = 0.5 * weights[k];
+    }
+    for (uint64_t chunk = first; chunk < last; chunk += panelsPerChunk)
+    {
+        uint64_t chunkEnd = ((last - chunk) < panelsPerChunk) ? last : (chunk + panelsPerChunk);
+        uint64_t count = 0;
+        PhaseStamp phase = startPhase();
+        for (uint64_t i = chunk; i < chunkEnd; i++) for (int k = 0; k < order; k++) values[count++] = a + ((double) i + halfNodes[k]) * dx;
+        engine.evaluator(values.data(), values.data(), count);
+        for (uint64_t j = 0; j < count; j++) values[j] *= halfWeights[j % order];
+        stopPhase(engine.timings, Phase::Evaluation, phase);
+        if (engine.timings != nullptr) engine.timings->evaluations += count;
+        phase = startPhase();
+        double chunkError = 0.0, chunkSum = sumValues(engine.accumulator, values.data(), count, chunkError);
+        stopPhase(engine.timings, Phase::Accumulation, phase);
+        if (compensated)
+        {
+            addNeumaier(sum, error, chunkSum);
+            error += chunkError;
+        }
+        else sum += chunkSum;
+    }
+    return sum;
+}
+
+/**
+ * This function returns the sum of values[0] through values[count - 1] computed with accumulator 
+ * and stores the error term of that sum in error (such that sum + error is closer to the exact sum than sum is). 
+ * The naive and pairwise accumulators do not compute an error term, so they store zero in error.
+ */
+double sumValues(Accumulator accumulator, const double * values, uint64_t count, double & error)
+{
+    if (accumulator == Accumulator::Kahan) return sumKahan(values, count, error);
+    if (accumulator == Accumulator::Neumaier) return sumNeumaier(values, count, error);
+    if (accumulator == Accumulator::Pairwise) return sumPairwise(values, count, error);
+    if (accumulator == Accumulator::VectorCompensated) return sumCompensated(values, count, error);
+    if (accumulator == Accumulator::LongDouble) return sumInLongDouble(values, count, error);
+    return sumNaive(values, count, error);
+}
+
+// This function returns the sum of values[0] through values[count - 1] added one at a time in plain double arithmetic (and stores zero in error).
+double sumNaive(const double * values, uint64_t count, double & error)
+{
+    double sum = 0.0;
+    error = 0.0;
+    for (uint64_t i = 0; i < count; i++) sum += values[i];
+    return sum;
+}
+
+/**
+ * This function returns the sum of values[0] through values[count - 1] using Kahan summation: 
+ * error stores the (negated) part of each value which was lost when it was added to sum, 
+ * and is subtracted from the next value before that value is added (the error term stored in error is the negation of the last correction).
+ */
+double sumKahan(const double * values, uint64_t count, double & error)
+{
+    double sum = 0.0, correction = 0.0;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        double value = values[i] - correction;
+        double total = sum + value;
+        correction = (total - sum) - value;
+        sum = total;
+    }
+    error = -correction;
+    return sum;
+}
+
+/**
+ * This function adds value to sum and adds the rounding error of that addition to error (Neumaier's improvement of Kahan summation: 
+ * the error is computed from whichever of sum and value has the larger magnitude, so it is exact even if value is larger than sum).
+ */
+void addNeumaier(double & sum, double & error, double value)
+{
+    double total = sum + value;
+    if (std::fabs(sum) >= std::fabs(value)) error += (sum - total) + value;
+    else error += (value - total) + sum;
+    sum = total;
+}
+
+// This function returns the sum of values[0] through values[count - 1] using Neumaier summation (and stores the total rounding error of the additions in error).
+double sumNeumaier(const double * values, uint64_t count, double & error)
+{
+    double sum = 0.0;
+    error = 0.0;
+    for (uint64_t i = 0; i < count; i++) addNeumaier(sum, error, values[i]);
+    return sum;
+}
+
+/**
+ * This function returns the sum of values[0] through values[count - 1] using pairwise summation: 
+ * the values are split into two halves which are summed recursively and then added, 
+ * and at most PAIRWISE_BLOCK_SIZE values are added in a plain loop (with four partial sums) at the bottom of the recursion. 
+ * Zero is stored in error.
+ */
+double sumPairwise(const double * values, uint64_t count, double & error)
+{
+    error = 0.0;
+    if (count <= PAIRWISE_BLOCK_SIZE)
+    {
+        double sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+        uint64_t i = 0;
+        for (; i + 4 <= count; i += 4)
+        {
+            sum0 += values[i];
+            sum1 += values[i + 1];
+            sum2 += values[i + 2];
+            sum3 += values[i + 3];
+        }
+        for (; i < count; i++) sum0 += values[i];
+        return (sum0 + sum1) + (sum2 + sum3);
+    }
+    uint64_t half = count / 2;
+    return sumPairwise(values, half, error) + sumPairwise(values + half, count - half, error);
+}
+
+/**
+ * This function returns the sum of values[0] through values[count - 1] using sumCompensatedVector 
+ * for the widest instruction set which this processor supports (or sumNeumaier on processors without AVX2), 
+ * and stores the error term of that sum in error.
+ */
+double sumCompensated(const double * values, uint64_t count, double & error)
+{
+    static const InstructionSet instructionSet = detectInstructionSet();
+    if (instructionSet == InstructionSet::Avx512) return sumCompensatedAvx512(values, count, error);
+    if (instructionSet == InstructionSet::Avx2) return sumCompensatedAvx2(values, count, error);
+    return sumNeumaier(values, count, error);
+}
+
+/**
+ * This function returns the sum of values[0] through values[count - 1] added one at a time in long double (80-bit extended precision) arithmetic 
+ * rounded to double, and stores the part of the long double sum which that rounding removed in error.
+ */
+double sumInLongDouble(const double * values, uint64_t count, double & error)
+{
+    long double sum = 0.0L;
+    for (uint64_t i = 0; i < count; i++) sum += values[i];
+    error = (double) (sum - (long double) (double) sum);
+    return (double) sum;
+}
+
+/**
+ * This function returns the quadrature of f over [a,b] on n partitions using engine (on engine.threadCount threads, 
+ * printing the progress to the command line terminal and to file if showProgress is true), where f is the function which engine evaluates. 
+ * 
+ * For the rectangle rules and Gauss-Legendre, that is dx times the total weighted height of the rectangles. 
+ * For the Newton-Cotes rules, f is also evaluated at a and at the last end-point (with engine.evaluator), 
+ * and the weights of those two points are corrected as described by endpointCorrectionOfRule.
+ */
+double computeQuadrature(const RiemannEngine & engine, double a, double b, uint64_t n, bool showProgress, std::ofstream & file)
+{
+    double dx = (b - a) / n;
+    double sum = sumRectangleHeightsInParallel(engine, a, dx, n, showProgress, file);
+    if ((engine.rule != Rule::Trapezoid) && (engine.rule != Rule::Simpson) && (engine.rule != Rule::Boole)) return sum * dx;
+    double ends[2] = { a, a + (double) n * dx };
+    engine.evaluator(ends, ends, 2);
+    if (engine.timings != nullptr) engine.timings->evaluations += 2;
+    return dx * scaleOfRule(engine.rule) * (sum + endpointCorrectionOfRule(engine.rule) * (ends[1] - ends[0]));
+}
+
+/**
+ * This function returns the quadrature of func over the n partitions of [a,b] (each of length dx) for rule (and order, if rule is GaussLegendre) 
+ * by evaluating func once at each of the numberOfPointsOfRule(rule, order, n) points of that rule (see pointOfRule) in order. 
+ * It is used when the steps are traced (or when there is no compiled kernel for func), 
+ * and it prints every trace.interval-th point if trace.level is "sampled" and every step of every point if trace.level is "full".
+ */
+double sumWeightedPoints(Function func, double a, double dx, uint64_t n, Rule rule, int order, const TraceSettings & trace, std::ofstream & file)
+{
+    double sum = 0.0, x = 0.0, y = 0.0, weight = 0.0;
+    uint64_t count = numberOfPointsOfRule(rule, order, n);
+    if (trace.level == "full")
+    {
+        std::cout << "\n\n~~~~~~~~~~~~~~";
+        file << "\n\n~~~~~~~~~~~~~~";
+    }
+    for (uint64_t j = 0; j < count; j++)
+    {
+        // Determine the jth point of the rule and its weight, and evaluate func at that point (once).
+        pointOfRule(rule, order, a, dx, n, j, x, weight);
+        y = func(x);
+
+        // Add the weighted area of the current point to the running total sum.
+        sum += weight * y * dx;
+        if (trace.level == "none") continue;
+        if (trace.level == "sampled")
+        {
+            if ((j % (uint64_t) trace.interval == 0) || (j == count - 1))
+            {
+                std::cout << "\n\nj = " << j << ", x = " << x << ", weight = " << weight << ", f(x) = " << y << ", sum = " << sum << ".";
+                file << "\n\nj = " << j << ", x = " << x << ", weight = " << weight << ", f(x) = " << y << ", sum = " << sum << ".";
+            }
+            continue;
+        }
+
+        // Print the value of j, x, the weight of f(x), the weighted area of the jth point, and the running total to the command line terminal and to the output file stream.
+        std::cout << "\n\nj = " << j << ". // current iteration of the for loop (of " << count << " iterations)";
+        std::cout << "\n\nx = " << x << ". // the jth point at which the rule evaluates f";
+        std::cout << "\n\nweight = " << weight << ". // the weight of f(x) in the rule (in units of dx)";
+        std::cout << "\n\nweighted_area_x = weight * func(x) * dx = " << weight << " * " << y << " * " << dx << " = " << (weight * y * dx) << ".";
+        std::cout << "\n\nsum = " << sum << ". // the current value stored in the variable named sum";
+        std::cout << "\n\n~~~~~~~~~~~~~~";
+        file << "\n\nj = " << j << ". // current iteration of the for loop (of " << count << " iterations)";
+        file << "\n\nx = " << x << ". // the jth point at which the rule evaluates f";
+        file << "\n\nweight = " << weight << ". // the weight of f(x) in the rule (in units of dx)";
+        file << "\n\nweighted_area_x = weight * func(x) * dx = " << weight << " * " << y << " * " << dx << " = " << (weight * y * dx) << ".";
+        file << "\n\nsum = " << sum << ". // the current value stored in the variable named sum";
+        file << "\n\n~~~~~~~~~~~~~~";
+    }
+    return sum;
+}
+
+/**
+ * This function returns the exact integral over [a,b] of the function whose option number (in the list displayed by selectFunctionFromListOfFunctions) is functionOption 
+ * (computed from its antiderivative), or NAN if functionOption is not the option number of any function in that list.
+ */
+double exactIntegral(int functionOption, double a, double b)
+{
+    if (functionOption == 0) return (b * b * b - a * a * a) / 3.0;
+    if (functionOption == 1) return (b * b * b * b - a * a * a * a) / 4.0;
+    if (functionOption == 2) return std::cos(a) - std::cos(b);
+    if (functionOption == 3) return std::sin(b) - std::sin(a);
+    if (functionOption == 4) return 2.0 * (b * std::sqrt(b) - a * std::sqrt(a)) / 3.0;
+    if (functionOption == 5) return (b * b + 3.0 * b) - (a * a + 3.0 * a);
+    return NAN;
+}
+
+/**
+ * This function doubles the number of partitions n (starting with n = 4) until the result of computeQuadrature with engine over [a,b] 
+ * is within tolerance of exact, and returns the number of evaluations of f which that result needed (storing its n in n and its error in error). 
+ * If the rule would need more than RULE_REPORT_MAXIMUM_EVALUATIONS evaluations, this function returns 0 and stores the smallest error which was reached in error.
+ */
+uint64_t evaluationsToTolerance(const RiemannEngine & engine, double a, double b, double exact, double tolerance, double & error, uint64_t & n)
+{
+    std::ofstream noFile;
+    double bestError = INFINITY;
+    for (n = 4; numberOfPointsOfRule(engine.rule, engine.order, n) <= RULE_REPORT_MAXIMUM_EVALUATIONS; n *= 2)
+    {
+        error = std::fabs(computeQuadrature(engine, a, b, n, false, noFile) - exact);
+        if (error <= tolerance) return numberOfPointsOfRule(engine.rule, engine.order, n);
+        if (error < bestError) bestError = error;
+    }
+    error = bestError;
+    return 0;
+}
+
+// This function returns the name of accumulator (as displayed by selectAccumulator).
+std::string nameOfAccumulator(Accumulator accumulator)
+{
+    static const char * names[NUMBER_OF_ACCUMULATORS] = { "naive", "Kahan", "Neumaier", "pairwise", "vector compensated", "long double" };
+    return names[(int) accumulator];
+}
+
+/**
+ * This function prints (to the command line terminal) how long the parallel Riemann sum of the function whose option number is options["function"] 
+ * takes on 1, 2, 4, ... threads (and on every core), the speedup and the scaling efficiency (speedup divided by the number of threads) of each thread count, 
+ * and whether each result is bit-identical to the result on one thread.
+ * Return 0 if every result is bit-identical (or 1 otherwise).
+ */
+int runScalingReport(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "function", "2" }, { "method", "midpoint" }, { "a", "0" }, { "b", "3" }, { "n", "1000000000" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str());
+    uint64_t n = strtoull(settings["n"].c_str(), NULL, 10);
+    int cores = (int) std::thread::hardware_concurrency();
+    InstructionSet instructionSet = detectInstructionSet();
+    RiemannEngine engine = { selectRiemannKernel(functionOption, ruleFromMethod(settings["method"]), instructionSet), nullptr, Accumulator::Naive, 1, ruleFromMethod(settings["method"]), 0, Polynomial(), nullptr, 0 };
+    std::ofstream noFile;
+    if ((engine.kernel == nullptr) || (n < MINIMUM_n) || (n > MAXIMUM_n) || (b <= a))
+    {
+        std::cout << "\n\nInvalid scaling report settings (function must be 0 through " << (NUMBER_OF_FUNCTIONS - 1) << ", n must be within [" << MINIMUM_n << "," << MAXIMUM_n << "], and b must be larger than a).\n\n";
+        return 2;
+    }
+    if (cores < 1) cores = 1;
+
+    // Time 1, 2, 4, ... threads, and finally every core (if the number of cores is not a power of two).
+    std::vector<int> threadCounts;
+    for (int threads = 1; threads < cores; threads *= 2) threadCounts.push_back(threads);
+    threadCounts.push_back(cores);
+    double dx = (b - a) / n, baselineSeconds = 0.0, baselineSum = 0.0;
+    bool identical = true;
+    std::cout.precision(17);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nScaling Report (function " << functionOption << ", " << settings["method"] << ", [" << a << "," << b << "], n = " << n << ", " << nameOfInstructionSet(instructionSet) << ", " << cores << " core(s))";
+    std::cout << "\n--------------------------------";
+    for (int threads : threadCounts)
+    {
+        auto start = std::chrono::steady_clock::now();
+        engine.threadCount = threads;
+        double sum = sumRectangleHeightsInParallel(engine, a, dx, n, false, noFile) * dx;
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        if (threads == 1)
+        {
+            baselineSeconds = seconds;
+            baselineSum = sum;
+        }
+        bool same = (std::memcmp(&sum, &baselineSum, sizeof(sum)) == 0);
+        if (!same) identical = false;
+        double speedup = baselineSeconds / seconds;
+        std::cout << "\n\n" << threads << " thread(s): " << seconds << " seconds, speedup " << speedup << ", efficiency " << (speedup / threads);
+        std::cout << ", sum = " << sum << (same ? " (bit-identical to 1 thread)." : " (DIFFERS from 1 thread).");
+    }
+    std::cout << "\n\n--------------------------------\n\n";
+    return identical ? 0 : 1;
+}
+
+/**
+ * This function prints (to the command line terminal) the measured cost and the rounding error of each accumulator 
+ * for the Riemann sum of the function whose option number is options["function"], and returns 0.
+ * 
+ * The cost per element of each accumulator alone is measured by summing the same block of PARALLEL_BLOCK_SIZE heights 
+ * ACCUMULATOR_COST_REPETITIONS times (so the heights are already in the cache and no function is evaluated). 
+ * Then the whole Riemann sum is computed with each accumulator (on every core), and its time per rectangle (including the function evaluations) 
+ * and its relative difference from a reference sum of the same heights are printed. 
+ * The reference adds the heights with Neumaier summation in long double arithmetic (about 128 bits of effective precision), 
+ * so the printed difference is the rounding error of the accumulator (not the discretization error of the Riemann sum).
+ */
+int runAccumulatorReport(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "function", "2" }, { "method", "midpoint" }, { "a", "0" }, { "b", "3" }, { "n", "100000000" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str());
+    uint64_t n = strtoull(settings["n"].c_str(), NULL, 10);
+    Rule rule = ruleFromMethod(settings["method"]);
+    InstructionSet instructionSet = detectInstructionSet();
+    RiemannEngine engine = { selectRiemannKernel(functionOption, rule, instructionSet), selectBatchEvaluator(functionOption, instructionSet), Accumulator::Naive, (int) std::thread::hardware_concurrency(), rule, 0, Polynomial(), nullptr, 0 };
+    std::ofstream noFile;
+    if ((engine.kernel == nullptr) || ((rule != Rule::Left) && (rule != Rule::Right) && (rule != Rule::Midpoint)) || (n < MINIMUM_n) || (n > MAXIMUM_n) || (b <= a))
+    {
+        std::cout << "\n\nInvalid accumulator report settings (function must be 0 through " << (NUMBER_OF_FUNCTIONS - 1) << ", method must be left, right, or midpoint, n must be within [" << MINIMUM_n << "," << MAXIMUM_n << "], and b must be larger than a).\n\n";
+        return 2;
+    }
+    if (engine.threadCount < 1) engine.threadCount = 1;
+    double dx = (b - a) / n, offset = offsetOfRule(rule);
+
+    // Compute the reference sum of the heights (block by block, with the same evaluator as the buffered accumulators).
+    std::vector<double> heights(PARALLEL_BLOCK_SIZE);
+    long double referenceSum = 0.0L, referenceError = 0.0L;
+    for (uint64_t first = 0; first < n; first += PARALLEL_BLOCK_SIZE)
+    {
+        uint64_t count = ((n - first) < PARALLEL_BLOCK_SIZE) ? (n - first) : PARALLEL_BLOCK_SIZE;
+        for (uint64_t i = 0; i < count; i++) heights[i] = a + ((double) first + offset + (double) i) * dx;
+        engine.evaluator(heights.data(), heights.data(), count);
+        for (uint64_t i = 0; i < count; i++)
+        {
+            long double value = heights[i], total = referenceSum + value;
+            if (fabsl(referenceSum) >= fabsl(value)) referenceError += (referenceSum - total) + value;
+            else referenceError += (value - total) + referenceSum;
+            referenceSum = total;
+        }
+    }
+    long double reference = referenceSum + referenceError;
+
+    // Store the heights of the first block (which the cost measurement sums repeatedly).
+    uint64_t blockCount = (n < PARALLEL_BLOCK_SIZE) ? n : PARALLEL_BLOCK_SIZE;
+    for (uint64_t i = 0; i < blockCount; i++) heights[i] = a + ((double) i + offset) * dx;
+    engine.evaluator(heights.data(), heights.data(), blockCount);
+
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nAccumulator Report (function " << functionOption << ", " << settings["method"] << ", [" << a << "," << b << "], n = " << n << ", " << nameOfInstructionSet(instructionSet) << ", " << engine.threadCount << " thread(s))";
+    std::cout << "\n--------------------------------";
+    for (int k = 0; k < NUMBER_OF_ACCUMULATORS; k++)
+    {
+        engine.accumulator = (Accumulator) k;
+
+        // Measure the cost per element of the accumulator alone (the naive accumulator is measured as a plain loop, since its kernel adds while it evaluates).
+        volatile double sink = 0.0;
+        double error = 0.0;
+        auto start = std::chrono::steady_clock::now();
+        for (int repetition = 0; repetition < ACCUMULATOR_COST_REPETITIONS; repetition++) sink = sink + sumValues(engine.accumulator, heights.data(), blockCount, error) + error;
+        double summationSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        // Compute the whole Riemann sum with the accumulator.
+        start = std::chrono::steady_clock::now();
+        double sum = sumRectangleHeightsInParallel(engine, a, dx, n, false, noFile);
+        double totalSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double relativeError = (double) (fabsl((long double) sum - reference) / fabsl(reference));
+        std::cout << "\n\n" << nameOfAccumulator(engine.accumulator) << ": " << (1e9 * summationSeconds / ((double) blockCount * ACCUMULATOR_COST_REPETITIONS)) << " nanoseconds per element (summation only), ";
+        std::cout << (1e9 * totalSeconds / (double) n) << " nanoseconds per rectangle (including the function evaluations), relative error " << relativeError << ".";
+    }
+    std::cout.precision(17);
+    std::cout << "\n\nreference sum of the heights = " << (double) reference << ", Riemann sum = " << (double) (reference * dx) << ".";
+    std::cout << "\n\n--------------------------------\n\n";
+    return 0;
+}
+
+/**
+ * This function prints (to the command line terminal) how many evaluations of the function whose option number is options["function"] 
+ * each rule needs before its result over [a,b] is within options["tolerance"] of the exact integral (see exactIntegral), and returns 0.
+ * 
+ * Each rule's evaluations are counted by evaluationsToTolerance 
+ * (and if a rule would need more than RULE_REPORT_MAXIMUM_EVALUATIONS evaluations, the smallest error which was reached is printed instead). 
+ * The Gauss-Legendre rules of orders 2, 3, 4, 5, 6, 8, 16, 32, and 64 are included.
+ */
+int runRuleReport(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "function", "2" }, { "a", "0" }, { "b", "3" }, { "tolerance", "1e-10" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str()), tolerance = atof(settings["tolerance"].c_str());
+    double exact = exactIntegral(functionOption, a, b);
+    InstructionSet instructionSet = detectInstructionSet();
+    int threadCount = (int) std::thread::hardware_concurrency();
+    if (std::isnan(exact) || (b <= a) || !(tolerance > 0.0))
+    {
+        std::cout << "\n\nInvalid rule report settings (function must be 0 through " << (NUMBER_OF_FUNCTIONS - 1) << ", b must be larger than a, and tolerance must be positive).\n\n";
+        return 2;
+    }
+    std::vector<std::string> methods = { "left", "right", "midpoint", "trapezoid", "simpson", "boole" };
+    for (int order : { 2, 3, 4, 5, 6, 8, 16, 32, 64 }) methods.push_back("gauss-legendre-" + std::to_string(order));
+    std::ofstream noFile;
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nRule Report (function " << functionOption << ", [" << a << "," << b << "], tolerance " << tolerance << ", " << nameOfInstructionSet(instructionSet) << ")";
+    std::cout << "\n--------------------------------";
+    for (const std::string & method : methods)
+    {
+        Rule rule = ruleFromMethod(method);
+        RiemannEngine engine = { selectRiemannKernel(functionOption, rule, instructionSet), selectBatchEvaluator(functionOption, instructionSet), Accumulator::Naive, (threadCount < 1) ? 1 : threadCount, rule, gaussLegendreOrderFromMethod(method), Polynomial(), nullptr, 0 };
+        double error = 0.0;
+        uint64_t n = 0, evaluations = evaluationsToTolerance(engine, a, b, exact, tolerance, error, n);
+        if (evaluations > 0) std::cout << "\n\n" << method << ": " << evaluations << " evaluations (n = " << n << "), error " << error << ".";
+        else std::cout << "\n\n" << method << ": tolerance not reached within " << RULE_REPORT_MAXIMUM_EVALUATIONS << " evaluations (smallest error " << error << ").";
+    }
+    std::cout.precision(17);
+    std::cout << "\n\nexact integral = " << exact << ".";
+    std::cout << "\n\n--------------------------------\n\n";
+    return 0;
+}
+
+/**
+ * This function returns the 15-point Kronrod estimate of the integral of f (the function which evaluator evaluates) over [a,b] 
+ * and the estimated error of that estimate (as a Subinterval).
+ * 
+ * The 15 points are the 7 Gauss-Legendre nodes and the 8 Kronrod nodes which interleave them (so the 7-point Gauss estimate costs no extra evaluations), 
+ * and all 15 are evaluated in one call to evaluator. 
+ * The error estimate is the one used by QUADPACK: |Kronrod - Gauss| is rescaled by the spread of f around its mean on [a,b] 
+ * (which makes it sharper when the two rules agree well) and is never smaller than 50 times the rounding error of the estimate.
+ */
+Subinterval evaluateGaussKronrod(BatchEvaluator evaluator, double a, double b)
+{
+    // Store the non-negative Kronrod nodes (the odd-numbered ones are also the Gauss nodes), the Kronrod weights, and the Gauss weights.
+    static const double nodes[8] = { 0.991455371120812639206854697526329, 0.949107912342758524526189684047851, 0.864864423359769072789712788640926, 0.741531185599394439863864773280788, 
+                                     0.586087235467691130294144845693013, 0.405845151377397166906606412076961, 0.207784955007898467600689403773245, 0.0 };
+    static const double kronrodWeights[8] = { 0.022935322010529224963732008058970, 0.063092092629978553290700663189204, 0.104790010322250183839876322541518, 0.140653259715525918745189590510238, 
+                                              0.169004726639267902826583426598550, 0.190350578064785409913256402421014, 0.204432940075298892414161999234649, 0.209482141084727828012999174891714 };
+    static const double gaussWeights[4] = { 0.129484966168869693270611432679082, 0.279705391489276667901467771423780, 0.381830050505118944950369775488975, 0.417959183673469387755102040816327 };
+    double center = 0.5 * (a + b), halfLength = 0.5 * (b - a), x[GAUSS_KRONROD_POINTS], y[GAUSS_KRONROD_POINTS];
+
+    // Store the center first, followed by the pairs of points which are symmetric about the center.
+    x[0] = center;
+    for (int j = 0; j < 7; j++)
+    {
+        x[1 + 2 * j] = center - halfLength * nodes[j];
+        x[2 + 2 * j] = center + halfLength * nodes[j];
+    }
+    evaluator(x, y, GAUSS_KRONROD_POINTS);
+    double kronrod = kronrodWeights[7] * y[0], gauss = gaussWeights[3] * y[0], absolute = kronrodWeights[7] * std::fabs(y[0]);
+    for (int j = 0; j < 7; j++)
+    {
+        kronrod += kronrodWeights[j] * (y[1 + 2 * j] + y[2 + 2 * j]);
+        absolute += kronrodWeights[j] * (std::fabs(y[1 + 2 * j]) + std::fabs(y[2 + 2 * j]));
+        if (j % 2 == 1) gauss += gaussWeights[j / 2] * (y[1 + 2 * j] + y[2 + 2 * j]);
+    }
+
+    // Measure the spread of f around its mean on [a,b] (both weighted by the Kronrod weights).
+    double mean = 0.5 * kronrod, spread = kronrodWeights[7] * std::fabs(y[0] - mean);
+    for (int j = 0; j < 7; j++) spread += kronrodWeights[j] * (std::fabs(y[1 + 2 * j] - mean) + std::fabs(y[2 + 2 * j] - mean));
+    double error = std::fabs((kronrod - gauss) * halfLength);
+    absolute *= std::fabs(halfLength);
+    spread *= std::fabs(halfLength);
+    if ((spread != 0.0) && (error != 0.0)) error = spread * std::fmin(1.0, std::pow(200.0 * error / spread, 1.5));
+    if (absolute > DBL_MIN / (50.0 * DBL_EPSILON)) error = std::fmax(50.0 * DBL_EPSILON * absolute, error);
+    return { a, b, kronrod * halfLength, error };
+}
+
+/**
+ * This function returns the integral of f (the function which evaluator evaluates) over [a,b] computed with adaptive Gauss-Kronrod quadrature, 
+ * which stops when the error bound is at most absoluteTolerance or at most relativeTolerance times the magnitude of the estimate.
+ * 
+ * The subintervals are stored in a priority queue (largest estimated error first). In each round, the subintervals with the largest errors are removed from the queue 
+ * (as many as are needed for their errors to add up to the amount by which the error bound exceeds the tolerance, up to ADAPTIVE_BATCH_SIZE), 
+ * both halves of each of them are evaluated on the thread pool (one task per half), and the halves are added to the queue. 
+ * The batches do not depend on threadCount, so the result is bit-identical for every threadCount. 
+ * Refinement also stops after ADAPTIVE_MAXIMUM_SUBINTERVALS subintervals, or when a subinterval is too narrow to be bisected in double arithmetic 
+ * (in which case converged is false). 
+ * If an estimate or error of any subinterval is not finite (e.g. because f is undefined somewhere in [a,b]), refinement stops at once 
+ * (before that subinterval is added to the queue, whose ordering needs comparable errors), and the estimate and error bound are NaN (and converged is false).
+ * 
+ * The final estimate and error bound are the sums (with Neumaier summation) of the estimates and errors of every subinterval in the queue.
+ */
+AdaptiveResult computeAdaptiveQuadrature(BatchEvaluator evaluator, double a, double b, double absoluteTolerance, double relativeTolerance, int threadCount)
+{
+    std::priority_queue<Subinterval> queue;
+    std::vector<Subinterval> parents, children;
+    AdaptiveResult result = { 0.0, 0.0, GAUSS_KRONROD_POINTS, 1, false };
+    Subinterval whole = evaluateGaussKronrod(evaluator, a, b);
+    double estimate = whole.estimate, error = whole.error;
+    bool resolutionReached = false;
+    if (!std::isfinite(estimate) || !std::isfinite(error)) return { NAN, NAN, result.evaluations, 1, false };
+    queue.push(whole);
+    ThreadPool & pool = acquireThreadPool((threadCount < 1) ? 1 : threadCount);
+    while (!resolutionReached && (queue.size() < ADAPTIVE_MAXIMUM_SUBINTERVALS))
+    {
+        double tolerance = std::fmax(absoluteTolerance, relativeTolerance * std::fabs(estimate));
+        if (error <= tolerance)
+        {
+            result.converged = true;
+            break;
+        }
+
+        // Remove the subintervals with the largest errors (until their errors cover the excess error or the batch is full).
+        double coveredError = 0.0;
+        parents.clear();
+        while (!queue.empty() && (parents.size() < ADAPTIVE_BATCH_SIZE) && (coveredError < error - tolerance))
+        {
+            parents.push_back(queue.top());
+            coveredError += queue.top().error;
+            queue.pop();
+        }
+        if (parents.empty()) break;
+
+        // Evaluate both halves of every removed subinterval on the thread pool.
+        children.resize(2 * parents.size());
+        runOnThreadPool(pool, children.size(), [&](uint64_t k)
+        {
+            const Subinterval & parent = parents[k / 2];
+            double middle = 0.5 * (parent.a + parent.b);
+            children[k] = (k % 2 == 0) ? evaluateGaussKronrod(evaluator, parent.a, middle) : evaluateGaussKronrod(evaluator, middle, parent.b);
+        });
+        result.evaluations += GAUSS_KRONROD_POINTS * children.size();
+
+        // Stop (with a NaN result) if f was not finite on any half, without adding it to the queue.
+        for (const Subinterval & child : children) if (!std::isfinite(child.estimate) || !std::isfinite(child.error)) return { NAN, NAN, result.evaluations, queue.size() + parents.size(), false };
+
+        // Replace each removed subinterval with its halves (unless it is too narrow to be bisected, in which case it is kept and refinement stops).
+        for (size_t k = 0; k < parents.size(); k++)
+        {
+            double middle = 0.5 * (parents[k].a + parents[k].b);
+            if ((middle <= parents[k].a) || (middle >= parents[k].b))
+            {
+                queue.push(parents[k]);
+                resolutionReached = true;
+                continue;
+            }
+            queue.push(children[2 * k]);
+            queue.push(children[2 * k + 1]);
+            estimate += (children[2 * k].estimate + children[2 * k + 1].estimate) - parents[k].estimate;
+            error += (children[2 * k].error + children[2 * k + 1].error) - parents[k].error;
+        }
+    }
+
+    // Add the estimates and errors of every subinterval (the running totals above are only used to decide when to stop).
+    double estimateError = 0.0, errorError = 0.0;
+    result.subintervals = queue.size();
+    while (!queue.empty())
+    {
+        addNeumaier(result.estimate, estimateError, queue.top().estimate);
+        addNeumaier(result.errorBound, errorError, queue.top().error);
+        queue.pop();
+    }
+    result.estimate += estimateError;
+    result.errorBound += errorError;
+    if (result.errorBound <= std::fmax(absoluteTolerance, relativeTolerance * std::fabs(result.estimate))) result.converged = true;
+    return result;
+}
+
+/**
+ * This function computes the integral of the function whose option number is functionOption over [parameters.a, parameters.b] 
+ * with computeAdaptiveQuadrature (using the tolerances stored in parameters, the widest instruction set which this processor supports, and every core), 
+ * prints the estimate, the error bound, the number of function evaluations, and the number of subintervals 
+ * to the command line terminal and to the output file stream, and returns the estimate.
+ */
+double computeAdaptiveIntegral(int functionOption, const Parameters & parameters, std::ofstream & file)
+{
+    BatchEvaluator evaluator = selectBatchEvaluator(functionOption, detectInstructionSet());
+    int threadCount = (int) std::thread::hardware_concurrency();
+    if (evaluator == nullptr) return 0.0;
+
+    // Reject an interval outside of the domain of f (the square root is not defined for negative x), instead of refining around undefined values.
+    if ((functionOption == 4) && (parameters.a < 0.0))
+    {
+        std::cout << "\n\nf(x) = sqrt(x) is not defined for x < 0, so a is required to be at least 0 for adaptive quadrature.";
+        file << "\n\nf(x) = sqrt(x) is not defined for x < 0, so a is required to be at least 0 for adaptive quadrature.";
+        return NAN;
+    }
+    AdaptiveResult result = computeAdaptiveQuadrature(evaluator, parameters.a, parameters.b, parameters.absoluteTolerance, parameters.relativeTolerance, threadCount);
+    std::cout << "\n\nAdaptive Gauss-Kronrod (7-point Gauss, 15-point Kronrod) quadrature " << (result.converged ? "met" : "did NOT meet") << " the tolerance.";
+    std::cout << "\n\nestimate = " << result.estimate << ". // the integral of f over [a,b]";
+    std::cout << "\n\nerror_bound = " << result.errorBound << ". // the sum of the estimated errors of the subintervals";
+    std::cout << "\n\nevaluations = " << result.evaluations << ", subintervals = " << result.subintervals << ".";
+    file << "\n\nAdaptive Gauss-Kronrod (7-point Gauss, 15-point Kronrod) quadrature " << (result.converged ? "met" : "did NOT meet") << " the tolerance.";
+    file << "\n\nestimate = " << result.estimate << ". // the integral of f over [a,b]";
+    file << "\n\nerror_bound = " << result.errorBound << ". // the sum of the estimated errors of the subintervals";
+    file << "\n\nevaluations = " << result.evaluations << ", subintervals = " << result.subintervals << ".";
+    return result.estimate;
+}
+
+/**
+ * This function prints (to the command line terminal) the estimate, error bound, actual error (compared with exactIntegral), number of evaluations, and time 
+ * of adaptive quadrature of the function whose option number is options["function"] over [a,b] with absolute tolerance options["tolerance"] 
+ * and relative tolerance options["relative"], followed by the number of evaluations which the uniform midpoint, Simpson, and Gauss-Legendre (order 7) rules 
+ * need to come within the same absolute tolerance (see evaluationsToTolerance). 
+ * Return 0 if the adaptive error bound met the tolerance and the actual error is within that bound (or 1 otherwise).
+ */
+int runAdaptiveReport(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "function", "4" }, { "a", "0" }, { "b", "3" }, { "tolerance", "1e-10" }, { "relative", "0" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str()), tolerance = atof(settings["tolerance"].c_str()), relative = atof(settings["relative"].c_str());
+    double exact = exactIntegral(functionOption, a, b);
+    InstructionSet instructionSet = detectInstructionSet();
+    int threadCount = (int) std::thread::hardware_concurrency();
+    if (std::isnan(exact) || (b <= a) || !(tolerance > 0.0))
+    {
+        std::cout << "\n\nInvalid adaptive report settings (function must be 0 through " << (NUMBER_OF_FUNCTIONS - 1) << ", b must be larger than a, and tolerance must be positive).\n\n";
+        return 2;
+    }
+    if (threadCount < 1) threadCount = 1;
+    auto start = std::chrono::steady_clock::now();
+    AdaptiveResult result = computeAdaptiveQuadrature(selectBatchEvaluator(functionOption, instructionSet), a, b, tolerance, relative, threadCount);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    double actualError = std::fabs(result.estimate - exact);
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nAdaptive Report (function " << functionOption << ", [" << a << "," << b << "], tolerance " << tolerance << ", relative " << relative << ", " << threadCount << " thread(s))";
+    std::cout << "\n--------------------------------";
+    std::cout << "\n\nadaptive Gauss-Kronrod: " << result.evaluations << " evaluations, " << result.subintervals << " subintervals, " << seconds << " seconds, ";
+    std::cout << "error bound " << result.errorBound << ", actual error " << actualError << (result.converged ? "." : " (tolerance NOT met).");
+    for (const std::string & method : { std::string("midpoint"), std::string("simpson"), std::string("gauss-legendre-7") })
+    {
+        Rule rule = ruleFromMethod(method);
+        RiemannEngine engine = { selectRiemannKernel(functionOption, rule, instructionSet), selectBatchEvaluator(functionOption, instructionSet), Accumulator::Naive, threadCount, rule, gaussLegendreOrderFromMethod(method), Polynomial(), nullptr, 0 };
+        double error = 0.0;
+        uint64_t n = 0, evaluations = evaluationsToTolerance(engine, a, b, exact, tolerance, error, n);
+        if (evaluations > 0) std::cout << "\n\nuniform " << method << ": " << evaluations << " evaluations (" << ((double) evaluations / (double) result.evaluations) << " times as many), error " << error << ".";
+        else std::cout << "\n\nuniform " << method << ": tolerance not reached within " << RULE_REPORT_MAXIMUM_EVALUATIONS << " evaluations (smallest error " << error << ").";
+    }
+    std::cout.precision(17);
+    std::cout << "\n\nadaptive estimate = " << result.estimate << ", exact integral = " << exact << ".";
+    std::cout << "\n\n--------------------------------\n\n";
+    return (result.converged && (actualError <= result.errorBound)) ? 0 : 1;
+}
+
+/**
+ * This function returns the integral of f over [a,b] computed with Romberg integration (where f is the function which engine evaluates), 
+ * which stops when two successive diagonal values of the Romberg tableau differ by at most absoluteTolerance 
+ * or by at most relativeTolerance times the magnitude of the newer value.
+ * 
+ * Row 0 of the tableau is the trapezoid rule on one partition, T(1) = (b - a) * (f(a) + f(b)) / 2. 
+ * When the number of partitions doubles from n to 2n, the end-points of the new partitions are the old end-points and the midpoints of the old partitions, 
+ * so T(2n) = (T(n) + M(n)) / 2 where M(n) is the midpoint rule on n partitions. 
+ * Hence each row evaluates f only at the n new points (with the midpoint kernel of engine on engine.threadCount threads, so engine.rule must be Midpoint), 
+ * and the whole sequence up to 2n partitions evaluates f exactly 2n + 1 times (which is also what the trapezoid rule on 2n partitions alone needs). 
+ * 
+ * Each row k is then extrapolated with Richardson extrapolation (R[k][j] = R[k][j - 1] + (R[k][j - 1] - R[k - 1][j - 1]) / (4^j - 1)), 
+ * which cancels the h^2, h^4, ..., h^(2j) terms of the error of the trapezoid rule (for a smooth f). Only the previous row is stored. 
+ * If showTableau is true, n, the trapezoid value, and the diagonal value of each row are printed to the command line terminal and to file.
+ */
+RombergResult computeRombergIntegral(const RiemannEngine & engine, double a, double b, double absoluteTolerance, double relativeTolerance, bool showTableau, std::ofstream & file)
+{
+    std::vector<double> previousRow, row;
+    RombergResult result = { 0.0, INFINITY, 2, 1, false };
+    double ends[2] = { a, b };
+    engine.evaluator(ends, ends, 2);
+    row.push_back(0.5 * (b - a) * (ends[0] + ends[1]));
+    if (showTableau)
+    {
+        std::cout << "\n\nn = 1: trapezoid = " << row[0] << ", extrapolated = " << row[0] << ".";
+        file << "\n\nn = 1: trapezoid = " << row[0] << ", extrapolated = " << row[0] << ".";
+    }
+    for (int k = 1; k < ROMBERG_MAXIMUM_LEVELS; k++)
+    {
+        // Evaluate f at the midpoints of the current n partitions (the only new points of the trapezoid rule on 2n partitions).
+        double dx = (b - a) / (double) result.n;
+        double midpoint = dx * sumRectangleHeightsInParallel(engine, a, dx, result.n, false, file);
+        result.evaluations += result.n;
+        result.n *= 2;
+
+        // Compute row k of the tableau from row k - 1.
+        previousRow.swap(row);
+        row.assign(k + 1, 0.0);
+        row[0] = 0.5 * (previousRow[0] + midpoint);
+        double factor = 1.0;
+        for (int j = 1; j <= k; j++)
+        {
+            factor *= 4.0;
+            row[j] = row[j - 1] + (row[j - 1] - previousRow[j - 1]) / (factor - 1.0);
+        }
+        result.estimate = row[k];
+        result.difference = std::fabs(row[k] - previousRow[k - 1]);
+        if (showTableau)
+        {
+            std::cout << "\n\nn = " << result.n << ": trapezoid = " << row[0] << ", extrapolated = " << row[k] << ", difference = " << result.difference << ".";
+            file << "\n\nn = " << result.n << ": trapezoid = " << row[0] << ", extrapolated = " << row[k] << ", difference = " << result.difference << ".";
+        }
+
+        // Stop when the diagonal has settled (but never on the first row, whose difference compares only two low-order rules).
+        if ((k >= 2) && (result.difference <= std::fmax(absoluteTolerance, relativeTolerance * std::fabs(row[k]))))
+        {
+            result.converged = true;
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * This function prints (to the command line terminal) the diagonal of the Romberg tableau (see computeRombergIntegral) 
+ * of the function whose option number is options["function"] over [a,b] with absolute tolerance options["tolerance"] and relative tolerance options["relative"], 
+ * followed by the actual error (compared with exactIntegral), the number of function evaluations, and the number of evaluations which 
+ * recomputing every trapezoid rule of the sequence from scratch would have needed. 
+ * Return 0 if the tableau converged (or 1 otherwise).
+ */
+int runRombergReport(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "function", "2" }, { "a", "0" }, { "b", "3" }, { "tolerance", "1e-12" }, { "relative", "0" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str()), tolerance = atof(settings["tolerance"].c_str()), relative = atof(settings["relative"].c_str());
+    double exact = exactIntegral(functionOption, a, b);
+    InstructionSet instructionSet = detectInstructionSet();
+    int threadCount = (int) std::thread::hardware_concurrency();
+    std::ofstream noFile;
+    if (std::isnan(exact) || (b <= a) || !(tolerance > 0.0 || relative > 0.0))
+    {
+        std::cout << "\n\nInvalid Romberg report settings (function must be 0 through " << (NUMBER_OF_FUNCTIONS - 1) << ", b must be larger than a, and a tolerance must be positive).\n\n";
+        return 2;
+    }
+    if (threadCount < 1) threadCount = 1;
+    RiemannEngine engine = { selectRiemannKernel(functionOption, Rule::Midpoint, instructionSet), selectBatchEvaluator(functionOption, instructionSet), Accumulator::VectorCompensated, threadCount, Rule::Midpoint, 0, Polynomial(), nullptr, 0 };
+    std::cout.precision(17);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nRomberg Report (function " << functionOption << ", [" << a << "," << b << "], tolerance " << tolerance << ", relative " << relative << ", " << threadCount << " thread(s))";
+    std::cout << "\n--------------------------------";
+    auto start = std::chrono::steady_clock::now();
+    RombergResult result = computeRombergIntegral(engine, a, b, tolerance, relative, true, noFile);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    // Recomputing the trapezoid rule on 1, 2, 4, ..., n partitions from scratch would evaluate f 2 + 3 + 5 + ... + (n + 1) = 2n + log2(n) times.
+    uint64_t fromScratch = 0;
+    for (uint64_t n = 1; n <= result.n; n *= 2) fromScratch += n + 1;
+    std::cout.precision(6);
+    std::cout << "\n\n" << (result.converged ? "Converged" : "Did NOT converge") << " after n = " << result.n << " partitions: " << result.evaluations << " evaluations (" << fromScratch << " if every row were recomputed from scratch), " << seconds << " seconds.";
+    std::cout << "\n\ndifference = " << result.difference << ", actual error = " << std::fabs(result.estimate - exact) << ".";
+    std::cout << "\n\n--------------------------------\n\n";
+    return result.converged ? 0 : 1;
+}
+
+/**
+ * This function compiles text (a user-defined function f(x)) into program and returns true
+ * (or stores the reason in error and the index of the character at which compilation stopped in errorPosition, and returns false, leaving program unchanged).
+ *
+ * The grammar (from the loosest to the tightest binding) is:
+ * sum = product (('+' | '-') product)*,
+ * product = unary (('*' | '/') unary | power)* (where a power which directly follows a factor, e.g. "2x" or "3sin(x)", is multiplied by it),
+ * unary = ('-' | '+') unary | power,
+ * power = primary ('^' unary)? (so ^ is right-associative and binds tighter than a leading minus, i.e. -x^2 = -(x^2)),
+ * primary = number | x | pi | e | name '(' sum ')' | pow '(' sum ',' sum ')' | '(' sum ')'.
+ *
+ * Every node is simplified as it is created (see addExpressionNode). The simplified tree is then compiled into register instructions (see emitExpressionNode),
+ * so evaluating f over a batch of x values executes each instruction once for the whole batch (rather than walking the tree once per x value).
+ */
+bool compileExpression(const std::string & text, ExpressionProgram & program, std::string & error, size_t & errorPosition)
+{
+    static uint64_t compilations = 0;
+    std::vector<ExpressionNode> nodes;
+    std::vector<int> freeRegisters;
+    size_t position = 0;
+    error.clear();
+    int root = parseExpressionSum(text, position, nodes, error);
+    skipExpressionSpaces(text, position);
+    if ((root >= 0) && (position < text.size()))
+    {
+        error = std::string("unexpected character '") + text[position] + "'";
+        root = -1;
+    }
+    if (root < 0)
+    {
+        errorPosition = position;
+        return false;
+    }
+
+    // Store the constants in the registers which follow x, then emit the instructions (whose intermediate values use the registers which follow the constants).
+    ExpressionProgram compiled = { text, {}, {}, 1, 0, 0 };
+    collectExpressionConstants(nodes, root, compiled);
+    compiled.registerCount = 1 + (int) compiled.constants.size();
+    compiled.result = (compiled.registerCount <= EXPRESSION_MAXIMUM_REGISTERS) ? emitExpressionNode(nodes, root, compiled, freeRegisters, error) : -1;
+    if (compiled.result < 0)
+    {
+        if (error.empty()) error = "the expression needs more than " + std::to_string(EXPRESSION_MAXIMUM_REGISTERS) + " registers";
+        errorPosition = text.size();
+        return false;
+    }
+    compiled.identifier = ++compilations;
+    program = compiled;
+    return true;
+}
+
+/**
+ * This function appends the node operation(left, right) (or the constant value, if operation is Constant) to nodes and returns its index,
+ * after simplifying it. If every operand of the node is a constant, the node is replaced with the constant which it evaluates to.
+ * Otherwise the following identities (which hold in double arithmetic, except for the sign of a zero result) are applied:
+ * u + 0 = 0 + u = u, u - 0 = u, 0 - u = -u, u + (-v) = u - v, u - (-v) = u + v, u * 1 = 1 * u = u, u * -1 = -1 * u = -u, u / 1 = u, -(-u) = u,
+ * u^1 = u, u^0 = 1, u^2 = u * u (Square), u^3 = u * u * u (Cube), u^-1 = 1 / u,
+ * and division by a power of two is replaced with multiplication by its (exact) reciprocal.
+ */
+int addExpressionNode(std::vector<ExpressionNode> & nodes, ExpressionOperation operation, double value, int left, int right)
+{
+    auto isConstant = [&](int index) { return (index >= 0) && (nodes[index].operation == ExpressionOperation::Constant); };
+    auto isConstantEqualTo = [&](int index, double constant) { return isConstant(index) && (nodes[index].value == constant); };
+    if ((operation != ExpressionOperation::Constant) && (operation != ExpressionOperation::Variable) && isConstant(left) && ((right < 0) || isConstant(right)))
+    {
+        value = applyExpressionOperation(operation, nodes[left].value, (right < 0) ? 0.0 : nodes[right].value);
+        operation = ExpressionOperation::Constant;
+        left = right = -1;
+    }
+    else if (operation == ExpressionOperation::Add)
+    {
+        if (isConstantEqualTo(right, 0.0)) return left;
+        if (isConstantEqualTo(left, 0.0)) return right;
+        if (nodes[right].operation == ExpressionOperation::Negate) return addExpressionNode(nodes, ExpressionOperation::Subtract, 0.0, left, nodes[right].left);
+    }
+    else if (operation == ExpressionOperation::Subtract)
+    {
+        if (isConstantEqualTo(right, 0.0)) return left;
+        if (isConstantEqualTo(left, 0.0)) return addExpressionNode(nodes, ExpressionOperation::Negate, 0.0, right, -1);
+        if (nodes[right].operation == ExpressionOperation::Negate) return addExpressionNode(nodes, ExpressionOperation::Add, 0.0, left, nodes[right].left);
+    }
+    else if (operation == ExpressionOperation::Multiply)
+    {
+        if (isConstantEqualTo(right, 1.0)) return left;
+        if (isConstantEqualTo(left, 1.0)) return right;
+        if (isConstantEqualTo(right, -1.0)) return addExpressionNode(nodes, ExpressionOperation::Negate, 0.0, left, -1);
+        if (isConstantEqualTo(left, -1.0)) return addExpressionNode(nodes, ExpressionOperation::Negate, 0.0, right, -1);
+    }
+    else if (operation == ExpressionOperation::Divide)
+    {
+        int exponent = 0;
+        if (isConstantEqualTo(right, 1.0)) return left;
+        if (isConstant(right) && std::isnormal(nodes[right].value) && (std::fabs(std::frexp(nodes[right].value, &exponent)) == 0.5) && std::isnormal(1.0 / nodes[right].value))
+        {
+            int reciprocal = addExpressionNode(nodes, ExpressionOperation::Constant, 1.0 / nodes[right].value, -1, -1);
+            return addExpressionNode(nodes, ExpressionOperation::Multiply, 0.0, left, reciprocal);
+        }
+    }
+    else if (operation == ExpressionOperation::Power)
+    {
+        if (isConstantEqualTo(right, 1.0)) return left;
+        if (isConstantEqualTo(right, 0.0)) return addExpressionNode(nodes, ExpressionOperation::Constant, 1.0, -1, -1);
+        if (isConstantEqualTo(right, 2.0)) return addExpressionNode(nodes, ExpressionOperation::Square, 0.0, left, -1);
+        if (isConstantEqualTo(right, 3.0)) return addExpressionNode(nodes, ExpressionOperation::Cube, 0.0, left, -1);
+        if (isConstantEqualTo(right, -1.0)) return addExpressionNode(nodes, ExpressionOperation::Divide, 0.0, addExpressionNode(nodes, ExpressionOperation::Constant, 1.0, -1, -1), left);
+    }
+    else if ((operation == ExpressionOperation::Negate) && (nodes[left].operation == ExpressionOperation::Negate)) return nodes[left].left;
+    nodes.push_back({ operation, value, left, right });
+    return (int) nodes.size() - 1;
+}
+
+// This function advances position past any spaces (or tabs) in text.
+void skipExpressionSpaces(const std::string & text, size_t & position)
+{
+    while ((position < text.size()) && ((text[position] == ' ') || (text[position] == '\t'))) position++;
+}
+
+/**
+ * These functions parse one rule of the grammar of compileExpression from text (starting at position), append the nodes of what they parsed to nodes,
+ * advance position past it, and return the index of its node (or store the reason in error and return -1).
+ */
+int parseExpressionSum(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error)
+{
+    int left = parseExpressionProduct(text, position, nodes, error);
+    while (left >= 0)
+    {
+        skipExpressionSpaces(text, position);
+        if ((position >= text.size()) || ((text[position] != '+') && (text[position] != '-'))) break;
+        ExpressionOperation operation = (text[position++] == '+') ? ExpressionOperation::Add : ExpressionOperation::Subtract;
+        int right = parseExpressionProduct(text, position, nodes, error);
+        if (right < 0) return -1;
+        left = addExpressionNode(nodes, operation, 0.0, left, right);
+    }
+    return left;
+}
+
+int parseExpressionProduct(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error)
+{
+    int left = parseExpressionUnary(text, position, nodes, error);
+    while (left >= 0)
+    {
+        int right = -1;
+        ExpressionOperation operation = ExpressionOperation::Multiply;
+        skipExpressionSpaces(text, position);
+        if (position >= text.size()) break;
+        if ((text[position] == '*') || (text[position] == '/'))
+        {
+            if (text[position++] == '/') operation = ExpressionOperation::Divide;
+            right = parseExpressionUnary(text, position, nodes, error);
+        }
+        else if ((text[position] == '(') || std::isalpha((unsigned char) text[position])) right = parseExpressionPower(text, position, nodes, error);
+        else break;
+        if (right < 0) return -1;
+        left = addExpressionNode(nodes, operation, 0.0, left, right);
+    }
+    return left;
+}
+
+int parseExpressionUnary(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error)
+{
+    skipExpressionSpaces(text, position);
+    if ((position < text.size()) && ((text[position] == '-') || (text[position] == '+')))
+    {
+        bool negate = (text[position++] == '-');
+        int operand = parseExpressionUnary(text, position, nodes, error);
+        if ((operand < 0) || !negate) return operand;
+        return addExpressionNode(nodes, ExpressionOperation::Negate, 0.0, operand, -1);
+    }
+    return parseExpressionPower(text, position, nodes, error);
+}
+
+int parseExpressionPower(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error)
+{
+    int base = parseExpressionPrimary(text, position, nodes, error);
+    if (base < 0) return -1;
+    skipExpressionSpaces(text, position);
+    if ((position >= text.size()) || (text[position] != '^')) return base;
+    position++;
+    int exponent = parseExpressionUnary(text, position, nodes, error);
+    if (exponent < 0) return -1;
+    return addExpressionNode(nodes, ExpressionOperation::Power, 0.0, base, exponent);
+}
+
+int parseExpressionPrimary(const std::string & text, size_t & position, std::vector<ExpressionNode> & nodes, std::string & error)
+{
+    static const std::map<std::string, ExpressionOperation> functions = {
+        { "sqrt", ExpressionOperation::SquareRoot }, { "abs", ExpressionOperation::AbsoluteValue }, { "floor", ExpressionOperation::Floor }, { "ceil", ExpressionOperation::Ceiling },
+        { "exp", ExpressionOperation::Exponential }, { "log", ExpressionOperation::Logarithm }, { "ln", ExpressionOperation::Logarithm }, { "log10", ExpressionOperation::Logarithm10 },
+        { "sin", ExpressionOperation::Sine }, { "cos", ExpressionOperation::Cosine }, { "tan", ExpressionOperation::Tangent },
+        { "asin", ExpressionOperation::ArcSine }, { "acos", ExpressionOperation::ArcCosine }, { "atan", ExpressionOperation::ArcTangent },
+        { "sinh", ExpressionOperation::HyperbolicSine }, { "cosh", ExpressionOperation::HyperbolicCosine }, { "tanh", ExpressionOperation::HyperbolicTangent },
+        { "pow", ExpressionOperation::Power }
+    };
+    skipExpressionSpaces(text, position);
+    if (position >= text.size())
+    {
+        error = "unexpected end of the expression";
+        return -1;
+    }
+    char c = text[position];
+
+    // Parse a number (with strtod, so that a decimal point and an exponent such as 1.5e-3 are accepted).
+    if (std::isdigit((unsigned char) c) || (c == '.'))
+    {
+        char * end = nullptr;
+        double value = std::strtod(text.c_str() + position, &end);
+        if (end == text.c_str() + position)
+        {
+            error = "invalid number";
+            return -1;
+        }
+        position = end - text.c_str();
+        return addExpressionNode(nodes, ExpressionOperation::Constant, value, -1, -1);
+    }
+
+    // Parse a parenthesized sum.
+    if (c == '(')
+    {
+        position++;
+        int inner = parseExpressionSum(text, position, nodes, error);
+        if (inner < 0) return -1;
+        skipExpressionSpaces(text, position);
+        if ((position >= text.size()) || (text[position] != ')'))
+        {
+            error = "expected ')'";
+            return -1;
+        }
+        position++;
+        return inner;
+    }
+    if (!std::isalpha((unsigned char) c))
+    {
+        error = std::string("unexpected character '") + c + "'";
+        return -1;
+    }
+
+    // Parse x, a named constant, or a call of a function (whose arguments are sums).
+    size_t start = position;
+    while ((position < text.size()) && std::isalnum((unsigned char) text[position])) position++;
+    std::string name = text.substr(start, position - start);
+    if (name == "x") return addExpressionNode(nodes, ExpressionOperation::Variable, 0.0, -1, -1);
+    if (name == "pi") return addExpressionNode(nodes, ExpressionOperation::Constant, 3.14159265358979323846, -1, -1);
+    if (name == "e") return addExpressionNode(nodes, ExpressionOperation::Constant, 2.71828182845904523536, -1, -1);
+    auto function = functions.find(name);
+    if (function == functions.end())
+    {
+        position = start;
+        error = "unknown name \"" + name + "\"";
+        return -1;
+    }
+    skipExpressionSpaces(text, position);
+    if ((position >= text.size()) || (text[position] != '('))
+    {
+        error = "expected '(' after \"" + name + "\"";
+        return -1;
+    }
+    position++;
+    int argument = parseExpressionSum(text, position, nodes, error), second = -1;
+    if (argument < 0) return -1;
+    skipExpressionSpaces(text, position);
+    if (function->second == ExpressionOperation::Power)
+    {
+        if ((position >= text.size()) || (text[position] != ','))
+        {
+            error = "expected ',' (pow takes two arguments)";
+            return -1;
+        }
+        position++;
+        second = parseExpressionSum(text, position, nodes, error);
+        if (second < 0) return -1;
+        skipExpressionSpaces(text, position);
+    }
+    if ((position >= text.size()) || (text[position] != ')'))
+    {
+        error = "expected ')'";
+        return -1;
+    }
+    position++;
+    return addExpressionNode(nodes, function->second, 0.0, argument, second);
+}
+
+// This function appends every distinct constant (compared bit by bit, so 0 and -0 are distinct) of the tree whose root is nodes[index] to program.constants.
+void collectExpressionConstants(const std::vector<ExpressionNode> & nodes, int index, ExpressionProgram & program)
+{
+    const ExpressionNode & node = nodes[index];
+    if (node.operation == ExpressionOperation::Constant)
+    {
+        for (double constant : program.constants) if (std::memcmp(&constant, &node.value, sizeof(double)) == 0) return;
+        program.constants.push_back(node.value);
+        return;
+    }
+    if (node.left >= 0) collectExpressionConstants(nodes, node.left, program);
+    if (node.right >= 0) collectExpressionConstants(nodes, node.right, program);
+}
+
+/**
+ * This function appends the instructions which compute the tree whose root is nodes[index] to program.instructions (operands first)
+ * and returns the register which holds its value (or stores the reason in error and returns -1).
+ * x and the constants are already in their registers, so they need no instructions.
+ * The register of an intermediate value is returned to freeRegisters as soon as the instruction which uses it is emitted,
+ * so the number of registers grows with the depth of the tree rather than with its size.
+ */
+int emitExpressionNode(const std::vector<ExpressionNode> & nodes, int index, ExpressionProgram & program, std::vector<int> & freeRegisters, std::string & error)
+{
+    const ExpressionNode & node = nodes[index];
+    int firstTemporary = 1 + (int) program.constants.size(), left = 0, right = 0, destination = 0;
+    if (node.operation == ExpressionOperation::Variable) return 0;
+    if (node.operation == ExpressionOperation::Constant)
+    {
+        for (size_t k = 0; k < program.constants.size(); k++) if (std::memcmp(&program.constants[k], &node.value, sizeof(double)) == 0) return 1 + (int) k;
+        error = "missing constant";
+        return -1;
+    }
+    left = emitExpressionNode(nodes, node.left, program, freeRegisters, error);
+    if (left < 0) return -1;
+    if (node.right >= 0)
+    {
+        right = emitExpressionNode(nodes, node.right, program, freeRegisters, error);
+        if (right < 0) return -1;
+    }
+    if (left >= firstTemporary) freeRegisters.push_back(left);
+    if ((right >= firstTemporary) && (right != left)) freeRegisters.push_back(right);
+    if (!freeRegisters.empty())
+    {
+        destination = freeRegisters.back();
+        freeRegisters.pop_back();
+    }
+    else if (program.registerCount < EXPRESSION_MAXIMUM_REGISTERS) destination = program.registerCount++;
+    else return -1;
+    program.instructions.push_back({ node.operation, destination, left, right });
+    return destination;
+}
+
+// This function returns operation applied to left (and to right, if operation takes two operands).
+double applyExpressionOperation(ExpressionOperation operation, double left, double right)
+{
+    switch (operation)
+    {
+        case ExpressionOperation::Add: return left + right;
+        case ExpressionOperation::Subtract: return left - right;
+        case ExpressionOperation::Multiply: return left * right;
+        case ExpressionOperation::Divide: return left / right;
+        case ExpressionOperation::Power: return std::pow(left, right);
+        case ExpressionOperation::Negate: return -left;
+        case ExpressionOperation::Square: return left * left;
+        case ExpressionOperation::Cube: return left * left * left;
+        case ExpressionOperation::SquareRoot: return std::sqrt(left);
+        case ExpressionOperation::AbsoluteValue: return std::fabs(left);
+        case ExpressionOperation::Floor: return std::floor(left);
+        case ExpressionOperation::Ceiling: return std::ceil(left);
+        case ExpressionOperation::Exponential: return std::exp(left);
+        case ExpressionOperation::Logarithm: return std::log(left);
+        case ExpressionOperation::Logarithm10: return std::log10(left);
+        case ExpressionOperation::Sine: return std::sin(left);
+        case ExpressionOperation::Cosine: return std::cos(left);
+        case ExpressionOperation::Tangent: return std::tan(left);
+        case ExpressionOperation::ArcSine: return std::asin(left);
+        case ExpressionOperation::ArcCosine: return std::acos(left);
+        case ExpressionOperation::ArcTangent: return std::atan(left);
+        case ExpressionOperation::HyperbolicSine: return std::sinh(left);
+        case ExpressionOperation::HyperbolicCosine: return std::cosh(left);
+        case ExpressionOperation::HyperbolicTangent: return std::tanh(left);
+        default: return left;
+    }
+}
+
+/**
+ * This function stores operation(left[i], right[i]) in destination[i] for each i in [0, count).
+ * The operation is selected once per batch, and the arithmetic operations are plain loops (which the compiler vectorizes).
+ */
+void applyExpressionOperationToBatch(ExpressionOperation operation, const double * left, const double * right, double * destination, int count)
+{
+    switch (operation)
+    {
+        case ExpressionOperation::Add: for (int i = 0; i < count; i++) destination[i] = left[i] + right[i]; return;
+        case ExpressionOperation::Subtract: for (int i = 0; i < count; i++) destination[i] = left[i] - right[i]; return;
+        case ExpressionOperation::Multiply: for (int i = 0; i < count; i++) destination[i] = left[i] * right[i]; return;
+        case ExpressionOperation::Divide: for (int i = 0; i < count; i++) destination[i] = left[i] / right[i]; return;
+        case ExpressionOperation::Negate: for (int i = 0; i < count; i++) destination[i] = -left[i]; return;
+        case ExpressionOperation::Square: for (int i = 0; i < count; i++) destination[i] = left[i] * left[i]; return;
+        case ExpressionOperation::Cube: for (int i = 0; i < count; i++) destination[i] = left[i] * left[i] * left[i]; return;
+        case ExpressionOperation::SquareRoot: for (int i = 0; i < count; i++) destination[i] = std::sqrt(left[i]); return;
+        case ExpressionOperation::AbsoluteValue: for (int i = 0; i < count; i++) destination[i] = std::fabs(left[i]); return;
+        default: for (int i = 0; i < count; i++) destination[i] = applyExpressionOperation(operation, left[i], right[i]); return;
+    }
+}
+
+// This function returns the symbol of operation (if it is an arithmetic operator) or the name of the function which operation calls.
+std::string nameOfExpressionOperation(ExpressionOperation operation)
+{
+    static const char * const names[] = { "constant", "x", "+", "-", "*", "/", "pow", "-", "square", "cube", "sqrt", "abs", "floor", "ceil",
+        "exp", "log", "log10", "sin", "cos", "tan", "asin", "acos", "atan", "sinh", "cosh", "tanh" };
+    return names[(int) operation];
+}
+
+// This function prints the constants and the instructions of program (one per line) to the command line terminal and to the output file stream.
+void printExpressionProgram(const ExpressionProgram & program, std::ofstream & file)
+{
+    std::cout << "\n\nThat expression was compiled into " << program.instructions.size() << " instruction(s) which use " << program.registerCount << " register(s) (r0 holds x, and the constants are stored once per thread):";
+    file << "\n\nThat expression was compiled into " << program.instructions.size() << " instruction(s) which use " << program.registerCount << " register(s) (r0 holds x, and the constants are stored once per thread):";
+    for (size_t k = 0; k < program.constants.size(); k++)
+    {
+        std::cout << "\n\nr" << (k + 1) << " = " << program.constants[k] << ";";
+        file << "\n\nr" << (k + 1) << " = " << program.constants[k] << ";";
+    }
+    for (const ExpressionInstruction & instruction : program.instructions)
+    {
+        std::string line = "r" + std::to_string(instruction.destination) + " = ";
+        std::string left = "r" + std::to_string(instruction.left), right = "r" + std::to_string(instruction.right), name = nameOfExpressionOperation(instruction.operation);
+        if ((instruction.operation >= ExpressionOperation::Add) && (instruction.operation <= ExpressionOperation::Divide)) line += left + " " + name + " " + right + ";";
+        else if (instruction.operation == ExpressionOperation::Power) line += "pow(" + left + ", " + right + ");";
+        else if (instruction.operation == ExpressionOperation::Negate) line += "-" + left + ";";
+        else line += name + "(" + left + ");";
+        std::cout << "\n\n" << line;
+        file << "\n\n" << line;
+    }
+    std::cout << "\n\nf(x) = r" << program.result << ".";
+    file << "\n\nf(x) = r" << program.result << ".";
+}
+
+/**
+ * This function returns the registers of program which belong to the calling thread (EXPRESSION_BATCH_SIZE doubles per register).
+ * The constants are stored in those registers the first time that the calling thread executes program (i.e. once per thread per compilation).
+ */
+double * loadExpressionRegisters(const ExpressionProgram & program)
+{
+    thread_local std::vector<double> registers;
+    thread_local uint64_t loadedIdentifier = 0;
+    if (loadedIdentifier != program.identifier)
+    {
+        registers.assign((size_t) program.registerCount * EXPRESSION_BATCH_SIZE, 0.0);
+        for (size_t k = 0; k < program.constants.size(); k++) std::fill(registers.begin() + (k + 1) * EXPRESSION_BATCH_SIZE, registers.begin() + (k + 2) * EXPRESSION_BATCH_SIZE, program.constants[k]);
+        loadedIdentifier = program.identifier;
+    }
+    return registers.data();
+}
+
+/**
+ * This function stores f(x[i]) in y[i] for each i in [0, count) (where f is the compiled userDefinedExpression, and x may be the same array as y)
+ * by copying up to EXPRESSION_BATCH_SIZE x values into register 0, executing each instruction once for that whole batch (see applyExpressionOperationToBatch),
+ * and copying the result register into y.
+ */
+void evaluateExpressionBatch(const double * x, double * y, uint64_t count)
+{
+    const ExpressionProgram & program = userDefinedExpression;
+    double * registers = loadExpressionRegisters(program);
+    for (uint64_t first = 0; first < count; first += EXPRESSION_BATCH_SIZE)
+    {
+        int size = ((count - first) < EXPRESSION_BATCH_SIZE) ? (int) (count - first) : EXPRESSION_BATCH_SIZE;
+        std::memcpy(registers, x + first, size * sizeof(double));
+        for (const ExpressionInstruction & instruction : program.instructions)
+            applyExpressionOperationToBatch(instruction.operation, registers + instruction.left * EXPRESSION_BATCH_SIZE, registers + instruction.right * EXPRESSION_BATCH_SIZE, registers + instruction.destination * EXPRESSION_BATCH_SIZE, size);
+        std::memcpy(y + first, registers + program.result * EXPRESSION_BATCH_SIZE, size * sizeof(double));
+    }
+}
+
+/**
+ * This function is the kernel of the user-defined function for rule: it returns the total (weighted) height of the rectangles of partitions first through last - 1 of [a,b]
+ * by storing the x-axis points of up to EXPRESSION_BATCH_SIZE partitions in a buffer (computed as in sumRectangleHeights), 
+ * replacing them with f of those points in place (with evaluator), and adding them (each multiplied by interiorWeightOfRule(rule, i) for the Simpson and Boole rules).
+ */
+template <BatchEvaluator evaluator, Rule rule> double sumExpressionHeights(double a, double dx, uint64_t first, uint64_t last)
+{
+    double heights[EXPRESSION_BATCH_SIZE], sum0 = 0.0, sum1 = 0.0, sum2 = 0.0, sum3 = 0.0;
+    double t = (double) first + offsetOfRule(rule);
+    for (uint64_t i = first; i < last; i += EXPRESSION_BATCH_SIZE, t += EXPRESSION_BATCH_SIZE)
+    {
+        int count = ((last - i) < EXPRESSION_BATCH_SIZE) ? (int) (last - i) : EXPRESSION_BATCH_SIZE, k = 0;
+        for (k = 0; k < count; k++) heights[k] = a + (t + (double) k) * dx; // (an int index converts to double with vector instructions)
+        evaluator(heights, heights, count);
+        if ((rule == Rule::Simpson) || (rule == Rule::Boole)) for (k = 0; k < count; k++) heights[k] *= interiorWeightOfRule(rule, i + k);
+
+        // Add the heights into four partial sums (so that the additions do not form a single serial dependency chain).
+        for (k = 0; k + 4 <= count; k += 4)
+        {
+            sum0 += heights[k];
+            sum1 += heights[k + 1];
+            sum2 += heights[k + 2];
+            sum3 += heights[k + 3];
+        }
+        for (; k < count; k++) sum0 += heights[k];
+    }
+    return (sum0 + sum1) + (sum2 + sum3);
+}
+
+// This function returns the kernel of the user-defined function for rule (which must have a compiled kernel) and instructionSet (see sumExpressionHeights and sumExpressionHeightsVector).
+RiemannKernel selectExpressionKernel(Rule rule, InstructionSet instructionSet)
+{
+    static const RiemannKernel kernels[NUMBER_OF_INSTRUCTION_SETS][NUMBER_OF_RULES] = {
+        { sumExpressionHeights<evaluateExpressionBatch, Rule::Left>, sumExpressionHeights<evaluateExpressionBatch, Rule::Right>, sumExpressionHeights<evaluateExpressionBatch, Rule::Midpoint>,
+          sumExpressionHeights<evaluateExpressionBatch, Rule::Trapezoid>, sumExpressionHeights<evaluateExpressionBatch, Rule::Simpson>, sumExpressionHeights<evaluateExpressionBatch, Rule::Boole> },
+        { sumExpressionHeightsAvx2<Rule::Left>, sumExpressionHeightsAvx2<Rule::Right>, sumExpressionHeightsAvx2<Rule::Midpoint>,
+          sumExpressionHeightsAvx2<Rule::Trapezoid>, sumExpressionHeightsAvx2<Rule::Simpson>, sumExpressionHeightsAvx2<Rule::Boole> },
+        { sumExpressionHeightsAvx512<Rule::Left>, sumExpressionHeightsAvx512<Rule::Right>, sumExpressionHeightsAvx512<Rule::Midpoint>,
+          sumExpressionHeightsAvx512<Rule::Trapezoid>, sumExpressionHeightsAvx512<Rule::Simpson>, sumExpressionHeightsAvx512<Rule::Boole> }
+    };
+    return kernels[(int) instructionSet][(int) rule];
+}
+
+/**
+ * This function prints (to the command line terminal) a comparison of compiled expressions with the compiled kernels of the built-in functions and returns 0
+ * (or 2 if the settings are invalid).
+ *
+ * If options["expression"] was given (and compiled by runCommandLineMode), its program is printed and the midpoint Riemann sum of it over [a,b] with n partitions
+ * is timed on one thread with the scalar interpreter and with the widest instruction set.
+ * Otherwise the text of each built-in function (e.g. "sin(x)") is compiled, and the midpoint Riemann sum of the compiled expression is timed next to
+ * the built-in kernel of the same function (both with the widest instruction set on one thread),
+ * printing the nanoseconds per point of each, their ratio, and the relative difference between the two sums.
+ */
+int runExpressionReport(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "a", "0" }, { "b", "3" }, { "n", "16777216" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str());
+    uint64_t n = strtoull(settings["n"].c_str(), nullptr, 10);
+    InstructionSet instructionSet = detectInstructionSet();
+    std::ofstream noFile;
+    if ((b <= a) || (n < 1))
+    {
+        std::cout << "\n\nInvalid expression report settings (b must be larger than a and n must be positive).\n\n";
+        return 2;
+    }
+    double dx = (b - a) / n;
+
+    // Return the number of nanoseconds per point and the sum of the kernel over the n partitions (the fastest of three runs).
+    auto timeKernel = [&](RiemannKernel kernel, double & sum)
+    {
+        double best = INFINITY;
+        for (int repetition = 0; repetition < 3; repetition++)
+        {
+            auto start = std::chrono::steady_clock::now();
+            sum = kernel(a, dx, 0, n) * dx;
+            double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (seconds < best) best = seconds;
+        }
+        return 1e9 * best / (double) n;
+    };
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nExpression Report ([" << a << "," << b << "], n = " << n << ", midpoint, " << nameOfInstructionSet(instructionSet) << ", 1 thread)";
+    std::cout << "\n--------------------------------";
+    if (options.count("expression") > 0)
+    {
+        double scalarSum = 0.0, vectorSum = 0.0;
+        printExpressionProgram(userDefinedExpression, noFile);
+        double scalarCost = timeKernel(selectExpressionKernel(Rule::Midpoint, InstructionSet::Scalar), scalarSum);
+        double vectorCost = timeKernel(selectExpressionKernel(Rule::Midpoint, instructionSet), vectorSum);
+        std::cout << "\n\nscalar interpreter: " << scalarCost << " ns per point, sum = " << scalarSum << ".";
+        std::cout << "\n\n" << nameOfInstructionSet(instructionSet) << " interpreter: " << vectorCost << " ns per point, sum = " << vectorSum << ".";
+        std::cout << "\n\n--------------------------------\n\n";
+        return 0;
+    }
+    const char * const texts[NUMBER_OF_FUNCTIONS] = { "x^2", "x^3", "sin(x)", "cos(x)", "sqrt(x)", "2x + 3" };
+    for (int functionOption = 0; functionOption < NUMBER_OF_FUNCTIONS; functionOption++)
+    {
+        std::string error;
+        size_t errorPosition = 0;
+        double builtInSum = 0.0, expressionSum = 0.0;
+        compileExpression(texts[functionOption], userDefinedExpression, error, errorPosition);
+        double builtInCost = timeKernel(selectRiemannKernel(functionOption, Rule::Midpoint, instructionSet), builtInSum);
+        double expressionCost = timeKernel(selectExpressionKernel(Rule::Midpoint, instructionSet), expressionSum);
+        std::cout << "\n\nf(x) = " << texts[functionOption] << " (" << userDefinedExpression.instructions.size() << " instruction(s)): built-in " << builtInCost << " ns per point, compiled expression " << expressionCost
+                  << " ns per point (" << (expressionCost / builtInCost) << " times as long), relative difference " << (std::fabs(expressionSum - builtInSum) / std::fabs(builtInSum)) << ".";
+    }
+    std::cout << "\n\n--------------------------------\n\n";
+    return 0;
+}
+
+/**
+ * This function returns the coefficients of the function whose option number (in the list displayed by selectFunctionFromListOfFunctions) is functionOption 
+ * if that function is a polynomial (x^2, x^3, 2x + 3, or a user-defined expression which polynomialOfExpression recognizes), 
+ * or Polynomial() (which is not a polynomial) otherwise.
+ */
+Polynomial polynomialOfFunction(int functionOption)
+{
+    Polynomial polynomial = Polynomial();
+    if ((functionOption == USER_DEFINED_FUNCTION_OPTION) && (userDefinedExpression.identifier != 0)) return polynomialOfExpression(userDefinedExpression);
+    if ((functionOption != 0) && (functionOption != 1) && (functionOption != 5)) return polynomial;
+    polynomial.isPolynomial = true;
+    if (functionOption == 0)
+    {
+        polynomial.degree = 2;
+        polynomial.coefficients[2] = 1.0;
+    }
+    else if (functionOption == 1)
+    {
+        polynomial.degree = 3;
+        polynomial.coefficients[3] = 1.0;
+    }
+    else
+    {
+        polynomial.degree = 1;
+        polynomial.coefficients[0] = 3.0;
+        polynomial.coefficients[1] = 2.0;
+    }
+    return polynomial;
+}
+
+/**
+ * This function returns the coefficients of the compiled expression program if it is a polynomial of degree at most MAXIMUM_POLYNOMIAL_DEGREE 
+ * (or Polynomial() otherwise) by executing its instructions on polynomials instead of on batches of x values. 
+ * Addition, subtraction, negation, multiplication, Square, and Cube of polynomials are polynomials, 
+ * and so are division by a nonzero constant and a power whose exponent is a constant nonnegative integer. 
+ * Any other operation of a non-constant operand (e.g. sin(x) or 1 / x) means that the expression is not a polynomial 
+ * (constant operands were already folded by compileExpression, e.g. sin(pi / 2) * x is the polynomial 1 * x).
+ */
+Polynomial polynomialOfExpression(const ExpressionProgram & program)
+{
+    std::vector<Polynomial> registers(program.registerCount, Polynomial());
+    registers[0].isPolynomial = true;
+    registers[0].degree = 1;
+    registers[0].coefficients[1] = 1.0;
+    for (size_t k = 0; k < program.constants.size(); k++)
+    {
+        registers[k + 1].isPolynomial = true;
+        registers[k + 1].coefficients[0] = program.constants[k];
+    }
+    for (const ExpressionInstruction & instruction : program.instructions)
+    {
+        const Polynomial left = registers[instruction.left], right = registers[instruction.right];
+        Polynomial result = Polynomial();
+        bool rightIsConstant = right.isPolynomial && (right.degree == 0);
+        switch (instruction.operation)
+        {
+            case ExpressionOperation::Add:
+            case ExpressionOperation::Subtract:
+                result.isPolynomial = left.isPolynomial && right.isPolynomial;
+                result.degree = std::max(left.degree, right.degree);
+                for (int m = 0; m <= MAXIMUM_POLYNOMIAL_DEGREE; m++)
+                    result.coefficients[m] = (instruction.operation == ExpressionOperation::Add) ? (left.coefficients[m] + right.coefficients[m]) : (left.coefficients[m] - right.coefficients[m]);
+                break;
+            case ExpressionOperation::Negate:
+                result = left;
+                for (int m = 0; m <= MAXIMUM_POLYNOMIAL_DEGREE; m++) result.coefficients[m] = -left.coefficients[m];
+                break;
+            case ExpressionOperation::Multiply: result = multiplyPolynomials(left, right); break;
+            case ExpressionOperation::Square: result = multiplyPolynomials(left, left); break;
+            case ExpressionOperation::Cube: result = multiplyPolynomials(multiplyPolynomials(left, left), left); break;
+            case ExpressionOperation::Divide:
+                if (!rightIsConstant || (right.coefficients[0] == 0.0)) break;
+                result = left;
+                for (int m = 0; m <= MAXIMUM_POLYNOMIAL_DEGREE; m++) result.coefficients[m] = left.coefficients[m] / right.coefficients[0];
+                break;
+            case ExpressionOperation::Power:
+                if (!rightIsConstant || (right.coefficients[0] < 0.0) || (right.coefficients[0] > MAXIMUM_POLYNOMIAL_DEGREE) || (right.coefficients[0] != std::floor(right.coefficients[0]))) break;
+                result.isPolynomial = true;
+                result.coefficients[0] = 1.0;
+                for (int power = 0; power < (int) right.coefficients[0]; power++) result = multiplyPolynomials(result, left);
+                break;
+            default: break;
+        }
+
+        // Lower the degree past any leading coefficients which cancelled (e.g. x^2 - x^2 is the constant 0).
+        while (result.isPolynomial && (result.degree > 0) && (result.coefficients[result.degree] == 0.0)) result.degree--;
+        registers[instruction.destination] = result;
+    }
+    return registers[program.result];
+}
+
+// This function returns left * right (or Polynomial() if either one is not a polynomial or if the degree of the product is larger than MAXIMUM_POLYNOMIAL_DEGREE).
+Polynomial multiplyPolynomials(const Polynomial & left, const Polynomial & right)
+{
+    Polynomial product = Polynomial();
+    if (!left.isPolynomial || !right.isPolynomial || (left.degree + right.degree > MAXIMUM_POLYNOMIAL_DEGREE)) return product;
+    product.isPolynomial = true;
+    product.degree = left.degree + right.degree;
+    for (int i = 0; i <= left.degree; i++)
+        for (int j = 0; j <= right.degree; j++) product.coefficients[i + j] += left.coefficients[i] * right.coefficients[j];
+    return product;
+}
+
+// This function returns the order-th derivative of polynomial at x (using Horner's method on the coefficients of that derivative), where order is at least 0.
+double evaluatePolynomialDerivative(const Polynomial & polynomial, int order, double x)
+{
+    double value = 0.0;
+    for (int m = polynomial.degree; m >= order; m--)
+    {
+        double coefficient = polynomial.coefficients[m];
+        for (int j = 0; j < order; j++) coefficient *= (double) (m - j);
+        value = value * x + coefficient;
+    }
+    return value;
+}
+
+/**
+ * This function returns the Riemann sum dx * (f(a + offset * dx) + f(a + (1 + offset) * dx) + ... + f(a + (n - 1 + offset) * dx)) in closed form, 
+ * where f is polynomial (of degree d) and dx = (b - a) / n, using the Euler-Maclaurin formula 
+ * (which is exact for polynomials because every derivative of order d + 1 or higher is zero): 
+ * 
+ * sum = F(b) - F(a) + (B_1(offset) dx / 1!) (f(b) - f(a)) + (B_2(offset) dx^2 / 2!) (f'(b) - f'(a)) + ... + (B_(d+1)(offset) dx^(d+1) / (d+1)!) (f^(d)(b) - f^(d)(a)), 
+ * 
+ * where F is an antiderivative of f and B_k(t) = C(k,0) B_0 t^k + C(k,1) B_1 t^(k-1) + ... + C(k,k) B_k is the kth Bernoulli polynomial. 
+ * The number of operations depends only on d (not on n), and the result differs from the numeric sum only by the rounding of each.
+ */
+double closedFormRiemannSum(const Polynomial & polynomial, double a, double b, uint64_t n, double offset)
+{
+    double dx = (b - a) / n, sum = 0.0, power = 1.0, factorial = 1.0;
+
+    // Add the exact integral F(b) - F(a), where the coefficient of x^(m+1) in F is the coefficient of x^m in f divided by m + 1.
+    for (int m = 0; m <= polynomial.degree; m++) sum += polynomial.coefficients[m] * (std::pow(b, m + 1) - std::pow(a, m + 1)) / (m + 1);
+
+    // Add the Euler-Maclaurin corrections (the last of which uses the dth derivative of f, which is a constant).
+    for (int k = 1; k <= polynomial.degree + 1; k++)
+    {
+        double bernoulliPolynomial = 0.0, binomial = 1.0; // binomial is C(k,j)
+        for (int j = 0; j <= k; j++)
+        {
+            bernoulliPolynomial += binomial * bernoulliNumbers.values[j] * std::pow(offset, k - j);
+            binomial = binomial * (k - j) / (j + 1);
+        }
+        power *= dx;
+        factorial *= k;
+        sum += bernoulliPolynomial * power / factorial * (evaluatePolynomialDerivative(polynomial, k - 1, b) - evaluatePolynomialDerivative(polynomial, k - 1, a));
+    }
+    return sum;
+}
+
+/**
+ * This function returns, in closed form, what computeQuadrature returns for the polynomial f over the n partitions of [a,b] with rule (and order, if rule is GaussLegendre). 
+ * The rectangle rules are closedFormRiemannSum with the offset of the rule, and the trapezoid rule is the mean of the left and right sums. 
+ * The composite Simpson rule on n partitions is (4 T(n) - T(n / 2)) / 3 and the composite Boole rule is (16 S(n) - S(n / 2)) / 15 
+ * (where T and S are the trapezoid and Simpson rules, so n must be even for Simpson and a multiple of 4 for Boole, as computeRiemannSum requires). 
+ * The Gauss-Legendre rule is the sum over its nodes x_k (with weights w_k) of w_k / 2 times the Riemann sum whose offset is (1 + x_k) / 2.
+ */
+double closedFormQuadrature(const Polynomial & polynomial, double a, double b, uint64_t n, Rule rule, int order)
+{
+    double sum = 0.0;
+    if (rule == Rule::Trapezoid) return 0.5 * (closedFormRiemannSum(polynomial, a, b, n, 0.0) + closedFormRiemannSum(polynomial, a, b, n, 1.0));
+    if (rule == Rule::Simpson) return (4.0 * closedFormQuadrature(polynomial, a, b, n, Rule::Trapezoid, 0) - closedFormQuadrature(polynomial, a, b, n / 2, Rule::Trapezoid, 0)) / 3.0;
+    if (rule == Rule::Boole) return (16.0 * closedFormQuadrature(polynomial, a, b, n, Rule::Simpson, 0) - closedFormQuadrature(polynomial, a, b, n / 2, Rule::Simpson, 0)) / 15.0;
+    if (rule != Rule::GaussLegendre) return closedFormRiemannSum(polynomial, a, b, n, offsetOfRule(rule));
+    for (int k = 0; k < order; k++) sum += 0.5 * gaussLegendreTables.weights[order][k] * closedFormRiemannSum(polynomial, a, b, n, 0.5 * (1.0 + gaussLegendreTables.nodes[order][k]));
+    return sum;
+}
+
+// This function returns the estimates of computeAllRules for the polynomial f over the n partitions of [a,b] in closed form (so its number of evaluations is 0).
+AllRulesEstimates closedFormAllRules(const Polynomial & polynomial, double a, double b, uint64_t n)
+{
+    AllRulesEstimates estimates;
+    estimates.left = closedFormRiemannSum(polynomial, a, b, n, 0.0);
+    estimates.right = closedFormRiemannSum(polynomial, a, b, n, 1.0);
+    estimates.midpoint = closedFormRiemannSum(polynomial, a, b, n, 0.5);
+    estimates.trapezoid = 0.5 * (estimates.left + estimates.right);
+    estimates.simpson = (estimates.trapezoid + 2.0 * estimates.midpoint) / 3.0;
+    estimates.spread = std::fmax(std::fmax(estimates.left, estimates.right), std::fmax(estimates.midpoint, estimates.trapezoid)) 
+                     - std::fmin(std::fmin(estimates.left, estimates.right), std::fmin(estimates.midpoint, estimates.trapezoid));
+    estimates.evaluations = 0;
+    return estimates;
+}
+
+/**
+ * This function prints (to the command line terminal) the result of every rule computed by the numeric engine (computeQuadrature on every core) 
+ * next to its closed form (closedFormQuadrature) for the polynomial function whose option number is options["function"] 
+ * (or for each of x^2, x^3, and 2x + 3, and the user-defined expression if one was given, if no function was given), 
+ * together with the time which each took and their relative difference, which is measured against 
+ * max(|closed form|, (b - a) * max(|f(a)|, |f(b)|)) so that an integral which is close to zero does not inflate it. 
+ * 
+ * The numeric sums (which take time proportional to n) are computed only if options["compare"] is 1, 
+ * which is its default value for n up to CLOSED_FORM_MAXIMUM_COMPARED_n (and 0, which prints only the closed forms, above it). 
+ * 
+ * Return 0 if every relative difference is at most CLOSED_FORM_TOLERANCE (or 1 otherwise, or 2 if the settings are invalid).
+ */
+int runClosedFormReport(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "a", "0" }, { "b", "3" }, { "n", "1000000" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str());
+    uint64_t n = strtoull(settings["n"].c_str(), nullptr, 10);
+    if (settings.count("compare") == 0) settings["compare"] = (n <= CLOSED_FORM_MAXIMUM_COMPARED_n) ? "1" : "0";
+    bool compare = (settings["compare"] == "1");
+    InstructionSet instructionSet = detectInstructionSet();
+    int threadCount = (int) std::thread::hardware_concurrency();
+    std::vector<int> functionOptions = { 0, 1, 5 };
+    if (options.count("expression") > 0) functionOptions.push_back(USER_DEFINED_FUNCTION_OPTION);
+    if (options.count("function") > 0) functionOptions = { atoi(settings["function"].c_str()) };
+    bool valid = (b > a) && (n >= MINIMUM_n) && (n <= MAXIMUM_n) && (n % 4 == 0) && ((settings["compare"] == "0") || compare);
+    for (int functionOption : functionOptions) valid = valid && polynomialOfFunction(functionOption).isPolynomial;
+    if (!valid)
+    {
+        std::cout << "\n\nInvalid closed-form report settings (function must be a polynomial, i.e. 0, 1, 5, or 6 with a polynomial expression, b must be larger than a, n must be a multiple of 4 within [" << MINIMUM_n << "," << MAXIMUM_n << "], and compare must be 0 or 1).\n\n";
+        return 2;
+    }
+    if (threadCount < 1) threadCount = 1;
+    const std::vector<std::string> methods = { "left", "right", "midpoint", "trapezoid", "simpson", "boole", "gauss-legendre-2", "gauss-legendre-3" };
+    std::ofstream noFile;
+    bool agrees = true;
+    std::cout.precision(17);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nClosed-Form Report ([" << a << "," << b << "], n = " << n << ", " << nameOfInstructionSet(instructionSet) << ", " << threadCount << " thread(s))";
+    std::cout << "\n--------------------------------";
+    if (!compare) std::cout << "\n\nThe numeric sums are not computed (pass compare=1 to compute them, which takes time proportional to n), so only the closed forms are printed.";
+    for (int functionOption : functionOptions)
+    {
+        Polynomial polynomial = polynomialOfFunction(functionOption);
+        double ends[2] = { a, b };
+        selectBatchEvaluator(functionOption, instructionSet)(ends, ends, 2);
+        std::cout << "\n\nfunction " << functionOption << " (a polynomial of degree " << polynomial.degree << "):";
+        for (const std::string & method : methods)
+        {
+            Rule rule = ruleFromMethod(method);
+            RiemannEngine engine = { selectRiemannKernel(functionOption, rule, instructionSet), selectBatchEvaluator(functionOption, instructionSet), Accumulator::Naive, threadCount, rule, gaussLegendreOrderFromMethod(method), Polynomial(), nullptr, 0 };
+            if (!compare)
+            {
+                auto start = std::chrono::steady_clock::now();
+                double exact = closedFormQuadrature(polynomial, a, b, n, rule, engine.order);
+                double nanoseconds = 1e9 * std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+                std::streamsize precision = std::cout.precision(6);
+                std::cout << "\n\n" << method << ": closed form " << nanoseconds << " nanoseconds.";
+                std::cout.precision(precision);
+                std::cout << "\nclosed form = " << exact << ".";
+                continue;
+            }
+            auto start = std::chrono::steady_clock::now();
+            double numeric = computeQuadrature(engine, a, b, n, false, noFile);
+            auto middle = std::chrono::steady_clock::now();
+            double exact = closedFormQuadrature(polynomial, a, b, n, rule, engine.order);
+            auto end = std::chrono::steady_clock::now();
+            double scale = std::fmax(std::fabs(exact), (b - a) * std::fmax(std::fabs(ends[0]), std::fabs(ends[1])));
+            double difference = (scale > 0.0) ? (std::fabs(numeric - exact) / scale) : std::fabs(numeric - exact);
+            if (!(difference <= CLOSED_FORM_TOLERANCE)) agrees = false;
+            std::streamsize precision = std::cout.precision(6);
+            std::cout << "\n\n" << method << ": numeric " << std::chrono::duration<double>(middle - start).count() << " seconds, closed form " 
+                      << (1e9 * std::chrono::duration<double>(end - middle).count()) << " nanoseconds, relative difference " << difference << ((difference <= CLOSED_FORM_TOLERANCE) ? "." : " (TOO LARGE).");
+            std::cout.precision(precision);
+            std::cout << "\nnumeric = " << numeric << ", closed form = " << exact << ".";
+        }
+    }
+    std::cout << "\n\n--------------------------------\n\n";
+    return agrees ? 0 : 1;
+}
+
+/**
+ * This function returns the identity of the function whose option number is functionOption in the result cache: 
+ * functionOption + 1 for the built-in functions, and, for the user-defined function, a hash of its compiled program 
+ * (its constants and instructions, so that texts which differ only by spaces share their results) with the highest bit set 
+ * (so that it never equals the identity of a built-in function).
+ */
+uint64_t integrandIdentity(int functionOption)
+{
+    if ((functionOption != USER_DEFINED_FUNCTION_OPTION) || (userDefinedExpression.identifier == 0)) return (uint64_t) functionOption + 1;
+    const ExpressionProgram & program = userDefinedExpression;
+    uint64_t hash = 14695981039346656037ULL;
+    for (double constant : program.constants) hash = hashBytes(&constant, sizeof(constant), hash);
+    for (const ExpressionInstruction & instruction : program.instructions)
+    {
+        int32_t fields[4] = { (int32_t) instruction.operation, instruction.destination, instruction.left, instruction.right };
+        hash = hashBytes(fields, sizeof(fields), hash);
+    }
+    return hashBytes(&program.result, sizeof(program.result), hash) | (1ULL << 63);
+}
+
+// This function returns the key of the result cache for the given integrand identity, interval, number of partitions, rule, accumulator, and instruction set (with -0 stored as 0).
+ResultCacheKey makeResultCacheKey(uint64_t integrand, double a, double b, uint64_t n, Rule rule, int order, Accumulator accumulator, InstructionSet instructionSet)
+{
+    ResultCacheKey key;
+    std::memset(&key, 0, sizeof(key));
+    key.integrand = integrand;
+    key.a = (a == 0.0) ? 0.0 : a;
+    key.b = (b == 0.0) ? 0.0 : b;
+    key.n = n;
+    key.rule = (int32_t) rule;
+    key.order = (rule == Rule::GaussLegendre) ? order : 0;
+    key.accumulator = (int32_t) accumulator;
+    key.instructionSet = (int32_t) instructionSet;
+    return key;
+}
+
+// This function returns the 64-bit FNV-1a hash of size bytes, continuing from hash (which is 14695981039346656037 for the first bytes).
+uint64_t hashBytes(const void * bytes, size_t size, uint64_t hash)
+{
+    const unsigned char * data = (const unsigned char *) bytes;
+    for (size_t k = 0; k < size; k++)
+    {
+        hash ^= data[k];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// This function returns the canonical hash of key (the FNV-1a hash of its bytes).
+uint64_t hashResultCacheKey(const ResultCacheKey & key)
+{
+    return hashBytes(&key, sizeof(key), 14695981039346656037ULL);
+}
+
+// This function returns the hash of the start of key (the canonical hash of key with its right end b and its number of partitions n set to 0).
+uint64_t hashResultCacheStart(const ResultCacheKey & key)
+{
+    ResultCacheKey start = key;
+    start.b = 0.0;
+    start.n = 0;
+    return hashResultCacheKey(start);
+}
+
+// This function adds key to the starts of cache (unless it is already there). The caller must hold cache.mutex.
+void addResultCacheStart(ResultCache & cache, const ResultCacheKey & key)
+{
+    uint64_t hash = hashResultCacheStart(key);
+    auto range = cache.starts.equal_range(hash);
+    for (auto start = range.first; start != range.second; ++start) if (std::memcmp(&start->second, &key, sizeof(key)) == 0) return;
+    cache.starts.emplace(hash, key);
+}
+
+// This function removes key from the starts of cache unless its result is still in memory or in the file of cache. The caller must hold cache.mutex.
+void removeResultCacheStart(ResultCache & cache, const ResultCacheKey & key)
+{
+    auto found = cache.index.find(hashResultCacheKey(key));
+    if ((found != cache.index.end()) && (std::memcmp(&found->second->key, &key, sizeof(key)) == 0)) return;
+    if (resultIsInFile(cache, key)) return;
+    auto range = cache.starts.equal_range(hashResultCacheStart(key));
+    for (auto start = range.first; start != range.second; ++start)
+    {
+        if (std::memcmp(&start->second, &key, sizeof(key)) != 0) continue;
+        cache.starts.erase(start);
+        return;
+    }
+}
+
+// This function returns true if the result of key is stored in the file of cache (and false otherwise, or if no file is open).
+bool resultIsInFile(const ResultCache & cache, const ResultCacheKey & key)
+{
+    if (cache.header == nullptr) return false;
+    const ResultCacheSlot * set = cache.slots + (hashResultCacheKey(key) % (RESULT_CACHE_FILE_SLOTS / RESULT_CACHE_FILE_WAYS)) * RESULT_CACHE_FILE_WAYS;
+    for (int way = 0; way < RESULT_CACHE_FILE_WAYS; way++) if ((set[way].stamp != 0) && (std::memcmp(&set[way].key, &key, sizeof(key)) == 0)) return true;
+    return false;
+}
+
+/**
+ * This function maps the file at path (creating it if it does not exist) into memory as the file of cache and returns true 
+ * (or returns false, leaving cache in memory only, if the file cannot be opened, sized, or mapped). 
+ * A file whose header does not match (e.g. one written with a different number of slots, or with keys without an instruction set) is cleared, 
+ * and the key of every result in the file is added to the starts of cache (see hashResultCacheStart). 
+ * The file is not locked, so two runtime instances of this program which use the same file at the same time may overwrite each other's results.
+ */
+bool openResultCacheFile(ResultCache & cache, const std::string & path)
+{
+    size_t bytes = sizeof(ResultCacheFileHeader) + RESULT_CACHE_FILE_SLOTS * sizeof(ResultCacheSlot);
+    struct stat status;
+    int descriptor = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+    if (descriptor < 0) return false;
+    if ((fstat(descriptor, &status) != 0) || (((size_t) status.st_size != bytes) && (ftruncate(descriptor, (off_t) bytes) != 0)))
+    {
+        close(descriptor);
+        return false;
+    }
+    void * mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor); // (the mapping stays valid after the descriptor is closed)
+    if (mapping == MAP_FAILED) return false;
+    cache.header = (ResultCacheFileHeader *) mapping;
+    cache.slots = (ResultCacheSlot *) (cache.header + 1);
+    cache.mappedBytes = bytes;
+    if ((std::memcmp(cache.header->magic, "RSCACHE2", 8) != 0) || (cache.header->slotCount != RESULT_CACHE_FILE_SLOTS))
+    {
+        std::memset(mapping, 0, bytes);
+        std::memcpy(cache.header->magic, "RSCACHE2", 8);
+        cache.header->slotCount = RESULT_CACHE_FILE_SLOTS;
+    }
+    std::unique_lock<std::mutex> lock(cache.mutex);
+    for (size_t k = 0; k < RESULT_CACHE_FILE_SLOTS; k++) if (cache.slots[k].stamp != 0) addResultCacheStart(cache, cache.slots[k].key);
+    return true;
+}
+
+// This function unmaps the file of cache (if one is open), which leaves every result which was stored in it in the file, and keeps only the starts of the results in memory.
+void closeResultCacheFile(ResultCache & cache)
+{
+    std::unique_lock<std::mutex> lock(cache.mutex);
+    if (cache.header != nullptr) munmap(cache.header, cache.mappedBytes);
+    cache.header = nullptr;
+    cache.slots = nullptr;
+    cache.mappedBytes = 0;
+    cache.starts.clear();
+    for (const ResultCacheEntry & entry : cache.entries) addResultCacheStart(cache, entry.key);
+}
+
+/**
+ * This function stores the result of key in value and returns true if cache contains that result (see findExactResult) 
+ * or if it can be added up from the results of at most RESULT_CACHE_MAXIMUM_PIECES adjacent intervals (see findComposedResult), 
+ * and returns false otherwise, updating the hit and miss counters of cache. 
+ * A composed result is stored in cache (so the next lookup of key is an exact hit).
+ */
+bool lookUpResult(ResultCache & cache, const ResultCacheKey & key, double & value)
+{
+    std::unique_lock<std::mutex> lock(cache.mutex);
+    if (findExactResult(cache, key, value))
+    {
+        cache.hits++;
+        return true;
+    }
+    if (findComposedResult(cache, key, value, RESULT_CACHE_MAXIMUM_PIECES))
+    {
+        cache.composedHits++;
+        storeResultInMemory(cache, key, value);
+        storeResultInFile(cache, key, value);
+        return true;
+    }
+    cache.misses++;
+    return false;
+}
+
+/**
+ * This function stores the result of key in value and returns true if that result is in memory (which makes it the most recently used entry) 
+ * or in the file of cache (which copies it into memory), and returns false otherwise. The caller must hold cache.mutex.
+ */
+bool findExactResult(ResultCache & cache, const ResultCacheKey & key, double & value)
+{
+    uint64_t hash = hashResultCacheKey(key);
+    auto found = cache.index.find(hash);
+    if ((found != cache.index.end()) && (std::memcmp(&found->second->key, &key, sizeof(key)) == 0))
+    {
+        cache.entries.splice(cache.entries.begin(), cache.entries, found->second);
+        value = found->second->value;
+        return true;
+    }
+    if (cache.header == nullptr) return false;
+    ResultCacheSlot * set = cache.slots + (hash % (RESULT_CACHE_FILE_SLOTS / RESULT_CACHE_FILE_WAYS)) * RESULT_CACHE_FILE_WAYS;
+    for (int way = 0; way < RESULT_CACHE_FILE_WAYS; way++)
+    {
+        if ((set[way].stamp == 0) || (std::memcmp(&set[way].key, &key, sizeof(key)) != 0)) continue;
+        set[way].stamp = ++cache.header->stamp;
+        value = set[way].value;
+        storeResultInMemory(cache, key, value);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * This function stores the result of key in value and returns true if that result is the sum of the cached result of an interval [a,c] 
+ * (with the same integrand, rule, order, accumulator, instruction set, and left end a as key) and the result of [c,b] with the remaining partitions 
+ * (which is itself found exactly or composed from at most pieces - 1 intervals), and returns false otherwise. The caller must hold cache.mutex. 
+ * 
+ * The grids align if c is exactly (in double arithmetic) the end-point a + m * dx of partition m - 1 of [a,b], where m is the number of partitions of [a,c] 
+ * (which must be even for the Simpson rule and a multiple of 4 for the Boole rule, since both pieces must be valid for that rule). 
+ * Every rule is a sum over the partitions of [a,b], so the composed result differs from the directly computed one only by rounding 
+ * (of the partition widths of the two pieces, of the x-axis points, and of the sums), whereas an interval [a,c] whose c is off the grid by any amount would not be a sum of partitions of [a,b]. 
+ * The candidates for [a,c] are the results in memory and in the file whose start is the start of key (which the starts of cache index directly).
+ */
+bool findComposedResult(ResultCache & cache, const ResultCacheKey & key, double & value, int pieces)
+{
+    if (pieces < 2) return false;
+    uint64_t multiple = (key.rule == (int32_t) Rule::Simpson) ? 2 : ((key.rule == (int32_t) Rule::Boole) ? 4 : 1);
+    double dx = (key.b - key.a) / key.n;
+    std::vector<ResultCacheKey> candidates;
+    auto range = cache.starts.equal_range(hashResultCacheStart(key));
+    for (auto start = range.first; start != range.second; ++start)
+    {
+        const ResultCacheKey & other = start->second;
+        if ((other.integrand == key.integrand) && (other.rule == key.rule) && (other.order == key.order) && (other.accumulator == key.accumulator) && (other.instructionSet == key.instructionSet) 
+            && (other.a == key.a) && (other.n < key.n) && (other.n % multiple == 0) && (key.a + (double) other.n * dx == other.b)) candidates.push_back(other);
+    }
+
+    // (The lookups below may change the starts of cache, so the candidates are copied first.)
+    for (const ResultCacheKey & candidate : candidates)
+    {
+        double first = 0.0, rest = 0.0;
+        ResultCacheKey restKey = key;
+        restKey.a = candidate.b;
+        restKey.n = key.n - candidate.n;
+        if ((findExactResult(cache, restKey, rest) || findComposedResult(cache, restKey, rest, pieces - 1)) && findExactResult(cache, candidate, first))
+        {
+            value = first + rest;
+            return true;
+        }
+    }
+    return false;
+}
+
+// This function stores value as the result of key in memory and in the file of cache (if one is open).
+void storeResult(ResultCache & cache, const ResultCacheKey & key, double value)
+{
+    std::unique_lock<std::mutex> lock(cache.mutex);
+    storeResultInMemory(cache, key, value);
+    storeResultInFile(cache, key, value);
+}
+
+/**
+ * This function stores value as the result of key in memory (as the most recently used entry, replacing any entry with the same hash) 
+ * and evicts the least recently used entries while more than cache.capacity entries are in memory, keeping the starts of cache up to date. The caller must hold cache.mutex.
+ */
+void storeResultInMemory(ResultCache & cache, const ResultCacheKey & key, double value)
+{
+    uint64_t hash = hashResultCacheKey(key);
+    auto found = cache.index.find(hash);
+    if (found != cache.index.end())
+    {
+        ResultCacheKey replaced = found->second->key;
+        cache.entries.erase(found->second);
+        cache.index.erase(found);
+        removeResultCacheStart(cache, replaced);
+    }
+    cache.entries.push_front({ key, value });
+    cache.index[hash] = cache.entries.begin();
+    addResultCacheStart(cache, key);
+    while (cache.entries.size() > cache.capacity)
+    {
+        ResultCacheKey evicted = cache.entries.back().key;
+        cache.index.erase(hashResultCacheKey(evicted));
+        cache.entries.pop_back();
+        cache.evictions++;
+        removeResultCacheStart(cache, evicted);
+    }
+}
+
+/**
+ * This function stores value as the result of key in the file of cache (if one is open): in the slot of its set which already holds key, 
+ * or else in an empty slot of that set, or else in the least recently used slot of that set (which is evicted), keeping the starts of cache up to date. The caller must hold cache.mutex.
+ */
+void storeResultInFile(ResultCache & cache, const ResultCacheKey & key, double value)
+{
+    if (cache.header == nullptr) return;
+    ResultCacheSlot * set = cache.slots + (hashResultCacheKey(key) % (RESULT_CACHE_FILE_SLOTS / RESULT_CACHE_FILE_WAYS)) * RESULT_CACHE_FILE_WAYS;
+    int chosen = 0;
+    for (int way = 0; way < RESULT_CACHE_FILE_WAYS; way++)
+    {
+        if ((set[way].stamp != 0) && (std::memcmp(&set[way].key, &key, sizeof(key)) == 0))
+        {
+            chosen = way;
+            break;
+        }
+        if (set[way].stamp < set[chosen].stamp) chosen = way;
+    }
+    bool replaces = (set[chosen].stamp != 0) && (std::memcmp(&set[chosen].key, &key, sizeof(key)) != 0);
+    ResultCacheKey replaced = set[chosen].key;
+    set[chosen].key = key;
+    set[chosen].value = value;
+    set[chosen].stamp = ++cache.header->stamp;
+    addResultCacheStart(cache, key);
+    if (!replaces) return;
+    cache.evictions++;
+    removeResultCacheStart(cache, replaced);
+}
+
+// This function prints the counters of cache (and the number of results in memory) to the command line terminal and to the output file stream.
+void printResultCacheCounters(const ResultCache & cache, std::ofstream & file)
+{
+    std::cout << "\n\nresult cache: " << cache.hits << " hit(s), " << cache.composedHits << " composed hit(s), " << cache.misses << " miss(es), " << cache.evictions << " eviction(s), " 
+              << cache.entries.size() << " result(s) in memory" << ((cache.header != nullptr) ? " (and in the file)." : ".");
+    file << "\n\nresult cache: " << cache.hits << " hit(s), " << cache.composedHits << " composed hit(s), " << cache.misses << " miss(es), " << cache.evictions << " eviction(s), " 
+         << cache.entries.size() << " result(s) in memory" << ((cache.header != nullptr) ? " (and in the file)." : ".");
+}
+
+/**
+ * This function prints (to the command line terminal) how the result cache answers a sequence of computations of the function whose option number is options["function"] 
+ * with options["method"], and returns 0 if every answer matched the directly computed result (or 1 otherwise, or 2 if the settings are invalid):
+ * 
+ * 1. [a,b] with n partitions is computed and stored (a miss, unless options["file"] already holds it), then looked up again (a hit, which must be bit-identical).
+ * 2. [b,c] with n partitions (where c = 2b - a) is computed and stored, and [a,c] with 2n partitions is looked up, 
+ *    which is answered by adding the results of [a,b] and [b,c] (a composed hit, which must be within 10^-12 of the directly computed [a,c], relative to its magnitude).
+ * 3. capacity + 1 further results (with n + 4, n + 8, ... partitions) are stored, so the least recently used results are evicted.
+ */
+int runCacheReport(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "function", "2" }, { "method", "midpoint" }, { "a", "0" }, { "b", "3" }, { "n", "4000000" }, { "capacity", "4" }, { "file", "" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str());
+    uint64_t n = strtoull(settings["n"].c_str(), nullptr, 10);
+    Rule rule = ruleFromMethod(settings["method"]);
+    InstructionSet instructionSet = detectInstructionSet();
+    int threadCount = (int) std::thread::hardware_concurrency();
+    ResultCache cache;
+    RiemannEngine engine = { selectRiemannKernel(functionOption, rule, instructionSet), selectBatchEvaluator(functionOption, instructionSet), Accumulator::Naive, (threadCount < 1) ? 1 : threadCount, rule, gaussLegendreOrderFromMethod(settings["method"]), Polynomial(), &cache, integrandIdentity(functionOption) };
+    std::ofstream noFile;
+    engine.instructionSet = instructionSet;
+    cache.capacity = strtoull(settings["capacity"].c_str(), nullptr, 10);
+    if (!methodIsRecognized(settings["method"]) || ((engine.kernel == nullptr) && ((rule != Rule::GaussLegendre) || (engine.evaluator == nullptr))) || (b <= a) || (n < 4) || (n % 4 != 0) || (n > MAXIMUM_n / 2) || (cache.capacity < 1))
+    {
+        std::cout << "\n\nInvalid cache report settings (function must be 0 through " << USER_DEFINED_FUNCTION_OPTION << ", method must be recognized, b must be larger than a, n must be a multiple of 4 no larger than " << (MAXIMUM_n / 2) << ", and capacity must be positive).\n\n";
+        return 2;
+    }
+    if (!settings["file"].empty() && !openResultCacheFile(cache, settings["file"]))
+    {
+        std::cout << "\n\nThe file named " << settings["file"] << " could not be opened.\n\n";
+        return 2;
+    }
+    bool matches = true;
+    std::cout.precision(17);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nCache Report (function " << functionOption << ", " << settings["method"] << ", [" << a << "," << b << "], n = " << n << ", capacity " << cache.capacity << ((cache.header != nullptr) ? (", file " + settings["file"]) : std::string()) << ")";
+    std::cout << "\n--------------------------------";
+
+    // Return the result of [left,right] with count partitions from the cache (or compute and store it), printing whether it was found and how long that took.
+    auto computeCached = [&](const std::string & label, double left, double right, uint64_t count)
+    {
+        double value = 0.0;
+        ResultCacheKey key = makeResultCacheKey(engine.integrand, left, right, count, rule, engine.order, engine.accumulator, engine.instructionSet);
+        uint64_t hits = cache.hits, composedHits = cache.composedHits;
+        auto start = std::chrono::steady_clock::now();
+        if (!lookUpResult(cache, key, value))
+        {
+            value = computeQuadrature(engine, left, right, count, false, noFile);
+            storeResult(cache, key, value);
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        std::string outcome = (cache.hits > hits) ? "hit" : ((cache.composedHits > composedHits) ? "composed hit" : "miss");
+        std::streamsize precision = std::cout.precision(6);
+        std::cout << "\n\n" << label << ": " << outcome << " in " << (1e6 * seconds) << " microseconds";
+        std::cout.precision(precision);
+        std::cout << ", result = " << value << ".";
+        return value;
+    };
+    double c = 2.0 * b - a;
+    double first = computeCached("[a,b] (first lookup)", a, b, n);
+    double second = computeCached("[a,b] (second lookup)", a, b, n);
+    if (std::memcmp(&first, &second, sizeof(first)) != 0) matches = false;
+    computeCached("[b,c] (c = 2b - a)", b, c, n);
+    double composed = computeCached("[a,c] (2n partitions)", a, c, 2 * n);
+    double direct = computeQuadrature(engine, a, c, 2 * n, false, noFile);
+    double difference = std::fabs(composed - direct) / std::fmax(std::fabs(direct), DBL_MIN);
+    if (!(difference <= 1e-12)) matches = false;
+    std::streamsize precision = std::cout.precision(6);
+    std::cout << "\n\nThe relative difference between [a,c] from the cache and [a,c] computed directly is " << difference << ((difference <= 1e-12) ? "." : " (TOO LARGE).");
+    std::cout.precision(precision);
+    for (uint64_t k = 1; k <= cache.capacity + 1; k++) computeCached("[a,b] (n + " + std::to_string(4 * k) + " partitions)", a, b, n + 4 * k);
+    std::ofstream counterFile;
+    printResultCacheCounters(cache, counterFile);
+    closeResultCacheFile(cache);
+    std::cout << "\n\n--------------------------------\n\n";
+    return matches ? 0 : 1;
+}
+
+/**
+ * This function appends a job to batch which integrates the function whose option number is function over [a,b] with n partitions and method 
+ * (one of the methods recognized by methodIsRecognized), and returns false if method is not recognized (in which case the job is still appended, but it is invalid).
+ */
+bool addBatchJob(IntegrationBatch & batch, int function, const std::string & method, double a, double b, uint64_t n)
+{
+    bool recognized = methodIsRecognized(method);
+    batch.a.push_back(a);
+    batch.b.push_back(b);
+    batch.n.push_back(n);
+    batch.function.push_back(function);
+    batch.rule.push_back(ruleFromMethod(method));
+    batch.order.push_back(recognized ? gaussLegendreOrderFromMethod(method) : -1);
+    batch.result.push_back(NAN);
+    return recognized;
+}
+
+/**
+ * This function returns true if job of batch can be computed: its function has a batch evaluator, its method was recognized, 
+ * a and b are finite with b larger than a, n is 1 through MAXIMUM_n, and n is even for the Simpson rule and a multiple of 4 for the Boole rule.
+ */
+bool batchJobIsValid(const IntegrationBatch & batch, size_t job)
+{
+    Rule rule = batch.rule[job];
+    uint64_t n = batch.n[job];
+    if ((selectBatchEvaluator(batch.function[job], InstructionSet::Scalar) == nullptr) || (batch.order[job] < 0)) return false;
+    if (!std::isfinite(batch.a[job]) || !std::isfinite(batch.b[job]) || (batch.b[job] <= batch.a[job])) return false;
+    if ((n < 1) || (n > MAXIMUM_n)) return false;
+    if ((rule == Rule::Simpson) && (n % 2 != 0)) return false;
+    if ((rule == Rule::Boole) && (n % 4 != 0)) return false;
+    return true;
+}
+
+// This function returns the method string which ruleFromMethod and gaussLegendreOrderFromMethod map to rule and order (the inverse of those two functions).
+std::string methodOfRule(Rule rule, int order)
+{
+    static const char * const methods[NUMBER_OF_RULES] = { "left", "right", "midpoint", "trapezoid", "simpson", "boole" };
+    if (rule == Rule::GaussLegendre) return "gauss-legendre-" + std::to_string(order);
+    return methods[(int) rule];
+}
+
+/**
+ * This function computes every job of batch (on threadCount threads, using the batch evaluators for instructionSet), stores the result of each job in batch.result 
+ * (NAN for the jobs which batchJobIsValid rejects), stores the number of groups in groupCount, and returns the total number of points at which the integrands were evaluated.
+ * 
+ * The jobs are grouped by integrand, rule, and order (a stable sort of the job indices, so the jobs of each group keep their order). 
+ * The small jobs of each group are cut into tasks of about BATCH_TASK_POINTS points which the thread pool computes in parallel with sumBatchJobs, 
+ * which evaluates the points of many jobs of the same group with each call of the group's batch evaluator. 
+ * Each job with more than BATCH_LARGE_JOB_POINTS points is instead computed on its own by computeQuadrature (which spreads that job across every thread).
+ */
+uint64_t computeBatch(IntegrationBatch & batch, int threadCount, InstructionSet instructionSet, size_t & groupCount)
+{
+    std::vector<size_t> jobs, largeJobs;
+    std::vector<BatchTask> tasks;
+    uint64_t totalPoints = 0;
+    groupCount = 0;
+    for (size_t k = 0; k < batch.a.size(); k++)
+    {
+        batch.result[k] = NAN;
+        if (!batchJobIsValid(batch, k)) continue;
+        uint64_t points = numberOfPointsOfRule(batch.rule[k], batch.order[k], batch.n[k]);
+        totalPoints += points;
+        if (points > BATCH_LARGE_JOB_POINTS) largeJobs.push_back(k);
+        else jobs.push_back(k);
+    }
+
+    // Group the small jobs by integrand, rule, and order.
+    std::stable_sort(jobs.begin(), jobs.end(), [&](size_t left, size_t right)
+    {
+        if (batch.function[left] != batch.function[right]) return batch.function[left] < batch.function[right];
+        if (batch.rule[left] != batch.rule[right]) return batch.rule[left] < batch.rule[right];
+        return batch.order[left] < batch.order[right];
+    });
+
+    // Cut each group into tasks of about BATCH_TASK_POINTS points (a task never spans two groups).
+    uint64_t taskPoints = 0;
+    for (size_t i = 0; i < jobs.size(); i++)
+    {
+        size_t k = jobs[i];
+        bool newGroup = (i == 0) || (batch.function[k] != batch.function[jobs[i - 1]]) || (batch.rule[k] != batch.rule[jobs[i - 1]]) || (batch.order[k] != batch.order[jobs[i - 1]]);
+        if (newGroup) groupCount++;
+        if (newGroup || (taskPoints >= BATCH_TASK_POINTS))
+        {
+            tasks.push_back({ i, i });
+            taskPoints = 0;
+        }
+        tasks.back().last = i + 1;
+        taskPoints += numberOfPointsOfRule(batch.rule[k], batch.order[k], batch.n[k]);
+    }
+
+    // Compute the tasks on the thread pool.
+    ThreadPool & pool = acquireThreadPool((threadCount < 1) ? 1 : threadCount);
+    runOnThreadPool(pool, tasks.size(), [&](uint64_t t)
+    {
+        const BatchTask & task = tasks[t];
+        sumBatchJobs(batch, jobs.data() + task.first, task.last - task.first, selectBatchEvaluator(batch.function[jobs[task.first]], instructionSet));
+    });
+
+    // Compute each large job on its own.
+    std::ofstream noFile;
+    for (size_t k : largeJobs)
+    {
+        int function = batch.function[k];
+        RiemannEngine engine = { selectRiemannKernel(function, batch.rule[k], instructionSet), selectBatchEvaluator(function, instructionSet), Accumulator::Naive, (threadCount < 1) ? 1 : threadCount, batch.rule[k], batch.order[k], Polynomial(), nullptr, 0 };
+        batch.result[k] = computeQuadrature(engine, batch.a[k], batch.b[k], batch.n[k], false, noFile);
+    }
+    if (!largeJobs.empty()) groupCount += largeJobs.size();
+    return totalPoints;
+}
+
+/**
+ * This function computes the jobs jobs[0] through jobs[count - 1] of batch (which must all have the same integrand, rule, and order) and stores their results in batch.result. 
+ * The points of those jobs (the same points as pointOfRule) are packed, one job after the other, into a buffer of BATCH_BUFFER_SIZE points, 
+ * so that one call of evaluator evaluates the points of many small jobs (or part of one larger job). 
+ * Each run of consecutive points of one job in the buffer is a segment, and the weighted values of each segment are added to the sum of its job.
+ */
+void sumBatchJobs(IntegrationBatch & batch, const size_t * jobs, size_t count, BatchEvaluator evaluator)
+{
+    double x[BATCH_BUFFER_SIZE];
+    BatchSegment segments[BATCH_BUFFER_SIZE];
+    std::vector<double> sums(count, 0.0);
+    Rule rule = batch.rule[jobs[0]];
+    int order = batch.order[jobs[0]], filled = 0, segmentCount = 0;
+    double offset = offsetOfRule(rule), scale = scaleOfRule(rule), endpointWeight = scale * (interiorWeightOfRule(rule, 0) - endpointCorrectionOfRule(rule));
+    const double * nodes = gaussLegendreTables.nodes[(rule == Rule::GaussLegendre) ? order : 0];
+    const double * nodeWeights = gaussLegendreTables.weights[(rule == Rule::GaussLegendre) ? order : 0];
+
+    // Evaluate the buffered points and add the weighted values of each segment to the sum of its job.
+    auto flush = [&]()
+    {
+        evaluator(x, x, (uint64_t) filled);
+        for (int s = 0; s < segmentCount; s++)
+        {
+            const BatchSegment & segment = segments[s];
+            const double * y = x + segment.start;
+            uint64_t n = batch.n[jobs[segment.job]];
+            double sum = 0.0;
+            if (rule == Rule::GaussLegendre)
+            {
+                int node = (int) (segment.first % (uint64_t) order);
+                for (int t = 0; t < segment.count; t++)
+                {
+                    sum += 0.5 * nodeWeights[node] * y[t];
+                    if (++node == order) node = 0;
+                }
+            }
+            else if ((rule == Rule::Left) || (rule == Rule::Right) || (rule == Rule::Midpoint)) for (int t = 0; t < segment.count; t++) sum += y[t];
+            else
+            {
+                for (int t = 0; t < segment.count; t++)
+                {
+                    uint64_t j = segment.first + t;
+                    sum += (((j == 0) || (j == n)) ? endpointWeight : scale * interiorWeightOfRule(rule, j)) * y[t];
+                }
+            }
+            sums[segment.job] += sum;
+        }
+        filled = 0;
+        segmentCount = 0;
+    };
+    for (size_t i = 0; i < count; i++)
+    {
+        size_t k = jobs[i];
+        uint64_t n = batch.n[k], points = numberOfPointsOfRule(rule, order, n);
+        double a = batch.a[k], dx = (batch.b[k] - a) / n;
+        for (uint64_t first = 0; first < points; )
+        {
+            int space = BATCH_BUFFER_SIZE - filled;
+            int length = ((points - first) < (uint64_t) space) ? (int) (points - first) : space;
+            double * destination = x + filled;
+            if (rule == Rule::GaussLegendre)
+            {
+                // Step through the nodes of each partition (point first + t is node (first + t) % order of partition (first + t) / order).
+                uint64_t partition = first / (uint64_t) order;
+                int node = (int) (first % (uint64_t) order);
+                for (int t = 0; t < length; t++)
+                {
+                    destination[t] = a + ((double) partition + 0.5 * (1.0 + nodes[node])) * dx;
+                    if (++node == order)
+                    {
+                        node = 0;
+                        partition++;
+                    }
+                }
+            }
+            else
+            {
+                double start = (double) first + offset;
+                for (int t = 0; t < length; t++) destination[t] = a + (start + (double) t) * dx; // (an int index converts to double with vector instructions)
+            }
+            segments[segmentCount++] = { i, filled, length, first };
+            filled += length;
+            first += (uint64_t) length;
+            if (filled == BATCH_BUFFER_SIZE) flush();
+        }
+    }
+    if (filled > 0) flush();
+    for (size_t i = 0; i < count; i++) batch.result[jobs[i]] = sums[i] * ((batch.b[jobs[i]] - batch.a[jobs[i]]) / batch.n[jobs[i]]);
+}
+
+/**
+ * This function appends the jobs of the job file named path to batch and returns true (or stores a description of the first invalid line in error and returns false). 
+ * Each line of a job file is either blank, a comment (starting with #), or a job: "function method a b n" 
+ * (for example "2 simpson 0 3.14159 1000" integrates sin(x) over [0,3.14159] with 1000 partitions and the Simpson rule).
+ */
+bool loadBatchJobs(const std::string & path, IntegrationBatch & batch, std::string & error)
+{
+    std::ifstream jobFile(path);
+    std::string line, method, extra;
+    int lineNumber = 0, function = 0;
+    double a = 0.0, b = 0.0;
+    uint64_t n = 0;
+    if (!jobFile.is_open())
+    {
+        error = "the file named " + path + " could not be opened";
+        return false;
+    }
+    while (std::getline(jobFile, line))
+    {
+        lineNumber++;
+        size_t start = line.find_first_not_of(" \t\r");
+        if ((start == std::string::npos) || (line[start] == '#')) continue;
+        std::istringstream fields(line);
+        if (!(fields >> function >> method >> a >> b >> n) || (fields >> extra))
+        {
+            error = "line " + std::to_string(lineNumber) + " of " + path + " is not \"function method a b n\"";
+            return false;
+        }
+        if (!addBatchJob(batch, function, method, a, b, n))
+        {
+            error = "line " + std::to_string(lineNumber) + " of " + path + " has an unrecognized method (" + method + ")";
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * This function computes a batch of jobs and prints (to the command line terminal) the number of jobs, groups, and points, the time per point, 
+ * and the speedup over computing each job one at a time with computeQuadrature (unless options["compare"] is 0), 
+ * and returns 0 if every valid job matched its one-at-a-time result within 10^-12 (relative to the larger of 1 and the magnitude of that result), 1 otherwise, or 2 if the settings are invalid.
+ * 
+ * If options["jobs"] names a job file (see loadBatchJobs), its jobs are computed and the result of each job is written (as "function method a b n result") 
+ * to options["output"] (reimann_sum_batch_output.txt by default). 
+ * Otherwise options["count"] random jobs (with options["seed"]) are generated over every function, rule, and Gauss-Legendre order (and written to options["output"] only if it is given).
+ */
+int runBatchMode(const std::map<std::string, std::string> & options)
+{
+    int hardwareThreads = (int) std::thread::hardware_concurrency();
+    std::map<std::string, std::string> settings = { { "jobs", "" }, { "output", "" }, { "count", std::to_string(BATCH_RANDOM_JOBS) }, { "seed", "1" }, { "compare", "1" }, { "threads", std::to_string((hardwareThreads < 1) ? 1 : hardwareThreads) } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int threadCount = atoi(settings["threads"].c_str());
+    uint64_t count = strtoull(settings["count"].c_str(), nullptr, 10);
+    InstructionSet instructionSet = detectInstructionSet();
+    IntegrationBatch batch;
+    std::string error;
+    if (threadCount < 1)
+    {
+        std::cout << "\n\nInvalid batch settings (threads must be positive).\n\n";
+        return 2;
+    }
+    if (!settings["jobs"].empty())
+    {
+        if (!loadBatchJobs(settings["jobs"], batch, error))
+        {
+            std::cout << "\n\nThe job file could not be loaded: " << error << ".\n\n";
+            return 2;
+        }
+        if (settings["output"].empty()) settings["output"] = "reimann_sum_batch_output.txt";
+    }
+    else
+    {
+        // Generate count random jobs (of every function, including the user-defined function if an expression was given, and every method).
+        std::mt19937_64 generator(strtoull(settings["seed"].c_str(), nullptr, 10));
+        int functionCount = (userDefinedExpression.identifier != 0) ? (USER_DEFINED_FUNCTION_OPTION + 1) : NUMBER_OF_FUNCTIONS;
+        std::uniform_int_distribution<int> functions(0, functionCount - 1), methods(0, NUMBER_OF_RULES + MAXIMUM_GAUSS_LEGENDRE_ORDER - MINIMUM_GAUSS_LEGENDRE_ORDER);
+        std::uniform_int_distribution<uint64_t> quarters(1, 64);
+        std::uniform_real_distribution<double> starts(0.0, 2.0), lengths(0.5, 3.0);
+        for (uint64_t k = 0; k < count; k++)
+        {
+            int method = methods(generator);
+            double a = starts(generator);
+            addBatchJob(batch, functions(generator), (method < NUMBER_OF_RULES) ? methodOfRule((Rule) method, 0) : methodOfRule(Rule::GaussLegendre, MINIMUM_GAUSS_LEGENDRE_ORDER + method - NUMBER_OF_RULES), a, a + lengths(generator), 4 * quarters(generator));
+        }
+    }
+    size_t invalidJobs = 0, groupCount = 0;
+    for (size_t k = 0; k < batch.a.size(); k++) if (!batchJobIsValid(batch, k)) invalidJobs++;
+    auto start = std::chrono::steady_clock::now();
+    uint64_t points = computeBatch(batch, threadCount, instructionSet, groupCount);
+    double batchSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nBatch (" << batch.a.size() << " job(s)" << (settings["jobs"].empty() ? " generated with seed " + settings["seed"] : " from " + settings["jobs"]) << ", " << threadCount << " thread(s), " << nameOfInstructionSet(instructionSet) << ")";
+    std::cout << "\n--------------------------------";
+    std::cout << "\n\nvalid jobs: " << (batch.a.size() - invalidJobs) << " (" << invalidJobs << " invalid job(s) have the result nan)";
+    std::cout << "\n\ngroups (integrand, rule, and order): " << groupCount;
+    std::cout << "\n\npoints evaluated: " << points;
+    std::cout << "\n\nbatch time: " << batchSeconds << " seconds (" << ((points > 0) ? (1e9 * batchSeconds / points) : 0.0) << " nanoseconds per point)";
+
+    // Compute every valid job again, one at a time, and compare.
+    bool matches = true;
+    if (settings["compare"] != "0")
+    {
+        std::ofstream noFile;
+        double largestDifference = 0.0;
+        start = std::chrono::steady_clock::now();
+        for (size_t k = 0; k < batch.a.size(); k++)
+        {
+            if (!batchJobIsValid(batch, k)) continue;
+            RiemannEngine engine = { selectRiemannKernel(batch.function[k], batch.rule[k], instructionSet), selectBatchEvaluator(batch.function[k], instructionSet), Accumulator::Naive, threadCount, batch.rule[k], batch.order[k], Polynomial(), nullptr, 0 };
+            double single = computeQuadrature(engine, batch.a[k], batch.b[k], batch.n[k], false, noFile);
+            double difference = std::fabs(batch.result[k] - single) / std::fmax(1.0, std::fabs(single));
+            if (!(difference <= largestDifference)) largestDifference = difference;
+        }
+        double singleSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        matches = (largestDifference <= 1e-12);
+        std::cout << "\n\none job at a time: " << singleSeconds << " seconds (the batch is " << (singleSeconds / batchSeconds) << " times as fast)";
+        std::cout << "\n\nlargest relative difference from one job at a time: " << largestDifference << (matches ? "." : " (TOO LARGE).");
+    }
+
+    // Write the result of every job.
+    if (!settings["output"].empty())
+    {
+        std::ofstream output(settings["output"]);
+        output.precision(17);
+        output << "# function method a b n result";
+        for (size_t k = 0; k < batch.a.size(); k++) output << "\n" << batch.function[k] << " " << ((batch.order[k] < 0) ? "?" : methodOfRule(batch.rule[k], batch.order[k])) << " " << batch.a[k] << " " << batch.b[k] << " " << batch.n[k] << " " << batch.result[k];
+        output << "\n";
+        std::cout << "\n\nThe results were written to " << settings["output"] << ".";
+    }
+    std::cout << "\n\n--------------------------------\n\n";
+    return matches ? 0 : 1;
+}
+
+// This function returns the formula of the box function whose option number is functionOption (or "?" if there is no such function).
+std::string nameOfBoxFunction(int functionOption)
+{
+    static const char * const names[NUMBER_OF_BOX_FUNCTIONS] = { "x1^2 + ... + xd^2", "cos(x1) * ... * cos(xd)", "sin(x1 + ... + xd)" };
+    if ((functionOption < 0) || (functionOption >= NUMBER_OF_BOX_FUNCTIONS)) return "?";
+    return names[functionOption];
+}
+
+/**
+ * This function returns true if box can be integrated with rule (and order, if rule is GaussLegendre): 
+ * box.dimension is 1 through MAXIMUM_BOX_DIMENSION, every axis has finite end-points with b larger than a, 
+ * every n is positive (even for the Simpson rule and a multiple of 4 for the Boole rule), no axis has more than BOX_MAXIMUM_AXIS_POINTS points, 
+ * and the number of points of the whole grid fits in 64 bits.
+ */
+bool boxIsValid(const Box & box, Rule rule, int order)
+{
+    if ((box.dimension < 1) || (box.dimension > MAXIMUM_BOX_DIMENSION)) return false;
+    if ((rule == Rule::GaussLegendre) && ((order < MINIMUM_GAUSS_LEGENDRE_ORDER) || (order > MAXIMUM_GAUSS_LEGENDRE_ORDER))) return false;
+    for (int k = 0; k < box.dimension; k++)
+    {
+        if (!std::isfinite(box.a[k]) || !std::isfinite(box.b[k]) || (box.b[k] <= box.a[k]) || (box.n[k] < 1)) return false;
+        if (((rule == Rule::Simpson) && (box.n[k] % 2 != 0)) || ((rule == Rule::Boole) && (box.n[k] % 4 != 0))) return false;
+        if (box.n[k] > BOX_MAXIMUM_AXIS_POINTS) return false;
+        if (numberOfPointsOfRule(rule, order, box.n[k]) > BOX_MAXIMUM_AXIS_POINTS) return false;
+    }
+    return numberOfPointsOfBox(box, rule, order) > 0;
+}
+
+// This function returns the number of points of the tensor-product grid of rule on box (the product of the number of points of each axis), or 0 if that number does not fit in 64 bits.
+uint64_t numberOfPointsOfBox(const Box & box, Rule rule, int order)
+{
+    uint64_t total = 1;
+    for (int k = 0; k < box.dimension; k++)
+    {
+        uint64_t points = numberOfPointsOfRule(rule, order, box.n[k]);
+        if ((points == 0) || (total > UINT64_MAX / points)) return 0;
+        total *= points;
+    }
+    return total;
+}
+
+/**
+ * This function returns the integral of the function which evaluator evaluates over box, computed with the tensor product of rule (and order, if rule is GaussLegendre) 
+ * on threadCount threads: the sum over every point of the grid (the points of the rule along each axis, see pointOfRule) 
+ * of f at that point times the product of the weights (times dx) of its coordinates. 
+ * For the rectangle rules this is the d-dimensional Riemann sum, and for Gauss-Legendre it is the product-Gauss rule. 
+ * 
+ * The points and weights of each axis are computed once. The grid (in the order in which axis 0 varies fastest) is cut into tiles of BOX_TILE_POINTS points, 
+ * which the thread pool sums in parallel with sumBoxTile (PARALLEL_BATCH_BLOCKS tiles at a time), 
+ * and the tile sums are added in tile order by a ReductionTree (so the result does not depend on threadCount).
+ */
+double computeBoxIntegral(BoxEvaluator evaluator, const Box & box, Rule rule, int order, int threadCount)
+{
+    std::vector<std::vector<double>> axisPoints(box.dimension), axisWeights(box.dimension);
+    for (int k = 0; k < box.dimension; k++)
+    {
+        double dx = (box.b[k] - box.a[k]) / box.n[k];
+        uint64_t count = numberOfPointsOfRule(rule, order, box.n[k]);
+        axisPoints[k].resize(count);
+        axisWeights[k].resize(count);
+        for (uint64_t j = 0; j < count; j++)
+        {
+            pointOfRule(rule, order, box.a[k], dx, box.n[k], j, axisPoints[k][j], axisWeights[k][j]);
+            axisWeights[k][j] *= dx;
+        }
+    }
+    uint64_t total = numberOfPointsOfBox(box, rule, order);
+    uint64_t tileCount = (total + BOX_TILE_POINTS - 1) / BOX_TILE_POINTS;
+    ReductionTree tree;
+    std::vector<double> tileSums(PARALLEL_BATCH_BLOCKS);
+    ThreadPool & pool = acquireThreadPool((threadCount < 1) ? 1 : threadCount);
+    for (uint64_t firstTile = 0; firstTile < tileCount; firstTile += PARALLEL_BATCH_BLOCKS)
+    {
+        uint64_t batchTiles = ((tileCount - firstTile) < PARALLEL_BATCH_BLOCKS) ? (tileCount - firstTile) : PARALLEL_BATCH_BLOCKS;
+        runOnThreadPool(pool, batchTiles, [&](uint64_t t)
+        {
+            uint64_t first = (firstTile + t) * BOX_TILE_POINTS;
+            uint64_t last = ((total - first) < BOX_TILE_POINTS) ? total : (first + BOX_TILE_POINTS);
+            tileSums[t] = sumBoxTile(evaluator, box, axisPoints, axisWeights, first, last);
+        });
+        for (uint64_t t = 0; t < batchTiles; t++) addToReductionTree(tree, tileSums[t], 0.0);
+    }
+    return finishReductionTree(tree);
+}
+
+/**
+ * This function returns the weighted sum of f over the points first through last - 1 of the grid of box (in the order in which axis 0 varies fastest), 
+ * where axisPoints[k] and axisWeights[k] are the points and weights (times dx) of axis k. 
+ * 
+ * The coordinates of the tile are stored axis by axis in a buffer which belongs to the calling thread (one row of consecutive axis-0 points at a time, see BoxRow), 
+ * evaluator evaluates the whole tile with one call, and the values of each row are weighted by the axis-0 weights and by the weight of the row.
+ */
+double sumBoxTile(BoxEvaluator evaluator, const Box & box, const std::vector<std::vector<double>> & axisPoints, const std::vector<std::vector<double>> & axisWeights, uint64_t first, uint64_t last)
+{
+    thread_local std::vector<double> buffer, values;
+    thread_local std::vector<BoxRow> rows;
+    int dimension = box.dimension;
+    uint64_t rowLength = axisPoints[0].size(), index[MAXIMUM_BOX_DIMENSION], remaining = last - first, rest = first / rowLength;
+    double * coordinates[MAXIMUM_BOX_DIMENSION];
+    if (buffer.size() < (size_t) dimension * BOX_TILE_POINTS) buffer.resize((size_t) dimension * BOX_TILE_POINTS);
+    if (values.size() < BOX_TILE_POINTS) values.resize(BOX_TILE_POINTS);
+    for (int k = 0; k < dimension; k++) coordinates[k] = buffer.data() + (size_t) k * BOX_TILE_POINTS;
+
+    // Determine the index of each axis of the first point of the tile.
+    index[0] = first % rowLength;
+    for (int k = 1; k < dimension; k++)
+    {
+        index[k] = rest % axisPoints[k].size();
+        rest /= axisPoints[k].size();
+    }
+
+    // Store the coordinates of the tile one row at a time, then move the index to the start of the next row.
+    int filled = 0;
+    rows.clear();
+    while (remaining > 0)
+    {
+        int length = ((rowLength - index[0]) < remaining) ? (int) (rowLength - index[0]) : (int) remaining;
+        double weight = 1.0;
+        std::memcpy(coordinates[0] + filled, axisPoints[0].data() + index[0], length * sizeof(double));
+        for (int k = 1; k < dimension; k++)
+        {
+            std::fill(coordinates[k] + filled, coordinates[k] + filled + length, axisPoints[k][index[k]]);
+            weight *= axisWeights[k][index[k]];
+        }
+        rows.push_back({ filled, length, index[0], weight });
+        filled += length;
+        remaining -= (uint64_t) length;
+        index[0] = 0;
+        for (int k = 1; k < dimension; k++)
+        {
+            if (++index[k] < axisPoints[k].size()) break;
+            index[k] = 0;
+        }
+    }
+
+    // Evaluate the whole tile, then weight and add the values of each row.
+    evaluator(coordinates, dimension, values.data(), (uint64_t) filled);
+    double sum = 0.0;
+    for (const BoxRow & row : rows)
+    {
+        const double * weights = axisWeights[0].data() + row.first;
+        const double * y = values.data() + row.start;
+        double rowSum = 0.0;
+        for (int t = 0; t < row.count; t++) rowSum += weights[t] * y[t];
+        sum += row.weight * rowSum;
+    }
+    return sum;
+}
+
+/**
+ * This function returns the exact integral over box of the box function whose option number is functionOption (see nameOfBoxFunction), or NAN if there is no such function. 
+ * The integral of sin(x1 + ... + xd) is the imaginary part of the integral of exp(i (x1 + ... + xd)), which is the product over the axes of (exp(i b) - exp(i a)) / i.
+ */
+double exactBoxIntegral(int functionOption, const Box & box)
+{
+    if (functionOption == 0)
+    {
+        double integral = 0.0;
+        for (int k = 0; k < box.dimension; k++)
+        {
+            double term = (box.b[k] * box.b[k] * box.b[k] - box.a[k] * box.a[k] * box.a[k]) / 3.0;
+            for (int j = 0; j < box.dimension; j++) if (j != k) term *= box.b[j] - box.a[j];
+            integral += term;
+        }
+        return integral;
+    }
+    if (functionOption == 1)
+    {
+        double integral = 1.0;
+        for (int k = 0; k < box.dimension; k++) integral *= std::sin(box.b[k]) - std::sin(box.a[k]);
+        return integral;
+    }
+    if (functionOption == 2)
+    {
+        std::complex<double> integral = 1.0;
+        for (int k = 0; k < box.dimension; k++) integral *= (std::polar(1.0, box.b[k]) - std::polar(1.0, box.a[k])) / std::complex<double>(0.0, 1.0);
+        return integral.imag();
+    }
+    return NAN;
+}
+
+/**
+ * This function prints (to the command line terminal) the integral of the box function whose option number is options["function"] over the box [a,b]^d 
+ * with the tensor product of options["method"], for d = 1 through options["dimension"], and returns 0 (or 2 if the settings are invalid). 
+ * For each d, the number of partitions of every axis is chosen so that the grid has about options["points"] points, 
+ * and the time, the throughput (grid points per second), the result, and its relative error (compared with exactBoxIntegral) are printed.
+ */
+int runBoxReport(const std::map<std::string, std::string> & options)
+{
+    int hardwareThreads = (int) std::thread::hardware_concurrency();
+    std::map<std::string, std::string> settings = { { "function", "1" }, { "method", "midpoint" }, { "dimension", "6" }, { "a", "0" }, { "b", "1" }, { "points", "4194304" }, { "threads", std::to_string((hardwareThreads < 1) ? 1 : hardwareThreads) } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str()), maximumDimension = atoi(settings["dimension"].c_str()), threadCount = atoi(settings["threads"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str()), points = atof(settings["points"].c_str());
+    Rule rule = ruleFromMethod(settings["method"]);
+    int order = gaussLegendreOrderFromMethod(settings["method"]);
+    InstructionSet instructionSet = detectInstructionSet();
+    BoxEvaluator evaluator = selectBoxEvaluator(functionOption, instructionSet);
+    if ((evaluator == nullptr) || !methodIsRecognized(settings["method"]) || (maximumDimension < 1) || (maximumDimension > MAXIMUM_BOX_DIMENSION) || !(b > a) || !(points >= 1.0) || (threadCount < 1))
+    {
+        std::cout << "\n\nInvalid box report settings (function must be 0 through " << (NUMBER_OF_BOX_FUNCTIONS - 1) << ", method must be recognized, dimension must be 1 through " << MAXIMUM_BOX_DIMENSION << ", b must be larger than a, and points and threads must be positive).\n\n";
+        return 2;
+    }
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nBox Report (f = " << nameOfBoxFunction(functionOption) << ", " << settings["method"] << ", [" << a << "," << b << "]^d, about " << points << " points, " << threadCount << " thread(s), " << nameOfInstructionSet(instructionSet) << ")";
+    std::cout << "\n--------------------------------";
+    for (int dimension = 1; dimension <= maximumDimension; dimension++)
+    {
+        // Choose n (a multiple of the number of partitions per panel of the rule) so that each axis has about points^(1/d) points.
+        uint64_t panel = (rule == Rule::Boole) ? 4 : ((rule == Rule::Simpson) ? 2 : 1);
+        double axisPoints = std::pow(points, 1.0 / dimension) / ((rule == Rule::GaussLegendre) ? order : 1);
+        uint64_t n = panel * (uint64_t) std::floor(axisPoints / panel);
+        Box box;
+        box.dimension = dimension;
+        for (int k = 0; k < dimension; k++)
+        {
+            box.a[k] = a;
+            box.b[k] = b;
+            box.n[k] = (n < panel) ? panel : n;
+        }
+        if (!boxIsValid(box, rule, order))
+        {
+            std::cout << "\n\nd = " << dimension << ": the grid is too large (an axis may have at most " << BOX_MAXIMUM_AXIS_POINTS << " points).";
+            continue;
+        }
+        uint64_t gridPoints = numberOfPointsOfBox(box, rule, order);
+        auto start = std::chrono::steady_clock::now();
+        double integral = computeBoxIntegral(evaluator, box, rule, order, threadCount);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double exact = exactBoxIntegral(functionOption, box);
+        std::cout << "\n\nd = " << dimension << ": n = " << box.n[0] << " per axis, " << gridPoints << " points, " << seconds << " seconds, " << (gridPoints / seconds) << " points per second";
+        std::streamsize precision = std::cout.precision(17);
+        std::cout << ", integral = " << integral;
+        std::cout.precision(precision);
+        std::cout << ", relative error = " << (std::fabs(integral - exact) / std::fmax(std::fabs(exact), DBL_MIN)) << ".";
+    }
+    std::cout << "\n\n--------------------------------\n\n";
+    return 0;
+}
+
+/**
+ * This function stores in output the Philox4x32-10 random numbers of counter under key (Salmon et al., "Parallel random numbers: as easy as 1, 2, 3"): 
+ * ten rounds of two 32-bit multiplications (whose high halves are mixed with the other words and the key) with the key bumped by the Weyl constants after each round. 
+ * Every counter gives four independent 32-bit numbers, so the random numbers of any sample can be computed directly from its index (without stepping through the samples before it).
+ */
+void philox4x32(const uint32_t counter[4], const uint32_t key[2], uint32_t output[4])
+{
+    uint32_t c0 = counter[0], c1 = counter[1], c2 = counter[2], c3 = counter[3], k0 = key[0], k1 = key[1];
+    for (int round = 0; round < 10; round++)
+    {
+        uint64_t product0 = (uint64_t) 0xD2511F53u * c0, product1 = (uint64_t) 0xCD9E8D57u * c2;
+        uint32_t next0 = (uint32_t) (product1 >> 32) ^ c1 ^ k0, next2 = (uint32_t) (product0 >> 32) ^ c3 ^ k1;
+        c1 = (uint32_t) product1;
+        c3 = (uint32_t) product0;
+        c0 = next0;
+        c2 = next2;
+        k0 += 0x9E3779B9u;
+        k1 += 0xBB67AE85u;
+    }
+    output[0] = c0;
+    output[1] = c1;
+    output[2] = c2;
+    output[3] = c3;
+}
+
+// This function returns the uniformly distributed number in [0,1) whose 53 significant bits are the high 53 bits of bits.
+double uniformFromBits(uint64_t bits)
+{
+    return (double) (bits >> 11) * 0x1.0p-53;
+}
+
+// This function adds value to statistics (Welford's update, which does not lose the variance to cancellation when the mean is large).
+void addToRunningVariance(RunningVariance & statistics, double value)
+{
+    statistics.count++;
+    double delta = value - statistics.mean;
+    statistics.mean += delta / statistics.count;
+    statistics.m2 += delta * (value - statistics.mean);
+}
+
+// This function adds the values summarized by other to statistics (the pairwise update of Chan, Golub, and LeVeque).
+void mergeRunningVariance(RunningVariance & statistics, const RunningVariance & other)
+{
+    if (other.count == 0) return;
+    uint64_t count = statistics.count + other.count;
+    double delta = other.mean - statistics.mean;
+    statistics.mean += delta * ((double) other.count / count);
+    statistics.m2 += other.m2 + delta * delta * ((double) statistics.count * (double) other.count / count);
+    statistics.count = count;
+}
+
+/**
+ * This function stores the coordinates of the samples first through first + count - 1 of the pseudorandom stream of seed in coordinates (one array per axis of box). 
+ * Coordinates 2q and 2q + 1 of sample j come from the Philox counter (j, q) under the key seed, so every block of samples (and therefore every thread) 
+ * has its own independent stream, and the samples do not depend on which thread draws them.
+ */
+void storeRandomPointsOfBox(const Box & box, uint64_t seed, uint64_t first, uint64_t count, double * const * coordinates)
+{
+    const uint32_t key[2] = { (uint32_t) seed, (uint32_t) (seed >> 32) };
+    uint32_t bits[4];
+    for (uint64_t i = 0; i < count; i++)
+    {
+        uint64_t sample = first + i;
+        for (int k = 0; k < box.dimension; k += 2)
+        {
+            const uint32_t counter[4] = { (uint32_t) sample, (uint32_t) (sample >> 32), (uint32_t) (k / 2), 0 };
+            philox4x32(counter, key, bits);
+            coordinates[k][i] = box.a[k] + (box.b[k] - box.a[k]) * uniformFromBits(((uint64_t) bits[0] << 32) | bits[1]);
+            if (k + 1 < box.dimension) coordinates[k + 1][i] = box.a[k + 1] + (box.b[k + 1] - box.a[k + 1]) * uniformFromBits(((uint64_t) bits[2] << 32) | bits[3]);
+        }
+    }
+}
+
+// This function returns the number of base digits which the scrambled radical inverse in base uses (enough digits for 52 bits).
+int haltonDigitCount(int base)
+{
+    return (int) std::ceil(52.0 / std::log2((double) base));
+}
+
+/**
+ * This function stores the random digit scrambling of replicate for the Halton sequence of box in shifts and tails: 
+ * digit t of the radical inverse along axis k is shifted by shifts[k * 64 + t] (modulo the base of axis k, the (k + 1)th prime), 
+ * and tails[k * 64 + t] is the value which the shifted zero digits t, t + 1, ... add (so the radical inverse of an index stops at its last nonzero digit). 
+ * The shifts of each replicate come from the Philox counter (replicate, k, t, 1) under the key seed.
+ */
+void makeHaltonScrambling(const Box & box, uint64_t seed, int replicate, std::vector<uint32_t> & shifts, std::vector<double> & tails)
+{
+    static const int primes[MAXIMUM_BOX_DIMENSION] = { 2, 3, 5, 7, 11, 13, 17, 19 };
+    const uint32_t key[2] = { (uint32_t) seed, (uint32_t) (seed >> 32) };
+    uint32_t bits[4];
+    shifts.assign(MAXIMUM_BOX_DIMENSION * 64, 0);
+    tails.assign(MAXIMUM_BOX_DIMENSION * 64 + 1, 0.0);
+    for (int k = 0; k < box.dimension; k++)
+    {
+        int base = primes[k], digits = haltonDigitCount(base);
+        for (int t = 0; t < digits; t++)
+        {
+            const uint32_t counter[4] = { (uint32_t) replicate, (uint32_t) k, (uint32_t) t, 1 };
+            philox4x32(counter, key, bits);
+            shifts[k * 64 + t] = bits[0] % (uint32_t) base;
+        }
+        double tail = 0.0;
+        for (int t = digits - 1; t >= 0; t--)
+        {
+            tail = (shifts[k * 64 + t] + tail) / base;
+            tails[k * 64 + t] = tail;
+        }
+    }
+}
+
+/**
+ * This function stores the coordinates of the points first through first + count - 1 of the Halton sequence of box (scrambled by shifts and tails, see makeHaltonScrambling) 
+ * in coordinates (one array per axis of box). Point j is computed directly from j, so any thread can skip ahead to any block of the sequence.
+ */
+void storeHaltonPointsOfBox(const Box & box, const std::vector<uint32_t> & shifts, const std::vector<double> & tails, uint64_t first, uint64_t count, double * const * coordinates)
+{
+    static const int primes[MAXIMUM_BOX_DIMENSION] = { 2, 3, 5, 7, 11, 13, 17, 19 };
+    for (int k = 0; k < box.dimension; k++)
+    {
+        const uint32_t * shift = shifts.data() + k * 64;
+        const double * tail = tails.data() + k * 64;
+        switch (primes[k])
+        {
+            case 2: storeScrambledRadicalInverses<2>(shift, tail, first, count, box.a[k], box.b[k] - box.a[k], coordinates[k]); break;
+            case 3: storeScrambledRadicalInverses<3>(shift, tail, first, count, box.a[k], box.b[k] - box.a[k], coordinates[k]); break;
+            case 5: storeScrambledRadicalInverses<5>(shift, tail, first, count, box.a[k], box.b[k] - box.a[k], coordinates[k]); break;
+            case 7: storeScrambledRadicalInverses<7>(shift, tail, first, count, box.a[k], box.b[k] - box.a[k], coordinates[k]); break;
+            case 11: storeScrambledRadicalInverses<11>(shift, tail, first, count, box.a[k], box.b[k] - box.a[k], coordinates[k]); break;
+            case 13: storeScrambledRadicalInverses<13>(shift, tail, first, count, box.a[k], box.b[k] - box.a[k], coordinates[k]); break;
+            case 17: storeScrambledRadicalInverses<17>(shift, tail, first, count, box.a[k], box.b[k] - box.a[k], coordinates[k]); break;
+            default: storeScrambledRadicalInverses<19>(shift, tail, first, count, box.a[k], box.b[k] - box.a[k], coordinates[k]); break;
+        }
+    }
+}
+
+/**
+ * This function stores a + width * (the scrambled radical inverse in base of index) in coordinates[i] for each index first + i in [first, first + count) 
+ * (see makeHaltonScrambling). The base is a template parameter so that the divisions by it compile to multiplications.
+ */
+template <uint64_t base> void storeScrambledRadicalInverses(const uint32_t * shift, const double * tail, uint64_t first, uint64_t count, double a, double width, double * coordinates)
+{
+    const double inverseBase = 1.0 / (double) base;
+    for (uint64_t i = 0; i < count; i++)
+    {
+        uint64_t index = first + i;
+        double value = 0.0, factor = inverseBase;
+        int t = 0;
+        for (; index > 0; t++)
+        {
+            uint64_t digit = index % base;
+            index /= base;
+            value += (double) ((digit + shift[t]) % base) * factor;
+            factor *= inverseBase;
+        }
+        value += tail[t] * factor * (double) base;
+        coordinates[i] = a + width * value;
+    }
+}
+
+/**
+ * This function returns the statistics (see RunningVariance) of f (which evaluator evaluates) at the MONTE_CARLO_BLOCK_SIZE samples of one block, starting with sample first: 
+ * pseudorandom points of the stream of seed if sampling is Pseudorandom, or points of the Halton sequence scrambled by shifts and tails if sampling is Halton. 
+ * The points are stored in a buffer which belongs to the calling thread, and the whole block is evaluated with one call of evaluator.
+ */
+RunningVariance sampleMonteCarloBlock(BoxEvaluator evaluator, const Box & box, Sampling sampling, uint64_t seed, const std::vector<uint32_t> & shifts, const std::vector<double> & tails, uint64_t first)
+{
+    thread_local std::vector<double> buffer, values;
+    double * coordinates[MAXIMUM_BOX_DIMENSION];
+    RunningVariance statistics = { 0, 0.0, 0.0 };
+    if (buffer.size() < (size_t) box.dimension * MONTE_CARLO_BLOCK_SIZE) buffer.resize((size_t) box.dimension * MONTE_CARLO_BLOCK_SIZE);
+    if (values.size() < MONTE_CARLO_BLOCK_SIZE) values.resize(MONTE_CARLO_BLOCK_SIZE);
+    for (int k = 0; k < box.dimension; k++) coordinates[k] = buffer.data() + (size_t) k * MONTE_CARLO_BLOCK_SIZE;
+    if (sampling == Sampling::Pseudorandom) storeRandomPointsOfBox(box, seed, first, MONTE_CARLO_BLOCK_SIZE, coordinates);
+    else storeHaltonPointsOfBox(box, shifts, tails, first, MONTE_CARLO_BLOCK_SIZE, coordinates);
+    evaluator(coordinates, box.dimension, values.data(), MONTE_CARLO_BLOCK_SIZE);
+    for (int i = 0; i < MONTE_CARLO_BLOCK_SIZE; i++) addToRunningVariance(statistics, values[i]);
+    return statistics;
+}
+
+/**
+ * This function returns the Monte Carlo estimate of the integral over box of the function which evaluator evaluates (on threadCount threads), 
+ * sampling until the standard error is at most targetError (or until maximumSamples evaluations were used). 
+ * 
+ * If sampling is Pseudorandom, the estimate is the volume of box times the mean of f at independent uniform points, 
+ * and its standard error is the volume times the standard deviation of f divided by the square root of the number of samples. 
+ * If sampling is Halton, QUASI_MONTE_CARLO_REPLICATES independently scrambled Halton sequences are sampled at the same indices, 
+ * the estimate is the mean of their estimates, and the standard error is the standard deviation of their estimates divided by the square root of their number 
+ * (a single quasi-Monte Carlo sequence has no variance from which its error could be estimated). 
+ * 
+ * The samples are drawn in blocks of MONTE_CARLO_BLOCK_SIZE (block i always holds the same samples), MONTE_CARLO_ROUND_BLOCKS blocks per round on the thread pool, 
+ * and the statistics of the blocks are merged in block order after each round (so the result does not depend on threadCount). 
+ * The standard error is checked after each round.
+ */
+MonteCarloResult computeMonteCarloIntegral(BoxEvaluator evaluator, const Box & box, Sampling sampling, uint64_t seed, double targetError, uint64_t maximumSamples, int threadCount)
+{
+    int replicates = (sampling == Sampling::Halton) ? QUASI_MONTE_CARLO_REPLICATES : 1;
+    std::vector<std::vector<uint32_t>> shifts(replicates);
+    std::vector<std::vector<double>> tails(replicates);
+    std::vector<RunningVariance> replicateStatistics(replicates, RunningVariance{ 0, 0.0, 0.0 }), blockStatistics(MONTE_CARLO_ROUND_BLOCKS * replicates);
+    MonteCarloResult result = { 0.0, INFINITY, 0, false };
+    double volume = 1.0;
+    for (int k = 0; k < box.dimension; k++) volume *= box.b[k] - box.a[k];
+    for (int r = 0; r < replicates; r++) if (sampling == Sampling::Halton) makeHaltonScrambling(box, seed, r, shifts[r], tails[r]);
+    ThreadPool & pool = acquireThreadPool((threadCount < 1) ? 1 : threadCount);
+    for (uint64_t firstBlock = 0; result.samples + (uint64_t) replicates * MONTE_CARLO_BLOCK_SIZE <= maximumSamples; firstBlock += MONTE_CARLO_ROUND_BLOCKS)
+    {
+        // Sample the blocks of this round (of every replicate) on whichever thread claims them.
+        uint64_t roundBlocks = (maximumSamples - result.samples) / ((uint64_t) replicates * MONTE_CARLO_BLOCK_SIZE);
+        if (roundBlocks > MONTE_CARLO_ROUND_BLOCKS) roundBlocks = MONTE_CARLO_ROUND_BLOCKS;
+        runOnThreadPool(pool, roundBlocks * replicates, [&](uint64_t task)
+        {
+            uint64_t block = firstBlock + task / replicates;
+            int r = (int) (task % replicates);
+            blockStatistics[task] = sampleMonteCarloBlock(evaluator, box, sampling, seed, shifts[r], tails[r], block * MONTE_CARLO_BLOCK_SIZE);
+        });
+        for (uint64_t task = 0; task < roundBlocks * replicates; task++) mergeRunningVariance(replicateStatistics[task % replicates], blockStatistics[task]);
+        result.samples += roundBlocks * replicates * MONTE_CARLO_BLOCK_SIZE;
+
+        // Update the estimate and its standard error, and stop if the standard error reached the target.
+        if (sampling == Sampling::Pseudorandom)
+        {
+            const RunningVariance & statistics = replicateStatistics[0];
+            result.estimate = volume * statistics.mean;
+            result.standardError = volume * std::sqrt(statistics.m2 / (double) (statistics.count - 1) / (double) statistics.count);
+        }
+        else
+        {
+            RunningVariance estimates = { 0, 0.0, 0.0 };
+            for (int r = 0; r < replicates; r++) addToRunningVariance(estimates, volume * replicateStatistics[r].mean);
+            result.estimate = estimates.mean;
+            result.standardError = std::sqrt(estimates.m2 / (double) (replicates - 1) / (double) replicates);
+        }
+        if (result.standardError <= targetError)
+        {
+            result.converged = true;
+            break;
+        }
+    }
+    return result;
+}
+
+/**
+ * This function prints (to the command line terminal) the pseudorandom Monte Carlo and scrambled Halton quasi-Monte Carlo estimates of the integral 
+ * of the box function whose option number is options["function"] over the box [a,b]^d (where d is options["dimension"]), 
+ * each sampled until its standard error is at most options["error"] (or until options["samples"] samples were used), 
+ * together with the number of samples, the time, and the actual error (compared with exactBoxIntegral). 
+ * Return 0 if each actual error is within 5 standard errors (or 1 otherwise, or 2 if the settings are invalid).
+ */
+int runMonteCarloReport(const std::map<std::string, std::string> & options)
+{
+    int hardwareThreads = (int) std::thread::hardware_concurrency();
+    std::map<std::string, std::string> settings = { { "function", "1" }, { "dimension", "6" }, { "a", "0" }, { "b", "1" }, { "error", "1e-4" }, { "samples", "100000000" }, { "seed", "1" }, { "threads", std::to_string((hardwareThreads < 1) ? 1 : hardwareThreads) } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str()), dimension = atoi(settings["dimension"].c_str()), threadCount = atoi(settings["threads"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str()), targetError = atof(settings["error"].c_str());
+    uint64_t maximumSamples = strtoull(settings["samples"].c_str(), nullptr, 10), seed = strtoull(settings["seed"].c_str(), nullptr, 10);
+    InstructionSet instructionSet = detectInstructionSet();
+    BoxEvaluator evaluator = selectBoxEvaluator(functionOption, instructionSet);
+    if ((evaluator == nullptr) || (dimension < 1) || (dimension > MAXIMUM_BOX_DIMENSION) || !std::isfinite(a) || !std::isfinite(b) || !(b > a) || !(targetError > 0.0) || (maximumSamples < (uint64_t) QUASI_MONTE_CARLO_REPLICATES * MONTE_CARLO_BLOCK_SIZE) || (threadCount < 1))
+    {
+        std::cout << "\n\nInvalid Monte Carlo report settings (function must be 0 through " << (NUMBER_OF_BOX_FUNCTIONS - 1) << ", dimension must be 1 through " << MAXIMUM_BOX_DIMENSION << ", b must be larger than a, error must be positive, samples must be at least " << ((uint64_t) QUASI_MONTE_CARLO_REPLICATES * MONTE_CARLO_BLOCK_SIZE) << ", and threads must be positive).\n\n";
+        return 2;
+    }
+    Box box;
+    box.dimension = dimension;
+    for (int k = 0; k < dimension; k++)
+    {
+        box.a[k] = a;
+        box.b[k] = b;
+        box.n[k] = 1;
+    }
+    static const char * const names[NUMBER_OF_SAMPLINGS] = { "Monte Carlo (Philox4x32-10)", "quasi-Monte Carlo (scrambled Halton)" };
+    double exact = exactBoxIntegral(functionOption, box);
+    bool consistent = true;
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nMonte Carlo Report (f = " << nameOfBoxFunction(functionOption) << ", [" << a << "," << b << "]^" << dimension << ", target standard error " << targetError << ", seed " << seed << ", " << threadCount << " thread(s), " << nameOfInstructionSet(instructionSet) << ")";
+    std::cout << "\n--------------------------------";
+    for (int method = 0; method < NUMBER_OF_SAMPLINGS; method++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        MonteCarloResult result = computeMonteCarloIntegral(evaluator, box, (Sampling) method, seed, targetError, maximumSamples, threadCount);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        double error = std::fabs(result.estimate - exact);
+        if (!(error <= 5.0 * result.standardError)) consistent = false;
+        std::cout << "\n\n" << names[method] << ": " << result.samples << " samples in " << seconds << " seconds (" << (result.samples / seconds) << " samples per second)" << (result.converged ? "" : " (the target was NOT reached)");
+        std::streamsize precision = std::cout.precision(17);
+        std::cout << "\nestimate = " << result.estimate;
+        std::cout.precision(precision);
+        std::cout << ", standard error = " << result.standardError << ", actual error = " << error << " (" << (error / result.standardError) << " standard errors).";
+    }
+    std::streamsize precision = std::cout.precision(17);
+    std::cout << "\n\nexact integral = " << exact << ".";
+    std::cout.precision(precision);
+    std::cout << "\n\n--------------------------------\n\n";
+    return consistent ? 0 : 1;
+}
+
+/**
+ * This function maps the file at path into memory (read only) as file.data and returns true (or stores the reason in error and returns false). 
+ * The pages are read ahead sequentially and are released by integrateSampleFile after they are integrated, so a file of any size is integrated with bounded memory. 
+ * The format, layout, x0, and dx of file are not changed.
+ */
+bool openSampleFile(const std::string & path, SampleFile & file, std::string & error)
+{
+    struct stat status;
+    int descriptor = open(path.c_str(), O_RDONLY);
+    if (descriptor < 0)
+    {
+        error = "the file named " + path + " could not be opened";
+        return false;
+    }
+    if ((fstat(descriptor, &status) != 0) || (status.st_size <= 0))
+    {
+        close(descriptor);
+        error = "the file named " + path + " is empty";
+        return false;
+    }
+    void * mapping = mmap(nullptr, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+    close(descriptor); // (the mapping stays valid after the descriptor is closed)
+    if (mapping == MAP_FAILED)
+    {
+        error = "the file named " + path + " could not be mapped into memory";
+        return false;
+    }
+    madvise(mapping, (size_t) status.st_size, MADV_SEQUENTIAL);
+    file.data = (const char *) mapping;
+    file.size = (size_t) status.st_size;
+    return true;
+}
+
+// This function unmaps the sample file (if one is mapped).
+void closeSampleFile(SampleFile & file)
+{
+    if (file.data != nullptr) munmap((void *) file.data, file.size);
+    file.data = nullptr;
+    file.size = 0;
+}
+
+// This function appends the sample (x, y) to summary, where interval is the distance from the last sample of summary to x (which is ignored if summary is empty).
+void addSampleToSummary(SampleSummary & summary, double x, double y, double interval)
+{
+    if (summary.count == 0)
+    {
+        summary.firstX = x;
+        summary.firstY = y;
+    }
+    else
+    {
+        if (!(interval > 0.0)) summary.increasing = false;
+        addNeumaier(summary.left, summary.leftError, summary.lastY * interval);
+        addNeumaier(summary.right, summary.rightError, y * interval);
+        addNeumaier(summary.trapezoid, summary.trapezoidError, 0.5 * (summary.lastY + y) * interval);
+        if (summary.count >= 2) addNeumaier(summary.midpoint[summary.count % 2], summary.midpointError[summary.count % 2], summary.lastY * (summary.lastInterval + interval));
+        if (summary.count == 1)
+        {
+            summary.secondY = y;
+            summary.firstInterval = interval;
+        }
+        summary.penultimateY = summary.lastY;
+        summary.lastInterval = interval;
+    }
+    summary.lastX = x;
+    summary.lastY = y;
+    summary.count++;
+}
+
+/**
+ * This function appends the samples summarized by next (which follow the samples of summary in file) to summary, 
+ * adding the interval between the last sample of summary and the first sample of next (whose width is file.dx if the layout of file is Values) 
+ * and the midpoint panels which cross from summary to next (the parity p of next is the parity p + (the number of samples of summary) of the merged run).
+ */
+void mergeSampleSummaries(SampleSummary & summary, const SampleSummary & next, const SampleFile & file)
+{
+    summary.skippedLines += next.skippedLines;
+    if (next.count == 0) return;
+    if (summary.count == 0)
+    {
+        uint64_t skippedLines = summary.skippedLines;
+        summary = next;
+        summary.skippedLines = skippedLines;
+        return;
+    }
+    double interval = (file.layout == SampleLayout::Values) ? file.dx : (next.firstX - summary.lastX);
+    uint64_t count = summary.count;
+    addSampleToSummary(summary, next.firstX, next.firstY, interval);
+    if (next.count == 1) return;
+    addNeumaier(summary.midpoint[(count + 1) % 2], summary.midpointError[(count + 1) % 2], next.firstY * (interval + next.firstInterval));
+    for (int parity = 0; parity < 2; parity++)
+    {
+        addNeumaier(summary.midpoint[parity], summary.midpointError[parity], next.midpoint[(parity + count) % 2]);
+        summary.midpointError[parity] += next.midpointError[(parity + count) % 2];
+    }
+    addNeumaier(summary.left, summary.leftError, next.left);
+    addNeumaier(summary.right, summary.rightError, next.right);
+    addNeumaier(summary.trapezoid, summary.trapezoidError, next.trapezoid);
+    summary.leftError += next.leftError;
+    summary.rightError += next.rightError;
+    summary.trapezoidError += next.trapezoidError;
+    summary.increasing = summary.increasing && next.increasing;
+    summary.penultimateY = next.penultimateY;
+    summary.lastInterval = next.lastInterval;
+    summary.lastX = next.lastX;
+    summary.lastY = next.lastY;
+    summary.count += next.count - 1;
+}
+
+/**
+ * This function parses the line [begin,end) of a CSV file (without its line break) into x and y and returns true, 
+ * or returns false if the line is not a sample (e.g. if it is blank, a comment, or a header). 
+ * The numbers are parsed in place (without copying the line) and may be separated by commas, semicolons, spaces, or tabs. 
+ * A line of the Values layout holds only y.
+ */
+bool parseSampleLine(const char * begin, const char * end, SampleLayout layout, double & x, double & y)
+{
+    auto skipSeparators = [&](const char * position)
+    {
+        while ((position < end) && ((*position == ' ') || (*position == '\t') || (*position == ',') || (*position == ';') || (*position == '\r'))) position++;
+        return position;
+    };
+    const char * position = skipSeparators(begin);
+    if (layout == SampleLayout::Pairs)
+    {
+        std::from_chars_result parsed = std::from_chars(position, end, x);
+        if (parsed.ec != std::errc()) return false;
+        position = skipSeparators(parsed.ptr);
+    }
+    std::from_chars_result parsed = std::from_chars(position, end, y);
+    if (parsed.ec != std::errc()) return false;
+    return skipSeparators(parsed.ptr) == end;
+}
+
+/**
+ * This function returns the summary of the samples of chunk (the bytes chunk * SAMPLE_CHUNK_BYTES through (chunk + 1) * SAMPLE_CHUNK_BYTES - 1) of file. 
+ * The chunks of a binary file hold whole samples (SAMPLE_CHUNK_BYTES is a multiple of the size of a sample). 
+ * A line of a CSV file belongs to the chunk in which it starts, so a chunk skips the end of a line which started in the previous chunk 
+ * and finishes a line which continues into the next chunk. 
+ * The x of the ith sample of the Values layout is x0 + i * dx in a binary file and (i - the index of the first sample of the chunk) * dx in a CSV file 
+ * (whose chunks cannot know how many samples precede them), which is why mergeSampleSummaries uses dx as the interval between the chunks of that layout.
+ */
+SampleSummary summarizeSampleChunk(const SampleFile & file, uint64_t chunk)
+{
+    SampleSummary summary = { 0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, { 0.0, 0.0 }, { 0.0, 0.0 }, true };
+    size_t first = (size_t) chunk * SAMPLE_CHUNK_BYTES, last = ((file.size - first) < SAMPLE_CHUNK_BYTES) ? file.size : (first + SAMPLE_CHUNK_BYTES);
+    double x = 0.0, y = 0.0;
+    if (file.format == SampleFormat::Binary)
+    {
+        if (file.layout == SampleLayout::Values)
+        {
+            for (size_t offset = first; offset < last; offset += sizeof(double))
+            {
+                std::memcpy(&y, file.data + offset, sizeof(double));
+                addSampleToSummary(summary, file.x0 + (double) (offset / sizeof(double)) * file.dx, y, file.dx);
+            }
+            return summary;
+        }
+        for (size_t offset = first; offset < last; offset += 2 * sizeof(double))
+        {
+            double previousX = x;
+            std::memcpy(&x, file.data + offset, sizeof(double));
+            std::memcpy(&y, file.data + offset + sizeof(double), sizeof(double));
+            addSampleToSummary(summary, x, y, x - previousX);
+        }
+        return summary;
+    }
+
+    // Skip the end of the line which started in the previous chunk, then parse every line which starts in this chunk.
+    const char * position = file.data + first, * end = file.data + file.size;
+    if (first > 0) while ((position < file.data + last) && (position[-1] != '\n')) position++;
+    while (position < file.data + last)
+    {
+        const char * lineEnd = (const char *) std::memchr(position, '\n', end - position);
+        if (lineEnd == nullptr) lineEnd = end;
+        double previousX = x;
+        if (parseSampleLine(position, lineEnd, file.layout, x, y))
+        {
+            if (file.layout == SampleLayout::Values) x = (double) summary.count * file.dx;
+            addSampleToSummary(summary, x, y, (file.layout == SampleLayout::Values) ? file.dx : (x - previousX));
+        }
+        else
+        {
+            x = previousX;
+            if (lineEnd > position) summary.skippedLines++;
+        }
+        position = lineEnd + 1;
+    }
+    return summary;
+}
+
+/**
+ * This function returns the summary of every sample of file in one pass on threadCount threads: 
+ * the chunks of SAMPLE_CHUNK_BYTES bytes are summarized in parallel, SAMPLE_ROUND_CHUNKS chunks per round, and merged in file order (so the result does not depend on threadCount). 
+ * After each round, the pages of that round are released, so the memory used is bounded by the size of one round (no matter how large the file is).
+ */
+SampleSummary integrateSampleFile(const SampleFile & file, int threadCount)
+{
+    SampleSummary total = { 0, 0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, { 0.0, 0.0 }, { 0.0, 0.0 }, true };
+    std::vector<SampleSummary> summaries(SAMPLE_ROUND_CHUNKS);
+    uint64_t chunkCount = (file.size + SAMPLE_CHUNK_BYTES - 1) / SAMPLE_CHUNK_BYTES;
+    ThreadPool & pool = acquireThreadPool((threadCount < 1) ? 1 : threadCount);
+    for (uint64_t firstChunk = 0; firstChunk < chunkCount; firstChunk += SAMPLE_ROUND_CHUNKS)
+    {
+        uint64_t roundChunks = ((chunkCount - firstChunk) < SAMPLE_ROUND_CHUNKS) ? (chunkCount - firstChunk) : SAMPLE_ROUND_CHUNKS;
+        runOnThreadPool(pool, roundChunks, [&](uint64_t k) { summaries[k] = summarizeSampleChunk(file, firstChunk + k); });
+        for (uint64_t k = 0; k < roundChunks; k++) mergeSampleSummaries(total, summaries[k], file);
+        madvise((void *) (file.data + firstChunk * SAMPLE_CHUNK_BYTES), roundChunks * SAMPLE_CHUNK_BYTES - ((firstChunk + roundChunks == chunkCount) ? (chunkCount * SAMPLE_CHUNK_BYTES - file.size) : 0), MADV_DONTNEED);
+    }
+    return total;
+}
+
+/**
+ * This function returns the integral over [x_0, x_m-1] of the samples of summary with rule 0 (left: y_i times the interval which follows x_i), 1 (right: y_i+1 times the interval which precedes x_i+1), 
+ * 2 (midpoint: the samples are paired into panels [x_2j, x_2j+2] of two intervals, and y_2j+1 times the width of the panel is the midpoint rule over it), 
+ * or 3 (trapezoid), including the error terms of the Neumaier sums. 
+ * The odd samples are the midpoints of their panels only if the spacing is uniform (otherwise y_2j+1 stands in for the height at the middle of the panel, 
+ * which adds an error proportional to the distance between them). If the number of intervals is odd, the last interval is not in a panel and adds its trapezoid.
+ */
+double sampleRuleEstimate(const SampleSummary & summary, int rule)
+{
+    if (rule == 0) return summary.left + summary.leftError;
+    if (rule == 1) return summary.right + summary.rightError;
+    if (rule == 3) return summary.trapezoid + summary.trapezoidError;
+    double estimate = summary.midpoint[0] + summary.midpointError[0];
+    if ((summary.count >= 2) && (summary.count % 2 == 0)) estimate += 0.5 * (summary.penultimateY + summary.lastY) * summary.lastInterval;
+    return estimate;
+}
+
+/**
+ * This function writes count samples of the function whose option number is functionOption over [a,b] to the file at path in format and layout and returns true (or false if the file could not be written). 
+ * The samples of the Values layout are evenly spaced from a to b. The samples of the Pairs layout are not: each sample other than the first and last is moved by a random amount 
+ * (up to 40% of the average spacing, drawn with seed) so that x still increases. The numbers of a CSV file are written with std::to_chars (the shortest text which reads back as the same double).
+ */
+bool writeSampleFile(const std::string & path, SampleFormat format, SampleLayout layout, int functionOption, double a, double b, uint64_t count, uint64_t seed)
+{
+    BatchEvaluator evaluator = selectBatchEvaluator(functionOption, InstructionSet::Scalar);
+    std::ofstream output(path, std::ios::binary);
+    std::mt19937_64 generator(seed);
+    std::uniform_real_distribution<double> jitter(-0.4, 0.4);
+    std::vector<double> x(PARALLEL_BLOCK_SIZE), y(PARALLEL_BLOCK_SIZE);
+    std::vector<char> buffer(PARALLEL_BLOCK_SIZE * 64);
+    double spacing = (b - a) / (double) (count - 1);
+    if (!output.is_open() || (evaluator == nullptr)) return false;
+    for (uint64_t first = 0; first < count; first += PARALLEL_BLOCK_SIZE)
+    {
+        uint64_t blockSize = ((count - first) < PARALLEL_BLOCK_SIZE) ? (count - first) : PARALLEL_BLOCK_SIZE;
+        for (uint64_t i = 0; i < blockSize; i++)
+        {
+            uint64_t index = first + i;
+            double shift = ((layout == SampleLayout::Pairs) && (index > 0) && (index + 1 < count)) ? jitter(generator) : 0.0;
+            x[i] = (index + 1 == count) ? b : (a + ((double) index + shift) * spacing);
+        }
+        evaluator(x.data(), y.data(), blockSize);
+        char * position = buffer.data();
+        for (uint64_t i = 0; i < blockSize; i++)
+        {
+            if (format == SampleFormat::Binary)
+            {
+                if (layout == SampleLayout::Pairs)
+                {
+                    std::memcpy(position, &x[i], sizeof(double));
+                    position += sizeof(double);
+                }
+                std::memcpy(position, &y[i], sizeof(double));
+                position += sizeof(double);
+                continue;
+            }
+            if (layout == SampleLayout::Pairs)
+            {
+                position = std::to_chars(position, position + 32, x[i]).ptr;
+                *position++ = ',';
+            }
+            position = std::to_chars(position, position + 32, y[i]).ptr;
+            *position++ = '\n';
+        }
+        output.write(buffer.data(), position - buffer.data());
+    }
+    return output.good();
+}
+
+/**
+ * This function integrates the sample file options["file"] (see SampleFile; the format is CSV if the file name ends with .csv unless options["format"] says otherwise) 
+ * with the left, right, midpoint, and trapezoid rules in one pass on options["threads"] threads, 
+ * prints (to the command line terminal) the number of samples, the throughput, and the estimate of each rule, and returns 0 
+ * (or 1 if x does not increase from every sample to the next, or 2 if the settings are invalid or the file cannot be read). 
+ * 
+ * If options["generate"] is given, that many samples of the function whose option number is options["function"] over [options["a"],options["b"]] are written to the file first 
+ * (reimann_sum_samples.bin or reimann_sum_samples.csv if options["file"] is not given), and the relative error of each rule (compared with exactIntegral) is also printed.
+ */
+int runSampleMode(const std::map<std::string, std::string> & options)
+{
+    static const char * const ruleNames[NUMBER_OF_SAMPLE_RULES] = { "left", "right", "midpoint", "trapezoid" };
+    int hardwareThreads = (int) std::thread::hardware_concurrency();
+    std::map<std::string, std::string> settings = { { "file", "" }, { "format", "" }, { "layout", "pairs" }, { "x0", "0" }, { "dx", "1" }, { "generate", "0" }, { "function", "2" }, { "a", "0" }, { "b", "3" }, { "seed", "1" }, { "threads", std::to_string((hardwareThreads < 1) ? 1 : hardwareThreads) } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    std::string path = settings["file"], format = settings["format"], error;
+    uint64_t generate = strtoull(settings["generate"].c_str(), nullptr, 10);
+    int functionOption = atoi(settings["function"].c_str()), threadCount = atoi(settings["threads"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str());
+    if (format.empty()) format = ((path.size() >= 4) && (path.compare(path.size() - 4, 4, ".csv") == 0)) ? "csv" : "binary";
+    if (path.empty() && (generate > 0)) path = (format == "csv") ? "reimann_sum_samples.csv" : "reimann_sum_samples.bin";
+    SampleFile file = { nullptr, 0, (format == "csv") ? SampleFormat::Csv : SampleFormat::Binary, (settings["layout"] == "values") ? SampleLayout::Values : SampleLayout::Pairs, atof(settings["x0"].c_str()), atof(settings["dx"].c_str()) };
+    if (path.empty() || ((format != "csv") && (format != "binary")) || ((settings["layout"] != "pairs") && (settings["layout"] != "values")) || !(file.dx > 0.0) || (threadCount < 1) 
+        || ((generate > 0) && ((generate < 2) || (selectBatchEvaluator(functionOption, InstructionSet::Scalar) == nullptr) || !(b > a))))
+    {
+        std::cout << "\n\nInvalid sample settings (file must be given unless samples are generated, format must be binary or csv, layout must be pairs or values, dx and threads must be positive, ";
+        std::cout << "and generate must be at least 2 with function 0 through " << USER_DEFINED_FUNCTION_OPTION << " and b larger than a).\n\n";
+        return 2;
+    }
+    if (generate > 0)
+    {
+        if (!writeSampleFile(path, file.format, file.layout, functionOption, a, b, generate, strtoull(settings["seed"].c_str(), nullptr, 10)))
+        {
+            std::cout << "\n\nThe file named " << path << " could not be written.\n\n";
+            return 2;
+        }
+        file.x0 = a;
+        file.dx = (b - a) / (double) (generate - 1);
+    }
+    if (!openSampleFile(path, file, error))
+    {
+        std::cout << "\n\nThe sample file could not be read: " << error << ".\n\n";
+        return 2;
+    }
+    size_t sampleBytes = (file.layout == SampleLayout::Pairs) ? 2 * sizeof(double) : sizeof(double);
+    if ((file.format == SampleFormat::Binary) && (file.size % sampleBytes != 0))
+    {
+        closeSampleFile(file);
+        std::cout << "\n\nThe size of the binary file named " << path << " is not a multiple of " << sampleBytes << " bytes (the size of one sample).\n\n";
+        return 2;
+    }
+    auto start = std::chrono::steady_clock::now();
+    SampleSummary summary = integrateSampleFile(file, threadCount);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    size_t bytes = file.size;
+    closeSampleFile(file);
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nSampled Data (" << path << ", " << format << ", " << settings["layout"] << ", " << threadCount << " thread(s))";
+    std::cout << "\n--------------------------------";
+    if (summary.count < 2)
+    {
+        std::cout << "\n\n" << summary.count << " sample(s) (" << summary.skippedLines << " line(s) skipped), but at least 2 samples are needed.\n\n--------------------------------\n\n";
+        return 2;
+    }
+    double lastX = (file.layout == SampleLayout::Values) ? (file.x0 + (double) (summary.count - 1) * file.dx) : summary.lastX;
+    double firstX = (file.layout == SampleLayout::Values) ? file.x0 : summary.firstX;
+    std::cout << "\n\n" << summary.count << " samples over [" << firstX << "," << lastX << "] (" << summary.skippedLines << " line(s) skipped), " << bytes << " bytes in " << seconds << " seconds (" << (bytes / seconds / 1e6) << " MB per second, " << (summary.count / seconds) << " samples per second).";
+    if (!summary.increasing) std::cout << "\n\nx does NOT increase from every sample to the next, so the estimates below are not integrals.";
+    double exact = (generate > 0) ? exactIntegral(functionOption, a, b) : NAN;
+    for (int rule = 0; rule < NUMBER_OF_SAMPLE_RULES; rule++)
+    {
+        double estimate = sampleRuleEstimate(summary, rule);
+        std::streamsize precision = std::cout.precision(17);
+        std::cout << "\n\n" << ruleNames[rule] << ": " << estimate;
+        std::cout.precision(precision);
+        if (generate > 0) std::cout << " (relative error " << (std::fabs(estimate - exact) / std::fmax(std::fabs(exact), DBL_MIN)) << ")";
+        std::cout << ".";
+    }
+    if (generate > 0)
+    {
+        std::streamsize precision = std::cout.precision(17);
+        std::cout << "\n\nexact integral = " << exact << ".";
+        std::cout.precision(precision);
+    }
+    std::cout << "\n\n--------------------------------\n\n";
+    return summary.increasing ? 0 : 1;
+}
+
+/**
+ * This function writes a few sample sets which are small enough to integrate by hand (in every format and layout, with uniform and non-uniform spacing, and with a header line to skip) 
+ * to the file named SAMPLE_CHECK_FILE_NAME one at a time, integrates each one (as runSampleMode does) with every rule for sampled data, prints (to the command line terminal) each estimate next to the value computed by hand, and returns 0 if every estimate matches (or 1 otherwise).
+ */
+int runSampleRuleCheck()
+{
+    static const char * const ruleNames[NUMBER_OF_SAMPLE_RULES] = { "left", "right", "midpoint", "trapezoid" };
+    struct SampleCheck {
+        const char * name;
+        std::string data;
+        SampleFormat format;
+        SampleLayout layout;
+        double dx;
+        double expected[NUMBER_OF_SAMPLE_RULES];
+    };
+    const double values[3] = { 1.0, 3.0, 2.0 };
+    std::string binaryValues((const char *) values, sizeof(values));
+    std::vector<SampleCheck> checks = {
+        { "(0,0), (1,1), (2,4) (CSV pairs with a header)", "x,y\n0,0\n1,1\n2,4\n", SampleFormat::Csv, SampleLayout::Pairs, 1.0, { 1.0, 5.0, 2.0, 3.0 } },
+        { "(0,2), (1,4), (4,1) (CSV pairs, non-uniform)", "0,2\n1,4\n4,1", SampleFormat::Csv, SampleLayout::Pairs, 1.0, { 14.0, 7.0, 16.0, 10.5 } },
+        { "y = 1, 3, 2 with dx = 0.5 (CSV values)", "1\n3\n2\n", SampleFormat::Csv, SampleLayout::Values, 0.5, { 2.0, 2.5, 3.0, 2.25 } },
+        { "y = 1, 3, 2 with dx = 0.5 (binary values)", binaryValues, SampleFormat::Binary, SampleLayout::Values, 0.5, { 2.0, 2.5, 3.0, 2.25 } }
+    };
+    bool passed = true;
+    std::cout.precision(17);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nSampled Data Rule Check";
+    std::cout << "\n--------------------------------";
+    for (const SampleCheck & check : checks)
+    {
+        SampleFile file = { nullptr, 0, check.format, check.layout, 0.0, check.dx };
+        std::string error;
+        std::ofstream output(SAMPLE_CHECK_FILE_NAME, std::ios::binary);
+        output.write(check.data.data(), (std::streamsize) check.data.size());
+        output.close();
+        if (!output || !openSampleFile(SAMPLE_CHECK_FILE_NAME, file, error))
+        {
+            std::cout << "\n\nThe file named " << SAMPLE_CHECK_FILE_NAME << " could not be written and read back.\n\n";
+            std::remove(SAMPLE_CHECK_FILE_NAME);
+            return 1;
+        }
+        SampleSummary summary = integrateSampleFile(file, 2);
+        closeSampleFile(file);
+        std::cout << "\n\n" << check.name << ":";
+        for (int rule = 0; rule < NUMBER_OF_SAMPLE_RULES; rule++)
+        {
+            double estimate = sampleRuleEstimate(summary, rule);
+            bool matches = (summary.count == 3) && (std::fabs(estimate - check.expected[rule]) <= 1e-12);
+            passed = passed && matches;
+            std::cout << "\n" << ruleNames[rule] << ": " << estimate << " (expected " << check.expected[rule] << ") " << (matches ? "PASS" : "FAIL");
+        }
+    }
+    std::remove(SAMPLE_CHECK_FILE_NAME);
+    std::cout << "\n\n" << (passed ? "Every estimate matches." : "SOME ESTIMATES DO NOT MATCH.");
+    std::cout << "\n\n--------------------------------\n\n";
+    return passed ? 0 : 1;
+}
+
+/**
+ * This function prepares integral for the n partitions of [a,b] and returns true (or false if the n + 1 running sums cannot be stored). 
+ * If path is empty, the running sums are stored in integral.storage. Otherwise the file at path is created (or replaced) with room for n + 1 doubles 
+ * and mapped into memory, so the running sums are written straight into the file (which then has the binary values layout of a sample file, see SampleFile).
+ */
+bool allocateCumulativeIntegral(CumulativeIntegral & integral, double a, double b, uint64_t n, const std::string & path)
+{
+    size_t bytes = (size_t) (n + 1) * sizeof(double);
+    integral.n = n;
+    integral.a = a;
+    integral.dx = (b - a) / n;
+    integral.mappedBytes = 0;
+    if (path.empty())
+    {
+        integral.storage.resize(n + 1);
+        integral.values = integral.storage.data();
+        return true;
+    }
+    int descriptor = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (descriptor < 0) return false;
+    if (ftruncate(descriptor, (off_t) bytes) != 0)
+    {
+        close(descriptor);
+        return false;
+    }
+    void * mapping = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor); // (the mapping stays valid after the descriptor is closed)
+    if (mapping == MAP_FAILED) return false;
+    integral.values = (double *) mapping;
+    integral.mappedBytes = bytes;
+    return true;
+}
+
+// This function releases the running sums of integral (unmapping its file, which keeps every running sum in the file, if it has one).
+void releaseCumulativeIntegral(CumulativeIntegral & integral)
+{
+    if (integral.mappedBytes != 0) munmap(integral.values, integral.mappedBytes);
+    integral.storage.clear();
+    integral.storage.shrink_to_fit();
+    integral.values = nullptr;
+    integral.mappedBytes = 0;
+}
+
+/**
+ * This function stores the running integral of f (which evaluator evaluates) with rule (left, right, midpoint, trapezoid, or Gauss-Legendre of order) 
+ * in integral.values on threadCount threads, using a two-pass parallel prefix scan over blocks of PARALLEL_BLOCK_SIZE partitions: 
+ * 
+ * 1. Each block evaluates the contribution of each of its partitions and stores the running sum within the block (see scanCumulativeBlock). 
+ * 2. The block totals are scanned in order (with Neumaier summation, so the offsets are as accurate as one long compensated sum) into the offset of each block. 
+ * 3. Each block adds its offset to its running sums. 
+ * 
+ * Passes 1 and 3 run on the thread pool, and the blocks do not depend on threadCount, so the result is bit-identical for every threadCount.
+ */
+void computeCumulativeIntegral(CumulativeIntegral & integral, BatchEvaluator evaluator, Rule rule, int order, int threadCount)
+{
+    uint64_t blockCount = (integral.n + PARALLEL_BLOCK_SIZE - 1) / PARALLEL_BLOCK_SIZE;
+    std::vector<double> offsets(blockCount);
+    ThreadPool & pool = acquireThreadPool((threadCount < 1) ? 1 : threadCount);
+    runOnThreadPool(pool, blockCount, [&](uint64_t k)
+    {
+        uint64_t first = k * PARALLEL_BLOCK_SIZE, last = ((integral.n - first) < PARALLEL_BLOCK_SIZE) ? integral.n : (first + PARALLEL_BLOCK_SIZE);
+        offsets[k] = scanCumulativeBlock(integral, evaluator, rule, order, first, last);
+    });
+
+    // Replace each block total with the sum of the totals of the blocks before it.
+    double sum = 0.0, error = 0.0;
+    for (uint64_t k = 0; k < blockCount; k++)
+    {
+        double total = offsets[k];
+        offsets[k] = sum + error;
+        addNeumaier(sum, error, total);
+    }
+    runOnThreadPool(pool, blockCount, [&](uint64_t k)
+    {
+        uint64_t first = k * PARALLEL_BLOCK_SIZE, last = ((integral.n - first) < PARALLEL_BLOCK_SIZE) ? integral.n : (first + PARALLEL_BLOCK_SIZE);
+        double offset = offsets[k];
+        for (uint64_t i = first + 1; i <= last; i++) integral.values[i] += offset;
+    });
+    integral.values[0] = 0.0;
+}
+
+/**
+ * This function stores the integral of f (which evaluator evaluates) with rule from x_first to x_i in integral.values[i] for i = first + 1 through last 
+ * (the running sum of the contributions of partitions first through i - 1) and returns the integral over partitions first through last - 1. 
+ * The points of the block are evaluated with one call of evaluator (in place, in integral.values for the rectangle rules and in a buffer which belongs to the calling thread otherwise). 
+ * The contribution of partition i is dx times f at its left end-point, right end-point, or midpoint for the rectangle rules, 
+ * dx times the average of f at its end-points for the trapezoid rule, and dx times the sum of (w_k / 2) * f at its nodes for Gauss-Legendre.
+ */
+double scanCumulativeBlock(CumulativeIntegral & integral, BatchEvaluator evaluator, Rule rule, int order, uint64_t first, uint64_t last)
+{
+    thread_local std::vector<double> points;
+    double * running = integral.values + first + 1;
+    double a = integral.a, dx = integral.dx, sum = 0.0;
+    int count = (int) (last - first);
+    if ((rule == Rule::Left) || (rule == Rule::Right) || (rule == Rule::Midpoint))
+    {
+        double t = (double) first + offsetOfRule(rule);
+        for (int i = 0; i < count; i++) running[i] = a + (t + (double) i) * dx; // (an int index converts to double with vector instructions)
+        evaluator(running, running, (uint64_t) count);
+        for (int i = 0; i < count; i++)
+        {
+            sum += running[i] * dx;
+            running[i] = sum;
+        }
+        return sum;
+    }
+    if (rule == Rule::Trapezoid)
+    {
+        if (points.size() < (size_t) count + 1) points.resize((size_t) count + 1);
+        for (int i = 0; i <= count; i++) points[i] = a + ((double) first + (double) i) * dx;
+        evaluator(points.data(), points.data(), (uint64_t) count + 1);
+        for (int i = 0; i < count; i++)
+        {
+            sum += 0.5 * (points[i] + points[i + 1]) * dx;
+            running[i] = sum;
+        }
+        return sum;
+    }
+    const double * nodes = gaussLegendreTables.nodes[order];
+    const double * weights = gaussLegendreTables.weights[order];
+    if (points.size() < (size_t) count * order) points.resize((size_t) count * order);
+    for (int i = 0; i < count; i++) for (int k = 0; k < order; k++) points[(size_t) i * order + k] = a + ((double) first + (double) i + 0.5 * (1.0 + nodes[k])) * dx;
+    evaluator(points.data(), points.data(), (uint64_t) count * order);
+    for (int i = 0; i < count; i++)
+    {
+        double partition = 0.0;
+        for (int k = 0; k < order; k++) partition += 0.5 * weights[k] * points[(size_t) i * order + k];
+        sum += partition * dx;
+        running[i] = sum;
+    }
+    return sum;
+}
+
+// This function returns the integral over [x_i, x_j] (the partitions i through j - 1) from the running integral (in constant time, as one subtraction).
+double cumulativeIntegralBetween(const CumulativeIntegral & integral, uint64_t i, uint64_t j)
+{
+    return integral.values[j] - integral.values[i];
+}
+
+/**
+ * This function computes the running integral of the function whose option number is options["function"] with options["method"] over the n partitions of [a,b] 
+ * (into memory, or into the file options["file"]), and prints (to the command line terminal) its time and throughput, F(x) at 10 evenly spaced end-points 
+ * (compared with exactIntegral), the time per query of options["queries"] random queries of the integral over [x_i, x_j], 
+ * and the largest difference of CUMULATIVE_CHECKED_QUERIES of those queries from computeQuadrature over [x_i, x_j] with j - i partitions 
+ * (relative to the larger of 1 and the largest magnitude of F). Return 0 if that difference is at most 10^-12 (or 1 otherwise, or 2 if the settings are invalid).
+ */
+int runCumulativeReport(const std::map<std::string, std::string> & options)
+{
+    int hardwareThreads = (int) std::thread::hardware_concurrency();
+    std::map<std::string, std::string> settings = { { "function", "2" }, { "method", "midpoint" }, { "a", "0" }, { "b", "3" }, { "n", "10000000" }, { "file", "" }, { "queries", "1000000" }, { "threads", std::to_string((hardwareThreads < 1) ? 1 : hardwareThreads) } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str()), threadCount = atoi(settings["threads"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str());
+    uint64_t n = strtoull(settings["n"].c_str(), nullptr, 10), queries = strtoull(settings["queries"].c_str(), nullptr, 10);
+    Rule rule = ruleFromMethod(settings["method"]);
+    int order = gaussLegendreOrderFromMethod(settings["method"]);
+    InstructionSet instructionSet = detectInstructionSet();
+    BatchEvaluator evaluator = selectBatchEvaluator(functionOption, instructionSet);
+    CumulativeIntegral integral;
+    if ((evaluator == nullptr) || !methodIsRecognized(settings["method"]) || (rule == Rule::Simpson) || (rule == Rule::Boole) || !std::isfinite(a) || !std::isfinite(b) || !(b > a) || (n < 1) || (n > CUMULATIVE_MAXIMUM_n) || (threadCount < 1))
+    {
+        std::cout << "\n\nInvalid cumulative integral settings (function must be 0 through " << USER_DEFINED_FUNCTION_OPTION << ", method must be left, right, midpoint, trapezoid, or gauss-legendre-m, ";
+        std::cout << "b must be larger than a, n must be 1 through " << CUMULATIVE_MAXIMUM_n << ", and threads must be positive).\n\n";
+        return 2;
+    }
+    if (!allocateCumulativeIntegral(integral, a, b, n, settings["file"]))
+    {
+        std::cout << "\n\nThe file named " << settings["file"] << " could not be created with room for " << (n + 1) << " running sums.\n\n";
+        return 2;
+    }
+    auto start = std::chrono::steady_clock::now();
+    computeCumulativeIntegral(integral, evaluator, rule, order, threadCount);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout.precision(6);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nCumulative Integral (function " << functionOption << ", " << settings["method"] << ", [" << a << "," << b << "], n = " << n << ", " << threadCount << " thread(s), " << nameOfInstructionSet(instructionSet) << ")";
+    std::cout << "\n--------------------------------";
+    std::cout << "\n\n" << (n + 1) << " running sums in " << seconds << " seconds (" << (n / seconds) << " partitions per second), stored " << (settings["file"].empty() ? "in memory." : ("in the file named " + settings["file"] + "."));
+    std::streamsize precision = std::cout.precision(17);
+    for (int k = 1; k <= 10; k++)
+    {
+        uint64_t i = n * k / 10;
+        double x = a + (double) i * integral.dx;
+        std::cout << "\n\nF(" << x << ") = " << integral.values[i] << " (exact " << exactIntegral(functionOption, a, x) << ")";
+    }
+    std::cout.precision(precision);
+
+    // Time random queries of the integral over [x_i, x_j].
+    std::mt19937_64 generator(1);
+    std::uniform_int_distribution<uint64_t> indices(0, n);
+    std::vector<uint64_t> ends(2 * queries);
+    for (uint64_t q = 0; q < 2 * queries; q++) ends[q] = indices(generator);
+    double total = 0.0;
+    start = std::chrono::steady_clock::now();
+    for (uint64_t q = 0; q < queries; q++) total += cumulativeIntegralBetween(integral, ends[2 * q], ends[2 * q + 1]);
+    double querySeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << "\n\n" << queries << " queries of the integral over [x_i, x_j] in " << querySeconds << " seconds (" << ((queries > 0) ? (1e9 * querySeconds / queries) : 0.0) << " nanoseconds per query, total " << total << ").";
+
+    // Check some queries against the quadrature over [x_i, x_j] computed directly.
+    RiemannEngine engine = { selectRiemannKernel(functionOption, rule, instructionSet), evaluator, Accumulator::Naive, threadCount, rule, order, Polynomial(), nullptr, 0 };
+    std::ofstream noFile;
+    double scale = 1.0, largestDifference = 0.0;
+    for (uint64_t i = 0; i <= n; i++) scale = std::fmax(scale, std::fabs(integral.values[i]));
+    for (int q = 0; q < CUMULATIVE_CHECKED_QUERIES; q++)
+    {
+        uint64_t i = indices(generator), j = indices(generator);
+        if (i > j) std::swap(i, j);
+        if (i == j) continue;
+        double direct = computeQuadrature(engine, a + (double) i * integral.dx, a + (double) j * integral.dx, j - i, false, noFile);
+        largestDifference = std::fmax(largestDifference, std::fabs(cumulativeIntegralBetween(integral, i, j) - direct) / scale);
+    }
+    std::cout << "\n\nThe largest difference of " << CUMULATIVE_CHECKED_QUERIES << " queries from the quadrature computed directly is " << largestDifference << " (relative to the largest |F|)" << ((largestDifference <= 1e-12) ? "." : " (TOO LARGE).");
+    std::cout << "\n\n--------------------------------\n\n";
+    releaseCumulativeIntegral(integral);
+    return (largestDifference <= 1e-12) ? 0 : 1;
+}
+
+/**
+ * This function prints (to the command line terminal) the cost and the accuracy of the Riemann sum of the function whose option number is options["function"] 
+ * computed in each precision: double (the compiled kernel), long double (80-bit x87 arithmetic), double-double (scalar, AVX2, and AVX-512), and __float128 (software, 113 bits). 
+ * Every tier runs on one thread over the same n rectangles, so the printed slowdown is the cost of the precision itself (per core). 
+ * 
+ * The __float128 sum is the reference: each tier prints its result with DOUBLE_DOUBLE_DIGITS digits and its difference from the reference, relative to the larger of |reference| and 1 
+ * (so that integrals which are nearly 0 do not inflate the difference). The function returns 0 if every double-double tier is within 10^-24 of the reference 
+ * (i.e. if double-double arithmetic kept about 24 of its 32 digits through n additions), 1 otherwise, and 2 if the settings are invalid.
+ */
+int runPrecisionReport(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "function", "2" }, { "method", "midpoint" }, { "a", "0" }, { "b", "3" }, { "n", "1000000" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int functionOption = atoi(settings["function"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str());
+    uint64_t n = strtoull(settings["n"].c_str(), nullptr, 10);
+    Rule rule = ruleFromMethod(settings["method"]);
+    InstructionSet instructionSet = detectInstructionSet();
+    if ((selectDoubleDoubleKernel(functionOption, InstructionSet::Scalar) == nullptr) || !methodIsRecognized(settings["method"]) || ((rule != Rule::Left) && (rule != Rule::Right) && (rule != Rule::Midpoint)) || !std::isfinite(a) || !std::isfinite(b) || !(b > a) || (n < MINIMUM_n) || (n > MAXIMUM_n))
+    {
+        std::cout << "\n\nInvalid precision report settings (function must be 0 through 5, method must be left, right, or midpoint, n must be within [" << MINIMUM_n << "," << MAXIMUM_n << "], and b must be larger than a).\n\n";
+        return 2;
+    }
+    double offset = offsetOfRule(rule), dx = (b - a) / n;
+    DoubleDouble start = { a, 0.0 }, width = divideDoubleDoubleByDouble(twoSum(b, -a), (double) n);
+
+    // Compute the reference sum first (every other tier is compared against it).
+    auto begin = std::chrono::steady_clock::now();
+    DoubleDouble reference = sumInFloat128(functionOption, a, b, n, offset);
+    double referenceSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+    double scale = std::fmax(std::fabs(reference.high), 1.0), doubleSeconds = 0.0;
+    bool accurate = true;
+
+    std::cout.precision(4);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nPrecision Report (function " << functionOption << ", " << settings["method"] << ", [" << a << "," << b << "], n = " << n << ", " << nameOfInstructionSet(instructionSet) << ", 1 thread)";
+    std::cout << "\n--------------------------------";
+    const char * names[] = { "double", "long double", "double-double (scalar)", "double-double (AVX2)", "double-double (AVX-512)", "__float128" };
+    for (int tier = 0; tier < 6; tier++)
+    {
+        if ((tier == 3) && (instructionSet == InstructionSet::Scalar)) continue;
+        if ((tier == 4) && (instructionSet != InstructionSet::Avx512)) continue;
+        DoubleDouble result = reference;
+        double seconds = referenceSeconds;
+        begin = std::chrono::steady_clock::now();
+        if (tier == 0) result = DoubleDouble{ selectRiemannKernel(functionOption, rule, instructionSet)(a, dx, 0, n) * dx, 0.0 };
+        if (tier == 1) result = sumInLongDouble(functionOption, a, b, n, offset);
+        if ((tier >= 2) && (tier <= 4)) result = multiplyDoubleDouble(selectDoubleDoubleKernel(functionOption, (InstructionSet) (tier - 2))(start, width, offset, 0, n), width);
+        if (tier < 5) seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - begin).count();
+        if (tier == 0) doubleSeconds = seconds;
+        double difference = std::fabs(addDoubleDouble(result, negateDoubleDouble(reference)).high) / scale;
+        if ((tier >= 2) && (tier <= 4) && !(difference <= 1e-24)) accurate = false;
+        std::cout << "\n\n" << names[tier] << ": " << doubleDoubleToString(result, DOUBLE_DOUBLE_DIGITS);
+        std::cout << "\n    " << (1e9 * seconds / (double) n) << " nanoseconds per rectangle, " << (seconds / doubleSeconds) << " times the time of double, difference from __float128 " << difference << ".";
+    }
+    std::cout << "\n\n--------------------------------\n\n";
+    return accurate ? 0 : 1;
+}
+
+/**
+ * This function times the Riemann pipeline for every function in the list (including the user-defined function if an expression was given), 
+ * every rule (left, right, midpoint, trapezoid, Simpson, Boole, and Gauss-Legendre of order options["order"]), and every n on a log scale 
+ * from options["minimum-n"] to options["maximum-n"] (options["steps"] values of n per factor of 10, each rounded up to a multiple of 4 so that every rule accepts it), 
+ * prints one line per run, and appends one record per run to the file named options["output"] (as CSV with a header line if options["format"] is "csv", 
+ * or as one JSON object per line if it is "json"), so that the results of later runs can be compared with earlier ones.
+ * 
+ * Each run computes the quadrature options["repetitions"] times on options["threads"] threads with the accumulator whose option number is options["accumulator"] 
+ * (Neumaier by default, so that the evaluation and accumulation phases are measured separately) and records the fastest repetition: 
+ * the wall time and the CPU time of each phase (input is the preparation of the engine, output is the error of the result and the formatting of the record), 
+ * the elapsed wall time and CPU time of the computation, the function evaluations per second, the nanoseconds per rectangle, and the relative error of the result. 
+ * Return 0 if every record was written, 1 if the file could not be written, and 2 if the settings are invalid.
+ */
+int runBenchmarkSuite(const std::map<std::string, std::string> & options)
+{
+    int hardwareThreads = (int) std::thread::hardware_concurrency();
+    std::map<std::string, std::string> settings = { { "minimum-n", "1000" }, { "maximum-n", "10000000" }, { "steps", "1" }, { "accumulator", "2" }, { "order", "4" }, { "a", "0" }, { "b", "3" }, 
+        { "repetitions", "3" }, { "threads", std::to_string((hardwareThreads < 1) ? 1 : hardwareThreads) }, { "format", "csv" }, { "output", BENCHMARK_FILE_NAME } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    uint64_t minimumN = strtoull(settings["minimum-n"].c_str(), nullptr, 10), maximumN = strtoull(settings["maximum-n"].c_str(), nullptr, 10);
+    int steps = atoi(settings["steps"].c_str()), accumulatorOption = atoi(settings["accumulator"].c_str()), order = atoi(settings["order"].c_str());
+    int repetitions = atoi(settings["repetitions"].c_str()), threadCount = atoi(settings["threads"].c_str());
+    double a = atof(settings["a"].c_str()), b = atof(settings["b"].c_str());
+    bool json = (settings["format"] == "json");
+    if ((minimumN < MINIMUM_n) || (maximumN < minimumN) || (maximumN > MAXIMUM_n) || (steps < 1) || (steps > 100) || (accumulatorOption < 0) || (accumulatorOption >= NUMBER_OF_ACCUMULATORS) 
+        || (order < MINIMUM_GAUSS_LEGENDRE_ORDER) || (order > MAXIMUM_GAUSS_LEGENDRE_ORDER) || (repetitions < 1) || (threadCount < 1) || !std::isfinite(a) || !std::isfinite(b) || !(b > a) 
+        || ((settings["format"] != "csv") && !json) || settings["output"].empty())
+    {
+        std::cout << "\n\nInvalid benchmark settings (minimum-n and maximum-n must be within [" << MINIMUM_n << "," << MAXIMUM_n << "] with minimum-n no larger than maximum-n, steps must be 1 through 100, ";
+        std::cout << "accumulator must be 0 through " << (NUMBER_OF_ACCUMULATORS - 1) << ", order must be " << MINIMUM_GAUSS_LEGENDRE_ORDER << " through " << MAXIMUM_GAUSS_LEGENDRE_ORDER << ", ";
+        std::cout << "repetitions and threads must be positive, b must be larger than a, and format must be csv or json).\n\n";
+        return 2;
+    }
+
+    // Open the output file for appending (and write the CSV header if the file is new or empty).
+    struct stat status = {};
+    bool empty = (stat(settings["output"].c_str(), &status) != 0) || (status.st_size == 0);
+    std::ofstream output(settings["output"], std::ios::app);
+    if (!output)
+    {
+        std::cout << "\n\nThe file named " << settings["output"] << " could not be opened.\n\n";
+        return 1;
+    }
+    output.precision(17);
+    if (!json && empty)
+    {
+        output << "timestamp,instruction_set,threads,accumulator,function,method,a,b,n,repetitions";
+        for (int k = 0; k < NUMBER_OF_PHASES; k++) output << "," << nameOfPhase((Phase) k) << "_wall_seconds," << nameOfPhase((Phase) k) << "_cpu_seconds";
+        output << ",compute_wall_seconds,compute_cpu_seconds,evaluations,evaluations_per_second,nanoseconds_per_rectangle,result,relative_error\n";
+    }
+
+    // Identify this run of the suite by its start time (in UTC), which every record repeats.
+    char timestamp[32];
+    time_t now = time(nullptr);
+    strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", gmtime(&now));
+
+    // List the values of n (10^(k / steps) times minimum-n, rounded up to a multiple of 4, without repeating a value).
+    std::vector<uint64_t> sizes;
+    for (int k = 0; ; k++)
+    {
+        double value = std::ceil((double) minimumN * std::pow(10.0, (double) k / steps));
+        if (value > (double) maximumN) break;
+        uint64_t size = (((uint64_t) value + 3) / 4) * 4;
+        if (sizes.empty() || (size > sizes.back())) sizes.push_back(size);
+    }
+
+    InstructionSet instructionSet = detectInstructionSet();
+    Accumulator accumulator = (Accumulator) accumulatorOption;
+    int functionCount = (userDefinedExpression.identifier != 0) ? (USER_DEFINED_FUNCTION_OPTION + 1) : NUMBER_OF_FUNCTIONS;
+    std::ofstream noFile;
+    uint64_t records = 0;
+    std::cout.precision(4);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nBenchmark Suite (" << functionCount << " function(s), " << (NUMBER_OF_RULES + 1) << " rules, " << sizes.size() << " value(s) of n, " << nameOfAccumulator(accumulator) << " accumulator, " << nameOfInstructionSet(instructionSet) << ", " << threadCount << " thread(s))";
+    std::cout << "\n--------------------------------";
+    for (int functionOption = 0; functionOption < functionCount; functionOption++)
+    {
+        for (int ruleOption = 0; ruleOption <= NUMBER_OF_RULES; ruleOption++)
+        {
+            Rule rule = (Rule) ruleOption;
+            std::string method = methodOfRule(rule, order);
+            for (uint64_t n : sizes)
+            {
+                PhaseTimings best;
+                double bestSeconds = INFINITY, bestCpuSeconds = 0.0, result = 0.0;
+                for (int repetition = 0; repetition < repetitions; repetition++)
+                {
+                    PhaseTimings timings;
+                    PhaseStamp phase = startPhase();
+                    RiemannEngine engine = { selectRiemannKernel(functionOption, rule, instructionSet), selectBatchEvaluator(functionOption, instructionSet), accumulator, threadCount, rule, order, Polynomial(), nullptr, 0, &timings };
+                    stopPhase(&timings, Phase::Input, phase);
+                    auto start = std::chrono::steady_clock::now();
+                    double cpuStart = processCpuSeconds();
+                    result = computeQuadrature(engine, a, b, n, false, noFile);
+                    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count(), cpuSeconds = processCpuSeconds() - cpuStart;
+                    if (seconds >= bestSeconds) continue;
+                    bestSeconds = seconds;
+                    bestCpuSeconds = cpuSeconds;
+                    for (int k = 0; k < NUMBER_OF_PHASES; k++)
+                    {
+                        best.wallNanoseconds[k] = timings.wallNanoseconds[k].load();
+                        best.cpuNanoseconds[k] = timings.cpuNanoseconds[k].load();
+                    }
+                    best.evaluations = timings.evaluations.load();
+                }
+                PhaseTimings & timings = best;
+
+                /**
+                 * Compute the error of the result and format the fields of the record which follow the phases (the output phase of this run, 
+                 * which ends before its own times are formatted).
+                 */
+                PhaseStamp phase = startPhase();
+                double exact = exactIntegral(functionOption, a, b), relativeError = std::fabs(result - exact) / std::fmax(std::fabs(exact), DBL_MIN);
+                double evaluationsPerSecond = (double) timings.evaluations / bestSeconds, nanosecondsPerRectangle = 1e9 * bestSeconds / (double) n;
+                std::ostringstream record, fields;
+                record.precision(17);
+                fields.precision(17);
+                if (json)
+                {
+                    fields << "},\"compute_wall_seconds\":" << bestSeconds << ",\"compute_cpu_seconds\":" << bestCpuSeconds << ",\"evaluations\":" << timings.evaluations << ",\"evaluations_per_second\":" << evaluationsPerSecond;
+                    fields << ",\"nanoseconds_per_rectangle\":" << nanosecondsPerRectangle << ",\"result\":" << result << ",\"relative_error\":";
+                    if (std::isfinite(relativeError)) fields << relativeError;
+                    else fields << "null"; // (JSON has no nan, and the user-defined function has no exact integral)
+                    fields << "}";
+                }
+                else fields << "," << bestSeconds << "," << bestCpuSeconds << "," << timings.evaluations << "," << evaluationsPerSecond << "," << nanosecondsPerRectangle << "," << result << "," << relativeError;
+                stopPhase(&timings, Phase::Output, phase);
+                if (json)
+                {
+                    record << "{\"timestamp\":\"" << timestamp << "\",\"instruction_set\":\"" << nameOfInstructionSet(instructionSet) << "\",\"threads\":" << threadCount << ",\"accumulator\":\"" << nameOfAccumulator(accumulator) << "\"";
+                    record << ",\"function\":" << functionOption << ",\"method\":\"" << method << "\",\"a\":" << a << ",\"b\":" << b << ",\"n\":" << n << ",\"repetitions\":" << repetitions << ",\"phases\":{";
+                    for (int k = 0; k < NUMBER_OF_PHASES; k++) record << ((k > 0) ? "," : "") << "\"" << nameOfPhase((Phase) k) << "\":{\"wall_seconds\":" << (1e-9 * (double) timings.wallNanoseconds[k]) << ",\"cpu_seconds\":" << (1e-9 * (double) timings.cpuNanoseconds[k]) << "}";
+                }
+                else
+                {
+                    record << timestamp << "," << nameOfInstructionSet(instructionSet) << "," << threadCount << "," << nameOfAccumulator(accumulator) << "," << functionOption << "," << method << "," << a << "," << b << "," << n << "," << repetitions;
+                    for (int k = 0; k < NUMBER_OF_PHASES; k++) record << "," << (1e-9 * (double) timings.wallNanoseconds[k]) << "," << (1e-9 * (double) timings.cpuNanoseconds[k]);
+                }
+                output << record.str() << fields.str() << "\n";
+                records++;
+
+                // Print the run (with the share of the measured thread time which each parallel phase took).
+                double evaluationSeconds = 1e-9 * (double) timings.wallNanoseconds[(int) Phase::Evaluation], accumulationSeconds = 1e-9 * (double) timings.wallNanoseconds[(int) Phase::Accumulation];
+                double measured = evaluationSeconds + accumulationSeconds;
+                std::cout << "\n\nfunction " << functionOption << ", " << method << ", n = " << n << ": " << nanosecondsPerRectangle << " nanoseconds per rectangle, " << evaluationsPerSecond << " evaluations per second";
+                if (measured > 0.0) std::cout << " (evaluation " << (100.0 * evaluationSeconds / measured) << "%, accumulation " << (100.0 * accumulationSeconds / measured) << "% of the thread time)";
+            }
+        }
+    }
+    output.close();
+    std::cout << "\n\n" << records << " record(s) were appended to the file named " << settings["output"] << (output ? "." : " (WRITING FAILED).");
+    std::cout << "\n\n--------------------------------\n\n";
+    return output ? 0 : 1;
+}
+
+/**
+ * GCC analyzes inline functions (including those of the vectorized math kernels section) at the end of the translation unit 
+ * and reports -Wpsabi for them there, so the warning is ignored again after the last function (where no code follows which it could hide).
+ */
+#pragma GCC diagnostic ignored "-Wpsabi"
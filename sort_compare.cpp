@@ -13,12 +13,274 @@
 #include <stdlib.h> // srand(), rand()
 #include <time.h> // time() 
 #include <chrono> // for calculating sorting algorithm runtimes
+#include <string> // std::string
+#include <vector> // std::vector
+#include <thread> // std::thread (used by the parallel sorting engines)
+#include <random> // std::mt19937 (seeded pseudo-random number generator used for reproducible benchmark inputs)
+#include <functional> // std::function (used to pass sorting engines to the timing helper)
+#include <algorithm> // std::fill, std::sort (used to compute median runtimes)
+#include <map> // std::map (used to store command line options and baseline results)
+#include <sstream> // std::stringstream (used to split comma-separated command line option values)
+#include <iomanip> // std::setprecision (used to print mean context switch counts)
+#include <cmath> // sqrt() (used to compute the standard deviation of runtimes)
+#include <unistd.h> // gethostname(), syscall()
+#include <sys/utsname.h> // uname()
+#include <sys/ioctl.h> // ioctl() (used to start and stop performance counters)
+#include <sys/syscall.h> // SYS_perf_event_open
+#include <linux/perf_event.h> // perf_event_attr (hardware and software performance counters)
+#include <sys/resource.h> // getrusage() (used to read the peak resident set size)
+#include <atomic> // std::atomic (thread-safe allocation counters)
+#include <mutex> // std::mutex (used by the barrier between the passes of stable_sort_pairs)
+#include <condition_variable> // std::condition_variable (used to wake the threads which wait at a barrier)
+#include <new> // std::bad_alloc, std::nothrow_t (used by the interposed allocation functions)
+#include <sched.h> // sched_setaffinity(), sched_getcpu() (used to pin benchmark runs to a processor core)
+#include <cerrno> // errno, EINTR (used to retry interrupted pipe transfers)
+#include <sys/wait.h> // waitpid() (used to collect isolated benchmark runs from forked child processes)
+#include <emmintrin.h> // _mm_clflush(), _mm_mfence() (used to flush the benchmark input array out of the processor caches)
 #define MAXIMUM_S 1000 // constant which represents the maximum value for S
 #define MAXIMUM_T 1000 // constant which represents the maximum value for T
+#define MAXIMUM_THREADS 64 // constant which represents the maximum number of worker threads used by a parallel sorting engine
+#define AUTO_SORT_SAMPLE_SIZE 256 // constant which represents the number of elements which auto_sort inspects before selecting an algorithm
+#define CALIBRATION_FILE_NAME "sort_compare_calibration.txt" // name of the file which stores the thresholds measured by the tuning sweep
+#define RESULTS_FILE_NAME "sort_compare_results.jsonl" // name of the file which stores machine-readable results (one JSON object per line)
+#define CSV_RESULTS_FILE_NAME "sort_compare_results.csv" // name of the file which stores machine-readable results in the CSV format
+#define INTERACTIVE_RESULTS_FILE_NAME "sort_compare_interactive_results.jsonl" // name of the file which stores the machine-readable results of the interactive program (so that it never overwrites a saved benchmark baseline)
+#define MAXIMUM_QUADRATIC_S 20000 // constant which represents the largest S for which the benchmark mode runs engines whose worst case is quadratic
+#define NUMBER_OF_COUNTERS 6 // constant which represents the number of performance counters recorded per benchmark run
+#define ALLOCATION_HEADER_BYTES 16 // constant which represents the number of bytes stored in front of each allocation to remember its size (a multiple of the maximum alignment)
+#define CACHE_LINE_BYTES 64 // constant which represents the number of bytes in one processor cache line
+#define MAXIMUM_EVICTION_BYTES (256 * 1024 * 1024) // constant which represents the largest buffer which is streamed through the caches to make them cold
+#define FREQUENCY_SAMPLE_INTERVAL_MILLISECONDS 5 // constant which represents the number of milliseconds between two readings of the core frequency during a sorting run
+
+/**
+ * Define a struct-type variable named ArrayProfile which stores the statistics which auto_sort
+ * estimates from a small evenly-spaced sample of an array before choosing a sorting algorithm.
+ */
+struct ArrayProfile {
+    int sample_size; // number of elements which were inspected
+    int minimum_key; // smallest sampled element value
+    int maximum_key; // largest sampled element value
+    long long key_range; // maximum_key - minimum_key + 1
+    int ascending_pairs; // number of sampled adjacent pairs (A[p], A[p + 1]) such that A[p] <= A[p + 1]
+    int descending_pairs; // number of sampled adjacent pairs (A[p], A[p + 1]) such that A[p] > A[p + 1]
+    long long estimated_runs; // estimated number of ascending runs in the whole array
+    double duplicate_ratio; // fraction of sampled elements whose value equals another sampled element value
+};
+
+/**
+ * Define a struct-type variable named SortCalibration which stores the thresholds which auto_sort
+ * uses to pick an algorithm. The default values are used when no calibration file exists; 
+ * running the program as "./app --calibrate" times each sorting engine on the host machine
+ * and writes measured values to CALIBRATION_FILE_NAME.
+ */
+struct SortCalibration {
+    int small_array_threshold = 24; // arrays of at most this many elements are sorted by insertion_sort
+    int insertion_cutoff = 16; // subarrays of at most this many elements are finished by insertion_sort inside hybrid engines
+    int radix_digit_bits = 8; // number of key bits consumed by each pass of radix_sort
+    int radix_threshold = 4096; // smallest S for which radix_sort is preferred over hybrid_quick_sort
+    double counting_range_factor = 2.0; // counting_sort is used when key_range <= counting_range_factor * S
+    int thread_count = 1; // number of worker threads used by parallel_merge_sort
+    int parallel_threshold = 65536; // smallest S for which parallel_merge_sort is used
+};
+
+/**
+ * Define a struct-type variable named SortPlan which stores the algorithm (and the thresholds)
+ * which auto_sort selected for a particular array.
+ */
+struct SortPlan {
+    std::string algorithm; // name of the selected sorting engine
+    std::string reason; // plain-English explanation of why that engine was selected
+    int insertion_cutoff; 
+    int radix_digit_bits;
+    int thread_count;
+};
+
+/**
+ * Define a struct-type variable named SortEngine which pairs the name of a sorting algorithm 
+ * with a function object which sorts an int type array of S elements using that algorithm.
+ * 
+ * quadratic is true for engines whose worst-case runtime grows with S * S (or whose recursion 
+ * depth can grow with S), which the benchmark mode skips for S larger than MAXIMUM_QUADRATIC_S.
+ */
+struct SortEngine {
+    std::string name;
+    std::function<void(int *, int)> sort;
+    bool quadratic;
+    int thread_count;
+};
+
+/**
+ * Define a struct-type variable named KeyPayloadPair which stores one record for stable_sort_pairs: 
+ * the records are ordered by key only, and payload is carried along with its key 
+ * (e.g. the index of the record in a table which was already sorted by a secondary key).
+ */
+struct KeyPayloadPair {
+    int key;
+    int payload;
+};
+
+/**
+ * Define a struct-type variable named ThreadBarrier which stops each of thread_count threads at wait_at_barrier 
+ * until all of them have arrived (waiting counts the threads which have arrived, and generation counts how many times 
+ * the barrier released them, so that a thread which races ahead to the next wait cannot be mistaken for one of the current wait).
+ */
+struct ThreadBarrier {
+    std::mutex mutex;
+    std::condition_variable released;
+    int thread_count;
+    int waiting;
+    long long generation;
+};
+
+/**
+ * Define a struct-type variable named MemoryProfile which stores the memory footprint of one sorting run:
+ * how many heap allocations were made, how many bytes they requested, the largest number of heap bytes 
+ * which were live at the same time, how much the peak resident set size of the process grew, and how deep 
+ * the recursive sorting functions recursed (in calls and in bytes of stack).
+ * 
+ * A value of -1 means that the quantity could not be measured on this machine.
+ */
+struct MemoryProfile {
+    long long allocation_count;
+    long long allocated_bytes;
+    long long peak_live_bytes;
+    long long peak_rss_delta_kilobytes;
+    long long maximum_recursion_depth;
+    long long maximum_stack_bytes;
+};
+
+/**
+ * Define a struct-type variable named AllocationCounters which stores the running totals which are updated 
+ * by the interposed global operator new and operator delete functions (defined below main).
+ * 
+ * live_bytes counts every byte which was allocated and not yet freed, and peak_live_bytes stores 
+ * the largest value which live_bytes reached since the most recent call to start_memory_profile.
+ */
+struct AllocationCounters {
+    std::atomic<long long> allocation_count;
+    std::atomic<long long> allocated_bytes;
+    std::atomic<long long> live_bytes;
+    std::atomic<long long> peak_live_bytes;
+};
+
+/**
+ * Define a struct-type variable named StackDepthGuard which is declared as the first local variable of each 
+ * recursive sorting function. While a memory profile is being taken, its constructor increments the recursion depth of the calling thread and records 
+ * the deepest recursion (and the largest distance between the outermost call's stack frame and the current 
+ * stack frame) since the most recent call to start_memory_profile, and its destructor decrements the recursion depth. 
+ * Otherwise (e.g. during a timed run) it does nothing but remember that it is inactive.
+ */
+struct StackDepthGuard {
+    bool active;
+    StackDepthGuard();
+    ~StackDepthGuard();
+};
+
+// Define the allocation counters which are shared by every thread of this program.
+AllocationCounters allocation_counters;
+
+/**
+ * Define the flag which is true only between a call to start_memory_profile and the matching call to stop_memory_profile. 
+ * The allocation counters and the recursion depth counters are only updated while it is true, so timed runs (which never take a memory profile) 
+ * do not pay for the instrumentation.
+ */
+std::atomic<bool> memory_profile_active(false);
+
+// Define the deepest recursion depth and the largest stack distance (in bytes) which any thread reached since the most recent call to start_memory_profile.
+std::atomic<long long> maximum_recursion_depth(0), maximum_stack_bytes(0);
+
+// Define the current recursion depth of each thread and the address of the outermost recursive call's stack frame of each thread.
+thread_local long long current_recursion_depth = 0;
+thread_local const char * outermost_stack_frame = NULL;
+
+/**
+ * Define a struct-type variable named ExecutionSettings which stores how the benchmark mode isolates each sorting run:
+ * 
+ * pinned_cpu is the processor core which runs are pinned to with sched_setaffinity (or -1 to let the scheduler choose),
+ * isolation is "in_process" (every repetition runs in this process) or "fork" (every repetition runs in a freshly forked child process),
+ * cache_state is "warm" (no flushing), "flushed" (the input array is flushed out of the caches with clflush before each run), 
+ * or "cold" (the input array is flushed and a buffer twice the size of the last-level cache is streamed through the caches before each run),
+ * and concurrent_instances is the number of child processes (each pinned to its own core) which run the same algorithm at the same time.
+ */
+struct ExecutionSettings {
+    int pinned_cpu = -1;
+    std::string isolation = "in_process";
+    std::string cache_state = "warm";
+    int concurrent_instances = 1;
+};
+
+/**
+ * Define a struct-type variable named RunMeasurement which stores everything which is measured during one sorting run. 
+ * It contains no pointers so that a forked child process can send it to its parent process through a pipe.
+ */
+struct RunMeasurement {
+    double seconds;
+    double frequency_mhz; // mean of the core frequency sampled before, during, and after the run (or -1 if it could not be read)
+    double minimum_frequency_mhz; // lowest of those samples (or -1)
+    double maximum_frequency_mhz; // highest of those samples (or -1)
+    long long voluntary_context_switches; // number of times the running thread gave up the core during the run
+    long long involuntary_context_switches; // number of times the scheduler preempted the running thread during the run
+    int cpu_at_start;
+    int cpu_at_end;
+    int instance; // index of the concurrent instance which made this measurement
+    bool sorted;
+    long long counters[NUMBER_OF_COUNTERS];
+    MemoryProfile memory;
+};
+
+/**
+ * Define a struct-type variable named BenchmarkResult which stores one machine-readable result record: 
+ * which algorithm was run on which input, how long each run took, and what the performance counters observed.
+ * 
+ * counters[k] stores the mean value per run of the kth counter named in COUNTER_NAMES 
+ * (or -1 if that counter is not available on this machine).
+ */
+struct BenchmarkResult {
+    std::string algorithm;
+    int S;
+    int T;
+    std::string distribution;
+    unsigned int seed;
+    int thread_count;
+    int repetitions;
+    double minimum_seconds;
+    double median_seconds;
+    double mean_seconds;
+    double maximum_seconds;
+    double standard_deviation_seconds;
+    long long counters[NUMBER_OF_COUNTERS];
+    MemoryProfile memory;
+    ExecutionSettings execution = ExecutionSettings();
+    double average_frequency_mhz = -1.0;
+    double minimum_frequency_mhz = -1.0; // lowest frequency sampled during any run
+    double maximum_frequency_mhz = -1.0; // highest frequency sampled during any run
+    double voluntary_context_switches = -1.0; // mean per run
+    double involuntary_context_switches = -1.0; // mean per run
+    int cpu_migrations = -1; // number of runs which ended on a different core than they started on
+};
+
+/**
+ * Define a struct-type variable named FrequencySampler which reads the clock frequency of the processor core named cpu 
+ * once when it is started, every FREQUENCY_SAMPLE_INTERVAL_MILLISECONDS while a sorting run is in progress (on its own thread), and once when it is stopped, 
+ * so that throttling during the run is seen (and not only the frequency before and after it). 
+ * total_mhz, minimum_mhz, maximum_mhz, and samples describe the readings which succeeded.
+ */
+struct FrequencySampler {
+    int cpu;
+    std::atomic<bool> running;
+    double total_mhz;
+    double minimum_mhz;
+    double maximum_mhz;
+    int samples;
+    std::thread thread;
+};
+
+// Define the names of the performance counters which are stored in BenchmarkResult::counters (in that order).
+const char * const COUNTER_NAMES[NUMBER_OF_COUNTERS] = { "cycles", "instructions", "cache_misses", "branch_misses", "page_faults", "context_switches" };
 
 /** function prototypes */
 void copy_array(int * source_array, int * target_array, int S);
-void populate_array(int * A, int S, int T);
+void populate_array(int * A, int S, int T, unsigned int seed);
 void bubble_sort(int * A, int S);
 void merge_sort(int * A, int S);
 void merge_sort(int * A, int left, int right);
@@ -27,10 +289,81 @@ void selection_sort(int * A, int S);
 void quick_sort(int * A, int S);
 void quick_sort(int * A, int low, int high);
 int partition(int * A, int low, int high);
+void populate_array_with_distribution(int * A, int S, int T, const std::string & distribution, unsigned int seed);
+void insertion_sort(int * A, int low, int high);
+void insertion_sort(int * A, int S);
+void hybrid_quick_sort(int * A, int S, int insertion_cutoff);
+void hybrid_quick_sort(int * A, int low, int high, int insertion_cutoff);
+void hybrid_merge_sort(int * A, int S, int insertion_cutoff);
+void hybrid_merge_sort(int * A, int * buffer, int low, int high, int insertion_cutoff);
+void merge_runs(const int * source, int * target, int low, int mid, int high);
+void parallel_merge_sort(int * A, int S, int thread_count, int insertion_cutoff);
+void radix_sort(int * A, int S, int digit_bits);
+void counting_sort(int * A, int S, int minimum_key, int maximum_key);
+void reverse_array(int * A, int S);
+void wait_at_barrier(ThreadBarrier & barrier);
+void stable_sort_pairs(KeyPayloadPair * A, int S, int thread_count);
+bool pairs_are_stably_sorted(const KeyPayloadPair * A, int S);
+int run_stable_sort_benchmark(const std::map<std::string, std::string> & options);
+ArrayProfile sample_array_profile(const int * A, int S);
+SortCalibration load_sort_calibration(const std::string & file_name);
+bool save_sort_calibration(const SortCalibration & calibration, const std::string & file_name);
+SortPlan select_sort_plan(const ArrayProfile & profile, int S, const SortCalibration & calibration);
+SortPlan auto_sort(int * A, int S, const SortCalibration & calibration);
+double time_sort_engine(const std::function<void(int *, int)> & engine, const int * source, int S, int repetitions, int batch);
+int run_calibration_sweep();
+int run_command_line_mode(int argc, char * argv[]);
+std::map<std::string, std::string> parse_command_line_options(int argc, char * argv[], int first_index);
+std::vector<std::string> split_comma_separated_values(const std::string & values);
+std::vector<SortEngine> list_sort_engines(const SortCalibration & calibration, int thread_count);
+void start_performance_counters(int * descriptors);
+void stop_performance_counters(int * descriptors, long long * values);
+BenchmarkResult summarize_runs(const std::string & algorithm, int S, int T, const std::string & distribution, unsigned int seed, int thread_count, std::vector<double> seconds, const long long * counter_totals);
+std::string escape_json_string(const std::string & text);
+std::string read_host_name();
+std::string read_cpu_model();
+std::string describe_host_as_json();
+std::string benchmark_result_to_json(const BenchmarkResult & result, const std::string & host);
+std::string quote_csv_field(const std::string & text);
+std::vector<std::string> split_csv_line(const std::string & line);
+std::string describe_host_as_csv();
+std::string benchmark_result_to_csv(const BenchmarkResult & result, const std::string & host);
+std::string benchmark_csv_header();
+bool write_benchmark_results(const std::vector<BenchmarkResult> & results, const std::string & file_name, const std::string & format);
+std::string find_json_value(const std::string & line, const std::string & key);
+std::vector<BenchmarkResult> read_benchmark_results(const std::string & file_name);
+int compare_benchmark_results(const std::vector<BenchmarkResult> & baseline, const std::vector<BenchmarkResult> & current, double tolerance, std::ostream & output);
+int run_benchmark_mode(const std::map<std::string, std::string> & options);
+int run_compare_mode(const std::map<std::string, std::string> & options);
+void record_allocation(std::size_t size);
+void record_deallocation(std::size_t size);
+void update_maximum(std::atomic<long long> & maximum, long long value);
+long long read_process_status_kilobytes(const std::string & field);
+void start_memory_profile();
+MemoryProfile stop_memory_profile();
+MemoryProfile profile_sort_memory(const std::function<void(int *, int)> & sort, const int * source, int S);
+std::string describe_memory_profile(const MemoryProfile & memory);
+bool pin_to_cpu(int cpu);
+double read_cpu_frequency_mhz(int cpu);
+void add_frequency_sample(FrequencySampler & sampler);
+void start_frequency_sampler(FrequencySampler & sampler, int cpu);
+void stop_frequency_sampler(FrequencySampler & sampler, int cpu);
+long long read_last_level_cache_bytes();
+void prepare_cache_state(const std::string & cache_state, const int * work, int S);
+RunMeasurement run_sort_once(const SortEngine & engine, const int * source, int * work, int S, const std::string & cache_state, bool profile_memory);
+std::vector<RunMeasurement> run_sort_repetitions(const SortEngine & engine, const int * source, int S, int repetitions, const ExecutionSettings & execution);
+bool write_all(int descriptor, const void * data, size_t bytes);
+bool read_all(int descriptor, void * data, size_t bytes);
 
 /** program entry point */
-int main()
+int main(int argc, char * argv[])
 {
+    /**
+     * If the program was launched with command line arguments (e.g. "./app --calibrate" or "./app --benchmark S=100000"), 
+     * run the corresponding non-interactive mode instead of the interactive program and exit with that mode's exit status.
+     */
+    if (argc > 1) return run_command_line_mode(argc, argv);
+
     /***********************************************************************************
      * INITIALIZE VARIABLES
      ***********************************************************************************/
@@ -38,12 +371,18 @@ int main()
     // Declare three int type variables and set each of their initial values to 0.
     int S = 0, T = 0, i = 0;
 
-    // Declare four pointer-to-int type variables.
-    int * A, * A_copy_0, * A_copy_1, * A_copy_2;
+    // Declare five pointer-to-int type variables.
+    int * A, * A_copy_0, * A_copy_1, * A_copy_2, * A_copy_3;
 
     // Declare a file output stream object.
     std::ofstream file;
 
+    // Declare a list of machine-readable result records (one per sorting algorithm) which is written to INTERACTIVE_RESULTS_FILE_NAME at the end of the program.
+    std::vector<BenchmarkResult> results;
+
+    // Set the seed of the pseudo-random number generator to the number of seconds elapsed since the Unix Epoch (and record that seed in each result record).
+    unsigned int seed = (unsigned int) time(NULL);
+
     // Set the number of digits of floating-point numbers which are printed to the command line terminal to 100 digits.
     std::cout.precision(100);
 
@@ -157,9 +496,10 @@ int main()
     A_copy_0 = new int [S];
     A_copy_1 = new int [S];
     A_copy_2 = new int [S];
+    A_copy_3 = new int [S];
 
     // Populate A with random integer values.
-    populate_array(A, S, T);
+    populate_array(A, S, T, seed);
 
     // Print the contents of A to the command line terminal.
     std::cout << "\n\nA := " << A << ". // memory address of A[0]\n";
@@ -194,6 +534,9 @@ int main()
     // Populate A_copy_2 with the values of A such that both arrays appear to house identical data contents.
     copy_array(A, A_copy_2, S);
 
+    // Populate A_copy_3 with the values of A such that both arrays appear to house identical data contents.
+    copy_array(A, A_copy_3, S);
+
     // Print "UNSORTED ARRAY A_copy_0" to the command line terminal.
     std::cout << "\n\nUNSORTED ARRAY A_copy_0";
 
@@ -278,6 +621,30 @@ int main()
         file << "\nA_copy_2[" << i << "] := " << A_copy_2[i] << ". \t// &A_copy_2[" << i << "] = " << &A_copy_2[i] << ". (memory address of the first memory cell comprising the block of 4 contiguous memory cells allocated to A_copy_2[" << i << "]).";
     }
 
+    // Print "UNSORTED ARRAY A_copy_3" to the command line terminal.
+    std::cout << "\n\nUNSORTED ARRAY A_copy_3";
+
+    // Print "UNSORTED ARRAY A_copy_3" to the file output stream.
+    file << "\n\nUNSORTED ARRAY A_copy_3";
+
+    // Print the contents of A_copy_3 to the command line terminal.
+    std::cout << "\n\nA_copy_3 := " << A_copy_3 << ". // memory address of A_copy_3[0]\n";
+
+    // Print the contents of A_copy_3 to the file output stream.
+    file << "\n\nA_copy_3 := " << A_copy_3 << ". // memory address of A_copy_3[0]\n";
+
+    /**
+     * For each element, i, of the array represented by A_copy_3, 
+     * print the contents of the ith element of the array, A_copy_3[i], 
+     * and the memory address of that array element 
+     * to the command line terminal and to the file output stream.
+     */
+    for (i = 0; i < S; i += 1) 
+    {
+        std::cout << "\nA_copy_3[" << i << "] := " << A_copy_3[i] << ". \t// &A_copy_3[" << i << "] = " << &A_copy_3[i] << ". (memory address of the first memory cell comprising the block of 4 contiguous memory cells allocated to A_copy_3[" << i << "]).";
+        file << "\nA_copy_3[" << i << "] := " << A_copy_3[i] << ". \t// &A_copy_3[" << i << "] = " << &A_copy_3[i] << ". (memory address of the first memory cell comprising the block of 4 contiguous memory cells allocated to A_copy_3[" << i << "]).";
+    }
+
     // Print a horizontal line to the command line terminal.
     std::cout << "\n\n--------------------------------";
 
@@ -294,6 +661,9 @@ int main()
     // Print "SORTED ARRAY A (USING BUBBLE_SORT)" to the file output stream.
     file << "\n\nSORTED ARRAY A (USING BUBBLE_SORT)";
 
+    // Measure the memory footprint of sorting a copy of A in a separate untimed run (so that the instrumentation does not slow the timed run down).
+    MemoryProfile memory = profile_sort_memory([](int * B, int size) { bubble_sort(B, size); }, A, S);
+
     // Get the start time.
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -328,6 +698,14 @@ int main()
     std::cout << "\n\nElapsed time for bubble_sort(A, S): " << duration.count() << " seconds.";
     file << "\n\nElapsed time for bubble_sort(A, S): " << duration.count() << " seconds.";
 
+    // Record the elapsed time as a machine-readable result record.
+    results.push_back(summarize_runs("bubble_sort", S, T, "uniform", seed, 1, { duration.count() }, NULL));
+    results.back().memory = memory;
+
+    // Print the memory footprint of the sorting run.
+    std::cout << "\n\nMemory profile for bubble_sort(A, S): " << describe_memory_profile(memory) << ".";
+    file << "\n\nMemory profile for bubble_sort(A, S): " << describe_memory_profile(memory) << ".";
+
     // Print a horizontal line to the command line terminal.
     std::cout << "\n\n--------------------------------";
 
@@ -344,6 +722,9 @@ int main()
     // Print "SORTED ARRAY A_copy_0 (USING MERGE_SORT)" to the file output stream.
     file << "\n\nSORTED ARRAY A_copy_0 (USING MERGE_SORT)";
 
+    // Measure the memory footprint of sorting a copy of A_copy_0 in a separate untimed run (so that the instrumentation does not slow the timed run down).
+    memory = profile_sort_memory([](int * B, int size) { merge_sort(B, size); }, A_copy_0, S);
+
     // Get the start time.
     start = std::chrono::high_resolution_clock::now();
 
@@ -378,6 +759,14 @@ int main()
     std::cout << "\n\nElapsed time for merge_sort(A_copy_0, S): " << duration.count() << " seconds.";
     file << "\n\nElapsed time for merge_sort(A_copy_0, S): " << duration.count() << " seconds.";
 
+    // Record the elapsed time as a machine-readable result record.
+    results.push_back(summarize_runs("merge_sort", S, T, "uniform", seed, 1, { duration.count() }, NULL));
+    results.back().memory = memory;
+
+    // Print the memory footprint of the sorting run.
+    std::cout << "\n\nMemory profile for merge_sort(A_copy_0, S): " << describe_memory_profile(memory) << ".";
+    file << "\n\nMemory profile for merge_sort(A_copy_0, S): " << describe_memory_profile(memory) << ".";
+
     // Print a horizontal line to the command line terminal.
     std::cout << "\n\n--------------------------------";
 
@@ -394,6 +783,9 @@ int main()
     // Print "SORTED ARRAY A_copy_1 (USING SELECTION_SORT)" to the file output stream.
     file << "\n\nSORTED ARRAY A_copy_1 (USING SELECTION_SORT)";
 
+    // Measure the memory footprint of sorting a copy of A_copy_1 in a separate untimed run (so that the instrumentation does not slow the timed run down).
+    memory = profile_sort_memory([](int * B, int size) { selection_sort(B, size); }, A_copy_1, S);
+
     // Get the start time.
     start = std::chrono::high_resolution_clock::now();
 
@@ -428,6 +820,14 @@ int main()
     std::cout << "\n\nElapsed time for selection_sort(A_copy_1, S): " << duration.count() << " seconds.";
     file << "\n\nElapsed time for selection_sort(A_copy_1, S): " << duration.count() << " seconds.";
 
+    // Record the elapsed time as a machine-readable result record.
+    results.push_back(summarize_runs("selection_sort", S, T, "uniform", seed, 1, { duration.count() }, NULL));
+    results.back().memory = memory;
+
+    // Print the memory footprint of the sorting run.
+    std::cout << "\n\nMemory profile for selection_sort(A_copy_1, S): " << describe_memory_profile(memory) << ".";
+    file << "\n\nMemory profile for selection_sort(A_copy_1, S): " << describe_memory_profile(memory) << ".";
+
     // Print a horizontal line to the command line terminal.
     std::cout << "\n\n--------------------------------";
 
@@ -444,6 +844,9 @@ int main()
     // Print "SORTED ARRAY A_copy_2 (USING QUICK_SORT)" to the file output stream.
     file << "\n\nSORTED ARRAY A_copy_2 (USING QUICK_SORT)";
 
+    // Measure the memory footprint of sorting a copy of A_copy_2 in a separate untimed run (so that the instrumentation does not slow the timed run down).
+    memory = profile_sort_memory([](int * B, int size) { quick_sort(B, size); }, A_copy_2, S);
+
     // Get the start time.
     start = std::chrono::high_resolution_clock::now();
 
@@ -478,6 +881,82 @@ int main()
     std::cout << "\n\nElapsed time for quick_sort(A_copy_2, S): " << duration.count() << " seconds.";
     file << "\n\nElapsed time for quick_sort(A_copy_2, S): " << duration.count() << " seconds.";
 
+    // Record the elapsed time as a machine-readable result record.
+    results.push_back(summarize_runs("quick_sort", S, T, "uniform", seed, 1, { duration.count() }, NULL));
+    results.back().memory = memory;
+
+    // Print the memory footprint of the sorting run.
+    std::cout << "\n\nMemory profile for quick_sort(A_copy_2, S): " << describe_memory_profile(memory) << ".";
+    file << "\n\nMemory profile for quick_sort(A_copy_2, S): " << describe_memory_profile(memory) << ".";
+
+    // Print a horizontal line to the command line terminal.
+    std::cout << "\n\n--------------------------------";
+
+    // Print a horizontal line to the file output stream.
+    file << "\n\n--------------------------------";
+
+    /***********************************************************************************
+     * AUTO SORT
+     ***********************************************************************************/
+
+    // Print "SORTED ARRAY A_copy_3 (USING AUTO_SORT)" to the command line terminal.
+    std::cout << "\n\nSORTED ARRAY A_copy_3 (USING AUTO_SORT)";
+
+    // Print "SORTED ARRAY A_copy_3 (USING AUTO_SORT)" to the file output stream.
+    file << "\n\nSORTED ARRAY A_copy_3 (USING AUTO_SORT)";
+
+    // Load the thresholds written by the most recent "./app --calibrate" run (or the default thresholds if no calibration file exists).
+    SortCalibration calibration = load_sort_calibration(CALIBRATION_FILE_NAME);
+
+    // Measure the memory footprint of sorting a copy of A_copy_3 in a separate untimed run (so that the instrumentation does not slow the timed run down).
+    memory = profile_sort_memory([&](int * B, int size) { auto_sort(B, size, calibration); }, A_copy_3, S);
+
+    // Get the start time.
+    start = std::chrono::high_resolution_clock::now();
+
+    // Sample A_copy_3, select a sorting engine (and its thresholds), and sort A_copy_3 using that engine.
+    SortPlan plan = auto_sort(A_copy_3, S, calibration);
+
+    // Get the end time.
+    end = std::chrono::high_resolution_clock::now();
+
+    // Calculate the duration of time betweem start and end time.
+    duration = end - start;
+
+    // Print the contents of A_copy_3 to the command line terminal.
+    std::cout << "\n\nA_copy_3 := " << A_copy_3 << ". // memory address of A_copy_3[0]\n";
+
+    // Print the contents of A_copy_3 to the file output stream.
+    file << "\n\nA_copy_3 := " << A_copy_3 << ". // memory address of A_copy_3[0]\n";
+
+    /**
+     * For each element, i, of the array represented by A_copy_3, 
+     * print the contents of the ith element of the array, A_copy_3[i], 
+     * and the memory address of that array element 
+     * to the command line terminal and to the file output stream.
+     */
+    for (i = 0; i < S; i += 1) 
+    {
+        std::cout << "\nA_copy_3[" << i << "] := " << A_copy_3[i] << ". \t// &A_copy_3[" << i << "] = " << &A_copy_3[i] << ". (memory address of the first memory cell comprising the block of 4 contiguous memory cells allocated to A_copy_3[" << i << "]).";
+        file << "\nA_copy_3[" << i << "] := " << A_copy_3[i] << ". \t// &A_copy_3[" << i << "] = " << &A_copy_3[i] << ". (memory address of the first memory cell comprising the block of 4 contiguous memory cells allocated to A_copy_3[" << i << "]).";
+    }
+
+    // Print the sorting engine which auto_sort selected (and the reason why that engine was selected).
+    std::cout << "\n\nauto_sort selected " << plan.algorithm << " (insertion_cutoff = " << plan.insertion_cutoff << ", radix_digit_bits = " << plan.radix_digit_bits << ", thread_count = " << plan.thread_count << ") because " << plan.reason << ".";
+    file << "\n\nauto_sort selected " << plan.algorithm << " (insertion_cutoff = " << plan.insertion_cutoff << ", radix_digit_bits = " << plan.radix_digit_bits << ", thread_count = " << plan.thread_count << ") because " << plan.reason << ".";
+
+    // Print the duration in seconds.
+    std::cout << "\n\nElapsed time for auto_sort(A_copy_3, S): " << duration.count() << " seconds.";
+    file << "\n\nElapsed time for auto_sort(A_copy_3, S): " << duration.count() << " seconds.";
+
+    // Record the elapsed time as a machine-readable result record.
+    results.push_back(summarize_runs("auto_sort", S, T, "uniform", seed, plan.thread_count, { duration.count() }, NULL));
+    results.back().memory = memory;
+
+    // Print the memory footprint of the sorting run.
+    std::cout << "\n\nMemory profile for auto_sort(A_copy_3, S): " << describe_memory_profile(memory) << ".";
+    file << "\n\nMemory profile for auto_sort(A_copy_3, S): " << describe_memory_profile(memory) << ".";
+
 
     /***********************************************************************************
      * DELETE ARRAYS
@@ -495,6 +974,16 @@ int main()
     // De-allocate memory which was assigned to the dynamically-allocated array of S int type values named A_copy_2.
     delete [] A_copy_2;
 
+    // De-allocate memory which was assigned to the dynamically-allocated array of S int type values named A_copy_3.
+    delete [] A_copy_3;
+
+    // Write the machine-readable result records to INTERACTIVE_RESULTS_FILE_NAME (one JSON object per line).
+    if (write_benchmark_results(results, INTERACTIVE_RESULTS_FILE_NAME, "jsonl"))
+    {
+        std::cout << "\n\nThe machine-readable results of this program runtime instance were written to " << INTERACTIVE_RESULTS_FILE_NAME << ".";
+        file << "\n\nThe machine-readable results of this program runtime instance were written to " << INTERACTIVE_RESULTS_FILE_NAME << ".";
+    }
+
     // Print a closing message to the command line terminal.
     std::cout << "\n\n--------------------------------";
     std::cout << "\nEnd Of Program";
@@ -553,18 +1042,19 @@ void copy_array(int * source_array, int * target_array, int S)
  * selected as (and that any element of A is a natural number 
  * no larger than T).
  * 
+ * Assume that the value which is passed into this function as seed 
+ * is the number of seconds elapsed since some epoch such as the 
+ * Unix Epoch (which is 01_JANUARY_1970) or any other value which 
+ * should be recorded in order to regenerate the same array later.
+ * 
  * This function returns no value (but it does update the array 
  * referred to as A if the elements of A are not already sorted in 
  * ascending order).
  */
-void populate_array(int * A, int S, int T)
+void populate_array(int * A, int S, int T, unsigned int seed)
 {
-    /**
-     * Seed the pseudo-random number generator with the number of seconds 
-     * elapsed since some epoch such as the Unix Epoch (which is 
-     * 01_JANUARY_1970).
-     */
-    srand(time(NULL));
+    // Seed the pseudo-random number generator with seed.
+    srand(seed);
 
     // Populate the array with random integer values in the range [1, T].
     for (int i = 0; i < S; i++) A[i] = 1 + std::rand() % T;
@@ -682,6 +1172,7 @@ void merge(int * A, int left, int mid, int right)
  */
 void merge_sort(int * A, int left, int right) 
 {
+    StackDepthGuard guard;
     if (left < right) 
     {
         int mid = left + (right - left) / 2;
@@ -698,6 +1189,9 @@ void merge_sort(int * A, int left, int right)
  * This function is the wrapper function for merge_sort.
  * This function sorts the entire array named A (which is comprised of 
  * exactly S int type elements).
+ * 
+ * Merge Sort is stable (equal elements keep their original relative order) 
+ * because merge takes the element of the left half whenever two elements compare equal (L[i] <= R[j]).
  *
  * Assume that the value which is passed into this function as A is the memory 
  * address of the first element of a one-dimensional array of int type values.
@@ -718,6 +1212,8 @@ void merge_sort(int * A, int S)
  * Use the Selection Sort algorithm to arrange the elements of an int type array, 
  * A, in ascending order.
  * 
+ * Selection Sort is not stable (swapping the minimum into place can move an element past an equal element).
+ * 
  * Assume that the value which is passed into this function as A is the memory 
  * address of the first element of a one-dimensional array of int type values.
  * 
@@ -808,6 +1304,7 @@ int partition(int * A, int low, int high)
  */
 void quick_sort(int * A, int low, int high) 
 {
+    StackDepthGuard guard;
     if (low < high) 
     {
         int partitioning_index = partition(A, low, high);
@@ -824,6 +1321,9 @@ void quick_sort(int * A, int low, int high)
  * This function sorts the entire array named A (which is comprised of 
  * exactly S int type elements).
  * 
+ * Quick Sort is not stable (partitioning swaps elements across long distances). 
+ * Use merge_sort or stable_sort_pairs when records which compare equal must keep their original order.
+ * 
  * Assume that the value which is passed into this function as A is the memory 
  * address of the first element of a one-dimensional array of int type values.
  * 
@@ -837,4 +1337,2090 @@ void quick_sort(int * A, int low, int high)
 void quick_sort(int * A, int S) 
 {
     quick_sort(A, 0, S - 1);
-}
\ No newline at end of file
+}
+/**
+ * Populate an array of int type values with integer values in the range [1, T] 
+ * which are arranged according to the named distribution.
+ * 
+ * Assume that the value which is passed into this function as A 
+ * is the memory address of the first element of a one-dimensional 
+ * array of exactly S int type values.
+ * 
+ * distribution is expected to be one of the following strings:
+ * 
+ * "uniform" (independent random values), 
+ * "sorted" (random values arranged in ascending order), 
+ * "reversed" (random values arranged in descending order), 
+ * "nearly_sorted" (ascending values with roughly one percent of the elements swapped), 
+ * "few_unique" (random values drawn from at most eight distinct states).
+ * 
+ * Any other string is treated as "uniform".
+ * 
+ * Unlike populate_array, this function is seeded explicitly (rather than with the current time) 
+ * so that benchmark inputs can be regenerated exactly.
+ * 
+ * This function returns no value (but it does update the array referred to as A).
+ */
+void populate_array_with_distribution(int * A, int S, int T, const std::string & distribution, unsigned int seed)
+{
+    std::mt19937 generator(seed);
+    int i = 0, states = (distribution == "few_unique") ? ((T < 8) ? T : 8) : T;
+
+    // Populate the array with random integer values in the range [1, states].
+    for (i = 0; i < S; i++) A[i] = 1 + (int) (generator() % (unsigned int) states);
+
+    // Arrange the random values according to the requested distribution.
+    if ((distribution == "sorted") || (distribution == "reversed") || (distribution == "nearly_sorted")) radix_sort(A, S, 8);
+    if (distribution == "reversed") reverse_array(A, S);
+    if ((distribution == "nearly_sorted") && (S > 1))
+    {
+        for (i = 0; i < S / 100 + 1; i++)
+        {
+            int p = (int) (generator() % (unsigned int) S), q = (int) (generator() % (unsigned int) S);
+            int placeholder = A[p];
+            A[p] = A[q];
+            A[q] = placeholder;
+        }
+    }
+}
+
+/**
+ * Use the Insertion Sort algorithm to arrange the segment of array A which starts at A[low] 
+ * and which ends at A[high] in ascending order.
+ * 
+ * Insertion Sort performs O(S + I) work where I is the number of inverted pairs in the segment, 
+ * which makes it the fastest engine for tiny segments and for segments which are already sorted.
+ * 
+ * This function returns no value (but it does update the segment of 
+ * array A which starts at A[low] and which ends at A[high] if 
+ * that segment is not already sorted in ascending order). 
+ */
+void insertion_sort(int * A, int low, int high)
+{
+    for (int i = low + 1; i <= high; i++)
+    {
+        int key = A[i], j = i - 1;
+        while ((j >= low) && (A[j] > key))
+        {
+            A[j + 1] = A[j];
+            j--;
+        }
+        A[j + 1] = key;
+    }
+}
+
+/**
+ * Use the Insertion Sort algorithm to arrange the elements of an int type array, 
+ * A, in ascending order.
+ * 
+ * This function is the wrapper function for insertion_sort.
+ * 
+ * This function returns no value (but it does update the array 
+ * referred to as A if the elements of A are not already sorted in 
+ * ascending order). 
+ */
+void insertion_sort(int * A, int S)
+{
+    insertion_sort(A, 0, S - 1);
+}
+
+/**
+ * This function sorts the segment of array A which starts at A[low] 
+ * and which ends at A[high] using a hybrid of the Quick Sort algorithm 
+ * and the Insertion Sort algorithm.
+ * 
+ * Unlike quick_sort, the pivot is the median of the first, middle, and last elements of the segment, 
+ * the segment is split three ways (smaller than, equal to, and larger than the pivot) so that duplicate 
+ * values are never revisited, only the smaller side is sorted recursively (which limits the recursion 
+ * depth to log2(S) levels), and segments of at most insertion_cutoff elements are finished by insertion_sort.
+ * 
+ * This function returns no value (but it does update the segment of 
+ * array A which starts at A[low] and which ends at A[high] if 
+ * that segment is not already sorted in ascending order). 
+ */
+void hybrid_quick_sort(int * A, int low, int high, int insertion_cutoff)
+{
+    StackDepthGuard guard;
+    if (insertion_cutoff < 1) insertion_cutoff = 1;
+    while (high - low + 1 > insertion_cutoff)
+    {
+        // Select the median of A[low], A[mid], and A[high] as the pivot value.
+        int mid = low + (high - low) / 2;
+        int x = A[low], y = A[mid], z = A[high];
+        int pivot = (x < y) ? ((y < z) ? y : ((x < z) ? z : x)) : ((x < z) ? x : ((y < z) ? z : y));
+
+        // Split the segment into A[low..lt-1] < pivot, A[lt..gt] == pivot, and A[gt+1..high] > pivot.
+        int lt = low, i = low, gt = high, placeholder = 0;
+        while (i <= gt)
+        {
+            if (A[i] < pivot)
+            {
+                placeholder = A[lt];
+                A[lt] = A[i];
+                A[i] = placeholder;
+                lt++;
+                i++;
+            }
+            else if (A[i] > pivot)
+            {
+                placeholder = A[gt];
+                A[gt] = A[i];
+                A[i] = placeholder;
+                gt--;
+            }
+            else i++;
+        }
+
+        // Recursively sort the smaller side and continue looping on the larger side.
+        if (lt - low < high - gt)
+        {
+            hybrid_quick_sort(A, low, lt - 1, insertion_cutoff);
+            low = gt + 1;
+        }
+        else
+        {
+            hybrid_quick_sort(A, gt + 1, high, insertion_cutoff);
+            high = lt - 1;
+        }
+    }
+    insertion_sort(A, low, high);
+}
+
+/**
+ * Use a hybrid of the Quick Sort algorithm and the Insertion Sort algorithm to arrange 
+ * the elements of an int type array, A, in ascending order.
+ * 
+ * This function is the wrapper function for hybrid_quick_sort.
+ * 
+ * This function returns no value (but it does update the array 
+ * referred to as A if the elements of A are not already sorted in 
+ * ascending order). 
+ */
+void hybrid_quick_sort(int * A, int S, int insertion_cutoff)
+{
+    hybrid_quick_sort(A, 0, S - 1, insertion_cutoff);
+}
+
+/**
+ * Merge the sorted segment source[low..mid] and the sorted segment source[mid+1..high] 
+ * into target[low..high] such that target[low..high] is sorted in ascending order.
+ * 
+ * When two elements are equal, the element from the left segment is written first 
+ * (which means that the merge is stable).
+ */
+void merge_runs(const int * source, int * target, int low, int mid, int high)
+{
+    int i = low, j = mid + 1, k = low;
+    while ((i <= mid) && (j <= high)) target[k++] = (source[j] < source[i]) ? source[j++] : source[i++];
+    while (i <= mid) target[k++] = source[i++];
+    while (j <= high) target[k++] = source[j++];
+}
+
+/**
+ * This function sorts the segment of array A which starts at A[low] 
+ * and which ends at A[high] using a hybrid of the Merge Sort algorithm 
+ * and the Insertion Sort algorithm.
+ * 
+ * Unlike merge_sort, this function uses one caller-supplied buffer (instead of allocating 
+ * two temporary arrays per merge), skips the merge when the two halves are already in order, 
+ * and finishes segments of at most insertion_cutoff elements with insertion_sort.
+ * 
+ * Assume that buffer is the memory address of the first element of an int type array 
+ * which has at least high + 1 elements.
+ * 
+ * This function returns no value (but it does update the segment of 
+ * array A which starts at A[low] and which ends at A[high] if 
+ * that segment is not already sorted in ascending order). 
+ */
+void hybrid_merge_sort(int * A, int * buffer, int low, int high, int insertion_cutoff)
+{
+    StackDepthGuard guard;
+    if (high - low + 1 <= ((insertion_cutoff < 1) ? 1 : insertion_cutoff))
+    {
+        insertion_sort(A, low, high);
+        return;
+    }
+    int mid = low + (high - low) / 2;
+    hybrid_merge_sort(A, buffer, low, mid, insertion_cutoff);
+    hybrid_merge_sort(A, buffer, mid + 1, high, insertion_cutoff);
+    if (A[mid] <= A[mid + 1]) return;
+    merge_runs(A, buffer, low, mid, high);
+    for (int k = low; k <= high; k++) A[k] = buffer[k];
+}
+
+/**
+ * Use a hybrid of the Merge Sort algorithm and the Insertion Sort algorithm to arrange 
+ * the elements of an int type array, A, in ascending order.
+ * 
+ * This function is the wrapper function for hybrid_merge_sort.
+ * 
+ * This function returns no value (but it does update the array 
+ * referred to as A if the elements of A are not already sorted in 
+ * ascending order). 
+ */
+void hybrid_merge_sort(int * A, int S, int insertion_cutoff)
+{
+    if (S < 2) return;
+    int * buffer = new int [S];
+    hybrid_merge_sort(A, buffer, 0, S - 1, insertion_cutoff);
+    delete [] buffer;
+}
+
+/**
+ * Use thread_count worker threads to arrange the elements of an int type array, A, in ascending order.
+ * 
+ * A is divided into thread_count contiguous chunks, each chunk is sorted by hybrid_merge_sort 
+ * on its own thread, and then adjacent groups of sorted chunks are merged pairwise (one thread per merge) 
+ * until a single sorted run remains.
+ * 
+ * This function returns no value (but it does update the array 
+ * referred to as A if the elements of A are not already sorted in 
+ * ascending order). 
+ */
+void parallel_merge_sort(int * A, int S, int thread_count, int insertion_cutoff)
+{
+    int k = 0, width = 0;
+    if (thread_count > MAXIMUM_THREADS) thread_count = MAXIMUM_THREADS;
+    if (thread_count > S / 2) thread_count = S / 2;
+    if (thread_count <= 1)
+    {
+        hybrid_merge_sort(A, S, insertion_cutoff);
+        return;
+    }
+
+    // Set bounds[k] to store the index of the first element of the kth chunk (and bounds[thread_count] to store S).
+    std::vector<int> bounds(thread_count + 1);
+    for (k = 0; k <= thread_count; k++) bounds[k] = (int) (((long long) S * k) / thread_count);
+    int * buffer = new int [S];
+    std::vector<std::thread> workers;
+
+    // Sort each chunk on its own thread (bounds is captured by reference, since it outlives the threads and copying it once per thread would be wasted work).
+    for (k = 0; k < thread_count; k++) workers.emplace_back([&bounds, A, buffer, k, insertion_cutoff]() { hybrid_merge_sort(A, buffer, bounds[k], bounds[k + 1] - 1, insertion_cutoff); });
+    for (std::thread & worker : workers) worker.join();
+
+    // Merge adjacent groups of width sorted chunks from source into target, doubling width after each round.
+    int * source = A, * target = buffer;
+    for (width = 1; width < thread_count; width *= 2)
+    {
+        workers.clear();
+        for (k = 0; k < thread_count; k += 2 * width)
+        {
+            int low = bounds[k];
+            int mid = bounds[(k + width < thread_count) ? (k + width) : thread_count] - 1;
+            int high = bounds[(k + 2 * width < thread_count) ? (k + 2 * width) : thread_count] - 1;
+            workers.emplace_back([=]() { merge_runs(source, target, low, mid, high); });
+        }
+        for (std::thread & worker : workers) worker.join();
+        int * placeholder = source;
+        source = target;
+        target = placeholder;
+    }
+
+    // If the fully merged run ended up in buffer, copy it back into A.
+    if (source != A) for (k = 0; k < S; k++) A[k] = source[k];
+    delete [] buffer;
+}
+
+/**
+ * Use the Least-Significant-Digit Radix Sort algorithm to arrange the elements of an int type array, 
+ * A, in ascending order.
+ * 
+ * Each element is offset by the smallest element value (so that negative values are handled 
+ * and so that only the bits which actually vary are processed) and then the array is 
+ * distributed by digit_bits bits at a time (starting with the least significant bits) 
+ * using a counting pass and a stable scatter pass.
+ * 
+ * This function returns no value (but it does update the array 
+ * referred to as A if the elements of A are not already sorted in 
+ * ascending order). 
+ */
+void radix_sort(int * A, int S, int digit_bits)
+{
+    int i = 0, minimum_key = 0, maximum_key = 0, shift = 0;
+    if (S < 2) return;
+    if (digit_bits < 1) digit_bits = 1;
+    if (digit_bits > 16) digit_bits = 16;
+
+    // Find the smallest and the largest element values.
+    minimum_key = maximum_key = A[0];
+    for (i = 1; i < S; i++)
+    {
+        if (A[i] < minimum_key) minimum_key = A[i];
+        if (A[i] > maximum_key) maximum_key = A[i];
+    }
+    unsigned int key_span = (unsigned int) maximum_key - (unsigned int) minimum_key;
+
+    unsigned int buckets = 1u << digit_bits, mask = buckets - 1;
+    std::vector<unsigned int> counts(buckets);
+    int * buffer = new int [S], * source = A, * target = buffer;
+
+    // Distribute the elements by each digit (from least significant to most significant) until every varying bit was processed.
+    for (shift = 0; (shift < 32) && ((key_span >> shift) != 0); shift += digit_bits)
+    {
+        std::fill(counts.begin(), counts.end(), 0u);
+        for (i = 0; i < S; i++) counts[(((unsigned int) source[i] - (unsigned int) minimum_key) >> shift) & mask]++;
+        unsigned int total = 0;
+        for (unsigned int d = 0; d < buckets; d++)
+        {
+            unsigned int count = counts[d];
+            counts[d] = total;
+            total += count;
+        }
+        for (i = 0; i < S; i++) target[counts[(((unsigned int) source[i] - (unsigned int) minimum_key) >> shift) & mask]++] = source[i];
+        int * placeholder = source;
+        source = target;
+        target = placeholder;
+    }
+
+    // If the sorted elements ended up in buffer, copy them back into A.
+    if (source != A) for (i = 0; i < S; i++) A[i] = source[i];
+    delete [] buffer;
+}
+
+/**
+ * Use the Counting Sort algorithm to arrange the elements of an int type array, 
+ * A, in ascending order.
+ * 
+ * Assume that every element of A is no smaller than minimum_key and no larger than maximum_key.
+ * 
+ * Counting Sort performs O(S + maximum_key - minimum_key) work, which makes it the fastest 
+ * engine when the number of distinct states an element can represent is not much larger than S.
+ * 
+ * This function returns no value (but it does update the array 
+ * referred to as A if the elements of A are not already sorted in 
+ * ascending order). 
+ */
+void counting_sort(int * A, int S, int minimum_key, int maximum_key)
+{
+    if ((S < 2) || (maximum_key < minimum_key)) return;
+    std::vector<int> counts((size_t) ((long long) maximum_key - minimum_key + 1));
+    int i = 0, k = 0;
+    for (i = 0; i < S; i++) counts[(size_t) ((long long) A[i] - minimum_key)]++;
+    for (size_t d = 0; d < counts.size(); d++) for (int c = 0; c < counts[d]; c++) A[k++] = (int) (minimum_key + (long long) d);
+}
+
+/**
+ * Reverse the order of the elements of an int type array, A, which is comprised of exactly S elements.
+ */
+void reverse_array(int * A, int S)
+{
+    for (int i = 0, j = S - 1; i < j; i++, j--)
+    {
+        int placeholder = A[i];
+        A[i] = A[j];
+        A[j] = placeholder;
+    }
+}
+
+/**
+ * Block the calling thread until barrier.thread_count threads (including this one) have called this function for barrier.
+ * 
+ * This function returns no value.
+ */
+void wait_at_barrier(ThreadBarrier & barrier)
+{
+    std::unique_lock<std::mutex> lock(barrier.mutex);
+    long long generation = barrier.generation;
+    if (++barrier.waiting == barrier.thread_count)
+    {
+        barrier.waiting = 0;
+        barrier.generation++;
+        barrier.released.notify_all();
+        return;
+    }
+    barrier.released.wait(lock, [&]() { return barrier.generation != generation; });
+}
+
+/**
+ * Use thread_count worker threads to arrange the elements of a KeyPayloadPair type array, A, in ascending order of key.
+ * 
+ * The sort is stable: pairs whose keys are equal keep their original relative order, no matter how many threads are used.
+ * 
+ * This is a parallel Least-Significant-Digit Radix Sort over the four bytes of each key. 
+ * A is divided into thread_count contiguous chunks. During each pass every thread counts the digits of its own chunk, 
+ * then each thread is given the output positions for its chunk's digits (digit by digit, and within a digit in chunk order), 
+ * and then every thread scatters its chunk front to back. Since lower chunks always write in front of higher chunks 
+ * and each chunk writes in its original order, each pass is stable, and so the whole sort is stable. 
+ * Passes over a byte which is equal in every key are skipped.
+ * 
+ * The threads are started once (the calling thread sorts the first chunk) and run every pass, 
+ * meeting at a barrier after counting, after the output positions are computed (by the calling thread), and after scattering, 
+ * so that no thread is created or joined between passes.
+ * 
+ * This function returns no value (but it does update the array 
+ * referred to as A if the elements of A are not already sorted in 
+ * ascending order of key). 
+ */
+void stable_sort_pairs(KeyPayloadPair * A, int S, int thread_count)
+{
+    int k = 0;
+    if (S < 2) return;
+    if (thread_count > MAXIMUM_THREADS) thread_count = MAXIMUM_THREADS;
+    if (thread_count > S / 16384) thread_count = S / 16384; // each thread gets at least 16384 pairs
+    if (thread_count < 1) thread_count = 1;
+
+    // Set bounds[k] to store the index of the first element of the kth chunk (and bounds[thread_count] to store S).
+    std::vector<int> bounds(thread_count + 1);
+    for (k = 0; k <= thread_count; k++) bounds[k] = (int) (((long long) S * k) / thread_count);
+    std::vector<std::vector<int>> positions(thread_count, std::vector<int>(256));
+    KeyPayloadPair * buffer = new KeyPayloadPair [S];
+    ThreadBarrier barrier;
+    barrier.thread_count = thread_count;
+    barrier.waiting = 0;
+    barrier.generation = 0;
+    bool pass_is_needed = true;
+
+    // Run every pass over the chunk named chunk (each thread swaps its own copies of source and target after each pass, so they stay in step).
+    auto sort_chunk = [&](int chunk)
+    {
+        KeyPayloadPair * source = A, * target = buffer;
+        for (int shift = 0; shift < 32; shift += 8)
+        {
+            // Flipping the sign bit of each key makes the unsigned order of the digits match the signed order of the keys.
+            auto digit_of = [shift](int key) { return (((unsigned int) key ^ 0x80000000u) >> shift) & 255u; };
+
+            // Count the digits of this chunk.
+            std::vector<int> & counts = positions[chunk];
+            std::fill(counts.begin(), counts.end(), 0);
+            for (int i = bounds[chunk]; i < bounds[chunk + 1]; i++) counts[digit_of(source[i].key)]++;
+            wait_at_barrier(barrier);
+
+            // Turn the counts into output positions (all chunks for digit 0 first, then all chunks for digit 1, and so on).
+            if (chunk == 0)
+            {
+                int next = 0;
+                pass_is_needed = true;
+                for (int digit = 0; digit < 256; digit++)
+                {
+                    int digit_total = 0;
+                    for (int other = 0; other < thread_count; other++)
+                    {
+                        int count = positions[other][digit];
+                        positions[other][digit] = next;
+                        next += count;
+                        digit_total += count;
+                    }
+                    if (digit_total == S) pass_is_needed = false;
+                }
+            }
+            wait_at_barrier(barrier);
+            if (!pass_is_needed) continue;
+
+            // Scatter this chunk (front to back) into target.
+            std::vector<int> & next_position = positions[chunk];
+            for (int i = bounds[chunk]; i < bounds[chunk + 1]; i++) target[next_position[digit_of(source[i].key)]++] = source[i];
+            wait_at_barrier(barrier);
+            KeyPayloadPair * placeholder = source;
+            source = target;
+            target = placeholder;
+        }
+        return source;
+    };
+
+    std::vector<std::thread> workers;
+    for (int chunk = 1; chunk < thread_count; chunk++) workers.emplace_back(sort_chunk, chunk);
+    KeyPayloadPair * sorted = sort_chunk(0);
+    for (std::thread & worker : workers) worker.join();
+
+    // If the sorted pairs ended up in buffer, copy them back into A.
+    if (sorted != A) std::copy(sorted, sorted + S, A);
+    delete [] buffer;
+}
+
+/**
+ * Return true if the S pairs of A are in ascending order of key and every group of pairs with equal keys 
+ * is in ascending order of payload (which shows that a sort was stable when each payload was set to the pair's original index).
+ */
+bool pairs_are_stably_sorted(const KeyPayloadPair * A, int S)
+{
+    for (int i = 1; i < S; i++)
+    {
+        if (A[i - 1].key > A[i].key) return false;
+        if ((A[i - 1].key == A[i].key) && (A[i - 1].payload > A[i].payload)) return false;
+    }
+    return true;
+}
+
+/**
+ * Time stable_sort_pairs (with one thread and with the requested number of threads) against the serial merge_sort, 
+ * print the median runtime of each, and return 0 if every run of stable_sort_pairs sorted its pairs stably (or 1 otherwise).
+ * 
+ * The keys are generated by populate_array_with_distribution and the payload of each pair is its original index. 
+ * merge_sort sorts the keys only (it has no payloads to carry), which is the cheaper of the two jobs.
+ */
+int run_stable_sort_benchmark(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "S", "1000000" }, { "T", "1000" }, { "distribution", "uniform" }, { "seed", "1" }, { "repetitions", "5" }, { "threads", std::to_string(std::thread::hardware_concurrency()) } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    int S = atoi(settings["S"].c_str()), T = atoi(settings["T"].c_str()), repetitions = atoi(settings["repetitions"].c_str()), threads = atoi(settings["threads"].c_str());
+    unsigned int seed = (unsigned int) strtoul(settings["seed"].c_str(), NULL, 10);
+    if (S < 1) S = 1;
+    if (T < 1) T = 1;
+    if (repetitions < 1) repetitions = 1;
+    if (threads < 1) threads = 1;
+    std::vector<int> keys(S), work(S);
+    populate_array_with_distribution(keys.data(), S, T, settings["distribution"], seed);
+    std::vector<KeyPayloadPair> pairs(S), sorted_pairs(S);
+    for (int i = 0; i < S; i++) pairs[i] = { keys[i], i };
+    bool stable = true;
+
+    // Time one sorting job repetitions times and return the median number of seconds.
+    auto median_seconds = [&](const std::function<void()> & prepare, const std::function<void()> & sort)
+    {
+        std::vector<double> seconds;
+        for (int r = 0; r < repetitions; r++)
+        {
+            prepare();
+            auto start = std::chrono::high_resolution_clock::now();
+            sort();
+            auto end = std::chrono::high_resolution_clock::now();
+            std::chrono::duration<double> duration = end - start;
+            seconds.push_back(duration.count());
+        }
+        return summarize_runs("", S, T, settings["distribution"], seed, 1, seconds, NULL).median_seconds;
+    };
+
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nStable Sort Benchmark (S = " << S << ", T = " << T << ", distribution = " << settings["distribution"] << ")";
+    std::cout << "\n--------------------------------";
+    double merge_sort_seconds = median_seconds([&]() { work = keys; }, [&]() { merge_sort(work.data(), S); });
+    std::cout << "\nmerge_sort (keys only, 1 thread): " << merge_sort_seconds << " seconds.";
+    std::vector<int> thread_counts = { 1 };
+    if (threads > 1) thread_counts.push_back(threads);
+    for (int thread_count : thread_counts)
+    {
+        double pair_seconds = median_seconds([&]() { sorted_pairs = pairs; }, [&]() { stable_sort_pairs(sorted_pairs.data(), S, thread_count); });
+        bool run_is_stable = pairs_are_stably_sorted(sorted_pairs.data(), S);
+        if (!run_is_stable) stable = false;
+        std::cout << "\nstable_sort_pairs (key/payload pairs, " << thread_count << " thread(s)): " << pair_seconds << " seconds (" << (merge_sort_seconds / pair_seconds) << " times as fast as merge_sort); ";
+        std::cout << (run_is_stable ? "stable." : "NOT STABLE.");
+    }
+    std::cout << "\n\n";
+    return stable ? 0 : 1;
+}
+
+/**
+ * Estimate the key range, the number of ascending runs, and the duplicate ratio of an int type array, A, 
+ * by inspecting at most AUTO_SORT_SAMPLE_SIZE evenly-spaced positions of A (and the element which 
+ * immediately follows each of those positions).
+ * 
+ * The sample costs O(AUTO_SORT_SAMPLE_SIZE) time regardless of S.
+ */
+ArrayProfile sample_array_profile(const int * A, int S)
+{
+    ArrayProfile profile = { 0, 0, 0, 0, 0, 0, 1, 0.0 };
+    int sample[AUTO_SORT_SAMPLE_SIZE];
+    int k = 0, m = (S < AUTO_SORT_SAMPLE_SIZE) ? S : AUTO_SORT_SAMPLE_SIZE;
+    if (S < 1) return profile;
+    profile.minimum_key = profile.maximum_key = A[0];
+    for (k = 0; k < m; k++)
+    {
+        // Select the kth evenly-spaced position, p, of A (such that A[p + 1] exists whenever S > 1).
+        int p = (S > 1) ? (int) (((long long) k * (S - 1)) / m) : 0;
+        sample[k] = A[p];
+        if (A[p] < profile.minimum_key) profile.minimum_key = A[p];
+        if (A[p] > profile.maximum_key) profile.maximum_key = A[p];
+        if (S > 1)
+        {
+            if (A[p] <= A[p + 1]) profile.ascending_pairs++;
+            else profile.descending_pairs++;
+        }
+    }
+    profile.sample_size = m;
+    profile.key_range = (long long) profile.maximum_key - profile.minimum_key + 1;
+
+    // Each sampled descent marks the end of an ascending run, so extrapolate the descent rate to all S - 1 adjacent pairs.
+    profile.estimated_runs = 1 + (long long) (((double) profile.descending_pairs / m) * (S - 1));
+
+    // Sort the sample and count the sampled values which equal the value immediately before them.
+    insertion_sort(sample, m);
+    int duplicates = 0;
+    for (k = 1; k < m; k++) if (sample[k] == sample[k - 1]) duplicates++;
+    profile.duplicate_ratio = (double) duplicates / m;
+    return profile;
+}
+
+/**
+ * Read the thresholds which were written by save_sort_calibration from the plain-text file named file_name.
+ * 
+ * Each line of that file is expected to have the form "key = value". Missing keys (or a missing file) 
+ * leave the corresponding default values of SortCalibration in place.
+ */
+SortCalibration load_sort_calibration(const std::string & file_name)
+{
+    SortCalibration calibration;
+    std::ifstream input(file_name);
+    std::string key, equals_sign;
+    double value = 0.0;
+    while (input >> key >> equals_sign >> value)
+    {
+        if (key == "small_array_threshold") calibration.small_array_threshold = (int) value;
+        else if (key == "insertion_cutoff") calibration.insertion_cutoff = (int) value;
+        else if (key == "radix_digit_bits") calibration.radix_digit_bits = (int) value;
+        else if (key == "radix_threshold") calibration.radix_threshold = (int) value;
+        else if (key == "counting_range_factor") calibration.counting_range_factor = value;
+        else if (key == "thread_count") calibration.thread_count = (int) value;
+        else if (key == "parallel_threshold") calibration.parallel_threshold = (int) value;
+    }
+    return calibration;
+}
+
+/**
+ * Write the thresholds stored in calibration to the plain-text file named file_name (one "key = value" line per threshold).
+ * 
+ * This function returns true if the file was written and false otherwise.
+ */
+bool save_sort_calibration(const SortCalibration & calibration, const std::string & file_name)
+{
+    std::ofstream output(file_name);
+    if (!output) return false;
+    output << "small_array_threshold = " << calibration.small_array_threshold << "\n";
+    output << "insertion_cutoff = " << calibration.insertion_cutoff << "\n";
+    output << "radix_digit_bits = " << calibration.radix_digit_bits << "\n";
+    output << "radix_threshold = " << calibration.radix_threshold << "\n";
+    output << "counting_range_factor = " << calibration.counting_range_factor << "\n";
+    output << "thread_count = " << calibration.thread_count << "\n";
+    output << "parallel_threshold = " << calibration.parallel_threshold << "\n";
+    return true;
+}
+
+/**
+ * Select a sorting engine (and the thresholds which that engine should use) for an array of S elements 
+ * whose sampled statistics are stored in profile.
+ * 
+ * The checks are ordered from the cheapest engine to the most general engine:
+ * 
+ * tiny arrays and arrays whose sample contains no descents use insertion_sort,
+ * arrays whose sample contains no ascents are reversed and then use insertion_sort,
+ * arrays whose keys span few states use counting_sort,
+ * arrays whose sample contains few runs use hybrid_merge_sort (which skips merges of runs which are already in order),
+ * large arrays use parallel_merge_sort (if the calibration found that more than one thread pays off),
+ * arrays with many duplicate values use hybrid_quick_sort (whose three-way partition never revisits duplicates),
+ * and the remaining arrays use radix_sort (if S is at least the calibrated radix threshold) or hybrid_quick_sort.
+ */
+SortPlan select_sort_plan(const ArrayProfile & profile, int S, const SortCalibration & calibration)
+{
+    SortPlan plan = { "hybrid_quick_sort", "no cheaper engine applies", calibration.insertion_cutoff, calibration.radix_digit_bits, 1 };
+    if (S <= calibration.small_array_threshold)
+    {
+        plan.algorithm = "insertion_sort";
+        plan.reason = "S is no larger than small_array_threshold (" + std::to_string(calibration.small_array_threshold) + ")";
+    }
+    else if (profile.descending_pairs == 0)
+    {
+        plan.algorithm = "insertion_sort";
+        plan.reason = "the sample contains no descending adjacent pairs (the array appears to be sorted)";
+    }
+    else if (profile.ascending_pairs == 0)
+    {
+        plan.algorithm = "reverse_then_insertion_sort";
+        plan.reason = "the sample contains no ascending adjacent pairs (the array appears to be reverse-sorted)";
+    }
+    else if (profile.key_range <= calibration.counting_range_factor * S)
+    {
+        plan.algorithm = "counting_sort";
+        plan.reason = "the sampled key range (" + std::to_string(profile.key_range) + ") is small relative to S";
+    }
+    else if (profile.estimated_runs * 16 <= S)
+    {
+        plan.algorithm = "hybrid_merge_sort";
+        plan.reason = "the array appears to consist of few (about " + std::to_string(profile.estimated_runs) + ") ascending runs";
+    }
+    else if ((S >= calibration.parallel_threshold) && (calibration.thread_count > 1))
+    {
+        plan.algorithm = "parallel_merge_sort";
+        plan.thread_count = calibration.thread_count;
+        plan.reason = "S is at least parallel_threshold (" + std::to_string(calibration.parallel_threshold) + ")";
+    }
+    else if (profile.duplicate_ratio >= 0.5)
+    {
+        plan.reason = "at least half of the sampled values are duplicates";
+    }
+    else if (S >= calibration.radix_threshold)
+    {
+        plan.algorithm = "radix_sort";
+        plan.reason = "S is at least radix_threshold (" + std::to_string(calibration.radix_threshold) + ")";
+    }
+    return plan;
+}
+
+/**
+ * Sample an int type array, A, select a sorting engine using select_sort_plan, and arrange the elements of A 
+ * in ascending order using that engine.
+ * 
+ * Because the sampled key range may underestimate the true key range, counting_sort is only run after 
+ * an exact minimum and maximum were found and the exact range still satisfies the calibrated range factor 
+ * (otherwise the plan is selected again from a profile which holds the exact range, so that the next engine in the order of select_sort_plan is used). Likewise, a presorted-looking sample is confirmed 
+ * by one linear pass before insertion_sort is trusted (otherwise the plan falls back to hybrid_merge_sort).
+ * 
+ * This function returns the SortPlan which was executed.
+ */
+SortPlan auto_sort(int * A, int S, const SortCalibration & calibration)
+{
+    ArrayProfile profile = sample_array_profile(A, S);
+    SortPlan plan = select_sort_plan(profile, S, calibration);
+    if (plan.algorithm == "counting_sort")
+    {
+        int minimum_key = A[0], maximum_key = A[0];
+        for (int i = 1; i < S; i++)
+        {
+            if (A[i] < minimum_key) minimum_key = A[i];
+            if (A[i] > maximum_key) maximum_key = A[i];
+        }
+        if ((long long) maximum_key - minimum_key + 1 <= calibration.counting_range_factor * S)
+        {
+            counting_sort(A, S, minimum_key, maximum_key);
+            return plan;
+        }
+        profile.minimum_key = minimum_key;
+        profile.maximum_key = maximum_key;
+        profile.key_range = (long long) maximum_key - minimum_key + 1;
+        plan = select_sort_plan(profile, S, calibration);
+        plan.reason = "the exact key range (" + std::to_string(profile.key_range) + ") was too large for counting_sort, and " + plan.reason;
+    }
+    /**
+     * A sample without descents (or without ascents) does not prove that the whole array is in order, 
+     * and insertion_sort is quadratic on an array with many inversions, so verify the whole array 
+     * with one linear pass (which is cheap compared with any sort) before trusting the sample.
+     */
+    if (((plan.algorithm == "insertion_sort") || (plan.algorithm == "reverse_then_insertion_sort")) && (S > calibration.small_array_threshold))
+    {
+        bool reversed = (plan.algorithm == "reverse_then_insertion_sort");
+        for (int i = 1; i < S; i++)
+        {
+            if (reversed ? (A[i - 1] < A[i]) : (A[i - 1] > A[i]))
+            {
+                plan.algorithm = "hybrid_merge_sort";
+                plan.reason = "the sample looked presorted but a full pass found an out-of-order pair at index " + std::to_string(i);
+                break;
+            }
+        }
+    }
+    if (plan.algorithm == "insertion_sort") insertion_sort(A, S);
+    else if (plan.algorithm == "reverse_then_insertion_sort")
+    {
+        reverse_array(A, S);
+        insertion_sort(A, S);
+    }
+    else if (plan.algorithm == "hybrid_merge_sort") hybrid_merge_sort(A, S, plan.insertion_cutoff);
+    else if (plan.algorithm == "parallel_merge_sort") parallel_merge_sort(A, S, plan.thread_count, plan.insertion_cutoff);
+    else if (plan.algorithm == "radix_sort") radix_sort(A, S, plan.radix_digit_bits);
+    else hybrid_quick_sort(A, S, plan.insertion_cutoff);
+    return plan;
+}
+
+/**
+ * Return the smallest number of seconds which the sorting engine named engine took to sort a fresh copy of 
+ * source (which is comprised of exactly S int type values) over repetitions runs.
+ * 
+ * Each of those runs sorts batch consecutive copies of source (so that engines which finish tiny arrays in less 
+ * than one clock tick can still be timed) and the returned value is the time per copy.
+ */
+double time_sort_engine(const std::function<void(int *, int)> & engine, const int * source, int S, int repetitions, int batch)
+{
+    std::vector<int> work((size_t) S * batch);
+    double best = 0.0;
+    for (int r = 0; r < repetitions; r++)
+    {
+        for (int c = 0; c < batch; c++) copy_array((int *) source, work.data() + (size_t) c * S, S);
+        auto start = std::chrono::high_resolution_clock::now();
+        for (int c = 0; c < batch; c++) engine(work.data() + (size_t) c * S, S);
+        auto end = std::chrono::high_resolution_clock::now();
+        std::chrono::duration<double> duration = end - start;
+        double seconds = duration.count() / batch;
+        if ((r == 0) || (seconds < best)) best = seconds;
+    }
+    return best;
+}
+
+/**
+ * Time each sorting engine on this machine, derive the thresholds which auto_sort uses from those timings, 
+ * print each measurement to the command line terminal, and write the thresholds to CALIBRATION_FILE_NAME.
+ * 
+ * This function is run once per machine (using "./app --calibrate") and returns the program exit status.
+ */
+int run_calibration_sweep()
+{
+    SortCalibration calibration;
+    const int wide_T = 1000000000;
+    unsigned int seed = 2024;
+    int size = 0;
+    std::vector<int> source;
+
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nStart Of Calibration Sweep";
+    std::cout << "\n--------------------------------";
+
+    // Find the insertion cutoff which minimizes the hybrid_quick_sort runtime.
+    source.resize(1 << 16);
+    populate_array_with_distribution(source.data(), (int) source.size(), wide_T, "uniform", seed);
+    double best = -1.0;
+    for (int cutoff : { 4, 8, 12, 16, 24, 32, 48, 64 })
+    {
+        double seconds = time_sort_engine([=](int * A, int S) { hybrid_quick_sort(A, S, cutoff); }, source.data(), (int) source.size(), 5, 1);
+        std::cout << "\n\nhybrid_quick_sort(S = " << source.size() << ", insertion_cutoff = " << cutoff << "): " << seconds << " seconds.";
+        if ((best < 0.0) || (seconds < best))
+        {
+            best = seconds;
+            calibration.insertion_cutoff = cutoff;
+        }
+    }
+
+    // Find the largest array size for which insertion_sort is still at least as fast as hybrid_quick_sort.
+    for (size = 8; size <= 256; size *= 2)
+    {
+        source.resize(size);
+        populate_array_with_distribution(source.data(), size, wide_T, "uniform", seed);
+        double insertion_seconds = time_sort_engine([](int * A, int S) { insertion_sort(A, S); }, source.data(), size, 5, 1000);
+        double quick_seconds = time_sort_engine([&](int * A, int S) { hybrid_quick_sort(A, S, calibration.insertion_cutoff); }, source.data(), size, 5, 1000);
+        std::cout << "\n\nS = " << size << ": insertion_sort " << insertion_seconds << " seconds, hybrid_quick_sort " << quick_seconds << " seconds.";
+        if (insertion_seconds <= quick_seconds) calibration.small_array_threshold = size;
+    }
+
+    // Find the radix digit width which minimizes the radix_sort runtime.
+    source.resize(1 << 18);
+    populate_array_with_distribution(source.data(), (int) source.size(), wide_T, "uniform", seed);
+    best = -1.0;
+    for (int bits : { 4, 6, 8, 11, 16 })
+    {
+        double seconds = time_sort_engine([=](int * A, int S) { radix_sort(A, S, bits); }, source.data(), (int) source.size(), 3, 1);
+        std::cout << "\n\nradix_sort(S = " << source.size() << ", digit_bits = " << bits << "): " << seconds << " seconds.";
+        if ((best < 0.0) || (seconds < best))
+        {
+            best = seconds;
+            calibration.radix_digit_bits = bits;
+        }
+    }
+
+    // Find the smallest array size for which radix_sort is faster than hybrid_quick_sort.
+    calibration.radix_threshold = 1 << 30;
+    for (size = 1 << 8; size <= (1 << 20); size *= 4)
+    {
+        source.resize(size);
+        populate_array_with_distribution(source.data(), size, wide_T, "uniform", seed);
+        double radix_seconds = time_sort_engine([&](int * A, int S) { radix_sort(A, S, calibration.radix_digit_bits); }, source.data(), size, 3, 1);
+        double quick_seconds = time_sort_engine([&](int * A, int S) { hybrid_quick_sort(A, S, calibration.insertion_cutoff); }, source.data(), size, 3, 1);
+        std::cout << "\n\nS = " << size << ": radix_sort " << radix_seconds << " seconds, hybrid_quick_sort " << quick_seconds << " seconds.";
+        if ((radix_seconds < quick_seconds) && (size < calibration.radix_threshold)) calibration.radix_threshold = size;
+    }
+
+    // Find the largest key-range-to-S ratio for which counting_sort is still faster than hybrid_quick_sort.
+    size = 1 << 16;
+    source.resize(size);
+    calibration.counting_range_factor = 0.0;
+    for (double factor : { 0.5, 1.0, 2.0, 4.0, 8.0, 16.0, 32.0 })
+    {
+        populate_array_with_distribution(source.data(), size, (int) (factor * size), "uniform", seed);
+        double counting_seconds = time_sort_engine([&](int * A, int S) { counting_sort(A, S, 1, (int) (factor * size)); }, source.data(), size, 3, 1);
+        double quick_seconds = time_sort_engine([&](int * A, int S) { hybrid_quick_sort(A, S, calibration.insertion_cutoff); }, source.data(), size, 3, 1);
+        std::cout << "\n\nkey_range = " << factor << " * S: counting_sort " << counting_seconds << " seconds, hybrid_quick_sort " << quick_seconds << " seconds.";
+        if (counting_seconds < quick_seconds) calibration.counting_range_factor = factor;
+    }
+
+    // Find the thread count which minimizes the parallel_merge_sort runtime.
+    int hardware_threads = (int) std::thread::hardware_concurrency();
+    if (hardware_threads < 1) hardware_threads = 1;
+    if (hardware_threads > MAXIMUM_THREADS) hardware_threads = MAXIMUM_THREADS;
+    source.resize(1 << 20);
+    populate_array_with_distribution(source.data(), (int) source.size(), wide_T, "uniform", seed);
+    best = -1.0;
+    for (int threads = 1; threads <= hardware_threads; threads *= 2)
+    {
+        double seconds = time_sort_engine([&](int * A, int S) { parallel_merge_sort(A, S, threads, calibration.insertion_cutoff); }, source.data(), (int) source.size(), 3, 1);
+        std::cout << "\n\nparallel_merge_sort(S = " << source.size() << ", thread_count = " << threads << "): " << seconds << " seconds.";
+        if ((best < 0.0) || (seconds < best))
+        {
+            best = seconds;
+            calibration.thread_count = threads;
+        }
+    }
+
+    // Find the smallest array size for which parallel_merge_sort beats the fastest single-threaded engine.
+    calibration.parallel_threshold = 1 << 30;
+    for (size = 1 << 12; (calibration.thread_count > 1) && (size <= (1 << 22)); size *= 4)
+    {
+        source.resize(size);
+        populate_array_with_distribution(source.data(), size, wide_T, "uniform", seed);
+        double parallel_seconds = time_sort_engine([&](int * A, int S) { parallel_merge_sort(A, S, calibration.thread_count, calibration.insertion_cutoff); }, source.data(), size, 3, 1);
+        double radix_seconds = time_sort_engine([&](int * A, int S) { radix_sort(A, S, calibration.radix_digit_bits); }, source.data(), size, 3, 1);
+        double quick_seconds = time_sort_engine([&](int * A, int S) { hybrid_quick_sort(A, S, calibration.insertion_cutoff); }, source.data(), size, 3, 1);
+        double serial_seconds = (radix_seconds < quick_seconds) ? radix_seconds : quick_seconds;
+        std::cout << "\n\nS = " << size << ": parallel_merge_sort " << parallel_seconds << " seconds, fastest single-threaded engine " << serial_seconds << " seconds.";
+        if ((parallel_seconds < serial_seconds) && (size < calibration.parallel_threshold)) calibration.parallel_threshold = size;
+    }
+
+    // Write the measured thresholds to the calibration file.
+    bool saved = save_sort_calibration(calibration, CALIBRATION_FILE_NAME);
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\n\nsmall_array_threshold = " << calibration.small_array_threshold;
+    std::cout << "\ninsertion_cutoff = " << calibration.insertion_cutoff;
+    std::cout << "\nradix_digit_bits = " << calibration.radix_digit_bits;
+    std::cout << "\nradix_threshold = " << calibration.radix_threshold;
+    std::cout << "\ncounting_range_factor = " << calibration.counting_range_factor;
+    std::cout << "\nthread_count = " << calibration.thread_count;
+    std::cout << "\nparallel_threshold = " << calibration.parallel_threshold;
+    std::cout << (saved ? "\n\nThe thresholds above were written to " : "\n\nThe thresholds above could not be written to ") << CALIBRATION_FILE_NAME << ".";
+    std::cout << "\n\n--------------------------------";
+    std::cout << "\nEnd Of Calibration Sweep";
+    std::cout << "\n--------------------------------\n\n";
+    return saved ? 0 : 1;
+}
+
+/**
+ * Run the non-interactive mode named by the first command line argument and return that mode's exit status.
+ * 
+ * The supported modes are:
+ * 
+ * ./app --calibrate
+ * (time each sorting engine on this machine and write the measured thresholds to CALIBRATION_FILE_NAME)
+ * 
+ * ./app --benchmark [S=...] [T=...] [distribution=...] [seed=...] [repetitions=...] [threads=...] [algorithms=...] [format=jsonl|csv] [output=...] [baseline=...] [tolerance=...] 
+ *                    [cpu=...] [isolate=none|fork] [cache=warm|flushed|cold] [concurrent=...]
+ * (time each selected sorting engine on each selected input, write one result record per engine and input, 
+ * and, if a baseline file is named, compare the new records against the baseline records; 
+ * cpu pins every run to one processor core, isolate=fork runs every repetition in a freshly forked child process, 
+ * cache sets the state of the processor caches at the start of each run, 
+ * and concurrent runs that many pinned instances of the benchmark at the same time to expose memory-bandwidth contention)
+ * 
+ * ./app --compare baseline=... current=... [tolerance=...]
+ * (compare two result files which were written by the benchmark mode)
+ * 
+ * ./app --stable [S=...] [T=...] [distribution=...] [seed=...] [repetitions=...] [threads=...]
+ * (time stable_sort_pairs on key/payload pairs against the serial merge_sort and verify that the pairs were sorted stably)
+ * 
+ * S, distribution, and algorithms accept comma-separated lists (e.g. "S=1000,100000" or "algorithms=merge_sort,radix_sort").
+ */
+int run_command_line_mode(int argc, char * argv[])
+{
+    std::string mode = argv[1];
+    std::map<std::string, std::string> options = parse_command_line_options(argc, argv, 2);
+    if (mode == "--calibrate") return run_calibration_sweep();
+    if (mode == "--benchmark") return run_benchmark_mode(options);
+    if (mode == "--compare") return run_compare_mode(options);
+    if (mode == "--stable") return run_stable_sort_benchmark(options);
+    std::cout << "\n\nUnrecognized mode: " << mode;
+    std::cout << "\n\nUsage: ./app (interactive program)";
+    std::cout << "\n       ./app --calibrate";
+    std::cout << "\n       ./app --benchmark [S=...] [T=...] [distribution=...] [seed=...] [repetitions=...] [threads=...] [algorithms=...] [format=jsonl|csv] [output=...] [baseline=...] [tolerance=...]";
+    std::cout << "\n                         [cpu=...] [isolate=none|fork] [cache=warm|flushed|cold] [concurrent=...]";
+    std::cout << "\n       ./app --compare baseline=... current=... [tolerance=...]";
+    std::cout << "\n       ./app --stable [S=...] [T=...] [distribution=...] [seed=...] [repetitions=...] [threads=...]\n\n";
+    return 2;
+}
+
+/**
+ * Store each command line argument of the form "key=value" (starting with argv[first_index]) 
+ * in a map from key to value. Arguments which do not contain '=' are stored with the value "1".
+ */
+std::map<std::string, std::string> parse_command_line_options(int argc, char * argv[], int first_index)
+{
+    std::map<std::string, std::string> options;
+    for (int i = first_index; i < argc; i++)
+    {
+        std::string argument = argv[i];
+        size_t equals_sign = argument.find('=');
+        if (equals_sign == std::string::npos) options[argument] = "1";
+        else options[argument.substr(0, equals_sign)] = argument.substr(equals_sign + 1);
+    }
+    return options;
+}
+
+/**
+ * Split a string such as "uniform,sorted,reversed" into the list { "uniform", "sorted", "reversed" }.
+ */
+std::vector<std::string> split_comma_separated_values(const std::string & values)
+{
+    std::vector<std::string> list;
+    std::stringstream stream(values);
+    std::string value;
+    while (std::getline(stream, value, ',')) if (!value.empty()) list.push_back(value);
+    return list;
+}
+
+/**
+ * Return the list of every sorting engine which the benchmark mode can run 
+ * (the four original algorithms followed by the engines used by auto_sort and auto_sort itself).
+ * 
+ * The engines which depend on thresholds use the thresholds stored in calibration, 
+ * and parallel_merge_sort uses thread_count worker threads.
+ */
+std::vector<SortEngine> list_sort_engines(const SortCalibration & calibration, int thread_count)
+{
+    std::vector<SortEngine> engines;
+    engines.push_back({ "bubble_sort", [](int * A, int S) { bubble_sort(A, S); }, true, 1 });
+    engines.push_back({ "merge_sort", [](int * A, int S) { merge_sort(A, S); }, false, 1 });
+    engines.push_back({ "selection_sort", [](int * A, int S) { selection_sort(A, S); }, true, 1 });
+    engines.push_back({ "quick_sort", [](int * A, int S) { quick_sort(A, S); }, true, 1 });
+    engines.push_back({ "insertion_sort", [](int * A, int S) { insertion_sort(A, S); }, true, 1 });
+    engines.push_back({ "hybrid_quick_sort", [=](int * A, int S) { hybrid_quick_sort(A, S, calibration.insertion_cutoff); }, false, 1 });
+    engines.push_back({ "hybrid_merge_sort", [=](int * A, int S) { hybrid_merge_sort(A, S, calibration.insertion_cutoff); }, false, 1 });
+    engines.push_back({ "parallel_merge_sort", [=](int * A, int S) { parallel_merge_sort(A, S, thread_count, calibration.insertion_cutoff); }, false, thread_count });
+    engines.push_back({ "radix_sort", [=](int * A, int S) { radix_sort(A, S, calibration.radix_digit_bits); }, false, 1 });
+    engines.push_back({ "auto_sort", [=](int * A, int S) { auto_sort(A, S, calibration); }, false, calibration.thread_count });
+    return engines;
+}
+
+/**
+ * Open (and start) one Linux performance counter per entry of COUNTER_NAMES for the calling thread 
+ * and store each counter's file descriptor in descriptors (or -1 if that counter is not available, 
+ * which is common inside virtual machines and containers).
+ */
+void start_performance_counters(int * descriptors)
+{
+    const unsigned int types[NUMBER_OF_COUNTERS] = { PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_HARDWARE, PERF_TYPE_SOFTWARE, PERF_TYPE_SOFTWARE };
+    const unsigned long long configs[NUMBER_OF_COUNTERS] = { PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES, PERF_COUNT_SW_PAGE_FAULTS, PERF_COUNT_SW_CONTEXT_SWITCHES };
+    for (int k = 0; k < NUMBER_OF_COUNTERS; k++)
+    {
+        perf_event_attr attributes = {};
+        attributes.size = sizeof(attributes);
+        attributes.type = types[k];
+        attributes.config = configs[k];
+        attributes.disabled = 1;
+        attributes.exclude_kernel = 1;
+        attributes.exclude_hv = 1;
+        attributes.inherit = 1;
+        descriptors[k] = (int) syscall(SYS_perf_event_open, &attributes, 0, -1, -1, 0);
+        if (descriptors[k] >= 0)
+        {
+            ioctl(descriptors[k], PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptors[k], PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+}
+
+/**
+ * Stop and close the performance counters which were opened by start_performance_counters 
+ * and add each counter's value to values[k] (counters which are not available set values[k] to -1).
+ */
+void stop_performance_counters(int * descriptors, long long * values)
+{
+    for (int k = 0; k < NUMBER_OF_COUNTERS; k++)
+    {
+        long long value = -1;
+        if (descriptors[k] >= 0)
+        {
+            ioctl(descriptors[k], PERF_EVENT_IOC_DISABLE, 0);
+            if (read(descriptors[k], &value, sizeof(value)) != (ssize_t) sizeof(value)) value = -1;
+            close(descriptors[k]);
+        }
+        if ((value < 0) || (values[k] < 0)) values[k] = -1;
+        else values[k] += value;
+    }
+}
+
+/**
+ * Compute the minimum, median, mean, maximum, and standard deviation of the runtimes stored in seconds 
+ * and return a BenchmarkResult which stores those statistics together with the identity of the run.
+ * 
+ * counter_totals stores the sum of each performance counter over all runs (or NULL if no counters were recorded).
+ */
+BenchmarkResult summarize_runs(const std::string & algorithm, int S, int T, const std::string & distribution, unsigned int seed, int thread_count, std::vector<double> seconds, const long long * counter_totals)
+{
+    BenchmarkResult result = { algorithm, S, T, distribution, seed, thread_count, (int) seconds.size(), 0.0, 0.0, 0.0, 0.0, 0.0, { -1, -1, -1, -1, -1, -1 }, { -1, -1, -1, -1, -1, -1 } };
+    size_t count = seconds.size();
+    if (count == 0) return result;
+    std::sort(seconds.begin(), seconds.end());
+    double total = 0.0, squared_deviations = 0.0;
+    for (double value : seconds) total += value;
+    result.minimum_seconds = seconds[0];
+    result.maximum_seconds = seconds[count - 1];
+    result.median_seconds = (count % 2 == 1) ? seconds[count / 2] : 0.5 * (seconds[count / 2 - 1] + seconds[count / 2]);
+    result.mean_seconds = total / count;
+    for (double value : seconds) squared_deviations += (value - result.mean_seconds) * (value - result.mean_seconds);
+    result.standard_deviation_seconds = (count > 1) ? sqrt(squared_deviations / (count - 1)) : 0.0;
+    if (counter_totals != NULL) for (int k = 0; k < NUMBER_OF_COUNTERS; k++) result.counters[k] = (counter_totals[k] < 0) ? -1 : counter_totals[k] / (long long) count;
+    return result;
+}
+
+/**
+ * Return the characters of text with every character which JSON requires to be escaped replaced by its escape sequence.
+ */
+std::string escape_json_string(const std::string & text)
+{
+    std::string escaped;
+    for (char character : text)
+    {
+        if ((character == '"') || (character == '\\')) escaped += '\\';
+        if ((unsigned char) character < 0x20) escaped += ' ';
+        else escaped += character;
+    }
+    return escaped;
+}
+
+/**
+ * Return the network host name of the machine which is running this program (or "unknown").
+ */
+std::string read_host_name()
+{
+    char host_name[256] = "unknown";
+    gethostname(host_name, sizeof(host_name) - 1);
+    host_name[sizeof(host_name) - 1] = '\0';
+    return host_name;
+}
+
+/**
+ * Return the processor model name which /proc/cpuinfo reports for the first logical processor (or "unknown").
+ */
+std::string read_cpu_model()
+{
+    std::string line;
+    std::ifstream cpu_information("/proc/cpuinfo");
+    while (std::getline(cpu_information, line)) if (line.compare(0, 10, "model name") == 0) return line.substr(line.find(':') + 2);
+    return "unknown";
+}
+
+/**
+ * Return a JSON object which describes the machine which is running this program 
+ * (host name, processor model, number of logical processors, operating system kernel, and compiler version).
+ */
+std::string describe_host_as_json()
+{
+    std::string host_name = read_host_name(), cpu_model = read_cpu_model();
+    struct utsname system_name;
+    std::string kernel = (uname(&system_name) == 0) ? std::string(system_name.sysname) + " " + system_name.release + " " + system_name.machine : "unknown";
+    std::stringstream json;
+    json << "{\"hostname\":\"" << escape_json_string(host_name) << "\",\"cpu_model\":\"" << escape_json_string(cpu_model) << "\",\"logical_cpus\":" << std::thread::hardware_concurrency() << ",\"kernel\":\"" << escape_json_string(kernel) << "\",\"compiler\":\"" << escape_json_string(__VERSION__) << "\"}";
+    return json.str();
+}
+
+/**
+ * Return one BenchmarkResult formatted as a single-line JSON object (one line of a JSON Lines file). 
+ * host is the JSON object returned by describe_host_as_json and counters which are not available are written as null 
+ * (memory quantities which are not available are written as -1).
+ */
+std::string benchmark_result_to_json(const BenchmarkResult & result, const std::string & host)
+{
+    std::stringstream json;
+    json.precision(12);
+    json << "{\"algorithm\":\"" << escape_json_string(result.algorithm) << "\",\"S\":" << result.S << ",\"T\":" << result.T;
+    json << ",\"distribution\":\"" << escape_json_string(result.distribution) << "\",\"seed\":" << result.seed;
+    json << ",\"thread_count\":" << result.thread_count << ",\"repetitions\":" << result.repetitions;
+    json << ",\"minimum_seconds\":" << result.minimum_seconds << ",\"median_seconds\":" << result.median_seconds;
+    json << ",\"mean_seconds\":" << result.mean_seconds << ",\"maximum_seconds\":" << result.maximum_seconds;
+    json << ",\"standard_deviation_seconds\":" << result.standard_deviation_seconds << ",\"counters\":{";
+    for (int k = 0; k < NUMBER_OF_COUNTERS; k++)
+    {
+        json << ((k > 0) ? "," : "") << "\"" << COUNTER_NAMES[k] << "\":";
+        if (result.counters[k] < 0) json << "null";
+        else json << result.counters[k];
+    }
+    json << "},\"memory\":{\"allocation_count\":" << result.memory.allocation_count << ",\"allocated_bytes\":" << result.memory.allocated_bytes;
+    json << ",\"peak_live_bytes\":" << result.memory.peak_live_bytes << ",\"peak_rss_delta_kilobytes\":" << result.memory.peak_rss_delta_kilobytes;
+    json << ",\"maximum_recursion_depth\":" << result.memory.maximum_recursion_depth << ",\"maximum_stack_bytes\":" << result.memory.maximum_stack_bytes;
+    json << "},\"execution\":{\"pinned_cpu\":" << result.execution.pinned_cpu << ",\"isolation\":\"" << escape_json_string(result.execution.isolation) << "\"";
+    json << ",\"cache_state\":\"" << escape_json_string(result.execution.cache_state) << "\",\"concurrent_instances\":" << result.execution.concurrent_instances;
+    json << ",\"average_frequency_mhz\":" << result.average_frequency_mhz << ",\"minimum_frequency_mhz\":" << result.minimum_frequency_mhz << ",\"maximum_frequency_mhz\":" << result.maximum_frequency_mhz;
+    json << ",\"voluntary_context_switches\":" << result.voluntary_context_switches;
+    json << ",\"involuntary_context_switches\":" << result.involuntary_context_switches << ",\"cpu_migrations\":" << result.cpu_migrations;
+    json << "},\"host\":" << host << "}";
+    return json.str();
+}
+
+/**
+ * Return text as one CSV field: enclosed in double quotes, with every double quote inside of it doubled 
+ * (so that commas and quotes in names such as host names cannot split the field).
+ */
+std::string quote_csv_field(const std::string & text)
+{
+    std::string quoted = "\"";
+    for (char character : text)
+    {
+        if (character == '"') quoted += '"';
+        if ((character == '\n') || (character == '\r')) quoted += ' ';
+        else quoted += character;
+    }
+    return quoted + "\"";
+}
+
+/**
+ * Split one line of a CSV file into its fields, removing the quotes of every quoted field (see quote_csv_field), 
+ * in which commas do not separate fields and a doubled double quote stands for one double quote.
+ */
+std::vector<std::string> split_csv_line(const std::string & line)
+{
+    std::vector<std::string> fields(1);
+    bool quoted = false;
+    for (size_t i = 0; i < line.size(); i++)
+    {
+        if (quoted && (line[i] == '"') && (i + 1 < line.size()) && (line[i + 1] == '"')) fields.back() += line[++i];
+        else if (line[i] == '"') quoted = !quoted;
+        else if ((line[i] == ',') && !quoted) fields.push_back("");
+        else fields.back() += line[i];
+    }
+    return fields;
+}
+
+/**
+ * Return the last three fields of a CSV result line, which describe the machine which is running this program 
+ * (host name, processor model, and number of logical processors), so that they are read once per results file rather than once per record.
+ */
+std::string describe_host_as_csv()
+{
+    return quote_csv_field(read_host_name()) + "," + quote_csv_field(read_cpu_model()) + "," + std::to_string(std::thread::hardware_concurrency());
+}
+
+/**
+ * Return the header line of a CSV results file (whose columns match benchmark_result_to_csv).
+ */
+std::string benchmark_csv_header()
+{
+    std::string header = "algorithm,S,T,distribution,seed,thread_count,repetitions,minimum_seconds,median_seconds,mean_seconds,maximum_seconds,standard_deviation_seconds";
+    for (int k = 0; k < NUMBER_OF_COUNTERS; k++) header += std::string(",") + COUNTER_NAMES[k];
+    return header + ",allocation_count,allocated_bytes,peak_live_bytes,peak_rss_delta_kilobytes,maximum_recursion_depth,maximum_stack_bytes,pinned_cpu,isolation,cache_state,concurrent_instances,average_frequency_mhz,minimum_frequency_mhz,maximum_frequency_mhz,voluntary_context_switches,involuntary_context_switches,cpu_migrations,hostname,cpu_model,logical_cpus";
+}
+
+/**
+ * Return one BenchmarkResult formatted as one line of a CSV file (counters which are not available are left empty, and every text field is quoted). 
+ * host is the text returned by describe_host_as_csv.
+ */
+std::string benchmark_result_to_csv(const BenchmarkResult & result, const std::string & host)
+{
+    std::stringstream csv;
+    csv.precision(12);
+    csv << quote_csv_field(result.algorithm) << "," << result.S << "," << result.T << "," << quote_csv_field(result.distribution) << "," << result.seed << "," << result.thread_count << "," << result.repetitions;
+    csv << "," << result.minimum_seconds << "," << result.median_seconds << "," << result.mean_seconds << "," << result.maximum_seconds << "," << result.standard_deviation_seconds;
+    for (int k = 0; k < NUMBER_OF_COUNTERS; k++)
+    {
+        csv << ",";
+        if (result.counters[k] >= 0) csv << result.counters[k];
+    }
+    csv << "," << result.memory.allocation_count << "," << result.memory.allocated_bytes << "," << result.memory.peak_live_bytes;
+    csv << "," << result.memory.peak_rss_delta_kilobytes << "," << result.memory.maximum_recursion_depth << "," << result.memory.maximum_stack_bytes;
+    csv << "," << result.execution.pinned_cpu << "," << quote_csv_field(result.execution.isolation) << "," << quote_csv_field(result.execution.cache_state) << "," << result.execution.concurrent_instances;
+    csv << "," << result.average_frequency_mhz << "," << result.minimum_frequency_mhz << "," << result.maximum_frequency_mhz << "," << result.voluntary_context_switches << "," << result.involuntary_context_switches << "," << result.cpu_migrations;
+    csv << "," << host;
+    return csv.str();
+}
+
+/**
+ * Write each BenchmarkResult stored in results to the file named file_name 
+ * using the format named format ("jsonl" for JSON Lines or "csv" for comma-separated values).
+ * 
+ * This function returns true if the file was written and false otherwise.
+ */
+bool write_benchmark_results(const std::vector<BenchmarkResult> & results, const std::string & file_name, const std::string & format)
+{
+    std::ofstream output(file_name);
+    if (!output) return false;
+    if (format == "csv")
+    {
+        std::string host = describe_host_as_csv();
+        output << benchmark_csv_header() << "\n";
+        for (const BenchmarkResult & result : results) output << benchmark_result_to_csv(result, host) << "\n";
+    }
+    else
+    {
+        std::string host = describe_host_as_json();
+        for (const BenchmarkResult & result : results) output << benchmark_result_to_json(result, host) << "\n";
+    }
+    return true;
+}
+
+/**
+ * Return the text of the value which follows "\"key\":" in a single-line JSON object (without surrounding quotes), 
+ * or an empty string if that key does not occur in line.
+ */
+std::string find_json_value(const std::string & line, const std::string & key)
+{
+    size_t position = line.find("\"" + key + "\":");
+    if (position == std::string::npos) return "";
+    position += key.size() + 3;
+    if ((position < line.size()) && (line[position] == '"'))
+    {
+        size_t closing_quote = line.find('"', position + 1);
+        return line.substr(position + 1, closing_quote - position - 1);
+    }
+    size_t end = line.find_first_of(",}", position);
+    return line.substr(position, end - position);
+}
+
+/**
+ * Read the result records which were written by write_benchmark_results (in either format) from the file named file_name.
+ * Only the identity of each run and its timing statistics are read back (counters are set to -1).
+ */
+std::vector<BenchmarkResult> read_benchmark_results(const std::string & file_name)
+{
+    std::vector<BenchmarkResult> results;
+    std::ifstream input(file_name);
+    std::string line;
+    int concurrent_instances_column = -1;
+    while (std::getline(input, line))
+    {
+        if (line.compare(0, 10, "algorithm,") == 0)
+        {
+            // Find the column of the CSV header which stores the number of concurrent instances (older result files do not have that column).
+            std::stringstream header(line);
+            std::string name;
+            for (int column = 0; std::getline(header, name, ','); column++) if (name == "concurrent_instances") concurrent_instances_column = column;
+            continue;
+        }
+        if (line.empty()) continue;
+        BenchmarkResult result = { "", 0, 0, "", 0, 1, 0, 0.0, 0.0, 0.0, 0.0, 0.0, { -1, -1, -1, -1, -1, -1 }, { -1, -1, -1, -1, -1, -1 } };
+        if (line[0] == '{')
+        {
+            result.algorithm = find_json_value(line, "algorithm");
+            result.S = atoi(find_json_value(line, "S").c_str());
+            result.T = atoi(find_json_value(line, "T").c_str());
+            result.distribution = find_json_value(line, "distribution");
+            result.seed = (unsigned int) strtoul(find_json_value(line, "seed").c_str(), NULL, 10);
+            result.thread_count = atoi(find_json_value(line, "thread_count").c_str());
+            result.repetitions = atoi(find_json_value(line, "repetitions").c_str());
+            result.minimum_seconds = atof(find_json_value(line, "minimum_seconds").c_str());
+            result.median_seconds = atof(find_json_value(line, "median_seconds").c_str());
+            result.mean_seconds = atof(find_json_value(line, "mean_seconds").c_str());
+            result.maximum_seconds = atof(find_json_value(line, "maximum_seconds").c_str());
+            result.standard_deviation_seconds = atof(find_json_value(line, "standard_deviation_seconds").c_str());
+            std::string instances = find_json_value(line, "concurrent_instances");
+            if (!instances.empty()) result.execution.concurrent_instances = atoi(instances.c_str());
+        }
+        else
+        {
+            std::vector<std::string> columns = split_csv_line(line);
+            if (columns.size() < 12) continue;
+            result.algorithm = columns[0];
+            result.S = atoi(columns[1].c_str());
+            result.T = atoi(columns[2].c_str());
+            result.distribution = columns[3];
+            result.seed = (unsigned int) strtoul(columns[4].c_str(), NULL, 10);
+            result.thread_count = atoi(columns[5].c_str());
+            result.repetitions = atoi(columns[6].c_str());
+            result.minimum_seconds = atof(columns[7].c_str());
+            result.median_seconds = atof(columns[8].c_str());
+            result.mean_seconds = atof(columns[9].c_str());
+            result.maximum_seconds = atof(columns[10].c_str());
+            result.standard_deviation_seconds = atof(columns[11].c_str());
+            if ((concurrent_instances_column > 0) && ((int) columns.size() > concurrent_instances_column)) result.execution.concurrent_instances = atoi(columns[concurrent_instances_column].c_str());
+        }
+        results.push_back(result);
+    }
+    return results;
+}
+
+/**
+ * Compare each record of current against the baseline record which has the same algorithm, S, T, distribution, 
+ * thread count, and number of concurrent instances, print one line per comparison to output, and return the number of regressions.
+ * 
+ * A record regresses when its median runtime exceeds the baseline median runtime by more than 
+ * tolerance (e.g. tolerance = 0.10 allows the median runtime to grow by up to ten percent).
+ */
+int compare_benchmark_results(const std::vector<BenchmarkResult> & baseline, const std::vector<BenchmarkResult> & current, double tolerance, std::ostream & output)
+{
+    std::map<std::string, BenchmarkResult> baseline_by_key;
+    for (const BenchmarkResult & result : baseline) baseline_by_key[result.algorithm + "|" + std::to_string(result.S) + "|" + std::to_string(result.T) + "|" + result.distribution + "|" + std::to_string(result.thread_count) + "|" + std::to_string(result.execution.concurrent_instances)] = result;
+    int regressions = 0;
+    for (const BenchmarkResult & result : current)
+    {
+        std::string key = result.algorithm + "|" + std::to_string(result.S) + "|" + std::to_string(result.T) + "|" + result.distribution + "|" + std::to_string(result.thread_count) + "|" + std::to_string(result.execution.concurrent_instances);
+        output << "\n\n" << result.algorithm << " (S = " << result.S << ", T = " << result.T << ", distribution = " << result.distribution << ", thread_count = " << result.thread_count << "): ";
+        std::map<std::string, BenchmarkResult>::const_iterator match = baseline_by_key.find(key);
+        if (match == baseline_by_key.end())
+        {
+            output << "no baseline record.";
+            continue;
+        }
+        double ratio = (match->second.median_seconds > 0.0) ? result.median_seconds / match->second.median_seconds : 1.0;
+        bool regressed = ratio > 1.0 + tolerance;
+        if (regressed) regressions++;
+        output << "median " << result.median_seconds << " seconds versus baseline median " << match->second.median_seconds << " seconds (ratio " << ratio << ")" << (regressed ? " REGRESSION." : " ok.");
+    }
+    output << "\n\n" << regressions << " regression(s) beyond a tolerance of " << tolerance << ".\n\n";
+    return regressions;
+}
+
+/**
+ * Run each selected sorting engine repetitions times on each selected input, write one result record per engine and input 
+ * (to the file named by the output option), and, if a baseline file is named by the baseline option, compare the new 
+ * records against the baseline records.
+ * 
+ * This function returns 0 on success, 1 if the comparison found a regression or an engine failed to sort its input, 
+ * and 2 if a file could not be read or written.
+ */
+int run_benchmark_mode(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string> settings = { { "S", "100000" }, { "T", "1000000" }, { "distribution", "uniform" }, { "seed", "1" }, { "repetitions", "5" }, { "threads", std::to_string(std::thread::hardware_concurrency()) }, { "algorithms", "all" }, { "format", "jsonl" }, { "tolerance", "0.10" }, { "allow_quadratic", "0" } };
+    for (const auto & option : options) settings[option.first] = option.second;
+    if (settings.find("output") == settings.end()) settings["output"] = (settings["format"] == "csv") ? CSV_RESULTS_FILE_NAME : RESULTS_FILE_NAME;
+    int T = atoi(settings["T"].c_str()), repetitions = atoi(settings["repetitions"].c_str()), threads = atoi(settings["threads"].c_str());
+    unsigned int seed = (unsigned int) strtoul(settings["seed"].c_str(), NULL, 10);
+    if (T < 1) T = 1;
+    if (repetitions < 1) repetitions = 1;
+    if (threads < 1) threads = 1;
+
+    // Read how each run is isolated (by default every run happens in this process on whichever core the scheduler picks, with warm caches).
+    ExecutionSettings execution;
+    if (settings.find("cpu") != settings.end()) execution.pinned_cpu = atoi(settings["cpu"].c_str()) % (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (settings.find("isolate") != settings.end()) execution.isolation = (settings["isolate"] == "fork") ? "fork" : "in_process";
+    if (settings.find("cache") != settings.end()) execution.cache_state = settings["cache"];
+    if (settings.find("concurrent") != settings.end()) execution.concurrent_instances = atoi(settings["concurrent"].c_str());
+    if ((execution.cache_state != "warm") && (execution.cache_state != "flushed") && (execution.cache_state != "cold"))
+    {
+        std::cout << "\n\nUnknown cache state: " << execution.cache_state << " (expected warm, flushed, or cold).\n\n";
+        return 2;
+    }
+    if (execution.concurrent_instances < 1) execution.concurrent_instances = 1;
+    if (execution.concurrent_instances > 1) execution.isolation = "fork";
+    if ((execution.pinned_cpu >= 0) && (execution.isolation == "in_process") && !pin_to_cpu(execution.pinned_cpu)) std::cout << "\nCould not pin the benchmark to core " << execution.pinned_cpu << ".";
+    SortCalibration calibration = load_sort_calibration(CALIBRATION_FILE_NAME);
+    std::vector<SortEngine> engines = list_sort_engines(calibration, threads);
+    std::vector<std::string> selected = split_comma_separated_values(settings["algorithms"]);
+    std::vector<BenchmarkResult> results;
+    int failures = 0;
+
+    std::cout.precision(6);
+    for (const std::string & size_text : split_comma_separated_values(settings["S"]))
+    {
+        int S = atoi(size_text.c_str());
+        if (S < 1) continue;
+        for (const std::string & distribution : split_comma_separated_values(settings["distribution"]))
+        {
+            std::vector<int> source(S);
+            populate_array_with_distribution(source.data(), S, T, distribution, seed);
+            for (const SortEngine & engine : engines)
+            {
+                if ((settings["algorithms"] != "all") && (std::find(selected.begin(), selected.end(), engine.name) == selected.end())) continue;
+                if (engine.quadratic && (S > MAXIMUM_QUADRATIC_S) && (settings["allow_quadratic"] == "0"))
+                {
+                    std::cout << "\nSkipping " << engine.name << " for S = " << S << " (its worst case is quadratic; pass allow_quadratic=1 to run it anyway).";
+                    continue;
+                }
+                std::vector<RunMeasurement> measurements = run_sort_repetitions(engine, source.data(), S, repetitions, execution);
+                if (measurements.empty())
+                {
+                    failures++;
+                    std::cout << "\n" << engine.name << " could not be run in isolation (S = " << S << ", distribution = " << distribution << ").";
+                    continue;
+                }
+
+                // Combine the measurements of every repetition (and of every concurrent instance) into one result record.
+                std::vector<double> seconds;
+                long long counter_totals[NUMBER_OF_COUNTERS] = { 0, 0, 0, 0, 0, 0 };
+                MemoryProfile largest_memory = { 0, 0, 0, 0, 0, 0 };
+                double frequency_total = 0.0, minimum_frequency = -1.0, maximum_frequency = -1.0, voluntary_total = 0.0, involuntary_total = 0.0;
+                int frequency_samples = 0, migrations = 0;
+                bool sorted = true;
+                for (const RunMeasurement & measurement : measurements)
+                {
+                    seconds.push_back(measurement.seconds);
+                    for (int k = 0; k < NUMBER_OF_COUNTERS; k++) counter_totals[k] = ((counter_totals[k] < 0) || (measurement.counters[k] < 0)) ? -1 : counter_totals[k] + measurement.counters[k];
+                    const long long * measured = &measurement.memory.allocation_count;
+                    long long * largest = &largest_memory.allocation_count;
+                    for (int k = 0; k < 6; k++) if (measured[k] > largest[k]) largest[k] = measured[k];
+                    if (measurement.frequency_mhz > 0.0)
+                    {
+                        frequency_total += measurement.frequency_mhz;
+                        minimum_frequency = (frequency_samples == 0) ? measurement.minimum_frequency_mhz : std::min(minimum_frequency, measurement.minimum_frequency_mhz);
+                        maximum_frequency = (frequency_samples == 0) ? measurement.maximum_frequency_mhz : std::max(maximum_frequency, measurement.maximum_frequency_mhz);
+                        frequency_samples++;
+                    }
+                    voluntary_total += measurement.voluntary_context_switches;
+                    involuntary_total += measurement.involuntary_context_switches;
+                    if (measurement.cpu_at_start != measurement.cpu_at_end) migrations++;
+                    if (!measurement.sorted) sorted = false;
+                }
+                if (!sorted)
+                {
+                    failures++;
+                    std::cout << "\n" << engine.name << " did not sort its input (S = " << S << ", distribution = " << distribution << ").";
+                }
+                results.push_back(summarize_runs(engine.name, S, T, distribution, seed, engine.thread_count, seconds, counter_totals));
+                results.back().memory = largest_memory;
+                results.back().execution = execution;
+                results.back().average_frequency_mhz = (frequency_samples > 0) ? frequency_total / frequency_samples : -1.0;
+                results.back().minimum_frequency_mhz = minimum_frequency;
+                results.back().maximum_frequency_mhz = maximum_frequency;
+                results.back().voluntary_context_switches = voluntary_total / measurements.size();
+                results.back().involuntary_context_switches = involuntary_total / measurements.size();
+                results.back().cpu_migrations = migrations;
+                std::cout << "\n" << engine.name << " (S = " << S << ", distribution = " << distribution << "): median " << results.back().median_seconds << " seconds over " << measurements.size() << " runs; ";
+                std::cout << "average frequency " << results.back().average_frequency_mhz << " MHz (" << minimum_frequency << " to " << maximum_frequency << " MHz during the runs), ";
+                std::cout << std::fixed << std::setprecision(3) << results.back().voluntary_context_switches << " voluntary and " << results.back().involuntary_context_switches << " involuntary context switches per run" << std::defaultfloat << std::setprecision(6);
+                std::cout << ", " << migrations << " migrated run(s); " << describe_memory_profile(largest_memory) << ".";
+
+                // When several instances ran at once, print each instance's median runtime so that memory-bandwidth contention is visible.
+                for (int instance = 0; (execution.concurrent_instances > 1) && (instance < execution.concurrent_instances); instance++)
+                {
+                    std::vector<double> instance_seconds;
+                    for (const RunMeasurement & measurement : measurements) if (measurement.instance == instance) instance_seconds.push_back(measurement.seconds);
+                    BenchmarkResult instance_summary = summarize_runs(engine.name, S, T, distribution, seed, engine.thread_count, instance_seconds, NULL);
+                    std::cout << "\n    instance " << instance << " (core " << ((execution.pinned_cpu < 0) ? instance : execution.pinned_cpu + instance) % (int) sysconf(_SC_NPROCESSORS_ONLN) << "): median " << instance_summary.median_seconds << " seconds.";
+                }
+            }
+        }
+    }
+
+    if (!write_benchmark_results(results, settings["output"], settings["format"]))
+    {
+        std::cout << "\n\nThe results could not be written to " << settings["output"] << ".\n\n";
+        return 2;
+    }
+    std::cout << "\n\nThe results were written to " << settings["output"] << ".";
+    if (settings.find("baseline") != settings.end())
+    {
+        std::vector<BenchmarkResult> baseline = read_benchmark_results(settings["baseline"]);
+        if (baseline.empty())
+        {
+            std::cout << "\n\nThe baseline file " << settings["baseline"] << " could not be read (or contains no results).\n\n";
+            return 2;
+        }
+        if (compare_benchmark_results(baseline, results, atof(settings["tolerance"].c_str()), std::cout) > 0) return 1;
+    }
+    std::cout << "\n\n";
+    return (failures > 0) ? 1 : 0;
+}
+
+/**
+ * Compare the result file named by the current option against the result file named by the baseline option 
+ * and return 1 if any record regressed beyond the tolerance option (0 if none did and 2 if a file could not be read).
+ */
+int run_compare_mode(const std::map<std::string, std::string> & options)
+{
+    std::map<std::string, std::string>::const_iterator baseline_name = options.find("baseline"), current_name = options.find("current"), tolerance = options.find("tolerance");
+    if ((baseline_name == options.end()) || (current_name == options.end()))
+    {
+        std::cout << "\n\nUsage: ./app --compare baseline=... current=... [tolerance=...]\n\n";
+        return 2;
+    }
+    std::vector<BenchmarkResult> baseline = read_benchmark_results(baseline_name->second), current = read_benchmark_results(current_name->second);
+    if (baseline.empty() || current.empty())
+    {
+        std::cout << "\n\nThe baseline file or the current file could not be read (or contains no results).\n\n";
+        return 2;
+    }
+    std::cout.precision(6);
+    return (compare_benchmark_results(baseline, current, (tolerance == options.end()) ? 0.10 : atof(tolerance->second.c_str()), std::cout) > 0) ? 1 : 0;
+}
+
+/**
+ * The following global operator new and operator delete functions replace the default C++ allocation functions 
+ * for the entire program (including the allocations made by std::vector and by merge) so that every heap allocation 
+ * is counted by allocation_counters.
+ * 
+ * Each allocation stores its requested size (and whether it was counted, i.e. whether a memory profile was being taken) 
+ * in an ALLOCATION_HEADER_BYTES header in front of the block which is returned to the caller, 
+ * which allows operator delete to subtract the correct number of bytes from live_bytes (and only for the blocks which were added to it).
+ * 
+ * The two functions which touch the header are never inlined so that the compiler does not mistake 
+ * the header arithmetic for an out-of-bounds access into the caller's array.
+ */
+__attribute__((noinline)) void * operator new(std::size_t size)
+{
+    char * block = (char *) malloc(size + ALLOCATION_HEADER_BYTES);
+    if (block == NULL) throw std::bad_alloc();
+    bool counted = memory_profile_active.load(std::memory_order_relaxed);
+    ((std::size_t *) block)[0] = size;
+    ((std::size_t *) block)[1] = counted;
+    if (counted) record_allocation(size);
+    return block + ALLOCATION_HEADER_BYTES;
+}
+
+void * operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+__attribute__((noinline)) void * operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    char * block = (char *) malloc(size + ALLOCATION_HEADER_BYTES);
+    if (block == NULL) return NULL;
+    bool counted = memory_profile_active.load(std::memory_order_relaxed);
+    ((std::size_t *) block)[0] = size;
+    ((std::size_t *) block)[1] = counted;
+    if (counted) record_allocation(size);
+    return block + ALLOCATION_HEADER_BYTES;
+}
+
+void * operator new[](std::size_t size, const std::nothrow_t & tag) noexcept
+{
+    return operator new(size, tag);
+}
+
+__attribute__((noinline)) void operator delete(void * pointer) noexcept
+{
+    if (pointer == NULL) return;
+    char * block = (char *) pointer - ALLOCATION_HEADER_BYTES;
+    if (((std::size_t *) block)[1] != 0) record_deallocation(((std::size_t *) block)[0]);
+    free(block);
+}
+
+void operator delete[](void * pointer) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void * pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void * pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete(void * pointer, const std::nothrow_t &) noexcept
+{
+    operator delete(pointer);
+}
+
+void operator delete[](void * pointer, const std::nothrow_t &) noexcept
+{
+    operator delete(pointer);
+}
+
+/**
+ * Add one allocation of size bytes to allocation_counters (and raise peak_live_bytes if live_bytes exceeds it).
+ */
+void record_allocation(std::size_t size)
+{
+    allocation_counters.allocation_count.fetch_add(1, std::memory_order_relaxed);
+    allocation_counters.allocated_bytes.fetch_add((long long) size, std::memory_order_relaxed);
+    long long live = allocation_counters.live_bytes.fetch_add((long long) size, std::memory_order_relaxed) + (long long) size;
+    update_maximum(allocation_counters.peak_live_bytes, live);
+}
+
+/**
+ * Subtract one freed block of size bytes from the live_bytes counter of allocation_counters.
+ */
+void record_deallocation(std::size_t size)
+{
+    allocation_counters.live_bytes.fetch_sub((long long) size, std::memory_order_relaxed);
+}
+
+/**
+ * Replace the value stored in maximum with value if value is larger (in a way which is safe when several threads do so at once).
+ */
+void update_maximum(std::atomic<long long> & maximum, long long value)
+{
+    long long previous = maximum.load(std::memory_order_relaxed);
+    while ((value > previous) && !maximum.compare_exchange_weak(previous, value, std::memory_order_relaxed)) { }
+}
+
+/**
+ * Increment the recursion depth of the calling thread and record the deepest recursion (and stack distance) reached so far 
+ * (if a memory profile is being taken).
+ */
+StackDepthGuard::StackDepthGuard() : active(memory_profile_active.load(std::memory_order_relaxed))
+{
+    char marker = 0;
+    if (!active) return;
+    if (current_recursion_depth == 0) outermost_stack_frame = &marker;
+    current_recursion_depth++;
+    update_maximum(maximum_recursion_depth, current_recursion_depth);
+    update_maximum(maximum_stack_bytes, (long long) (outermost_stack_frame - &marker));
+}
+
+/**
+ * Decrement the recursion depth of the calling thread (if the constructor incremented it).
+ */
+StackDepthGuard::~StackDepthGuard()
+{
+    if (active) current_recursion_depth--;
+}
+
+/**
+ * Return the value (in kilobytes) of the line of /proc/self/status which starts with field (e.g. "VmRSS:" or "VmHWM:"), 
+ * or -1 if that line could not be read.
+ */
+long long read_process_status_kilobytes(const std::string & field)
+{
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) if (line.compare(0, field.size(), field) == 0) return atoll(line.c_str() + field.size());
+    return -1;
+}
+
+// Define the measurements which start_memory_profile takes for stop_memory_profile.
+long long profile_rss_before_kilobytes = -1, profile_maximum_rss_before_kilobytes = -1, profile_live_bytes_before = 0;
+bool profile_peak_rss_was_reset = false;
+
+/**
+ * Reset the allocation counters, the recursion depth counters, and (if the kernel allows it) the peak resident set size 
+ * of this process so that stop_memory_profile reports only the memory used after this function returns.
+ */
+void start_memory_profile()
+{
+    // Writing "5" to /proc/self/clear_refs resets the peak resident set size (VmHWM) to the current resident set size.
+    std::ofstream clear_refs("/proc/self/clear_refs");
+    profile_peak_rss_was_reset = (bool) (clear_refs << "5" << std::flush);
+    clear_refs.close();
+    struct rusage usage;
+    profile_maximum_rss_before_kilobytes = (getrusage(RUSAGE_SELF, &usage) == 0) ? usage.ru_maxrss : -1;
+    profile_rss_before_kilobytes = read_process_status_kilobytes("VmRSS:");
+    allocation_counters.allocation_count.store(0);
+    allocation_counters.allocated_bytes.store(0);
+    profile_live_bytes_before = allocation_counters.live_bytes.load();
+    allocation_counters.peak_live_bytes.store(profile_live_bytes_before);
+    maximum_recursion_depth.store(0);
+    maximum_stack_bytes.store(0);
+    memory_profile_active.store(true);
+}
+
+/**
+ * Return the memory footprint of the work which was done since the most recent call to start_memory_profile.
+ * 
+ * peak_live_bytes counts only the bytes which were allocated after start_memory_profile was called.
+ * peak_rss_delta_kilobytes is the growth of the peak resident set size (measured with /proc/self/status 
+ * when the peak could be reset and with getrusage otherwise, in which case growth is only visible once 
+ * the process exceeds its earlier peak).
+ */
+MemoryProfile stop_memory_profile()
+{
+    MemoryProfile memory = { -1, -1, -1, -1, -1, -1 };
+    memory_profile_active.store(false);
+    memory.allocation_count = allocation_counters.allocation_count.load();
+    memory.allocated_bytes = allocation_counters.allocated_bytes.load();
+    memory.maximum_recursion_depth = maximum_recursion_depth.load();
+    memory.maximum_stack_bytes = maximum_stack_bytes.load();
+    long long peak_live = allocation_counters.peak_live_bytes.load() - profile_live_bytes_before;
+    memory.peak_live_bytes = (peak_live > 0) ? peak_live : 0;
+    long long peak_rss = read_process_status_kilobytes("VmHWM:");
+    struct rusage usage;
+    if (profile_peak_rss_was_reset && (peak_rss >= 0) && (profile_rss_before_kilobytes >= 0)) memory.peak_rss_delta_kilobytes = peak_rss - profile_rss_before_kilobytes;
+    else if ((getrusage(RUSAGE_SELF, &usage) == 0) && (profile_maximum_rss_before_kilobytes >= 0)) memory.peak_rss_delta_kilobytes = usage.ru_maxrss - profile_maximum_rss_before_kilobytes;
+    if (memory.peak_rss_delta_kilobytes < 0) memory.peak_rss_delta_kilobytes = 0;
+    return memory;
+}
+
+/**
+ * Return the memory footprint of sorting a copy of the S elements of source using sort. 
+ * This is a separate run which is not timed (the instrumentation which a memory profile turns on would slow the sort down), 
+ * so callers measure the memory footprint and the runtime of an algorithm in different runs on the same input.
+ */
+MemoryProfile profile_sort_memory(const std::function<void(int *, int)> & sort, const int * source, int S)
+{
+    std::vector<int> work(source, source + S);
+    start_memory_profile();
+    sort(work.data(), S);
+    return stop_memory_profile();
+}
+
+/**
+ * Return a one-line plain-English description of a MemoryProfile.
+ */
+std::string describe_memory_profile(const MemoryProfile & memory)
+{
+    return std::to_string(memory.allocation_count) + " heap allocations totaling " + std::to_string(memory.allocated_bytes) + " bytes, " 
+        + std::to_string(memory.peak_live_bytes) + " peak live heap bytes, " 
+        + std::to_string(memory.peak_rss_delta_kilobytes) + " kilobytes of peak resident set size growth, " 
+        + "maximum recursion depth " + std::to_string(memory.maximum_recursion_depth) + " (about " + std::to_string(memory.maximum_stack_bytes) + " bytes of stack)";
+}
+
+/**
+ * Restrict the calling process (and every thread or child process which it later creates) to the processor core whose index is cpu.
+ * Return true if the scheduler accepted the new affinity mask.
+ */
+bool pin_to_cpu(int cpu)
+{
+    cpu_set_t mask;
+    if (cpu < 0) return false;
+    CPU_ZERO(&mask);
+    CPU_SET(cpu, &mask);
+    return sched_setaffinity(0, sizeof(mask), &mask) == 0;
+}
+
+/**
+ * Return the current clock frequency (in megahertz) of the processor core whose index is cpu.
+ * 
+ * The frequency is read from the cpufreq directory in sysfs if the kernel exposes one 
+ * and otherwise from the "cpu MHz" line of the matching processor block of /proc/cpuinfo.
+ * Return -1 if neither source is available.
+ */
+double read_cpu_frequency_mhz(int cpu)
+{
+    if (cpu < 0) return -1.0;
+    std::ifstream scaling("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq");
+    long long kilohertz = 0;
+    if (scaling >> kilohertz) return kilohertz / 1000.0;
+    std::ifstream cpuinfo("/proc/cpuinfo");
+    std::string line;
+    int processor = -1;
+    while (std::getline(cpuinfo, line))
+    {
+        if (line.compare(0, 9, "processor") == 0) processor = atoi(line.substr(line.find(':') + 1).c_str());
+        else if ((processor == cpu) && (line.compare(0, 7, "cpu MHz") == 0)) return atof(line.substr(line.find(':') + 1).c_str());
+    }
+    return -1.0;
+}
+
+/**
+ * Read the frequency of the core of sampler once and add the reading to sampler (if it could be read).
+ */
+void add_frequency_sample(FrequencySampler & sampler)
+{
+    double frequency = read_cpu_frequency_mhz(sampler.cpu);
+    if (frequency <= 0.0) return;
+    sampler.total_mhz += frequency;
+    sampler.minimum_mhz = (sampler.samples == 0) ? frequency : std::min(sampler.minimum_mhz, frequency);
+    sampler.maximum_mhz = (sampler.samples == 0) ? frequency : std::max(sampler.maximum_mhz, frequency);
+    sampler.samples++;
+}
+
+/**
+ * Read the frequency of core cpu once and then start the thread of sampler, which reads it again every FREQUENCY_SAMPLE_INTERVAL_MILLISECONDS until stop_frequency_sampler is called. 
+ * The thread runs on every other core (even if the process is pinned to core cpu), so that it does not take time from the sorting run which it observes. 
+ * On a machine with one core (or if the thread cannot be moved) the frequency is only read before and after the run.
+ */
+void start_frequency_sampler(FrequencySampler & sampler, int cpu)
+{
+    cpu_set_t mask;
+    int cpu_count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    sampler.cpu = cpu;
+    sampler.total_mhz = 0.0;
+    sampler.minimum_mhz = -1.0;
+    sampler.maximum_mhz = -1.0;
+    sampler.samples = 0;
+    add_frequency_sample(sampler);
+    if ((cpu < 0) || (cpu_count < 2)) return;
+    CPU_ZERO(&mask);
+    for (int other = 0; other < cpu_count; other++) if (other != cpu) CPU_SET(other, &mask);
+    sampler.running.store(true);
+    sampler.thread = std::thread([&sampler, mask]()
+    {
+        if (sched_setaffinity(0, sizeof(mask), &mask) != 0) return;
+        while (true)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(FREQUENCY_SAMPLE_INTERVAL_MILLISECONDS));
+            if (!sampler.running.load()) break;
+            add_frequency_sample(sampler);
+        }
+    });
+}
+
+/**
+ * Stop the thread of sampler and read the frequency once more (of core cpu, on which the sorting run ended).
+ */
+void stop_frequency_sampler(FrequencySampler & sampler, int cpu)
+{
+    sampler.running.store(false);
+    if (sampler.thread.joinable()) sampler.thread.join();
+    sampler.cpu = cpu;
+    add_frequency_sample(sampler);
+}
+
+/**
+ * Return the size (in bytes) of the largest processor cache listed in /sys/devices/system/cpu/cpu0/cache (normally the last-level cache).
+ * Return 32 megabytes if the cache sizes cannot be read.
+ */
+long long read_last_level_cache_bytes()
+{
+    long long largest = 0;
+    for (int index = 0; index < 8; index++)
+    {
+        std::ifstream input("/sys/devices/system/cpu/cpu0/cache/index" + std::to_string(index) + "/size");
+        std::string size;
+        if (!(input >> size)) continue;
+        long long bytes = atoll(size.c_str());
+        if (size.back() == 'K') bytes *= 1024;
+        else if (size.back() == 'M') bytes *= 1024 * 1024;
+        if (bytes > largest) largest = bytes;
+    }
+    return (largest > 0) ? largest : 32LL * 1024 * 1024;
+}
+
+/**
+ * Put the processor caches into the state named by cache_state before a sorting run whose input array is work (and which has S elements).
+ * 
+ * "warm" leaves the caches as they are (so the input array is usually cached because it was just copied),
+ * "flushed" evicts each cache line of the input array from every cache level with clflush,
+ * and "cold" additionally streams a buffer which is twice the size of the last-level cache (at most MAXIMUM_EVICTION_BYTES) 
+ * through the caches so that the sorting run also finds no other useful data cached.
+ */
+void prepare_cache_state(const std::string & cache_state, const int * work, int S)
+{
+    static std::vector<char> eviction_buffer;
+    if (cache_state == "warm") return;
+    if (cache_state == "cold")
+    {
+        if (eviction_buffer.empty()) eviction_buffer.assign((size_t) std::min(2 * read_last_level_cache_bytes(), (long long) MAXIMUM_EVICTION_BYTES), 1);
+        // Writing one byte of every line forces the whole buffer through the caches (and the buffer outlives the call, so the writes are kept).
+        for (size_t i = 0; i < eviction_buffer.size(); i += CACHE_LINE_BYTES) eviction_buffer[i]++;
+    }
+    const char * bytes = (const char *) work;
+    for (size_t i = 0; i < (size_t) S * sizeof(int); i += CACHE_LINE_BYTES) _mm_clflush(bytes + i);
+    _mm_mfence();
+}
+
+/**
+ * Copy the S elements of source into work, sort work using engine, and return everything which was measured during that sorting run.
+ * Only the call to engine.sort is timed (the copy and any cache preparation happen before the clock starts). 
+ * If profile_memory is true, the memory footprint is measured afterwards in a separate untimed run (see profile_sort_memory); 
+ * otherwise every field of measurement.memory is 0.
+ */
+RunMeasurement run_sort_once(const SortEngine & engine, const int * source, int * work, int S, const std::string & cache_state, bool profile_memory)
+{
+    RunMeasurement measurement = RunMeasurement();
+    int descriptors[NUMBER_OF_COUNTERS];
+    struct rusage usage_before, usage_after;
+    for (int k = 0; k < NUMBER_OF_COUNTERS; k++) measurement.counters[k] = 0;
+    std::copy(source, source + S, work);
+    prepare_cache_state(cache_state, work, S);
+    measurement.cpu_at_start = sched_getcpu();
+    FrequencySampler sampler;
+    start_frequency_sampler(sampler, measurement.cpu_at_start);
+    getrusage(RUSAGE_THREAD, &usage_before);
+    start_performance_counters(descriptors);
+    auto start = std::chrono::high_resolution_clock::now();
+    engine.sort(work, S);
+    auto end = std::chrono::high_resolution_clock::now();
+    stop_performance_counters(descriptors, measurement.counters);
+    getrusage(RUSAGE_THREAD, &usage_after);
+    measurement.cpu_at_end = sched_getcpu();
+    stop_frequency_sampler(sampler, measurement.cpu_at_end);
+    std::chrono::duration<double> duration = end - start;
+    measurement.seconds = duration.count();
+    measurement.frequency_mhz = (sampler.samples > 0) ? sampler.total_mhz / sampler.samples : -1.0;
+    measurement.minimum_frequency_mhz = sampler.minimum_mhz;
+    measurement.maximum_frequency_mhz = sampler.maximum_mhz;
+    measurement.voluntary_context_switches = usage_after.ru_nvcsw - usage_before.ru_nvcsw;
+    measurement.involuntary_context_switches = usage_after.ru_nivcsw - usage_before.ru_nivcsw;
+    measurement.sorted = true;
+    for (int i = 1; i < S; i++) if (work[i - 1] > work[i]) measurement.sorted = false;
+    if (profile_memory) measurement.memory = profile_sort_memory(engine.sort, source, S);
+    return measurement;
+}
+
+/**
+ * Write (or read) exactly bytes bytes to (or from) the pipe end named by descriptor, 
+ * retrying after partial transfers and interrupted system calls, and return true on success.
+ */
+bool write_all(int descriptor, const void * data, size_t bytes)
+{
+    const char * next = (const char *) data;
+    while (bytes > 0)
+    {
+        ssize_t written = write(descriptor, next, bytes);
+        if ((written < 0) && (errno == EINTR)) continue;
+        if (written <= 0) return false;
+        next += written;
+        bytes -= (size_t) written;
+    }
+    return true;
+}
+
+bool read_all(int descriptor, void * data, size_t bytes)
+{
+    char * next = (char *) data;
+    while (bytes > 0)
+    {
+        ssize_t received = read(descriptor, next, bytes);
+        if ((received < 0) && (errno == EINTR)) continue;
+        if (received <= 0) return false;
+        next += received;
+        bytes -= (size_t) received;
+    }
+    return true;
+}
+
+/**
+ * Run engine on a copy of the S elements of source repetitions times (per instance) as described by execution 
+ * and return one RunMeasurement per completed run (or an empty vector if the child processes could not be created).
+ * 
+ * With isolation "in_process" every repetition runs in this process.
+ * With isolation "fork" every repetition runs in its own child process (so no run inherits the heap layout, page cache state, 
+ * or branch predictor history of an earlier run) and sends its measurement back through a pipe.
+ * With more than one concurrent instance, each instance is a child process pinned to its own core 
+ * (cores pinned_cpu, pinned_cpu + 1, and so on, wrapping around the number of cores) 
+ * which waits until every instance is ready and then runs all of its repetitions while the other instances run theirs.
+ * Every child keeps its measurements in memory and writes them to its pipe only after its last timed run 
+ * (so that no instance stalls on a full pipe while the others are still sorting). 
+ * If an instance exits before it is ready, the other instances are released without running and an empty vector is returned.
+ * The memory footprint is measured once (per instance), in an untimed run after the first timed repetition.
+ */
+std::vector<RunMeasurement> run_sort_repetitions(const SortEngine & engine, const int * source, int S, int repetitions, const ExecutionSettings & execution)
+{
+    std::vector<RunMeasurement> measurements;
+    int cpu_count = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if (execution.isolation == "in_process")
+    {
+        std::vector<int> work(S);
+        for (int r = 0; r < repetitions; r++) measurements.push_back(run_sort_once(engine, source, work.data(), S, execution.cache_state, r == 0));
+        return measurements;
+    }
+
+    // Each child process runs runs_per_child repetitions; a single instance forks one child per repetition.
+    int children = (execution.concurrent_instances > 1) ? execution.concurrent_instances : repetitions;
+    int runs_per_child = (execution.concurrent_instances > 1) ? repetitions : 1;
+    int first_cpu = (execution.pinned_cpu < 0) ? 0 : execution.pinned_cpu;
+    std::vector<pid_t> process_ids;
+    std::vector<int> result_pipes;
+    int ready_pipe[2], start_pipe[2];
+    if ((pipe(ready_pipe) != 0) || (pipe(start_pipe) != 0)) return measurements;
+    for (int child = 0; child < children; child++)
+    {
+        int result_pipe[2];
+        if (pipe(result_pipe) != 0) break;
+        std::cout.flush();
+        pid_t process_id = fork();
+        if (process_id < 0)
+        {
+            close(result_pipe[0]);
+            close(result_pipe[1]);
+            break;
+        }
+        if (process_id == 0)
+        {
+            // This is the child process: pin it, allocate its own work array, wait for the start signal (when instances run concurrently), and run.
+            char signal = 0;
+            int instance = (execution.concurrent_instances > 1) ? child : 0;
+            close(result_pipe[0]);
+            close(ready_pipe[0]);
+            close(start_pipe[1]);
+            for (int descriptor : result_pipes) close(descriptor);
+            if ((execution.pinned_cpu >= 0) || (execution.concurrent_instances > 1)) pin_to_cpu((first_cpu + instance) % cpu_count);
+            std::vector<int> work(S);
+            std::vector<RunMeasurement> results;
+            results.reserve(runs_per_child);
+            if (execution.concurrent_instances > 1)
+            {
+                write_all(ready_pipe[1], &signal, 1);
+                close(ready_pipe[1]);
+                if (!read_all(start_pipe[0], &signal, 1)) _exit(1);
+            }
+            for (int r = 0; r < runs_per_child; r++)
+            {
+                RunMeasurement measurement = run_sort_once(engine, source, work.data(), S, execution.cache_state, (r == 0) && ((child == 0) || (execution.concurrent_instances > 1)));
+                measurement.instance = instance;
+                results.push_back(measurement);
+            }
+            write_all(result_pipe[1], results.data(), results.size() * sizeof(RunMeasurement));
+            close(result_pipe[1]);
+            _exit(0);
+        }
+        close(result_pipe[1]);
+        process_ids.push_back(process_id);
+        result_pipes.push_back(result_pipe[0]);
+
+        // A single instance runs its children one after another so that no two repetitions overlap.
+        if (execution.concurrent_instances == 1)
+        {
+            RunMeasurement measurement;
+            if (read_all(result_pipe[0], &measurement, sizeof(measurement))) measurements.push_back(measurement);
+        }
+    }
+
+    /**
+     * Release the concurrent instances only after every one of them has been created, pinned, and is ready. 
+     * The parent's copies of the ends which only the children use are closed first, so that an instance which exits before it is ready 
+     * ends the wait with a short read (and closing the start pipe then releases the other instances, which exit without running).
+     */
+    close(ready_pipe[1]);
+    close(start_pipe[0]);
+    if (execution.concurrent_instances > 1)
+    {
+        char signal = 0;
+        bool ready = true;
+        for (size_t child = 0; ready && (child < process_ids.size()); child++) ready = read_all(ready_pipe[0], &signal, 1);
+        for (size_t child = 0; ready && (child < process_ids.size()); child++) write_all(start_pipe[1], &signal, 1);
+        close(start_pipe[1]);
+        for (int descriptor : result_pipes)
+        {
+            RunMeasurement measurement;
+            while (ready && read_all(descriptor, &measurement, sizeof(measurement))) measurements.push_back(measurement);
+        }
+    }
+    else close(start_pipe[1]);
+    for (int descriptor : result_pipes) close(descriptor);
+    for (pid_t process_id : process_ids) waitpid(process_id, NULL, 0);
+    close(ready_pipe[0]);
+    return measurements;
+}